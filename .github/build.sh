@@ -33,8 +33,8 @@ build_matrixmath_serializer_project() {
   # Project Settings.
   local project_path="$1"; # Root path of the project.
   local base_name='libmatrixmath_serializer';   # Base name for the project.
-  local test_dependencies='-lmatrixmath -ljson -lstr'; # Dependencies for tests (add as needed).
-  local library_dependencies='-lmatrixmath -ljson -lstr'; # Dependencies for library (add as needed).
+  local test_dependencies='-lmatrixmath -ljson -lstr -lpthread'; # Dependencies for tests (add as needed).
+  local library_dependencies='-lmatrixmath -ljson -lstr -lpthread'; # Dependencies for library (add as needed).
   local namespace=''; # The project namespace.
 
   # Build the project.
@@ -60,6 +60,7 @@ clean_directory() {
 #   $3 - Name of the application to be created.
 #   $4 - Space-separated list of dependencies for the build.
 #   $5 - Path to the directory where the binary should be moved.
+#   $6 - Optional, set to "keep" to preserve the current bin folder contents.
 #
 # Usage:
 #   build_app "$FILES_TO_COMPILE" "$BUILD_PATH" "$APP_NAME" "$DEPENDENCIES" "$BIN_PATH";
@@ -70,11 +71,14 @@ build_app() {
   local app_name=$3;
   local dependencies=$4;
   local bin_path=$5;
+  local keep_bin=$6;
   local current_path=$(pwd);
 
   # clean up build and bin folder.
   clean_directory "$build_path";
-  clean_directory "$bin_path";
+  if [ "$keep_bin" != "keep" ]; then
+    clean_directory "$bin_path";
+  fi
 
   # Go to the build path.
   cd "$build_path" || exit;
@@ -329,6 +333,9 @@ clean_project_precompiled_headers() {
   remove_precompiled_headers "$project_path/src";
   remove_precompiled_headers "$project_path/include";
   remove_precompiled_headers "$project_path/tests";
+  if [ -d "$project_path/benchmarks" ]; then
+    remove_precompiled_headers "$project_path/benchmarks";
+  fi
 }
 
 # Function to build the project.
@@ -353,15 +360,18 @@ build_project() {
   # Search paths for library and test code.
   local library_code_search_paths="$project_path/include $project_path/src/$project_namespace";
   local test_code_search_paths="$library_code_search_paths $project_path/tests/$project_namespace";
+  local benchmark_code_search_paths="$library_code_search_paths $project_path/benchmarks/$project_namespace";
 
   # Build paths.
   local base_build_path="$project_path/build/$project_namespace";
   local library_build_path="$base_build_path/library";
   local test_build_path="$base_build_path/test";
+  local benchmark_build_path="$base_build_path/benchmark";
 
   # Output paths.
   local bin_path="$project_path/bin";
   local app_name="$base_name.app";
+  local benchmark_app_name="$base_name.benchmark.app";
 
   # Clean up build directory before start the build.
   clean_directory "$base_build_path";
@@ -371,6 +381,13 @@ build_project() {
   app_files_to_compile=$(get_files_to_compile "$test_code_search_paths");
   build_app "$app_files_to_compile" $test_build_path $app_name "$test_dependencies" $bin_path;
 
+  # Build the benchmark app next to the main app, it is not run automatically.
+  if [ -d "$project_path/benchmarks/$project_namespace" ]; then
+    local benchmark_files_to_compile;
+    benchmark_files_to_compile=$(get_files_to_compile "$benchmark_code_search_paths");
+    build_app "$benchmark_files_to_compile" $benchmark_build_path $benchmark_app_name "$test_dependencies" $bin_path keep;
+  fi
+
   # Create shared and static libraries.
   local library_files_to_compile;
   library_files_to_compile=$(get_files_to_compile "$library_code_search_paths");
@@ -0,0 +1,130 @@
+#include <errno.h>
+#include <malloc.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "benchmark_allocator.h"
+
+/**
+ * The glibc allocator entry points the interposed functions forward to.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *pointer);
+
+/**
+ * Allocator counters, shared by every thread of the benchmark.
+ */
+static atomic_size_t benchmark_allocator_calls;
+static atomic_llong benchmark_allocator_live;
+static atomic_llong benchmark_allocator_peak;
+static atomic_llong benchmark_allocator_base;
+
+/**
+ * Records a change in the number of live bytes and updates the peak.
+ *
+ * @param long long delta
+ *   The number of bytes allocated, negative when bytes are released.
+ */
+static void benchmark_allocator_track(long long delta) {
+  long long live = atomic_fetch_add(&benchmark_allocator_live, delta) + delta;
+  long long peak = atomic_load(&benchmark_allocator_peak);
+  while (live > peak && !atomic_compare_exchange_weak(&benchmark_allocator_peak, &peak, live)) {
+  }
+}
+
+/**
+ * Records a successful allocation.
+ *
+ * @param void *pointer
+ *   The allocated block, or NULL if the allocation failed.
+ *
+ * @return void*
+ *   Returns the given pointer.
+ */
+static void *benchmark_allocator_allocated(void *pointer) {
+  atomic_fetch_add(&benchmark_allocator_calls, 1);
+  if (pointer != NULL) {
+    benchmark_allocator_track((long long)malloc_usable_size(pointer));
+  }
+  return pointer;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void *malloc(size_t size) {
+  return benchmark_allocator_allocated(__libc_malloc(size));
+}
+
+/**
+ * {@inheritdoc}
+ */
+void *calloc(size_t count, size_t size) {
+  return benchmark_allocator_allocated(__libc_calloc(count, size));
+}
+
+/**
+ * {@inheritdoc}
+ */
+void *realloc(void *pointer, size_t size) {
+  size_t previous = pointer != NULL ? malloc_usable_size(pointer) : 0;
+  void *resized = __libc_realloc(pointer, size);
+  // A failed realloc leaves the original block untouched.
+  if (resized == NULL && size > 0) {
+    atomic_fetch_add(&benchmark_allocator_calls, 1);
+    return NULL;
+  }
+  benchmark_allocator_track(-(long long)previous);
+  return benchmark_allocator_allocated(resized);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void *aligned_alloc(size_t alignment, size_t size) {
+  return benchmark_allocator_allocated(__libc_memalign(alignment, size));
+}
+
+/**
+ * {@inheritdoc}
+ */
+int posix_memalign(void **pointer, size_t alignment, size_t size) {
+  void *block = benchmark_allocator_allocated(__libc_memalign(alignment, size));
+  if (block == NULL) {
+    return ENOMEM;
+  }
+  *pointer = block;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void free(void *pointer) {
+  if (pointer == NULL) {
+    return;
+  }
+  benchmark_allocator_track(-(long long)malloc_usable_size(pointer));
+  __libc_free(pointer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void benchmark_allocator_reset() {
+  long long live = atomic_load(&benchmark_allocator_live);
+  atomic_store(&benchmark_allocator_base, live);
+  atomic_store(&benchmark_allocator_peak, live);
+  atomic_store(&benchmark_allocator_calls, 0);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void benchmark_allocator_snapshot(struct benchmark_allocator_stats *stats) {
+  long long peak = atomic_load(&benchmark_allocator_peak) - atomic_load(&benchmark_allocator_base);
+  stats->calls = atomic_load(&benchmark_allocator_calls);
+  stats->peak_bytes = peak > 0 ? (size_t)peak : 0;
+}
@@ -0,0 +1,33 @@
+#ifndef BENCHMARK_ALLOCATOR_H
+#define BENCHMARK_ALLOCATOR_H
+
+#include <stddef.h>
+
+/**
+ * Snapshot of the interposed allocator counters.
+ */
+struct benchmark_allocator_stats {
+  // Number of allocation calls (malloc, calloc, realloc and aligned variants).
+  size_t calls;
+  // Highest number of live bytes observed since the last reset.
+  size_t peak_bytes;
+};
+
+/**
+ * Starts a measurement window.
+ *
+ * Resets the call counter and the peak to the bytes currently live, so the
+ * next snapshot only reports what happened inside the window.
+ */
+void benchmark_allocator_reset();
+
+/**
+ * Reads the counters of the current measurement window.
+ *
+ * @param struct benchmark_allocator_stats *stats
+ *   Pointer receiving the allocation calls and the peak bytes allocated on top
+ *   of what was live when the window started.
+ */
+void benchmark_allocator_snapshot(struct benchmark_allocator_stats *stats);
+
+#endif
@@ -0,0 +1,472 @@
+#include <stdlib.h>
+#include <string.h>
+#include <json.h>
+#include "benchmark_formats.h"
+
+/**
+ * Number of threads used by the parallel formats.
+ */
+#define BENCHMARK_PARALLEL_THREADS 8
+
+/**
+ * Returns the length of a text payload.
+ */
+static void *benchmark_text_payload(char *text, size_t *length) {
+  if (text != NULL) {
+    *length = strlen(text);
+  }
+  return text;
+}
+
+/**
+ * Encodes a matrix with the default text encoder.
+ */
+static void *benchmark_json_encode_matrix(struct matrix *object, size_t *length) {
+  return benchmark_text_payload(matrix_serialize(object), length);
+}
+
+/**
+ * Decodes a matrix with the default text decoder.
+ */
+static int benchmark_json_decode_matrix(const void *payload, size_t length) {
+  struct matrix *object = matrix_unserialize((char *)payload);
+  matrix_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Encodes a vector with the default text encoder.
+ */
+static void *benchmark_json_encode_vector(struct vector *object, size_t *length) {
+  return benchmark_text_payload(vector_serialize(object), length);
+}
+
+/**
+ * Decodes a vector with the default text decoder.
+ */
+static int benchmark_json_decode_vector(const void *payload, size_t length) {
+  struct vector *object = vector_unserialize((char *)payload);
+  vector_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Encodes a matrix through an intermediate JSON tree.
+ */
+static void *benchmark_tree_encode_matrix(struct matrix *object, size_t *length) {
+  struct json *jobject = matrix_serialize_to_json(object);
+  if (jobject == NULL) {
+    return NULL;
+  }
+  char *text = json_encode(jobject);
+  json_destroy(jobject);
+  return benchmark_text_payload(text, length);
+}
+
+/**
+ * Decodes a matrix through an intermediate JSON tree.
+ */
+static int benchmark_tree_decode_matrix(const void *payload, size_t length) {
+  struct json *jobject = json_decode((char *)payload);
+  if (jobject == NULL) {
+    return 1;
+  }
+  // The tree is released by the decoder on failure.
+  struct matrix *object = matrix_unserialize_from_json_object(jobject);
+  if (object == NULL) {
+    return 1;
+  }
+  json_destroy(jobject);
+  matrix_destroy(object);
+  return 0;
+}
+
+/**
+ * Encodes a vector through an intermediate JSON tree.
+ */
+static void *benchmark_tree_encode_vector(struct vector *object, size_t *length) {
+  struct json *jobject = vector_serialize_to_json(object);
+  if (jobject == NULL) {
+    return NULL;
+  }
+  char *text = json_encode(jobject);
+  json_destroy(jobject);
+  return benchmark_text_payload(text, length);
+}
+
+/**
+ * Decodes a vector through an intermediate JSON tree.
+ */
+static int benchmark_tree_decode_vector(const void *payload, size_t length) {
+  struct json *jobject = json_decode((char *)payload);
+  if (jobject == NULL) {
+    return 1;
+  }
+  // The tree is released by the decoder on failure.
+  struct vector *object = vector_unserialize_from_json_object(jobject);
+  if (object == NULL) {
+    return 1;
+  }
+  json_destroy(jobject);
+  vector_destroy(object);
+  return 0;
+}
+
+/**
+ * Returns the default options with the parallel threshold lowered to one
+ * element, the benchmark sizes otherwise stay on the serial path.
+ */
+static struct serializer_options benchmark_parallel_options() {
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.parallel_threshold = 1;
+  return options;
+}
+
+/**
+ * Encodes a matrix with the parallel text encoder.
+ */
+static void *benchmark_parallel_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_parallel_options();
+  return benchmark_text_payload(matrix_serialize_parallel(object, &options, BENCHMARK_PARALLEL_THREADS), length);
+}
+
+/**
+ * Decodes a matrix with the parallel text decoder.
+ */
+static int benchmark_parallel_decode_matrix(const void *payload, size_t length) {
+  struct serializer_options options = benchmark_parallel_options();
+  struct matrix *object = matrix_unserialize_parallel(payload, &options, BENCHMARK_PARALLEL_THREADS);
+  matrix_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Arena shared by the arena formats, reset before every call.
+ */
+static struct serializer_arena *benchmark_arena = NULL;
+
+/**
+ * Returns the shared arena, reset and ready for a new call.
+ */
+static struct serializer_arena *benchmark_arena_get() {
+  if (benchmark_arena == NULL) {
+    benchmark_arena = serializer_arena_create(0);
+  }
+  serializer_arena_reset(benchmark_arena);
+  return benchmark_arena;
+}
+
+/**
+ * Leaves arena payloads alone, they are reclaimed by the next reset.
+ */
+static void benchmark_arena_release(void *payload) {
+}
+
+/**
+ * Encodes a matrix into arena memory.
+ */
+static void *benchmark_arena_encode_matrix(struct matrix *object, size_t *length) {
+  return matrix_serialize_arena(object, NULL, benchmark_arena_get(), length);
+}
+
+/**
+ * Decodes a matrix into arena memory.
+ */
+static int benchmark_arena_decode_matrix(const void *payload, size_t length) {
+  return matrix_unserialize_arena(payload, benchmark_arena_get()) == NULL;
+}
+
+/**
+ * Encodes a vector into arena memory.
+ */
+static void *benchmark_arena_encode_vector(struct vector *object, size_t *length) {
+  return vector_serialize_arena(object, NULL, benchmark_arena_get(), length);
+}
+
+/**
+ * Decodes a vector into arena memory.
+ */
+static int benchmark_arena_decode_vector(const void *payload, size_t length) {
+  int capacity;
+  return vector_unserialize_arena(payload, benchmark_arena_get(), &capacity) == NULL;
+}
+
+/**
+ * Encodes a matrix with the binary encoder.
+ */
+static void *benchmark_binary_encode_matrix(struct matrix *object, size_t *length) {
+  return matrix_serialize_binary(object, length);
+}
+
+/**
+ * Decodes a matrix with the binary decoder.
+ */
+static int benchmark_binary_decode_matrix(const void *payload, size_t length) {
+  struct matrix *object = matrix_unserialize_binary(payload, length);
+  matrix_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Encodes a vector with the binary encoder.
+ */
+static void *benchmark_binary_encode_vector(struct vector *object, size_t *length) {
+  return vector_serialize_binary(object, length);
+}
+
+/**
+ * Decodes a vector with the binary decoder.
+ */
+static int benchmark_binary_decode_vector(const void *payload, size_t length) {
+  struct vector *object = vector_unserialize_binary(payload, length);
+  vector_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Returns the default options with the given encoding, element type and layout.
+ */
+static struct serializer_options benchmark_options(int sparse, int element_type, int layout) {
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = sparse;
+  options.element_type = element_type;
+  options.layout = layout;
+  return options;
+}
+
+/**
+ * Encodes a matrix as text in the CSR form.
+ */
+static void *benchmark_sparse_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_ALWAYS, SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return benchmark_text_payload(matrix_serialize_with_options(object, &options), length);
+}
+
+/**
+ * Encodes a matrix as binary in the CSR form.
+ */
+static void *benchmark_binary_sparse_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_ALWAYS, SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return matrix_serialize_binary_with_options(object, &options, length);
+}
+
+/**
+ * Encodes a matrix as text rounded to float32.
+ */
+static void *benchmark_float32_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_FLOAT32, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return benchmark_text_payload(matrix_serialize_with_options(object, &options), length);
+}
+
+/**
+ * Encodes a vector as text rounded to float32.
+ */
+static void *benchmark_float32_encode_vector(struct vector *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_FLOAT32, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return benchmark_text_payload(vector_serialize_with_options(object, &options), length);
+}
+
+/**
+ * Encodes a matrix as binary float32 elements.
+ */
+static void *benchmark_binary_float32_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_FLOAT32, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return matrix_serialize_binary_with_options(object, &options, length);
+}
+
+/**
+ * Encodes a vector as binary float32 elements.
+ */
+static void *benchmark_binary_float32_encode_vector(struct vector *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_FLOAT32, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return vector_serialize_binary_with_options(object, &options, length);
+}
+
+/**
+ * Encodes a matrix as binary float16 elements.
+ */
+static void *benchmark_binary_float16_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_FLOAT16, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return matrix_serialize_binary_with_options(object, &options, length);
+}
+
+/**
+ * Encodes a vector as binary float16 elements.
+ */
+static void *benchmark_binary_float16_encode_vector(struct vector *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_FLOAT16, SERIALIZER_LAYOUT_ROW_MAJOR);
+  return vector_serialize_binary_with_options(object, &options, length);
+}
+
+/**
+ * Encodes a matrix as text in column-major order.
+ */
+static void *benchmark_column_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_LAYOUT_COLUMN_MAJOR);
+  return benchmark_text_payload(matrix_serialize_with_options(object, &options), length);
+}
+
+/**
+ * Decodes a column-major matrix string.
+ */
+static int benchmark_column_decode_matrix(const void *payload, size_t length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_LAYOUT_COLUMN_MAJOR);
+  struct matrix *object = matrix_unserialize_with_options(payload, &options);
+  matrix_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Encodes a matrix as binary in column-major order.
+ */
+static void *benchmark_binary_column_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_options options = benchmark_options(SERIALIZER_SPARSE_NEVER, SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_LAYOUT_COLUMN_MAJOR);
+  return matrix_serialize_binary_with_options(object, &options, length);
+}
+
+/**
+ * Encodes a matrix as a compressed text frame.
+ */
+static void *benchmark_compressed_encode_matrix(struct matrix *object, size_t *length) {
+  return matrix_serialize_compressed(object, NULL, length);
+}
+
+/**
+ * Encodes a matrix as a compressed binary frame.
+ */
+static void *benchmark_binary_compressed_encode_matrix(struct matrix *object, size_t *length) {
+  return matrix_serialize_binary_compressed(object, length);
+}
+
+/**
+ * Decodes a compressed text or binary frame.
+ */
+static int benchmark_compressed_decode_matrix(const void *payload, size_t length) {
+  struct matrix *object = matrix_unserialize_compressed(payload, length);
+  matrix_destroy(object);
+  return object == NULL;
+}
+
+/**
+ * Context shared by the context formats, it keeps its memory across calls.
+ */
+static struct matrixmath_serializer_ctx *benchmark_ctx = NULL;
+
+/**
+ * Returns the shared context.
+ */
+static struct matrixmath_serializer_ctx *benchmark_ctx_get() {
+  if (benchmark_ctx == NULL) {
+    benchmark_ctx = matrixmath_serializer_ctx_create(NULL);
+  }
+  return benchmark_ctx;
+}
+
+/**
+ * Leaves context payloads alone, they are reused by the next call.
+ */
+static void benchmark_ctx_release(void *payload) {
+}
+
+/**
+ * Encodes a matrix into the context buffer.
+ */
+static void *benchmark_ctx_encode_matrix(struct matrix *object, size_t *length) {
+  return (void *)matrix_serialize_ctx(benchmark_ctx_get(), object, length);
+}
+
+/**
+ * Decodes a matrix into the context scratch space.
+ */
+static int benchmark_ctx_decode_matrix(const void *payload, size_t length) {
+  return matrix_unserialize_ctx(benchmark_ctx_get(), payload) == NULL;
+}
+
+/**
+ * Encodes a vector into the context buffer.
+ */
+static void *benchmark_ctx_encode_vector(struct vector *object, size_t *length) {
+  return (void *)vector_serialize_ctx(benchmark_ctx_get(), object, length);
+}
+
+/**
+ * Decodes a vector into the context scratch space.
+ */
+static int benchmark_ctx_decode_vector(const void *payload, size_t length) {
+  int capacity;
+  return vector_unserialize_ctx(benchmark_ctx_get(), payload, &capacity) == NULL;
+}
+
+/**
+ * Packs a matrix into a single-slice tensor and encodes it as text.
+ */
+static void *benchmark_tensor_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_tensor *tensor = serializer_tensor_stack(&object, 1);
+  if (tensor == NULL) {
+    return NULL;
+  }
+  char *text = tensor_serialize(tensor, NULL);
+  serializer_tensor_destroy(tensor);
+  return benchmark_text_payload(text, length);
+}
+
+/**
+ * Decodes a tensor string.
+ */
+static int benchmark_tensor_decode_matrix(const void *payload, size_t length) {
+  struct serializer_tensor *tensor = tensor_unserialize(payload);
+  serializer_tensor_destroy(tensor);
+  return tensor == NULL;
+}
+
+/**
+ * Packs a matrix into a single-slice tensor and encodes it as binary.
+ */
+static void *benchmark_binary_tensor_encode_matrix(struct matrix *object, size_t *length) {
+  struct serializer_tensor *tensor = serializer_tensor_stack(&object, 1);
+  if (tensor == NULL) {
+    return NULL;
+  }
+  unsigned char *data = tensor_serialize_binary(tensor, NULL, length);
+  serializer_tensor_destroy(tensor);
+  return data;
+}
+
+/**
+ * Decodes a binary tensor payload.
+ */
+static int benchmark_binary_tensor_decode_matrix(const void *payload, size_t length) {
+  struct serializer_tensor *tensor = tensor_unserialize_binary(payload, length);
+  serializer_tensor_destroy(tensor);
+  return tensor == NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+const struct benchmark_format benchmark_formats[] = {
+  {"json", benchmark_json_encode_matrix, benchmark_json_decode_matrix, benchmark_json_encode_vector, benchmark_json_decode_vector, free},
+  {"json-tree", benchmark_tree_encode_matrix, benchmark_tree_decode_matrix, benchmark_tree_encode_vector, benchmark_tree_decode_vector, free},
+  {"json-parallel", benchmark_parallel_encode_matrix, benchmark_parallel_decode_matrix, NULL, NULL, free},
+  {"json-arena", benchmark_arena_encode_matrix, benchmark_arena_decode_matrix, benchmark_arena_encode_vector, benchmark_arena_decode_vector, benchmark_arena_release},
+  {"binary", benchmark_binary_encode_matrix, benchmark_binary_decode_matrix, benchmark_binary_encode_vector, benchmark_binary_decode_vector, free},
+  {"json-sparse", benchmark_sparse_encode_matrix, benchmark_json_decode_matrix, NULL, NULL, free},
+  {"binary-sparse", benchmark_binary_sparse_encode_matrix, benchmark_binary_decode_matrix, NULL, NULL, free},
+  {"json-float32", benchmark_float32_encode_matrix, benchmark_json_decode_matrix, benchmark_float32_encode_vector, benchmark_json_decode_vector, free},
+  {"binary-float32", benchmark_binary_float32_encode_matrix, benchmark_binary_decode_matrix, benchmark_binary_float32_encode_vector, benchmark_binary_decode_vector, free},
+  {"binary-float16", benchmark_binary_float16_encode_matrix, benchmark_binary_decode_matrix, benchmark_binary_float16_encode_vector, benchmark_binary_decode_vector, free},
+  {"json-column-major", benchmark_column_encode_matrix, benchmark_column_decode_matrix, NULL, NULL, free},
+  {"binary-column-major", benchmark_binary_column_encode_matrix, benchmark_binary_decode_matrix, NULL, NULL, free},
+  {"json-compressed", benchmark_compressed_encode_matrix, benchmark_compressed_decode_matrix, NULL, NULL, free},
+  {"binary-compressed", benchmark_binary_compressed_encode_matrix, benchmark_compressed_decode_matrix, NULL, NULL, free},
+  {"json-context", benchmark_ctx_encode_matrix, benchmark_ctx_decode_matrix, benchmark_ctx_encode_vector, benchmark_ctx_decode_vector, benchmark_ctx_release},
+  {"json-tensor", benchmark_tensor_encode_matrix, benchmark_tensor_decode_matrix, NULL, NULL, free},
+  {"binary-tensor", benchmark_binary_tensor_encode_matrix, benchmark_binary_tensor_decode_matrix, NULL, NULL, free},
+};
+
+/**
+ * {@inheritdoc}
+ */
+const size_t benchmark_format_count = sizeof(benchmark_formats) / sizeof(benchmark_formats[0]);
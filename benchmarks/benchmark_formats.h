@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_FORMATS_H
+#define BENCHMARK_FORMATS_H
+
+#include <stddef.h>
+#include "../include/matrixmath_serializer.h"
+
+/**
+ * A serialization format exercised by the benchmarks.
+ *
+ * Encoders return a payload and its length, which is handed back to release
+ * once it is no longer needed; decoders decode a NUL-terminated heap copy of a
+ * payload, destroy the result and return 0 on success. A NULL entry means the
+ * format does not support that object kind.
+ */
+struct benchmark_format {
+  // Name of the format, as reported in the results.
+  const char *name;
+  // Matrix encoder.
+  void *(*encode_matrix)(struct matrix *object, size_t *length);
+  // Matrix decoder.
+  int (*decode_matrix)(const void *payload, size_t length);
+  // Vector encoder.
+  void *(*encode_vector)(struct vector *object, size_t *length);
+  // Vector decoder.
+  int (*decode_vector)(const void *payload, size_t length);
+  // Releases an encoded payload.
+  void (*release)(void *payload);
+};
+
+/**
+ * The formats exercised by the benchmarks.
+ */
+extern const struct benchmark_format benchmark_formats[];
+
+/**
+ * The number of entries in benchmark_formats.
+ */
+extern const size_t benchmark_format_count;
+
+#endif
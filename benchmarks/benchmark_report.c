@@ -0,0 +1,39 @@
+#include "benchmark_report.h"
+
+/**
+ * {@inheritdoc}
+ */
+void benchmark_report_begin(FILE *output, int format) {
+  if (format == BENCHMARK_REPORT_JSON) {
+    fprintf(output, "[\n");
+    return;
+  }
+  fprintf(output, "kind,format,operation,rows,columns,bytes,iterations,mb_per_s,elements_per_s,p50_us,p99_us,malloc_calls,peak_bytes\n");
+}
+
+/**
+ * {@inheritdoc}
+ */
+void benchmark_report_result(FILE *output, int format, const struct benchmark_result *result, int first) {
+  if (format == BENCHMARK_REPORT_JSON) {
+    fprintf(output, "%s  {\"kind\":\"%s\",\"format\":\"%s\",\"operation\":\"%s\",\"rows\":%d,\"columns\":%d,\"bytes\":%zu,\"iterations\":%d,"
+      "\"mb_per_s\":%.3f,\"elements_per_s\":%.0f,\"p50_us\":%.3f,\"p99_us\":%.3f,\"malloc_calls\":%.1f,\"peak_bytes\":%zu}",
+      first ? "" : ",\n", result->kind, result->format, result->operation, result->rows, result->columns, result->bytes, result->iterations,
+      result->megabytes_per_second, result->elements_per_second, result->p50_microseconds, result->p99_microseconds, result->malloc_calls, result->peak_bytes);
+  }
+  else {
+    fprintf(output, "%s,%s,%s,%d,%d,%zu,%d,%.3f,%.0f,%.3f,%.3f,%.1f,%zu\n",
+      result->kind, result->format, result->operation, result->rows, result->columns, result->bytes, result->iterations,
+      result->megabytes_per_second, result->elements_per_second, result->p50_microseconds, result->p99_microseconds, result->malloc_calls, result->peak_bytes);
+  }
+  fflush(output);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void benchmark_report_end(FILE *output, int format) {
+  if (format == BENCHMARK_REPORT_JSON) {
+    fprintf(output, "\n]\n");
+  }
+}
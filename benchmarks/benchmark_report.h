@@ -0,0 +1,51 @@
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <stdio.h>
+#include "benchmark_runner.h"
+
+/**
+ * Output formats of the benchmark report.
+ */
+enum benchmark_report_format {
+  // One comma-separated line per result, preceded by a header line.
+  BENCHMARK_REPORT_CSV,
+  // A JSON array holding one object per result.
+  BENCHMARK_REPORT_JSON,
+};
+
+/**
+ * Writes the beginning of the report.
+ *
+ * @param FILE *output
+ *   The output stream.
+ * @param int format
+ *   One of the benchmark_report_format values.
+ */
+void benchmark_report_begin(FILE *output, int format);
+
+/**
+ * Writes one result to the report.
+ *
+ * @param FILE *output
+ *   The output stream.
+ * @param int format
+ *   One of the benchmark_report_format values.
+ * @param const struct benchmark_result *result
+ *   The result to write.
+ * @param int first
+ *   Non-zero if this is the first result of the report.
+ */
+void benchmark_report_result(FILE *output, int format, const struct benchmark_result *result, int first);
+
+/**
+ * Writes the end of the report.
+ *
+ * @param FILE *output
+ *   The output stream.
+ * @param int format
+ *   One of the benchmark_report_format values.
+ */
+void benchmark_report_end(FILE *output, int format);
+
+#endif
@@ -0,0 +1,104 @@
+#include <stdlib.h>
+#include <time.h>
+#include "benchmark_allocator.h"
+#include "benchmark_runner.h"
+
+/**
+ * Number of elements processed per benchmark case, across all iterations.
+ */
+#define BENCHMARK_ELEMENT_BUDGET (1 << 22)
+
+/**
+ * Bounds on the number of timed iterations.
+ */
+#define BENCHMARK_MIN_ITERATIONS 3
+#define BENCHMARK_MAX_ITERATIONS 1000
+
+/**
+ * Timed nanoseconds after which a case stops, once it has the minimum iterations.
+ */
+#define BENCHMARK_TIME_BUDGET 250e6
+
+/**
+ * Objects up to this size get an untimed warm-up run.
+ */
+#define BENCHMARK_WARMUP_ELEMENTS (1 << 20)
+
+/**
+ * Returns the current monotonic time in nanoseconds.
+ */
+static double benchmark_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/**
+ * Orders latency samples in ascending order.
+ */
+static int benchmark_compare_samples(const void *left, const void *right) {
+  double a = *(const double *)left;
+  double b = *(const double *)right;
+  return (a > b) - (a < b);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int benchmark_measure(benchmark_operation operation, void *state, size_t elements, struct benchmark_result *result) {
+  // Scale the iterations to the size of the object.
+  size_t iterations = BENCHMARK_ELEMENT_BUDGET / (elements > 0 ? elements : 1);
+  if (iterations < BENCHMARK_MIN_ITERATIONS) {
+    iterations = BENCHMARK_MIN_ITERATIONS;
+  }
+  if (iterations > BENCHMARK_MAX_ITERATIONS) {
+    iterations = BENCHMARK_MAX_ITERATIONS;
+  }
+  double *samples = malloc(iterations * sizeof(double));
+  if (samples == NULL) {
+    return 1;
+  }
+  size_t bytes = 0;
+  if (elements <= BENCHMARK_WARMUP_ELEMENTS && operation(state, &bytes) == 1) {
+    free(samples);
+    return 1;
+  }
+  // Time every iteration on its own, tracking the allocations it makes.
+  size_t calls = 0;
+  size_t peak_bytes = 0;
+  double total = 0;
+  struct benchmark_allocator_stats stats;
+  for (size_t i = 0; i < iterations; i++) {
+    benchmark_allocator_reset();
+    double start = benchmark_now();
+    int status = operation(state, &bytes);
+    samples[i] = benchmark_now() - start;
+    benchmark_allocator_snapshot(&stats);
+    if (status == 1) {
+      free(samples);
+      return 1;
+    }
+    total += samples[i];
+    calls += stats.calls;
+    if (stats.peak_bytes > peak_bytes) {
+      peak_bytes = stats.peak_bytes;
+    }
+    // Slow formats stop early, the samples taken so far are reported.
+    if (i + 1 >= BENCHMARK_MIN_ITERATIONS && total >= BENCHMARK_TIME_BUDGET) {
+      iterations = i + 1;
+    }
+  }
+  qsort(samples, iterations, sizeof(double), benchmark_compare_samples);
+  // Fill in the measurements, the samples are in nanoseconds.
+  double seconds = total / 1e9;
+  result->bytes = bytes;
+  result->iterations = (int)iterations;
+  result->megabytes_per_second = seconds > 0 ? (double)bytes * iterations / seconds / 1e6 : 0;
+  result->elements_per_second = seconds > 0 ? (double)elements * iterations / seconds : 0;
+  result->p50_microseconds = samples[iterations / 2] / 1e3;
+  result->p99_microseconds = samples[(iterations * 99) / 100] / 1e3;
+  result->malloc_calls = (double)calls / iterations;
+  result->peak_bytes = peak_bytes;
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include <stddef.h>
+
+/**
+ * Callback running one timed operation.
+ *
+ * @param void *state
+ *   The benchmark specific state.
+ * @param size_t *bytes
+ *   Pointer receiving the payload size processed by the operation.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+typedef int (*benchmark_operation)(void *state, size_t *bytes);
+
+/**
+ * Measurements of one benchmark case.
+ */
+struct benchmark_result {
+  // Object kind, "matrix" or "vector".
+  const char *kind;
+  // Format name.
+  const char *format;
+  // Operation name, "encode" or "decode".
+  const char *operation;
+  // Shape of the object.
+  int rows;
+  int columns;
+  // Payload size in bytes.
+  size_t bytes;
+  // Number of timed iterations.
+  int iterations;
+  // Throughput over all iterations.
+  double megabytes_per_second;
+  double elements_per_second;
+  // Latency percentiles in microseconds.
+  double p50_microseconds;
+  double p99_microseconds;
+  // Allocation calls per operation.
+  double malloc_calls;
+  // Highest number of bytes allocated by a single operation.
+  size_t peak_bytes;
+};
+
+/**
+ * Times an operation and fills in the measurements of a result.
+ *
+ * The number of iterations is derived from the number of elements, so small
+ * objects are measured many times and the largest ones only a few. A case also
+ * stops once its timed iterations exceed a fixed time budget.
+ *
+ * @param benchmark_operation operation
+ *   The operation to time.
+ * @param void *state
+ *   The state passed to the operation.
+ * @param size_t elements
+ *   Number of elements processed by one operation.
+ * @param struct benchmark_result *result
+ *   The result receiving the measurements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an operation failed.
+ */
+int benchmark_measure(benchmark_operation operation, void *state, size_t elements, struct benchmark_result *result);
+
+#endif
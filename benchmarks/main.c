@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "benchmark_formats.h"
+#include "benchmark_report.h"
+#include "benchmark_runner.h"
+
+/**
+ * Matrix sides exercised by the benchmarks, vectors hold side * side elements.
+ */
+static const int benchmark_sides[] = {1, 16, 128, 512, 1024, 2048, 4096, 8192};
+
+/**
+ * Largest side run by default, the larger ones are selected with --max-size.
+ */
+#define BENCHMARK_DEFAULT_MAX_SIZE 128
+
+/**
+ * State of an encode benchmark.
+ */
+struct benchmark_encode_state {
+  const struct benchmark_format *format;
+  struct matrix *matrix_object;
+  struct vector *vector_object;
+};
+
+/**
+ * State of a decode benchmark.
+ */
+struct benchmark_decode_state {
+  const struct benchmark_format *format;
+  const void *payload;
+  size_t length;
+  // Non-zero when the payload holds a matrix.
+  int is_matrix;
+};
+
+/**
+ * Returns a deterministic pseudo-random value spanning several magnitudes.
+ */
+static long double benchmark_value(unsigned long long *seed) {
+  *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  long double mantissa = (long double)(*seed >> 11) / (1ULL << 53) - 0.5L;
+  static const long double scales[] = {1e-6L, 1e-3L, 1, 1e3L, 1e6L};
+  return mantissa * scales[(*seed >> 3) % 5];
+}
+
+/**
+ * Encodes the object once, see benchmark_operation.
+ */
+static int benchmark_encode(void *state, size_t *bytes) {
+  struct benchmark_encode_state *encode = state;
+  void *payload = encode->matrix_object != NULL
+    ? encode->format->encode_matrix(encode->matrix_object, bytes)
+    : encode->format->encode_vector(encode->vector_object, bytes);
+  if (payload == NULL) {
+    return 1;
+  }
+  encode->format->release(payload);
+  return 0;
+}
+
+/**
+ * Decodes the payload once, see benchmark_operation.
+ */
+static int benchmark_decode(void *state, size_t *bytes) {
+  struct benchmark_decode_state *decode = state;
+  *bytes = decode->length;
+  return decode->is_matrix
+    ? decode->format->decode_matrix(decode->payload, decode->length)
+    : decode->format->decode_vector(decode->payload, decode->length);
+}
+
+/**
+ * Runs the encode and decode benchmarks of one object in one format.
+ *
+ * @param const struct benchmark_format *format
+ *   The format to benchmark.
+ * @param struct matrix *matrix_object
+ *   The matrix to benchmark, or NULL to benchmark the vector.
+ * @param struct vector *vector_object
+ *   The vector to benchmark when no matrix is given.
+ * @param FILE *output
+ *   The report output stream.
+ * @param int report_format
+ *   One of the benchmark_report_format values.
+ * @param int *first
+ *   Non-zero until the first result has been written.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an operation failed.
+ */
+static int benchmark_run_case(const struct benchmark_format *format, struct matrix *matrix_object, struct vector *vector_object, FILE *output, int report_format, int *first) {
+  struct benchmark_result result = {0};
+  result.kind = matrix_object != NULL ? "matrix" : "vector";
+  result.format = format->name;
+  result.rows = matrix_object != NULL ? matrix_object->rows : 1;
+  result.columns = matrix_object != NULL ? matrix_object->columns : vector_object->capacity;
+  size_t elements = (size_t)result.rows * result.columns;
+  // Encode benchmark.
+  struct benchmark_encode_state encode = {format, matrix_object, vector_object};
+  result.operation = "encode";
+  if (benchmark_measure(benchmark_encode, &encode, elements, &result) == 1) {
+    return 1;
+  }
+  benchmark_report_result(output, report_format, &result, *first);
+  *first = 0;
+  // Decode benchmark, from a heap copy of a payload produced by the same format.
+  struct benchmark_decode_state decode = {format, NULL, 0, matrix_object != NULL};
+  void *encoded = matrix_object != NULL
+    ? format->encode_matrix(matrix_object, &decode.length)
+    : format->encode_vector(vector_object, &decode.length);
+  char *payload = encoded != NULL ? malloc(decode.length + 1) : NULL;
+  if (payload != NULL) {
+    memcpy(payload, encoded, decode.length);
+    payload[decode.length] = '\0';
+  }
+  if (encoded != NULL) {
+    format->release(encoded);
+  }
+  if (payload == NULL) {
+    return 1;
+  }
+  decode.payload = payload;
+  result.operation = "decode";
+  int status = benchmark_measure(benchmark_decode, &decode, elements, &result);
+  free(payload);
+  if (status == 1) {
+    return 1;
+  }
+  benchmark_report_result(output, report_format, &result, *first);
+  return 0;
+}
+
+/**
+ * Prints the command line usage.
+ */
+static void benchmark_usage(const char *name) {
+  fprintf(stderr, "Usage: %s [--csv|--json] [--max-size N] [--output FILE]\n", name);
+}
+
+/**
+ * Main controller function.
+ *
+ * @param int argc
+ *   The number of arguments passed by the user in the command line.
+ * @param array argv
+ *   Array of char, the arguments names.
+ *
+ * @return int
+ *   The constant that represents the exit status.
+ */
+int main(int argc, char const *argv[]) {
+  // Parse the command line.
+  int report_format = BENCHMARK_REPORT_CSV;
+  int max_size = BENCHMARK_DEFAULT_MAX_SIZE;
+  const char *output_path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--csv") == 0) {
+      report_format = BENCHMARK_REPORT_CSV;
+    }
+    else if (strcmp(argv[i], "--json") == 0) {
+      report_format = BENCHMARK_REPORT_JSON;
+    }
+    else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+      max_size = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      output_path = argv[++i];
+    }
+    else {
+      benchmark_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  FILE *output = output_path != NULL ? fopen(output_path, "w") : stdout;
+  if (output == NULL) {
+    perror(output_path);
+    return EXIT_FAILURE;
+  }
+  // Run every format on every size, matrices first, then vectors.
+  int status = EXIT_SUCCESS;
+  int first = 1;
+  unsigned long long seed = 42;
+  benchmark_report_begin(output, report_format);
+  for (size_t s = 0; status == EXIT_SUCCESS && s < sizeof(benchmark_sides) / sizeof(benchmark_sides[0]); s++) {
+    int side = benchmark_sides[s];
+    if (side > max_size) {
+      break;
+    }
+    struct matrix *matrix_object = matrix_create(side, side);
+    struct vector *vector_object = vector_create(side * side);
+    if (matrix_object == NULL || vector_object == NULL) {
+      fprintf(stderr, "Unable to allocate the %dx%d benchmark objects.\n", side, side);
+      matrix_destroy(matrix_object);
+      vector_destroy(vector_object);
+      status = EXIT_FAILURE;
+      break;
+    }
+    for (int j = 0; j < side; j++) {
+      for (int k = 0; k < side; k++) {
+        matrix_setl(matrix_object, j, k, benchmark_value(&seed));
+        vector_setl(vector_object, j * side + k, benchmark_value(&seed));
+      }
+    }
+    for (size_t f = 0; status == EXIT_SUCCESS && f < benchmark_format_count; f++) {
+      const struct benchmark_format *format = &benchmark_formats[f];
+      if (format->encode_matrix != NULL && benchmark_run_case(format, matrix_object, NULL, output, report_format, &first) == 1) {
+        status = EXIT_FAILURE;
+      }
+      if (status == EXIT_SUCCESS && format->encode_vector != NULL && benchmark_run_case(format, NULL, vector_object, output, report_format, &first) == 1) {
+        status = EXIT_FAILURE;
+      }
+      if (status == EXIT_FAILURE) {
+        fprintf(stderr, "Benchmark failed for format %s at %dx%d.\n", format->name, side, side);
+      }
+    }
+    matrix_destroy(matrix_object);
+    vector_destroy(vector_object);
+  }
+  benchmark_report_end(output, report_format);
+  if (output != stdout) {
+    fclose(output);
+  }
+  return status;
+}
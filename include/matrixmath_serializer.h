@@ -1,9 +1,528 @@
-#ifndef VECTOR_SERIALIZER_H
-#define VECTOR_SERIALIZER_H
+#ifndef SERIALIZER_OPTIONS_H
+#define SERIALIZER_OPTIONS_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <matrixmath.h>
 #include <json.h>
 
+/**
+ * The maximum length of a formatted number, including the NUL terminator.
+ */
+#define SERIALIZER_NUMBER_MAX_LENGTH 64
+
+/**
+ * Number formatting modes used by the text encoders.
+ */
+enum serializer_precision {
+  // Shortest text that parses back to the exact same value, see
+  // serializer_format_long_double().
+  SERIALIZER_PRECISION_SHORTEST = 0,
+  // The value rounded to double and printed with 17 significant digits.
+  SERIALIZER_PRECISION_DOUBLE = 1,
+  // A fixed number of significant digits, see serializer_options.digits.
+  SERIALIZER_PRECISION_FIXED = 2,
+  // The json_number_string() output of the JSON tree encoder.
+  SERIALIZER_PRECISION_LEGACY = 3,
+};
+
+/**
+ * Matrix encodings selected by the matrix encoders.
+ */
+enum serializer_sparse_mode {
+  // Always write the dense array of rows.
+  SERIALIZER_SPARSE_NEVER = 0,
+  // Always write the compressed sparse row (CSR) form.
+  SERIALIZER_SPARSE_ALWAYS = 1,
+  // Write the CSR form when the fraction of nonzero elements is at most
+  // serializer_options.sparse_density, otherwise the dense form.
+  SERIALIZER_SPARSE_AUTO = 2,
+};
+
+/**
+ * Element orders used by the dense matrix encoders and decoders.
+ */
+enum serializer_layout {
+  // Each inner array, or run of elements, holds one row.
+  SERIALIZER_LAYOUT_ROW_MAJOR = 0,
+  // Each inner array, or run of elements, holds one column.
+  SERIALIZER_LAYOUT_COLUMN_MAJOR = 1,
+};
+
+/**
+ * Handling of NaN and infinities by the strict decoders.
+ */
+enum serializer_non_finite_policy {
+  // Reject NaN and infinities with SERIALIZER_ERROR_NON_FINITE.
+  SERIALIZER_NON_FINITE_REJECT = 0,
+  // Accept the nan, inf and infinity spellings, in any case and signed.
+  SERIALIZER_NON_FINITE_ALLOW = 1,
+};
+
+/**
+ * Options controlling the serializer output.
+ */
+struct serializer_options {
+  // Number formatting mode, one of the serializer_precision values.
+  int precision;
+  // Number of significant digits used by SERIALIZER_PRECISION_FIXED.
+  int digits;
+  // Minimum number of elements for the parallel encoders to use threads.
+  size_t parallel_threshold;
+  // Matrix encoding, one of the serializer_sparse_mode values.
+  int sparse;
+  // Highest fraction of nonzero elements encoded as CSR by SERIALIZER_SPARSE_AUTO.
+  double sparse_density;
+  // Element type the values are rounded to, one of the serializer_element_type
+  // values. The text encoders only accept the long double, float64 and float32
+  // types.
+  int element_type;
+  // Matrix element order, one of the serializer_layout values. Column-major
+  // matrices are always written in the dense form, and the batch, delta,
+  // streaming and compressed encoders are always row-major.
+  int layout;
+  // NaN and infinity handling of the strict decoders, one of the
+  // serializer_non_finite_policy values.
+  int non_finite;
+};
+
+/**
+ * Default minimum number of elements for the parallel encoders to use threads.
+ */
+#define SERIALIZER_PARALLEL_THRESHOLD 65536
+
+/**
+ * Default highest fraction of nonzero elements encoded as CSR in auto mode.
+ */
+#define SERIALIZER_SPARSE_DENSITY 0.25
+
+/**
+ * Initializes serializer options with their default values.
+ *
+ * @param struct serializer_options *options
+ *   Pointer to the options to initialize.
+ */
+void serializer_options_init(struct serializer_options *options);
+
+/**
+ * Formats a long double with the shortest text that round trips exactly.
+ *
+ * The value is printed once with LDBL_DECIMAL_DIG digits. Values with a round
+ * trip form of up to LDBL_DIG digits get their shortest form, the others keep
+ * the LDBL_DECIMAL_DIG digits, less any trailing zeros.
+ *
+ * @param long double value
+ *   The value to format.
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ *
+ * @return int
+ *   Returns the length of the formatted text.
+ */
+int serializer_format_long_double(long double value, char *buffer);
+
+/**
+ * Formats a double with the shortest text that round trips exactly.
+ *
+ * The digits are computed without printf, with the Ryu algorithm, and written
+ * in the %g notation.
+ *
+ * @param double value
+ *   The value to format.
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ *
+ * @return int
+ *   Returns the length of the formatted text.
+ */
+int serializer_format_double(double value, char *buffer);
+
+/**
+ * Formats a number according to the given serializer options.
+ *
+ * @param long double value
+ *   The value to format.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ *
+ * @return int
+ *   Returns the length of the formatted text, or -1 if an error occurred or,
+ *   with SERIALIZER_PRECISION_LEGACY, the text does not fit the buffer. The
+ *   encoders write the legacy text at its real length.
+ */
+int serializer_format_number(long double value, const struct serializer_options *options, char *buffer);
+
+/**
+ * Rounds a value to the nearest value of the given element type.
+ *
+ * Ties round to even and values beyond the largest finite element round to an
+ * infinity, so the result is exactly what the encoders store for the value.
+ *
+ * @param long double value
+ *   The value to round.
+ * @param int element_type
+ *   One of the serializer_element_type values.
+ *
+ * @return long double
+ *   Returns the rounded value widened back to long double, or NaN if the
+ *   element type is unknown.
+ */
+long double serializer_element_round(long double value, int element_type);
+
+/**
+ * Returns the largest relative error introduced by an element type.
+ *
+ * A decoded value x' of an encoded value x satisfies |x' - x| <= epsilon * |x|
+ * in the normal range of the element type. Text keeps the shortest digits that
+ * identify the rounded element, which can add up to the same error again, so
+ * text round trips are bounded by twice the returned value.
+ *
+ * @param int element_type
+ *   One of the serializer_element_type values.
+ *
+ * @return long double
+ *   Returns the unit roundoff of the element type, or -1 if it is unknown.
+ */
+long double serializer_element_epsilon(int element_type);
+
+/**
+ * Parses a decimal number spanning exactly the given number of bytes.
+ *
+ * Numbers with at most 19 significant digits and a small decimal exponent are
+ * converted with a single correctly rounded operation; anything else falls back
+ * to strtold(), so the result always matches strtold().
+ *
+ * @param const char *text
+ *   Pointer to the number text.
+ * @param size_t length
+ *   Number of bytes of the number text.
+ * @param long double *value
+ *   Pointer receiving the parsed value.
+ *
+ * @return int
+ *   Returns 0 if the whole span is a valid number, otherwise 1.
+ */
+int serializer_parse_number(const char *text, size_t length, long double *value);
+
+#endif // SERIALIZER_OPTIONS_H
+
+#ifndef SERIALIZER_ARENA_H
+#define SERIALIZER_ARENA_H
+
+/**
+ * Memory block owned by a serializer arena.
+ */
+struct serializer_arena_block {
+  // Next block of the arena.
+  struct serializer_arena_block *next;
+  // Number of usable bytes in the block.
+  size_t capacity;
+  // Number of bytes handed out from the block.
+  size_t used;
+  // The block memory, aligned for any type.
+  max_align_t data[];
+};
+
+/**
+ * Caller-owned bump allocator serving the temporary allocations of a call.
+ *
+ * Blocks are kept across serializer_arena_reset() calls, so once the arena has
+ * grown to the size of the largest request, steady-state operation performs no
+ * malloc or free at all. An arena must not be shared between threads.
+ */
+struct serializer_arena {
+  // First block of the arena.
+  struct serializer_arena_block *first;
+  // Block allocations are currently served from.
+  struct serializer_arena_block *current;
+  // Minimum size of new blocks.
+  size_t block_size;
+  // Most recent allocation, which can still be grown in place.
+  void *last;
+};
+
+/**
+ * Creates a serializer arena.
+ *
+ * @param size_t block_size
+ *   Minimum size of the arena blocks in bytes, or 0 to use the default size.
+ *
+ * @return struct serializer_arena*
+ *   Returns the arena, or NULL if an error occurred.
+ */
+struct serializer_arena *serializer_arena_create(size_t block_size);
+
+/**
+ * Allocates memory from the arena.
+ *
+ * The memory is aligned for any type and stays valid until the arena is reset
+ * or destroyed.
+ *
+ * @param struct serializer_arena *arena
+ *   The arena.
+ * @param size_t size
+ *   Number of bytes to allocate.
+ *
+ * @return void*
+ *   Returns the memory, or NULL if an error occurred.
+ */
+void *serializer_arena_alloc(struct serializer_arena *arena, size_t size);
+
+/**
+ * Resizes the most recent arena allocation, or moves any other one.
+ *
+ * @param struct serializer_arena *arena
+ *   The arena.
+ * @param void *pointer
+ *   Memory returned by the arena, or NULL to allocate.
+ * @param size_t old_size
+ *   The current size of the memory.
+ * @param size_t new_size
+ *   The requested size of the memory.
+ *
+ * @return void*
+ *   Returns the resized memory, or NULL if an error occurred, in which case the
+ *   original memory is left untouched.
+ */
+void *serializer_arena_realloc(struct serializer_arena *arena, void *pointer, size_t old_size, size_t new_size);
+
+/**
+ * Releases every allocation of the arena at once, keeping its blocks for reuse.
+ *
+ * @param struct serializer_arena *arena
+ *   The arena.
+ */
+void serializer_arena_reset(struct serializer_arena *arena);
+
+/**
+ * Frees the arena and all its blocks.
+ *
+ * @param struct serializer_arena *arena
+ *   The arena.
+ */
+void serializer_arena_destroy(struct serializer_arena *arena);
+
+#endif // SERIALIZER_ARENA_H
+
+#ifndef SERIALIZER_BUFFER_H
+#define SERIALIZER_BUFFER_H
+
+/**
+ * Output sink callback used by the streaming encoders.
+ *
+ * @param const char *data
+ *   Pointer to the bytes to consume.
+ * @param size_t length
+ *   Number of bytes to consume.
+ * @param void *context
+ *   The caller-supplied context pointer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 to abort the encoding.
+ */
+typedef int (*serializer_sink)(const char *data, size_t length, void *context);
+
+/**
+ * Growable output buffer used by the streaming encoders.
+ *
+ * When a sink is attached, the buffer works as a fixed-size staging area that is
+ * flushed into the sink whenever it fills up; otherwise it grows as needed.
+ */
+struct serializer_buffer {
+  // The buffer memory.
+  char *data;
+  // The number of bytes currently held in the buffer.
+  size_t length;
+  // The number of bytes allocated for the buffer.
+  size_t capacity;
+  // Optional sink the buffer contents are flushed into.
+  serializer_sink sink;
+  // Context pointer passed to the sink.
+  void *context;
+  // Optional arena the buffer memory is taken from.
+  struct serializer_arena *arena;
+  // Non-zero when the memory belongs to the caller and can not grow.
+  int fixed;
+  // Sticky error flag, set once any write fails.
+  int error;
+};
+
+/**
+ * Initializes a growable output buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the buffer to initialize.
+ * @param size_t capacity
+ *   The initial capacity in bytes, or 0 to use the default capacity.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_init(struct serializer_buffer *buffer, size_t capacity);
+
+/**
+ * Initializes an output buffer that flushes its contents into the given sink.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the buffer to initialize.
+ * @param serializer_sink sink
+ *   The sink receiving the encoded bytes.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ * @param size_t capacity
+ *   The staging capacity in bytes, or 0 to use the default capacity.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_init_sink(struct serializer_buffer *buffer, serializer_sink sink, void *context, size_t capacity);
+
+/**
+ * Initializes a growable output buffer whose memory is taken from an arena.
+ *
+ * The buffer memory, and any string detached from it, belongs to the arena and
+ * stays valid until the arena is reset or destroyed.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the buffer to initialize.
+ * @param struct serializer_arena *arena
+ *   The arena providing the buffer memory.
+ * @param size_t capacity
+ *   The initial capacity in bytes, or 0 to use the default capacity.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_init_arena(struct serializer_buffer *buffer, struct serializer_arena *arena, size_t capacity);
+
+/**
+ * Initializes an output buffer over caller-owned memory of a fixed size.
+ *
+ * Writes that do not fit, including the NUL terminator, put the buffer in its
+ * error state instead of growing it.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the buffer to initialize.
+ * @param char *data
+ *   The caller-owned memory.
+ * @param size_t capacity
+ *   The size of the memory in bytes.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_init_fixed(struct serializer_buffer *buffer, char *data, size_t capacity);
+
+/**
+ * Makes room for at least the given number of extra bytes in a growable buffer.
+ *
+ * Sink buffers keep their fixed staging size, so this is a no-op for them.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ * @param size_t extra
+ *   Number of extra bytes required on top of the current contents.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_reserve(struct serializer_buffer *buffer, size_t extra);
+
+/**
+ * Appends bytes to the output buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ * @param const char *data
+ *   Pointer to the bytes to append.
+ * @param size_t length
+ *   Number of bytes to append.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_write(struct serializer_buffer *buffer, const char *data, size_t length);
+
+/**
+ * Appends a single character to the output buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ * @param char character
+ *   The character to append.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_putc(struct serializer_buffer *buffer, char character);
+
+/**
+ * Appends a numeric value as a quoted JSON number string.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ * @param long double value
+ *   The value to append.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_write_number(struct serializer_buffer *buffer, long double value, const struct serializer_options *options);
+
+/**
+ * Flushes the buffered bytes into the attached sink, if any.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_flush(struct serializer_buffer *buffer);
+
+/**
+ * Empties the output buffer and clears its error flag, keeping its memory.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ */
+void serializer_buffer_clear(struct serializer_buffer *buffer);
+
+/**
+ * Detaches the buffer contents as a NUL-terminated string.
+ *
+ * The ownership of the returned string is transferred to the caller, or stays
+ * with the arena for arena-backed buffers, and the buffer is left empty, ready
+ * to be released or initialized again.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ * @param size_t *length
+ *   Optional pointer receiving the string length.
+ *
+ * @return char*
+ *   Returns the string, or NULL if the buffer is in an error state.
+ */
+char *serializer_buffer_detach(struct serializer_buffer *buffer, size_t *length);
+
+/**
+ * Frees the memory held by the output buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   Pointer to the output buffer.
+ */
+void serializer_buffer_release(struct serializer_buffer *buffer);
+
+#endif // SERIALIZER_BUFFER_H
+
+#ifndef VECTOR_SERIALIZER_H
+#define VECTOR_SERIALIZER_H
+
 /**
  * Generates a string representation of the given Vector object.
  *
@@ -15,6 +534,19 @@
  */
 char *vector_serialize(struct vector *object);
 
+/**
+ * Generates a string representation of the given Vector object using the given options.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return char*
+ *   Returns a string containing a representation of the Vector object.
+ */
+char *vector_serialize_with_options(struct vector *object, const struct serializer_options *options);
+
 /**
  * Generates a JSON representation of the given Vector object.
  *
@@ -46,6 +578,80 @@ struct json *vector_serialize_to_json(struct vector *object);
  */
 struct json *vector_serialize_to_json_object(const char *key, struct vector *object);
 
+/**
+ * Streams the string representation of the given Vector object into a buffer.
+ *
+ * This function writes the same output as vector_serialize_with_options()
+ * without building an intermediate JSON tree.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer receiving the serialized data.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int vector_serialize_to_stream(struct vector *object, const struct serializer_options *options, struct serializer_buffer *buffer);
+
+/**
+ * Streams the string representation of the given Vector object into a sink.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param serializer_sink sink
+ *   The sink receiving the serialized data.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int vector_serialize_to_sink(struct vector *object, const struct serializer_options *options, serializer_sink sink, void *context);
+
+/**
+ * Calculates an upper bound of the string length of the given Vector object.
+ *
+ * The bound only depends on the capacity and the options, so it costs O(1).
+ * SERIALIZER_PRECISION_LEGACY text has no fixed bound, so its exact length is
+ * measured by formatting every element instead.
+ *
+ * @param struct vector *object
+ *   The Vector object.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return size_t
+ *   Returns the maximum string length, not counting the NUL terminator, or 0
+ *   if the input is invalid.
+ */
+size_t vector_serialized_size(struct vector *object, const struct serializer_options *options);
+
+/**
+ * Writes the string representation of the given Vector object into caller memory.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param char *data
+ *   The destination memory, vector_serialized_size() + 1 bytes always suffice.
+ * @param size_t capacity
+ *   The size of the destination memory in bytes.
+ * @param size_t *length
+ *   Optional pointer receiving the string length, not counting the NUL
+ *   terminator.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred or the string
+ *   does not fit.
+ */
+int vector_serialize_to_buffer(struct vector *object, const struct serializer_options *options, char *data, size_t capacity, size_t *length);
+
 /**
  * Creates a Vector object from the given serialized data string.
  *
@@ -57,6 +663,23 @@ struct json *vector_serialize_to_json_object(const char *key, struct vector *obj
  */
 struct vector *vector_unserialize(char *data);
 
+/**
+ * Unserializes a string directly into an existing Vector object.
+ *
+ * The serialized capacity is checked against the destination before any value
+ * is written, and no memory is allocated. A malformed number found after the
+ * capacity check leaves the destination partially updated.
+ *
+ * @param struct vector *destination
+ *   The Vector object receiving the values.
+ * @param const char *data
+ *   The serialized string.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int vector_unserialize_into(struct vector *destination, const char *data);
+
 /**
  * Unserializes a JSON object into a vector object.
  *
@@ -86,8 +709,8 @@ struct vector *vector_get_and_unserialize_from_json_object(const char *key, stru
 /**
  * Retrieves and unserializes a vector from a JSON object, then sets it to the destination vector.
  *
- * This function retrieves a vector from the JSON object, unserializes it, and copies its contents
- * to the destination vector.
+ * This function retrieves a vector from the JSON object, checks its capacity against the
+ * destination vector and writes the values straight into it, without a temporary copy.
  *
  * @param struct vector *destination
  *   Pointer to the destination vector where the unserialized data will be stored.
@@ -118,15 +741,34 @@ int vector_set_from_json_object(struct vector *destination, const char *key, str
 char *matrix_serialize(struct matrix *object);
 
 /**
- * Generates a JSON representation of the given Matrix object.
+ * Generates a string representation of the given Matrix object using the given options.
  *
- * This function serializes a Matrix object into a JSON format.
+ * Depending on serializer_options.sparse the matrix is written as the dense
+ * array of rows or as a compressed sparse row object of the form
+ * {"format":"csr","rows":R,"columns":C,"row_offsets":[...],
+ * "column_indices":[...],"values":[...]}, holding only the nonzero elements.
+ * Negative zeros are not stored by the CSR form and decode as positive zeros.
  *
  * @param struct matrix *object
  *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
  *
- * @return struct json*
- *   Returns a JSON object containing a serialized representation of the Matrix object,
+ * @return char*
+ *   Returns a string containing a representation of the Matrix object.
+ */
+char *matrix_serialize_with_options(struct matrix *object, const struct serializer_options *options);
+
+/**
+ * Generates a JSON representation of the given Matrix object.
+ *
+ * This function serializes a Matrix object into a JSON format.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ *
+ * @return struct json*
+ *   Returns a JSON object containing a serialized representation of the Matrix object,
  *   or NULL if the serialization fails.
  */
 struct json *matrix_serialize_to_json(struct matrix *object);
@@ -148,9 +790,86 @@ struct json *matrix_serialize_to_json(struct matrix *object);
  */
 struct json *matrix_serialize_to_json_object(const char *key, struct matrix *object);
 
+/**
+ * Streams the string representation of the given Matrix object into a buffer.
+ *
+ * This function writes the same output as matrix_serialize_with_options()
+ * without building an intermediate JSON tree.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer receiving the serialized data.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_serialize_to_stream(struct matrix *object, const struct serializer_options *options, struct serializer_buffer *buffer);
+
+/**
+ * Streams the string representation of the given Matrix object into a sink.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param serializer_sink sink
+ *   The sink receiving the serialized data.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_serialize_to_sink(struct matrix *object, const struct serializer_options *options, serializer_sink sink, void *context);
+
+/**
+ * Calculates an upper bound of the string length of the given Matrix object.
+ *
+ * The bound only depends on the shape and the options, so it costs O(1).
+ * SERIALIZER_PRECISION_LEGACY text has no fixed bound, so its exact length is
+ * measured by formatting every element instead.
+ *
+ * @param struct matrix *object
+ *   The Matrix object.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return size_t
+ *   Returns the maximum string length, not counting the NUL terminator, or 0
+ *   if the input is invalid.
+ */
+size_t matrix_serialized_size(struct matrix *object, const struct serializer_options *options);
+
+/**
+ * Writes the string representation of the given Matrix object into caller memory.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param char *data
+ *   The destination memory, matrix_serialized_size() + 1 bytes always suffice.
+ * @param size_t capacity
+ *   The size of the destination memory in bytes.
+ * @param size_t *length
+ *   Optional pointer receiving the string length, not counting the NUL
+ *   terminator.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred or the string
+ *   does not fit.
+ */
+int matrix_serialize_to_buffer(struct matrix *object, const struct serializer_options *options, char *data, size_t capacity, size_t *length);
+
 /**
  * Creates a Matrix object object from the given serialized data string.
  *
+ * Both the dense and the CSR forms are accepted, the zeros of a CSR matrix are
+ * filled in directly without going through their text.
+ *
  * @param char* data
  *   The serialized string.
  *
@@ -159,6 +878,23 @@ struct json *matrix_serialize_to_json_object(const char *key, struct matrix *obj
  */
 struct matrix *matrix_unserialize(char *data);
 
+/**
+ * Unserializes a string directly into an existing Matrix object.
+ *
+ * The serialized shape is checked against the destination before any value
+ * is written, and no memory is allocated. A malformed number found after the
+ * shape check leaves the destination partially updated.
+ *
+ * @param struct matrix *destination
+ *   The Matrix object receiving the values.
+ * @param const char *data
+ *   The serialized string.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_unserialize_into(struct matrix *destination, const char *data);
+
 /**
  * Unserializes a JSON object into a matrix object.
  *
@@ -188,8 +924,8 @@ struct matrix *matrix_get_and_unserialize_from_json_object(const char *key, stru
 /**
  * Retrieves and unserializes a matrix from a JSON object, then sets it to the destination matrix.
  *
- * This function retrieves a matrix from the JSON object, unserializes it, and copies its contents
- * to the destination matrix.
+ * This function retrieves a matrix from the JSON object, checks its shape against the
+ * destination matrix and writes the values straight into it, without a temporary copy.
  *
  * @param struct matrix *destination
  *   Pointer to the destination matrix where the unserialized data will be stored.
@@ -204,3 +940,2216 @@ struct matrix *matrix_get_and_unserialize_from_json_object(const char *key, stru
 int matrix_set_from_json_object(struct matrix *destination, const char *key, struct json *json_object);
 
 #endif // MATRIX_SERIALIZER_H
+
+#ifndef BINARY_SERIALIZER_H
+#define BINARY_SERIALIZER_H
+
+/**
+ * The magic bytes opening every binary payload.
+ */
+#define SERIALIZER_BINARY_MAGIC "MMSB"
+
+/**
+ * The current binary format version.
+ */
+#define SERIALIZER_BINARY_VERSION 1
+
+/**
+ * The size in bytes of the binary header, the element block starts right after it.
+ */
+#define SERIALIZER_BINARY_HEADER_SIZE 32
+
+/**
+ * The kinds of objects stored in a binary payload.
+ */
+enum serializer_binary_kind {
+  SERIALIZER_BINARY_VECTOR = 1,
+  SERIALIZER_BINARY_MATRIX = 2,
+  SERIALIZER_BINARY_TENSOR = 3,
+};
+
+/**
+ * The element types stored in a binary payload.
+ */
+enum serializer_element_type {
+  // Native long double elements, sizeof(long double) bytes each. Payloads
+  // record the concrete long double format instead, see below.
+  SERIALIZER_ELEMENT_LONG_DOUBLE = 1,
+  // IEEE 754 binary64 elements, 8 bytes each.
+  SERIALIZER_ELEMENT_FLOAT64 = 2,
+  // IEEE 754 binary32 elements, 4 bytes each.
+  SERIALIZER_ELEMENT_FLOAT32 = 3,
+  // IEEE 754 binary16 elements, 2 bytes each, binary payloads only.
+  SERIALIZER_ELEMENT_FLOAT16 = 4,
+  // bfloat16 elements (the upper half of a binary32), 2 bytes each, binary
+  // payloads only.
+  SERIALIZER_ELEMENT_BFLOAT16 = 5,
+  // The long double formats recorded in payload headers, never passed in the
+  // options: x87 80-bit extended precision in a zero-padded slot, IEEE 754
+  // binary128 and IBM double-double. Hosts whose long double is a binary64
+  // record SERIALIZER_ELEMENT_FLOAT64.
+  SERIALIZER_ELEMENT_EXTENDED80 = 6,
+  SERIALIZER_ELEMENT_BINARY128 = 7,
+  SERIALIZER_ELEMENT_DOUBLE_DOUBLE = 8,
+};
+
+/**
+ * The byte orders recorded in a binary payload.
+ */
+enum serializer_endianness {
+  SERIALIZER_LITTLE_ENDIAN = 1,
+  SERIALIZER_BIG_ENDIAN = 2,
+};
+
+/**
+ * The flags recorded in a binary payload.
+ */
+enum serializer_binary_flag {
+  // The matrix is stored in compressed sparse row form instead of row-major.
+  SERIALIZER_BINARY_FLAG_SPARSE = 1,
+  // The dense matrix elements are stored column after column.
+  SERIALIZER_BINARY_FLAG_COLUMN_MAJOR = 2,
+  // The element block opens with the tensor shape, set on tensors only.
+  SERIALIZER_BINARY_FLAG_SHAPE = 4,
+};
+
+/**
+ * Decoded binary payload header.
+ *
+ * The header is laid out as: magic (4 bytes), version (2), kind (1), element
+ * type (1), endianness (1), flags (1), element size (2), rows (4), columns (4),
+ * CRC32 of the element block (4) and element block length (8). Multi-byte
+ * fields use the byte order given by the endianness field. Vectors are stored
+ * as a single row. Dense matrices are stored row after row, or column after
+ * column with SERIALIZER_BINARY_FLAG_COLUMN_MAJOR.
+ *
+ * With SERIALIZER_BINARY_FLAG_SPARSE the element block holds rows + 1 uint64
+ * row offsets, then one uint32 column index per stored element, then the
+ * stored elements; the first two blocks are zero-padded to a multiple of
+ * sizeof(long double) bytes.
+ *
+ * Tensors set SERIALIZER_BINARY_FLAG_SHAPE: the element block opens with the
+ * uint32 rank and the uint32 extents, zero-padded to a multiple of
+ * sizeof(long double) bytes, followed by the elements in row-major order. The
+ * columns field holds the last extent and the rows field the product of the
+ * others.
+ *
+ * Long double elements are recorded with the code of the host long double
+ * format and read back as SERIALIZER_ELEMENT_LONG_DOUBLE only on hosts using
+ * the same format, so a payload never decodes across incompatible formats of
+ * the same size.
+ *
+ * Elements narrower than long double are rounded on encode and widened back on
+ * decode, see serializer_element_round(). Memory-mapped views, indexed bundle
+ * views and compressed payloads only hold long double elements.
+ */
+struct serializer_binary_header {
+  uint16_t version;
+  uint8_t kind;
+  uint8_t element_type;
+  uint8_t endianness;
+  uint8_t flags;
+  uint16_t element_size;
+  uint32_t rows;
+  uint32_t columns;
+  uint32_t checksum;
+  uint64_t payload_length;
+};
+
+/**
+ * Computes the CRC32 (IEEE 802.3) checksum of the given bytes.
+ *
+ * @param uint32_t crc
+ *   The checksum of the previous bytes, or 0 to start a new checksum.
+ * @param const void *data
+ *   Pointer to the bytes to checksum.
+ * @param size_t length
+ *   Number of bytes to checksum.
+ *
+ * @return uint32_t
+ *   Returns the updated checksum.
+ */
+uint32_t serializer_crc32(uint32_t crc, const void *data, size_t length);
+
+/**
+ * Reads and validates the header of a binary payload.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   Number of bytes available at data.
+ * @param struct serializer_binary_header *header
+ *   Pointer receiving the decoded header.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the header is invalid or does not
+ *   fit the given length.
+ */
+int serializer_binary_read_header(const unsigned char *data, size_t length, struct serializer_binary_header *header);
+
+/**
+ * Generates a compact binary representation of the given Vector object.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+unsigned char *vector_serialize_binary(struct vector *object, size_t *length);
+
+/**
+ * Generates a binary representation of the given Vector object using the given options.
+ *
+ * The serializer_options.element_type selects the stored element type, the
+ * other options are ignored.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+unsigned char *vector_serialize_binary_with_options(struct vector *object, const struct serializer_options *options, size_t *length);
+
+/**
+ * Creates a Vector object from the given binary payload.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   Number of bytes available at data.
+ *
+ * @return struct vector*
+ *   The unserialized Vector object is returned, otherwise NULL.
+ */
+struct vector *vector_unserialize_binary(const unsigned char *data, size_t length);
+
+/**
+ * Generates a compact binary representation of the given Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+unsigned char *matrix_serialize_binary(struct matrix *object, size_t *length);
+
+/**
+ * Generates a binary representation of the given Matrix object using the given options.
+ *
+ * The serializer_options.sparse mode selects between the dense form and the
+ * SERIALIZER_BINARY_FLAG_SPARSE form, serializer_options.layout selects the
+ * order of the dense elements and serializer_options.element_type selects the
+ * stored element type, the other options are ignored.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+unsigned char *matrix_serialize_binary_with_options(struct matrix *object, const struct serializer_options *options, size_t *length);
+
+/**
+ * Creates a Matrix object from the given binary payload.
+ *
+ * Both the dense and the sparse forms are accepted, with any element type and
+ * either element order.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   Number of bytes available at data.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+struct matrix *matrix_unserialize_binary(const unsigned char *data, size_t length);
+
+#endif // BINARY_SERIALIZER_H
+
+#ifndef MATRIX_MAPPING_H
+#define MATRIX_MAPPING_H
+
+/**
+ * Read-only view over row-major long double matrix storage.
+ *
+ * The view does not own a struct matrix, its values point straight into memory
+ * owned by someone else, for example a memory-mapped binary file.
+ */
+struct matrix_view {
+  // The number of rows.
+  int rows;
+  // The number of columns.
+  int columns;
+  // Pointer to the first element, rows * columns elements in row-major order.
+  const long double *values;
+  // The mapping backing the view, or NULL if the view does not own a mapping.
+  void *mapping;
+  // The length in bytes of the mapping.
+  size_t mapping_length;
+};
+
+/**
+ * Writes the binary representation of a Matrix object to a file.
+ *
+ * @param const char *path
+ *   Path of the file to write.
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_write_binary_file(const char *path, struct matrix *object);
+
+/**
+ * Memory-maps a binary matrix file and returns a read-only view over it.
+ *
+ * Only the header is validated, so the cost does not depend on the matrix
+ * size; use matrix_view_verify() to check the element block checksum. The
+ * mapping is shared, several processes mapping the same file share its pages.
+ * Sparse payloads have no row-major element block and are rejected.
+ *
+ * @param const char *path
+ *   Path of the binary matrix file.
+ *
+ * @return struct matrix_view*
+ *   Returns the matrix view, or NULL if the file could not be mapped.
+ */
+struct matrix_view *matrix_map_file(const char *path);
+
+/**
+ * Unmaps a matrix view returned by matrix_map_file() and frees it.
+ *
+ * @param struct matrix_view *view
+ *   The matrix view to destroy.
+ */
+void matrix_unmap(struct matrix_view *view);
+
+/**
+ * Gets a pointer to an element of a matrix view.
+ *
+ * @param const struct matrix_view *view
+ *   The matrix view.
+ * @param int row
+ *   The row index.
+ * @param int column
+ *   The column index.
+ *
+ * @return const long double*
+ *   Returns the element pointer, or NULL if the indexes are out of range.
+ */
+const long double *matrix_view_getl(const struct matrix_view *view, int row, int column);
+
+/**
+ * Verifies the element block checksum of a mapped matrix view.
+ *
+ * This touches every page of the mapping.
+ *
+ * @param const struct matrix_view *view
+ *   The matrix view.
+ *
+ * @return int
+ *   Returns 0 if the checksum matches, otherwise 1.
+ */
+int matrix_view_verify(const struct matrix_view *view);
+
+/**
+ * Copies a matrix view into a new Matrix object.
+ *
+ * @param const struct matrix_view *view
+ *   The matrix view.
+ *
+ * @return struct matrix*
+ *   Returns the new Matrix object, or NULL if an error occurred.
+ */
+struct matrix *matrix_view_to_matrix(const struct matrix_view *view);
+
+#endif // MATRIX_MAPPING_H
+
+#ifndef PARALLEL_SERIALIZER_H
+#define PARALLEL_SERIALIZER_H
+
+/**
+ * Generates a string representation of the given Matrix object using several threads.
+ *
+ * The rows are split into contiguous chunks, each chunk is formatted into its
+ * own buffer on its own thread and the buffers are stitched together in order,
+ * so the output is identical to matrix_serialize_with_options(). Matrices with
+ * fewer elements than options->parallel_threshold are encoded serially.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param int threads
+ *   The number of threads to use.
+ *
+ * @return char*
+ *   Returns a string containing a representation of the Matrix object.
+ */
+char *matrix_serialize_parallel(struct matrix *object, const struct serializer_options *options, int threads);
+
+/**
+ * Creates a Matrix object from the given serialized data string using several threads.
+ *
+ * A structural pre-scan finds the row boundaries, the matrix is allocated once
+ * and worker threads parse disjoint row ranges straight into its storage. The
+ * result, or the failure, is the same as matrix_unserialize(). Inputs with
+ * fewer elements than options->parallel_threshold are decoded serially.
+ *
+ * @param const char *data
+ *   The serialized string.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param int threads
+ *   The number of threads to use.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+struct matrix *matrix_unserialize_parallel(const char *data, const struct serializer_options *options, int threads);
+
+#endif // PARALLEL_SERIALIZER_H
+
+#ifndef MATRIX_STREAM_H
+#define MATRIX_STREAM_H
+
+/**
+ * Row callback used by the streaming matrix reader.
+ *
+ * @param const long double *row
+ *   Pointer to the row values, only valid during the call.
+ * @param int columns
+ *   The number of values in the row.
+ * @param void *context
+ *   The caller-supplied context pointer.
+ *
+ * @return int
+ *   Returns 0 to continue reading, otherwise 1 to abort.
+ */
+typedef int (*matrix_row_callback)(const long double *row, int columns, void *context);
+
+/**
+ * Incremental matrix writer, emits the serialized matrix one row at a time.
+ */
+struct matrix_writer {
+  // Staging buffer attached to the output sink.
+  struct serializer_buffer buffer;
+  // The serializer options.
+  struct serializer_options options;
+  // The number of rows written so far.
+  int rows;
+  // The width of the rows, fixed by the first row.
+  int columns;
+  // Sticky error flag, set once a row fails after its output has started.
+  int error;
+};
+
+/**
+ * Incremental matrix reader, parses serialized matrices arriving in fragments.
+ */
+struct matrix_reader {
+  // The parser state.
+  int state;
+  // Sticky error flag.
+  int error;
+  // The row callback.
+  matrix_row_callback callback;
+  // Context pointer passed to the callback.
+  void *context;
+  // The number of rows read so far.
+  int rows;
+  // The width of the rows, fixed by the first row.
+  int columns;
+  // Values of the row being read.
+  long double *row;
+  // Number of values in the row being read.
+  int row_length;
+  // Allocated capacity of the row buffer.
+  int row_capacity;
+  // The value token being read, tokens may span several fragments.
+  char *token;
+  // Length of the value token being read.
+  int token_length;
+  // Allocated capacity of the token buffer, it grows to the longest token.
+  int token_capacity;
+  // Whether the value token being read is quoted.
+  int quoted;
+  // The number of bytes consumed so far.
+  size_t offset;
+};
+
+/**
+ * Starts writing a serialized matrix into a sink.
+ *
+ * @param serializer_sink sink
+ *   The sink receiving the serialized data.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return struct matrix_writer*
+ *   Returns the matrix writer, or NULL if an error occurred.
+ */
+struct matrix_writer *matrix_writer_begin(serializer_sink sink, void *context, const struct serializer_options *options);
+
+/**
+ * Writes one row of the matrix.
+ *
+ * A row rejected by the input checks writes nothing and the writer remains
+ * usable. Any other failure may leave part of the row in the sink, so it is
+ * sticky: every later push and matrix_writer_end() fail, and the output must
+ * be discarded.
+ *
+ * @param struct matrix_writer *writer
+ *   The matrix writer.
+ * @param const long double *row
+ *   Pointer to the row values.
+ * @param int columns
+ *   The number of values in the row, which must be the same for every row.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_writer_push_row(struct matrix_writer *writer, const long double *row, int columns);
+
+/**
+ * Finishes the serialized matrix, flushes it into the sink and frees the writer.
+ *
+ * @param struct matrix_writer *writer
+ *   The matrix writer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred, a previous row
+ *   failed or no row was written.
+ */
+int matrix_writer_end(struct matrix_writer *writer);
+
+/**
+ * Creates an incremental matrix reader.
+ *
+ * Memory use is bounded by one row and the longest value token, whatever the
+ * size of the matrix. Value tokens of any length are accepted, as by
+ * matrix_unserialize().
+ *
+ * @param matrix_row_callback callback
+ *   The callback receiving every non-empty row.
+ * @param void *context
+ *   Context pointer passed to the callback.
+ *
+ * @return struct matrix_reader*
+ *   Returns the matrix reader, or NULL if an error occurred.
+ */
+struct matrix_reader *matrix_reader_create(matrix_row_callback callback, void *context);
+
+/**
+ * Feeds a fragment of serialized data to the reader.
+ *
+ * Fragments may be split at any byte, including inside a value token of any
+ * length, rows are reported as soon as they are complete.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ * @param const char *data
+ *   Pointer to the fragment.
+ * @param size_t length
+ *   Number of bytes in the fragment.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the data is malformed or the
+ *   callback aborted.
+ */
+int matrix_reader_feed(struct matrix_reader *reader, const char *data, size_t length);
+
+/**
+ * Checks that the reader received a complete serialized matrix.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the data is incomplete or malformed.
+ */
+int matrix_reader_finish(struct matrix_reader *reader);
+
+/**
+ * Frees an incremental matrix reader.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ */
+void matrix_reader_destroy(struct matrix_reader *reader);
+
+/**
+ * Reads a serialized matrix from a file one row at a time.
+ *
+ * @param FILE *file
+ *   The file to read from.
+ * @param matrix_row_callback callback
+ *   The callback receiving every non-empty row.
+ * @param void *context
+ *   Context pointer passed to the callback.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_reader_read_file(FILE *file, matrix_row_callback callback, void *context);
+
+/**
+ * Reads a serialized matrix from a file descriptor one row at a time.
+ *
+ * @param int fd
+ *   The file descriptor to read from.
+ * @param matrix_row_callback callback
+ *   The callback receiving every non-empty row.
+ * @param void *context
+ *   Context pointer passed to the callback.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_reader_read_fd(int fd, matrix_row_callback callback, void *context);
+
+#endif // MATRIX_STREAM_H
+
+#ifndef ARENA_SERIALIZER_H
+#define ARENA_SERIALIZER_H
+
+/**
+ * Generates a string representation of a Vector object in arena memory.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_arena *arena
+ *   The arena providing all the memory, the string stays valid until the arena
+ *   is reset or destroyed and must not be freed.
+ * @param size_t *length
+ *   Optional pointer receiving the string length.
+ *
+ * @return char*
+ *   Returns the string, or NULL if an error occurred.
+ */
+char *vector_serialize_arena(struct vector *object, const struct serializer_options *options, struct serializer_arena *arena, size_t *length);
+
+/**
+ * Generates a string representation of a Matrix object in arena memory.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_arena *arena
+ *   The arena providing all the memory, the string stays valid until the arena
+ *   is reset or destroyed and must not be freed.
+ * @param size_t *length
+ *   Optional pointer receiving the string length.
+ *
+ * @return char*
+ *   Returns the string, or NULL if an error occurred.
+ */
+char *matrix_serialize_arena(struct matrix *object, const struct serializer_options *options, struct serializer_arena *arena, size_t *length);
+
+/**
+ * Parses a vector string into a block of values in arena memory.
+ *
+ * @param const char *data
+ *   The serialized vector string.
+ * @param struct serializer_arena *arena
+ *   The arena providing all the memory, the values stay valid until the arena
+ *   is reset or destroyed and must not be freed.
+ * @param int *capacity
+ *   Pointer receiving the number of elements.
+ *
+ * @return long double*
+ *   Returns the values, or NULL if an error occurred.
+ */
+long double *vector_unserialize_arena(const char *data, struct serializer_arena *arena, int *capacity);
+
+/**
+ * Parses a matrix string into a read-only view in arena memory.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param struct serializer_arena *arena
+ *   The arena providing all the memory, the view and its values stay valid
+ *   until the arena is reset or destroyed; do not pass it to matrix_unmap().
+ *
+ * @return struct matrix_view*
+ *   Returns the matrix view, or NULL if an error occurred.
+ */
+struct matrix_view *matrix_unserialize_arena(const char *data, struct serializer_arena *arena);
+
+#endif // ARENA_SERIALIZER_H
+
+#ifndef SERIALIZER_CONTEXT_H
+#define SERIALIZER_CONTEXT_H
+
+/**
+ * Reusable serializer context.
+ *
+ * The context retains its output buffer and decode scratch space across calls,
+ * so once it has grown to the largest object it handles, or has been sized up
+ * front with matrixmath_serializer_ctx_reserve(), serializing and decoding
+ * allocate nothing. A context must not be shared between threads.
+ */
+struct matrixmath_serializer_ctx {
+  // The options used by every call.
+  struct serializer_options options;
+  // The retained output buffer.
+  struct serializer_buffer buffer;
+  // The retained decode scratch space.
+  long double *scratch;
+  // The number of values the scratch space holds.
+  size_t scratch_capacity;
+  // The view returned by the matrix decoder.
+  struct matrix_view view;
+};
+
+/**
+ * Creates a reusable serializer context.
+ *
+ * @param const struct serializer_options *options
+ *   The serializer options, copied into the context, or NULL to use the
+ *   defaults.
+ *
+ * @return struct matrixmath_serializer_ctx*
+ *   Returns the context, or NULL if an error occurred.
+ */
+struct matrixmath_serializer_ctx *matrixmath_serializer_ctx_create(const struct serializer_options *options);
+
+/**
+ * Preallocates the context for objects up to the given shape.
+ *
+ * With SERIALIZER_PRECISION_LEGACY only the scratch space is preallocated, the
+ * text buffer grows on first use as the legacy text has no fixed bound.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ * @param int rows
+ *   The maximum number of rows, 1 for vectors.
+ * @param int columns
+ *   The maximum number of columns, or vector elements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrixmath_serializer_ctx_reserve(struct matrixmath_serializer_ctx *ctx, int rows, int columns);
+
+/**
+ * Frees a serializer context and its retained memory.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ */
+void matrixmath_serializer_ctx_destroy(struct matrixmath_serializer_ctx *ctx);
+
+/**
+ * Serializes a Vector object into the retained context buffer.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param size_t *length
+ *   Optional pointer receiving the string length.
+ *
+ * @return const char*
+ *   Returns the NUL-terminated string, owned by the context and valid until the
+ *   next call on it, or NULL if an error occurred.
+ */
+const char *vector_serialize_ctx(struct matrixmath_serializer_ctx *ctx, struct vector *object, size_t *length);
+
+/**
+ * Serializes a Matrix object into the retained context buffer.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param size_t *length
+ *   Optional pointer receiving the string length.
+ *
+ * @return const char*
+ *   Returns the NUL-terminated string, owned by the context and valid until the
+ *   next call on it, or NULL if an error occurred.
+ */
+const char *matrix_serialize_ctx(struct matrixmath_serializer_ctx *ctx, struct matrix *object, size_t *length);
+
+/**
+ * Parses a vector string into the retained context scratch space.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ * @param const char *data
+ *   The serialized vector string.
+ * @param int *capacity
+ *   Pointer receiving the number of elements.
+ *
+ * @return const long double*
+ *   Returns the values, owned by the context and valid until the next call on
+ *   it, or NULL if an error occurred.
+ */
+const long double *vector_unserialize_ctx(struct matrixmath_serializer_ctx *ctx, const char *data, int *capacity);
+
+/**
+ * Parses a matrix string into the retained context scratch space.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ * @param const char *data
+ *   The serialized matrix string.
+ *
+ * @return const struct matrix_view*
+ *   Returns a view owned by the context and valid until the next call on it,
+ *   or NULL if an error occurred.
+ */
+const struct matrix_view *matrix_unserialize_ctx(struct matrixmath_serializer_ctx *ctx, const char *data);
+
+#endif // SERIALIZER_CONTEXT_H
+
+#ifndef MATRIX_DELTA_H
+#define MATRIX_DELTA_H
+
+/**
+ * Computes the version tag of a Matrix object.
+ *
+ * The tag is the CRC32 of the elements as stored by matrix_serialize_binary(),
+ * so it equals the checksum recorded in the header of a dense binary payload.
+ *
+ * @param struct matrix *object
+ *   The Matrix object.
+ *
+ * @return uint32_t
+ *   Returns the version tag, or 0 if the matrix is invalid.
+ */
+uint32_t matrix_checksum(struct matrix *object);
+
+/**
+ * Streams the changes between two snapshots of a matrix into a buffer.
+ *
+ * Elements are compared bit for bit, so changes of sign of zero and of NaN
+ * payloads are kept. Consecutive changed elements, in row-major order, are
+ * grouped into runs that may span several rows, so updated row ranges cost a
+ * single entry. The output has the form
+ * {"format":"delta","rows":R,"columns":C,"base":B,"version":V,
+ * "changes":[[row,column,["value",...]],...]}, where base and version are the
+ * matrix_checksum() tags of the previous and current snapshots.
+ *
+ * @param struct matrix *previous
+ *   The snapshot the receiver already holds.
+ * @param struct matrix *current
+ *   The new snapshot, with the same shape.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer receiving the serialized data.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_serialize_delta_to_stream(struct matrix *previous, struct matrix *current, const struct serializer_options *options, struct serializer_buffer *buffer);
+
+/**
+ * Generates the changes between two snapshots of a matrix.
+ *
+ * See matrix_serialize_delta_to_stream() for the output format.
+ *
+ * @param struct matrix *previous
+ *   The snapshot the receiver already holds.
+ * @param struct matrix *current
+ *   The new snapshot, with the same shape.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return char*
+ *   Returns the delta string, or NULL if an error occurred.
+ */
+char *matrix_serialize_delta(struct matrix *previous, struct matrix *current, const struct serializer_options *options);
+
+/**
+ * Patches a matrix in place with a delta string.
+ *
+ * The whole delta is validated before the first element is written, so a
+ * rejected delta leaves the destination untouched. The cost only depends on
+ * the number of changed elements.
+ *
+ * @param struct matrix *destination
+ *   The matrix to patch, with the shape recorded in the delta.
+ * @param const char *data
+ *   The delta string.
+ * @param uint32_t *version
+ *   Optional pointer to the version tag of the destination. The delta is
+ *   rejected unless its base tag matches, and on success the tag is updated to
+ *   the delta version. Use matrix_checksum() to obtain the initial tag.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_apply_delta(struct matrix *destination, const char *data, uint32_t *version);
+
+#endif // MATRIX_DELTA_H
+
+#ifndef SERIALIZER_COMPRESSION_H
+#define SERIALIZER_COMPRESSION_H
+
+/**
+ * The magic bytes opening every compressed frame.
+ */
+#define SERIALIZER_COMPRESSED_MAGIC "MMSZ"
+
+/**
+ * The current compressed frame version.
+ */
+#define SERIALIZER_COMPRESSED_VERSION 1
+
+/**
+ * The size in bytes of the compressed frame header.
+ */
+#define SERIALIZER_COMPRESSED_HEADER_SIZE 24
+
+/**
+ * The size in bytes of the header of every compressed block.
+ */
+#define SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE 12
+
+/**
+ * The plaintext size of the blocks written by the compressor.
+ */
+#define SERIALIZER_COMPRESSION_BLOCK_SIZE 65536
+
+/**
+ * The largest plaintext block size accepted by the decompressor.
+ */
+#define SERIALIZER_COMPRESSION_MAX_BLOCK_SIZE 16777216
+
+/**
+ * The most plaintext bytes a compressed byte can expand to, every length
+ * extension byte of 255 stands for 255 bytes of a match.
+ */
+#define SERIALIZER_COMPRESSION_MAX_EXPANSION 255
+
+/**
+ * The kinds of plaintext stored in a compressed frame.
+ */
+enum serializer_compressed_content {
+  // Arbitrary bytes.
+  SERIALIZER_CONTENT_BYTES = 0,
+  // A dense matrix string, the frame records its shape.
+  SERIALIZER_CONTENT_MATRIX_TEXT = 1,
+  // A dense binary matrix payload, the frame records its shape.
+  SERIALIZER_CONTENT_MATRIX_BINARY = 2,
+};
+
+/**
+ * Reversible filters applied to fixed-size elements before compression.
+ */
+enum serializer_compression_filter {
+  SERIALIZER_FILTER_NONE = 0,
+  // Every element is XORed with the previous one, so the sign, exponent and
+  // leading mantissa bytes of similar numbers become zeros.
+  SERIALIZER_FILTER_DELTA = 1,
+  // Byte k of every element is grouped together, turning the bytes that
+  // change slowly across elements into long runs.
+  SERIALIZER_FILTER_SHUFFLE = 2,
+};
+
+/**
+ * Decoded compressed frame header.
+ *
+ * The header is laid out as: magic (4 bytes), version (1), content (1), filter
+ * (1), reserved (1), element size (2), reserved (2), block size (4), rows (4)
+ * and columns (4). It is followed by blocks made of the stored length (4), with
+ * the high bit set when the block is stored uncompressed, the plaintext length
+ * (4), the CRC32 of the plaintext (4) and the stored bytes. A block with a
+ * plaintext length of zero ends the frame. Multi-byte fields are little-endian.
+ */
+struct serializer_compressed_header {
+  uint8_t version;
+  uint8_t content;
+  uint8_t filter;
+  uint16_t element_size;
+  uint32_t block_size;
+  uint32_t rows;
+  uint32_t columns;
+};
+
+/**
+ * Streaming compressor, fed through serializer_compressor_write().
+ *
+ * Plaintext is collected into blocks of SERIALIZER_COMPRESSION_BLOCK_SIZE bytes,
+ * each compressed independently with a byte-oriented LZ77 codec and handed to
+ * the sink as soon as it is full, so memory use does not depend on the size of
+ * the plaintext.
+ */
+struct serializer_compressor {
+  // The sink receiving the compressed frame.
+  serializer_sink sink;
+  // Context pointer passed to the sink.
+  void *context;
+  // The serializer_compression_filter values applied to each block.
+  int filter;
+  // The element size used by the filters.
+  size_t element_size;
+  // The plaintext block being collected.
+  unsigned char *block;
+  // The number of bytes in the plaintext block.
+  size_t length;
+  // The filtered block.
+  unsigned char *scratch;
+  // The block header followed by the compressed block.
+  unsigned char *output;
+  // Hash table of the LZ77 match finder.
+  uint32_t *table;
+  // Sticky error flag.
+  int error;
+};
+
+/**
+ * Reads and validates the header of a compressed frame.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the compressed frame.
+ * @param size_t length
+ *   Number of bytes available at data.
+ * @param struct serializer_compressed_header *header
+ *   Pointer receiving the decoded header.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the header is invalid.
+ */
+int serializer_compressed_read_header(const unsigned char *data, size_t length, struct serializer_compressed_header *header);
+
+/**
+ * Starts a compressed frame of arbitrary bytes.
+ *
+ * The frame header is written to the sink right away.
+ *
+ * @param serializer_sink sink
+ *   The sink receiving the compressed frame.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ * @param int filter
+ *   The serializer_compression_filter values to apply.
+ * @param size_t element_size
+ *   The element size used by the filters, between 1 and 65535.
+ *
+ * @return struct serializer_compressor*
+ *   Returns the compressor, or NULL if an error occurred.
+ */
+struct serializer_compressor *serializer_compressor_create(serializer_sink sink, void *context, int filter, size_t element_size);
+
+/**
+ * Appends plaintext to a compressed frame.
+ *
+ * The signature matches serializer_sink, so a compressor can be passed as the
+ * sink of any streaming encoder.
+ *
+ * @param const char *data
+ *   The plaintext.
+ * @param size_t length
+ *   Number of bytes of plaintext.
+ * @param void *compressor
+ *   The struct serializer_compressor.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_compressor_write(const char *data, size_t length, void *compressor);
+
+/**
+ * Writes the last block and the end of the frame, then frees the compressor.
+ *
+ * @param struct serializer_compressor *compressor
+ *   The compressor.
+ *
+ * @return int
+ *   Returns 0 if the whole frame was written, otherwise 1.
+ */
+int serializer_compressor_finish(struct serializer_compressor *compressor);
+
+/**
+ * Decompresses a frame one block at a time into a sink.
+ *
+ * Only one plaintext block is held in memory, every block is checked against
+ * its checksum before it is handed to the sink.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the compressed frame.
+ * @param size_t length
+ *   Number of bytes of the compressed frame.
+ * @param serializer_sink sink
+ *   The sink receiving the plaintext.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the frame is invalid or the sink
+ *   failed.
+ */
+int serializer_decompress(const unsigned char *data, size_t length, serializer_sink sink, void *context);
+
+#endif // SERIALIZER_COMPRESSION_H
+
+#ifndef COMPRESSED_SERIALIZER_H
+#define COMPRESSED_SERIALIZER_H
+
+/**
+ * Streams the compressed string representation of a Matrix object into a sink.
+ *
+ * The dense form is always used, whatever serializer_options.sparse says, so
+ * the frame can be decoded row by row.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param serializer_sink sink
+ *   The sink receiving the compressed frame.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_serialize_compressed_to_sink(struct matrix *object, const struct serializer_options *options, serializer_sink sink, void *context);
+
+/**
+ * Generates the compressed string representation of a Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param size_t *length
+ *   Pointer receiving the frame length.
+ *
+ * @return unsigned char*
+ *   Returns the compressed frame, or NULL if an error occurred.
+ */
+unsigned char *matrix_serialize_compressed(struct matrix *object, const struct serializer_options *options, size_t *length);
+
+/**
+ * Generates the compressed binary representation of a Matrix object.
+ *
+ * The dense binary payload is streamed through the delta and shuffle filters,
+ * it is never built in memory.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param size_t *length
+ *   Pointer receiving the frame length.
+ *
+ * @return unsigned char*
+ *   Returns the compressed frame, or NULL if an error occurred.
+ */
+unsigned char *matrix_serialize_binary_compressed(struct matrix *object, size_t *length);
+
+/**
+ * Creates a Matrix object from a compressed frame.
+ *
+ * Both compressed strings and compressed binary payloads are accepted. Each
+ * block is decompressed straight into the parser, the plaintext is never held
+ * in memory as a whole.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the compressed frame.
+ * @param size_t length
+ *   Number of bytes of the compressed frame.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+struct matrix *matrix_unserialize_compressed(const unsigned char *data, size_t length);
+
+#endif // COMPRESSED_SERIALIZER_H
+
+#ifndef BATCH_SERIALIZER_H
+#define BATCH_SERIALIZER_H
+
+/**
+ * The magic bytes opening every binary bundle.
+ */
+#define SERIALIZER_BUNDLE_MAGIC "MMBN"
+
+/**
+ * The current binary bundle version.
+ */
+#define SERIALIZER_BUNDLE_VERSION 1
+
+/**
+ * The size in bytes of the binary bundle header, the index starts right after it.
+ */
+#define SERIALIZER_BUNDLE_HEADER_SIZE 32
+
+/**
+ * The size in bytes of every binary bundle index entry.
+ */
+#define SERIALIZER_BUNDLE_ENTRY_SIZE 32
+
+/**
+ * The flags recorded in a binary bundle.
+ */
+enum serializer_bundle_flag {
+  // The index lists the entries in bytewise key order and keys are unique.
+  SERIALIZER_BUNDLE_FLAG_SORTED = 1,
+};
+
+/**
+ * Decoded binary bundle header.
+ *
+ * The header is laid out as: magic (4 bytes), version (2), kind (1),
+ * endianness (1), flags (1), reserved (3), number of entries (4), CRC32 of the
+ * index and key block (4), key block length (4) and total bundle length (8).
+ * It is followed by the index, one entry per object, then the key block holding
+ * the NUL-terminated keys, zero-padded to a multiple of sizeof(long double),
+ * then the objects, each stored as a complete binary payload. Multi-byte fields
+ * use the byte order given by the endianness field.
+ */
+struct serializer_bundle_header {
+  uint16_t version;
+  uint8_t kind;
+  uint8_t endianness;
+  uint8_t flags;
+  uint32_t count;
+  uint32_t checksum;
+  uint32_t keys_length;
+  uint64_t length;
+};
+
+/**
+ * Decoded binary bundle index entry.
+ *
+ * The entry is laid out as: key offset (8 bytes), key length (4), reserved (4),
+ * payload offset (8) and payload length (8). Offsets count from the start of
+ * the bundle.
+ */
+struct serializer_bundle_entry {
+  uint64_t key_offset;
+  uint32_t key_length;
+  uint64_t payload_offset;
+  uint64_t payload_length;
+};
+
+/**
+ * A decoded batch of named vectors.
+ */
+struct vector_batch {
+  // The number of entries.
+  int count;
+  // The NUL-terminated keys, in document or index order.
+  char **keys;
+  // The vectors, in the same order as the keys.
+  struct vector **objects;
+};
+
+/**
+ * A decoded batch of named matrices.
+ */
+struct matrix_batch {
+  // The number of entries.
+  int count;
+  // The NUL-terminated keys, in document or index order.
+  char **keys;
+  // The matrices, in the same order as the keys.
+  struct matrix **objects;
+};
+
+/**
+ * Writes named vectors as a single JSON object, one member per vector.
+ *
+ * Keys must not contain quotes, backslashes or control characters, so they
+ * never need escaping.
+ *
+ * @param const char **keys
+ *   The member names.
+ * @param struct vector **objects
+ *   The vectors, one per key.
+ * @param int count
+ *   The number of vectors.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer shared by every vector.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int vector_serialize_batch_to_stream(const char **keys, struct vector **objects, int count, const struct serializer_options *options, struct serializer_buffer *buffer);
+
+/**
+ * Generates a single JSON object holding named vectors.
+ *
+ * @param const char **keys
+ *   The member names.
+ * @param struct vector **objects
+ *   The vectors, one per key.
+ * @param int count
+ *   The number of vectors.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return char*
+ *   Returns the JSON string, or NULL if an error occurred.
+ */
+char *vector_serialize_batch(const char **keys, struct vector **objects, int count, const struct serializer_options *options);
+
+/**
+ * Decodes every member of a JSON object of vectors.
+ *
+ * @param const char *data
+ *   The serialized batch.
+ *
+ * @return struct vector_batch*
+ *   Returns the batch, to be freed with vector_batch_destroy(), or NULL if the
+ *   text is malformed.
+ */
+struct vector_batch *vector_unserialize_batch(const char *data);
+
+/**
+ * Frees a batch of vectors, including its keys and vectors.
+ *
+ * @param struct vector_batch *batch
+ *   The batch to free.
+ */
+void vector_batch_destroy(struct vector_batch *batch);
+
+/**
+ * Writes named matrices as a single JSON object, one member per matrix.
+ *
+ * Matrices are always written in the dense form. Keys must not contain quotes,
+ * backslashes or control characters.
+ *
+ * @param const char **keys
+ *   The member names.
+ * @param struct matrix **objects
+ *   The matrices, one per key.
+ * @param int count
+ *   The number of matrices.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer shared by every matrix.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_serialize_batch_to_stream(const char **keys, struct matrix **objects, int count, const struct serializer_options *options, struct serializer_buffer *buffer);
+
+/**
+ * Generates a single JSON object holding named matrices.
+ *
+ * @param const char **keys
+ *   The member names.
+ * @param struct matrix **objects
+ *   The matrices, one per key.
+ * @param int count
+ *   The number of matrices.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return char*
+ *   Returns the JSON string, or NULL if an error occurred.
+ */
+char *matrix_serialize_batch(const char **keys, struct matrix **objects, int count, const struct serializer_options *options);
+
+/**
+ * Decodes every member of a JSON object of dense matrices.
+ *
+ * @param const char *data
+ *   The serialized batch.
+ *
+ * @return struct matrix_batch*
+ *   Returns the batch, to be freed with matrix_batch_destroy(), or NULL if the
+ *   text is malformed.
+ */
+struct matrix_batch *matrix_unserialize_batch(const char *data);
+
+/**
+ * Frees a batch of matrices, including its keys and matrices.
+ *
+ * @param struct matrix_batch *batch
+ *   The batch to free.
+ */
+void matrix_batch_destroy(struct matrix_batch *batch);
+
+/**
+ * Reads and validates the header and index checksum of a binary bundle.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary bundle.
+ * @param size_t length
+ *   Number of bytes available at data.
+ * @param struct serializer_bundle_header *header
+ *   Pointer receiving the decoded header.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the bundle is invalid.
+ */
+int serializer_bundle_read_header(const unsigned char *data, size_t length, struct serializer_bundle_header *header);
+
+/**
+ * Reads and validates one index entry of a binary bundle.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary bundle.
+ * @param const struct serializer_bundle_header *header
+ *   The header returned by serializer_bundle_read_header().
+ * @param uint32_t index
+ *   The entry index.
+ * @param struct serializer_bundle_entry *entry
+ *   Pointer receiving the decoded entry.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the entry is invalid.
+ */
+int serializer_bundle_read_entry(const unsigned char *data, const struct serializer_bundle_header *header, uint32_t index, struct serializer_bundle_entry *entry);
+
+/**
+ * Generates a binary bundle of named vectors with an offset index.
+ *
+ * @param const char **keys
+ *   The names.
+ * @param struct vector **objects
+ *   The vectors, one per key.
+ * @param int count
+ *   The number of vectors.
+ * @param size_t *length
+ *   Pointer receiving the bundle length.
+ *
+ * @return unsigned char*
+ *   Returns the binary bundle, or NULL if an error occurred.
+ */
+unsigned char *vector_serialize_batch_binary(const char **keys, struct vector **objects, int count, size_t *length);
+
+/**
+ * Decodes every vector of a binary bundle.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary bundle.
+ * @param size_t length
+ *   Number of bytes available at data.
+ *
+ * @return struct vector_batch*
+ *   Returns the batch, to be freed with vector_batch_destroy(), or NULL if the
+ *   bundle is invalid.
+ */
+struct vector_batch *vector_unserialize_batch_binary(const unsigned char *data, size_t length);
+
+/**
+ * Generates a binary bundle of named matrices with an offset index.
+ *
+ * @param const char **keys
+ *   The names.
+ * @param struct matrix **objects
+ *   The matrices, one per key.
+ * @param int count
+ *   The number of matrices.
+ * @param size_t *length
+ *   Pointer receiving the bundle length.
+ *
+ * @return unsigned char*
+ *   Returns the binary bundle, or NULL if an error occurred.
+ */
+unsigned char *matrix_serialize_batch_binary(const char **keys, struct matrix **objects, int count, size_t *length);
+
+/**
+ * Decodes every matrix of a binary bundle.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary bundle.
+ * @param size_t length
+ *   Number of bytes available at data.
+ *
+ * @return struct matrix_batch*
+ *   Returns the batch, to be freed with matrix_batch_destroy(), or NULL if the
+ *   bundle is invalid.
+ */
+struct matrix_batch *matrix_unserialize_batch_binary(const unsigned char *data, size_t length);
+
+#endif // BATCH_SERIALIZER_H
+
+#ifndef BUNDLE_INDEX_H
+#define BUNDLE_INDEX_H
+
+/**
+ * A sorted binary bundle opened for lookups by key.
+ *
+ * Opening reads the header and checks the index checksum only; objects are
+ * decoded one at a time, on request.
+ */
+struct serializer_bundle {
+  // Pointer to the bundle.
+  const unsigned char *data;
+  // The bundle length.
+  size_t length;
+  // The decoded header.
+  struct serializer_bundle_header header;
+  // The mapping backing the bundle, or NULL if the memory belongs to the caller.
+  void *mapping;
+  // The length in bytes of the mapping.
+  size_t mapping_length;
+};
+
+/**
+ * Generates a binary bundle of named vectors with a sorted key index.
+ *
+ * @param const char **keys
+ *   The names, which must be unique.
+ * @param struct vector **objects
+ *   The vectors, one per key.
+ * @param int count
+ *   The number of vectors.
+ * @param size_t *length
+ *   Pointer receiving the bundle length.
+ *
+ * @return unsigned char*
+ *   Returns the binary bundle, or NULL if an error occurred.
+ */
+unsigned char *vector_serialize_indexed(const char **keys, struct vector **objects, int count, size_t *length);
+
+/**
+ * Generates a binary bundle of named matrices with a sorted key index.
+ *
+ * @param const char **keys
+ *   The names, which must be unique.
+ * @param struct matrix **objects
+ *   The matrices, one per key.
+ * @param int count
+ *   The number of matrices.
+ * @param size_t *length
+ *   Pointer receiving the bundle length.
+ *
+ * @return unsigned char*
+ *   Returns the binary bundle, or NULL if an error occurred.
+ */
+unsigned char *matrix_serialize_indexed(const char **keys, struct matrix **objects, int count, size_t *length);
+
+/**
+ * Writes a binary bundle of named matrices with a sorted key index to a file.
+ *
+ * @param const char *path
+ *   Path of the file to write.
+ * @param const char **keys
+ *   The names, which must be unique.
+ * @param struct matrix **objects
+ *   The matrices, one per key.
+ * @param int count
+ *   The number of matrices.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int matrix_write_indexed_file(const char *path, const char **keys, struct matrix **objects, int count);
+
+/**
+ * Opens a sorted binary bundle held in caller memory.
+ *
+ * The memory must stay valid until the bundle is closed.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary bundle.
+ * @param size_t length
+ *   Number of bytes available at data.
+ *
+ * @return struct serializer_bundle*
+ *   Returns the opened bundle, or NULL if it is invalid or not sorted.
+ */
+struct serializer_bundle *serializer_bundle_open(const unsigned char *data, size_t length);
+
+/**
+ * Memory-maps a sorted binary bundle file and opens it.
+ *
+ * Only the header and the index are read, the objects are paged in when they
+ * are looked up. The mapping is shared between processes mapping the file.
+ *
+ * @param const char *path
+ *   Path of the bundle file.
+ *
+ * @return struct serializer_bundle*
+ *   Returns the opened bundle, or NULL if the file could not be mapped.
+ */
+struct serializer_bundle *serializer_bundle_map_file(const char *path);
+
+/**
+ * Closes a bundle, unmapping its file if it was mapped.
+ *
+ * @param struct serializer_bundle *bundle
+ *   The bundle to close.
+ */
+void serializer_bundle_close(struct serializer_bundle *bundle);
+
+/**
+ * Finds the index entry of a key by binary search.
+ *
+ * @param const struct serializer_bundle *bundle
+ *   The opened bundle.
+ * @param const char *key
+ *   The key to find.
+ * @param struct serializer_bundle_entry *entry
+ *   Pointer receiving the entry.
+ *
+ * @return int
+ *   Returns 0 if the key was found, otherwise 1.
+ */
+int serializer_bundle_find(const struct serializer_bundle *bundle, const char *key, struct serializer_bundle_entry *entry);
+
+/**
+ * Decodes the vector stored under a key.
+ *
+ * @param const struct serializer_bundle *bundle
+ *   The opened bundle, which must hold vectors.
+ * @param const char *key
+ *   The key to find.
+ *
+ * @return struct vector*
+ *   Returns the vector, or NULL if the key is missing or its payload invalid.
+ */
+struct vector *vector_bundle_get(const struct serializer_bundle *bundle, const char *key);
+
+/**
+ * Decodes the matrix stored under a key.
+ *
+ * @param const struct serializer_bundle *bundle
+ *   The opened bundle, which must hold matrices.
+ * @param const char *key
+ *   The key to find.
+ *
+ * @return struct matrix*
+ *   Returns the matrix, or NULL if the key is missing or its payload invalid.
+ */
+struct matrix *matrix_bundle_get(const struct serializer_bundle *bundle, const char *key);
+
+/**
+ * Points a view at the matrix stored under a key, without copying it.
+ *
+ * The view does not own a mapping and stays valid while the bundle is open.
+ * Only the payload header is checked, use matrix_bundle_get() to also check
+ * the element block checksum.
+ *
+ * @param const struct serializer_bundle *bundle
+ *   The opened bundle, which must hold matrices.
+ * @param const char *key
+ *   The key to find.
+ * @param struct matrix_view *view
+ *   Pointer receiving the view.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the key is missing or its payload
+ *   is not a dense matrix.
+ */
+int matrix_bundle_view(const struct serializer_bundle *bundle, const char *key, struct matrix_view *view);
+
+#endif // BUNDLE_INDEX_H
+
+#ifndef MATRIX_LAYOUT_H
+#define MATRIX_LAYOUT_H
+
+/**
+ * Creates a Matrix object from the given serialized string using the given options.
+ *
+ * With SERIALIZER_LAYOUT_COLUMN_MAJOR every inner array of the dense form holds
+ * one column, as written by matrix_serialize_with_options() with the same
+ * layout. The columns are parsed a strip at a time and moved into the matrix
+ * rows with a tiled transpose. The CSR form is always row-major, the other
+ * options are ignored.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+struct matrix *matrix_unserialize_with_options(const char *data, const struct serializer_options *options);
+
+#endif // MATRIX_LAYOUT_H
+
+#ifndef SERIALIZER_METRICS_H
+#define SERIALIZER_METRICS_H
+
+/**
+ * Phases timed by the instrumentation.
+ *
+ * The encode and decode phases span a whole call, the other phases are nested
+ * inside them, so their times overlap.
+ */
+enum serializer_phase {
+  // Building a JSON tree from an object, or reading one back.
+  SERIALIZER_PHASE_TREE = 0,
+  // Formatting the numbers of a text encoder.
+  SERIALIZER_PHASE_FORMAT = 1,
+  // A whole encode call.
+  SERIALIZER_PHASE_ENCODE = 2,
+  // A whole decode call.
+  SERIALIZER_PHASE_DECODE = 3,
+  // Parsing the numbers of a text decoder.
+  SERIALIZER_PHASE_PARSE = 4,
+  // Allocating objects and growing output buffers.
+  SERIALIZER_PHASE_ALLOCATE = 5,
+};
+
+/**
+ * The number of timed phases.
+ */
+#define SERIALIZER_PHASE_COUNT 6
+
+/**
+ * Counters and timers collected by the instrumentation.
+ */
+struct serializer_metrics {
+  // The number of instrumented calls.
+  uint64_t calls;
+  // The number of times each phase ran, indexed by serializer_phase.
+  uint64_t phase_calls[SERIALIZER_PHASE_COUNT];
+  // The time spent in each phase, in nanoseconds.
+  uint64_t phase_nanoseconds[SERIALIZER_PHASE_COUNT];
+  // The number of serialized bytes read by the decoders.
+  uint64_t bytes_in;
+  // The number of serialized bytes written by the encoders.
+  uint64_t bytes_out;
+  // The number of bytes allocated for objects and output buffers.
+  uint64_t allocated_bytes;
+};
+
+/**
+ * Callback receiving the counters of each finished call.
+ *
+ * @param const char *operation
+ *   The name of the public function that finished.
+ * @param const struct serializer_metrics *metrics
+ *   The counters of that call alone, valid until the callback returns.
+ * @param void *context
+ *   The context given to serializer_metrics_set_callback().
+ */
+typedef void (*serializer_metrics_callback)(const char *operation, const struct serializer_metrics *metrics, void *context);
+
+/**
+ * Turns the instrumentation on or off.
+ *
+ * The instrumentation is off by default and then costs one relaxed load per
+ * call. Building the library with SERIALIZER_NO_METRICS defined removes it
+ * entirely. Calls nested inside an instrumented call, such as a vector decode
+ * run by a batch decoder, are added to the outermost call.
+ *
+ * @param int enabled
+ *   Non-zero to start recording, zero to stop.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the instrumentation was compiled
+ *   out and can not be enabled.
+ */
+int serializer_metrics_enable(int enabled);
+
+/**
+ * Registers the callback invoked after every instrumented call.
+ *
+ * The callback runs on the thread that made the call, it must be thread safe
+ * when the serializers are used from several threads.
+ *
+ * @param serializer_metrics_callback callback
+ *   The callback, or NULL to remove it.
+ * @param void *context
+ *   Context passed to the callback.
+ */
+void serializer_metrics_set_callback(serializer_metrics_callback callback, void *context);
+
+/**
+ * Copies the totals of every call recorded since the last reset.
+ *
+ * @param struct serializer_metrics *metrics
+ *   The structure receiving the totals.
+ */
+void serializer_metrics_snapshot(struct serializer_metrics *metrics);
+
+/**
+ * Clears the recorded totals.
+ */
+void serializer_metrics_reset(void);
+
+#endif // SERIALIZER_METRICS_H
+
+#ifndef ASYNC_SERIALIZER_H
+#define ASYNC_SERIALIZER_H
+
+/**
+ * Flags of the asynchronous calls, combined with a bitwise or.
+ */
+enum serializer_async_flag {
+  // Copy the matrix, or the input bytes, on the calling thread when the job is
+  // submitted, so the job sees them as they were at that moment.
+  SERIALIZER_ASYNC_SNAPSHOT = 0,
+  // Use the matrix or the input bytes in place, they must stay alive and
+  // unchanged until the callback runs.
+  SERIALIZER_ASYNC_BORROW = 1,
+  // Wait for a free queue slot instead of failing when the queue is full.
+  SERIALIZER_ASYNC_BLOCK = 2,
+  // Use the binary format instead of JSON.
+  SERIALIZER_ASYNC_BINARY = 4,
+};
+
+/**
+ * Outcomes of an asynchronous job.
+ */
+enum serializer_async_status {
+  // The job completed.
+  SERIALIZER_ASYNC_DONE = 0,
+  // The job failed, the input could not be serialized or decoded.
+  SERIALIZER_ASYNC_FAILED = 1,
+  // The job was cancelled before it completed.
+  SERIALIZER_ASYNC_CANCELLED = 2,
+};
+
+/**
+ * Result handed to the completion callback.
+ */
+struct serializer_async_result {
+  // The serializer_async_status value.
+  int status;
+  // The serialized bytes, owned by the callback. JSON is NUL-terminated.
+  char *data;
+  // The number of serialized bytes.
+  size_t length;
+  // The decoded Matrix object, owned by the callback.
+  struct matrix *matrix;
+};
+
+/**
+ * Completion callback of an asynchronous job.
+ *
+ * The callback runs exactly once per job, on a worker thread, and takes
+ * ownership of the data or the matrix of the result.
+ *
+ * @param const struct serializer_async_result *result
+ *   The job result.
+ * @param void *context
+ *   The context given when the job was submitted.
+ */
+typedef void (*serializer_async_callback)(const struct serializer_async_result *result, void *context);
+
+/**
+ * Bounded pool of worker threads running asynchronous jobs.
+ */
+struct serializer_pool;
+
+/**
+ * Handle of a submitted job, released with serializer_job_release().
+ */
+struct serializer_job;
+
+/**
+ * Creates a worker pool.
+ *
+ * @param int workers
+ *   The number of worker threads.
+ * @param int queue_capacity
+ *   The number of jobs that may wait for a worker, further submissions fail
+ *   or block until a slot frees up.
+ *
+ * @return struct serializer_pool*
+ *   The pool, or NULL if it could not be created.
+ */
+struct serializer_pool *serializer_pool_create(int workers, int queue_capacity);
+
+/**
+ * Destroys a worker pool.
+ *
+ * Queued jobs are reported as cancelled and running jobs are waited for. No
+ * job may be submitted while the pool is being destroyed.
+ *
+ * @param struct serializer_pool *pool
+ *   The pool to destroy.
+ */
+void serializer_pool_destroy(struct serializer_pool *pool);
+
+/**
+ * Serializes a Matrix object on a worker thread.
+ *
+ * Unless SERIALIZER_ASYNC_BORROW is given, the matrix values are copied before
+ * this function returns, so the caller may change or destroy the matrix right
+ * away and the result reflects the values at submission time.
+ *
+ * @param struct serializer_pool *pool
+ *   The worker pool.
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, copied, or NULL to use the defaults.
+ * @param int flags
+ *   The serializer_async_flag values.
+ * @param serializer_async_callback callback
+ *   The completion callback.
+ * @param void *context
+ *   Context passed to the callback.
+ *
+ * @return struct serializer_job*
+ *   The job handle, or NULL if the input is invalid, the queue is full or
+ *   an allocation failed. The callback is not invoked when NULL is returned.
+ */
+struct serializer_job *matrix_serialize_async(struct serializer_pool *pool, struct matrix *object, const struct serializer_options *options, int flags, serializer_async_callback callback, void *context);
+
+/**
+ * Decodes a Matrix object from a buffer on a worker thread.
+ *
+ * @param struct serializer_pool *pool
+ *   The worker pool.
+ * @param const char *data
+ *   The serialized matrix, JSON or binary with SERIALIZER_ASYNC_BINARY. A
+ *   borrowed JSON string must be NUL-terminated.
+ * @param size_t length
+ *   The number of bytes, without any NUL terminator.
+ * @param int flags
+ *   The serializer_async_flag values.
+ * @param serializer_async_callback callback
+ *   The completion callback.
+ * @param void *context
+ *   Context passed to the callback.
+ *
+ * @return struct serializer_job*
+ *   The job handle, or NULL if the job could not be submitted.
+ */
+struct serializer_job *matrix_unserialize_async(struct serializer_pool *pool, const char *data, size_t length, int flags, serializer_async_callback callback, void *context);
+
+/**
+ * Reads a file descriptor to its end and decodes a Matrix object from it on a
+ * worker thread.
+ *
+ * The descriptor is not closed, it must stay open until the callback runs.
+ *
+ * @param struct serializer_pool *pool
+ *   The worker pool.
+ * @param int fd
+ *   The file descriptor.
+ * @param int flags
+ *   The serializer_async_flag values, SERIALIZER_ASYNC_BORROW is ignored.
+ * @param serializer_async_callback callback
+ *   The completion callback.
+ * @param void *context
+ *   Context passed to the callback.
+ *
+ * @return struct serializer_job*
+ *   The job handle, or NULL if the job could not be submitted.
+ */
+struct serializer_job *matrix_unserialize_fd_async(struct serializer_pool *pool, int fd, int flags, serializer_async_callback callback, void *context);
+
+/**
+ * Requests the cancellation of a job.
+ *
+ * A queued job is reported as cancelled without running. A running encode
+ * stops at its next output block, a running decode after its current step.
+ *
+ * @param struct serializer_job *job
+ *   The job to cancel.
+ *
+ * @return int
+ *   Returns 0 if the callback will report the job as cancelled, otherwise 1
+ *   if the job already finished.
+ */
+int serializer_job_cancel(struct serializer_job *job);
+
+/**
+ * Waits until the callback of a job has returned.
+ *
+ * @param struct serializer_job *job
+ *   The job to wait for.
+ *
+ * @return int
+ *   The serializer_async_status value of the job.
+ */
+int serializer_job_wait(struct serializer_job *job);
+
+/**
+ * Releases a job handle, the job itself keeps running.
+ *
+ * @param struct serializer_job *job
+ *   The job handle.
+ */
+void serializer_job_release(struct serializer_job *job);
+
+#endif // ASYNC_SERIALIZER_H
+
+#ifndef STRICT_DECODER_H
+#define STRICT_DECODER_H
+
+/**
+ * Failure reasons reported by the strict decoders.
+ */
+enum serializer_error_code {
+  // No error.
+  SERIALIZER_ERROR_NONE = 0,
+  // The input is NULL or the options are invalid.
+  SERIALIZER_ERROR_ARGUMENT = 1,
+  // The JSON structure is malformed, such as a missing bracket or comma.
+  SERIALIZER_ERROR_SYNTAX = 2,
+  // A value is not a valid JSON number.
+  SERIALIZER_ERROR_NUMBER = 3,
+  // A value is null.
+  SERIALIZER_ERROR_NULL = 4,
+  // The input is empty, or a row is shorter or longer than the first one.
+  SERIALIZER_ERROR_SHAPE = 5,
+  // A finite number is too large for the element type of the options.
+  SERIALIZER_ERROR_OVERFLOW = 6,
+  // A NaN or an infinity was rejected by the non-finite policy.
+  SERIALIZER_ERROR_NON_FINITE = 7,
+  // An allocation failed.
+  SERIALIZER_ERROR_MEMORY = 8,
+};
+
+/**
+ * Location and reason of a strict decoding failure.
+ */
+struct serializer_error {
+  // One of the serializer_error_code values.
+  int code;
+  // Index of the row, or inner array, holding the error, -1 outside of one.
+  int row;
+  // Index of the value within the row, -1 when the error is not on a value.
+  int column;
+  // Byte offset of the error in the text, 0 for JSON trees.
+  size_t offset;
+};
+
+/**
+ * Decodes a Matrix object, validating the whole input in the same pass.
+ *
+ * Unlike matrix_unserialize(), null values, ragged rows, malformed numbers,
+ * values overflowing the element type of the options and, unless allowed,
+ * NaN and infinities are all rejected. The first error is reported and the
+ * values are parsed once, into a buffer moved into the matrix at the end.
+ *
+ * @param const char *data
+ *   The serialized matrix, a dense array of rows, or of columns when the
+ *   options select SERIALIZER_LAYOUT_COLUMN_MAJOR.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_error *error
+ *   Pointer receiving the error, or NULL.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+struct matrix *matrix_unserialize_strict(const char *data, const struct serializer_options *options, struct serializer_error *error);
+
+/**
+ * Decodes a Vector object, validating the whole input in the same pass.
+ *
+ * @param const char *data
+ *   The serialized vector.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_error *error
+ *   Pointer receiving the error, or NULL. The row is always 0.
+ *
+ * @return struct vector*
+ *   The unserialized Vector object is returned, otherwise NULL.
+ */
+struct vector *vector_unserialize_strict(const char *data, const struct serializer_options *options, struct serializer_error *error);
+
+/**
+ * Creates a Matrix object from a JSON array with the strict checks of
+ * matrix_unserialize_strict().
+ *
+ * The JSON array is never destroyed, it stays owned by the caller.
+ *
+ * @param struct json *jobject
+ *   The JSON array of rows.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_error *error
+ *   Pointer receiving the error, or NULL.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+struct matrix *matrix_unserialize_from_json_object_strict(struct json *jobject, const struct serializer_options *options, struct serializer_error *error);
+
+#endif // STRICT_DECODER_H
+
+#ifndef TENSOR_SERIALIZER_H
+#define TENSOR_SERIALIZER_H
+
+/**
+ * The highest number of dimensions of a tensor.
+ */
+#define SERIALIZER_TENSOR_MAX_RANK 8
+
+/**
+ * Dense tensor stored in a single allocation.
+ *
+ * The structure and its elements share one memory block, released with
+ * serializer_tensor_destroy(). A stack of same-shaped matrices is a rank 3
+ * tensor whose innermost two dimensions are the matrix rows and columns.
+ */
+struct serializer_tensor {
+  // The number of dimensions, from 1 to SERIALIZER_TENSOR_MAX_RANK.
+  int rank;
+  // The extent of each dimension, outermost first.
+  int shape[SERIALIZER_TENSOR_MAX_RANK];
+  // The number of elements, the product of the extents.
+  size_t count;
+  // The elements in row-major order, the last dimension varying fastest.
+  long double *values;
+};
+
+/**
+ * Creates a zero-filled tensor.
+ *
+ * @param int rank
+ *   The number of dimensions.
+ * @param const int *shape
+ *   The rank positive extents, outermost first.
+ *
+ * @return struct serializer_tensor*
+ *   The tensor, or NULL if the shape is invalid or the allocation failed.
+ */
+struct serializer_tensor *serializer_tensor_create(int rank, const int *shape);
+
+/**
+ * Stacks same-shaped matrices into a rank 3 tensor.
+ *
+ * @param struct matrix **objects
+ *   The matrices, all with the shape of the first one.
+ * @param int count
+ *   The number of matrices.
+ *
+ * @return struct serializer_tensor*
+ *   The tensor of shape count x rows x columns, or NULL on failure.
+ */
+struct serializer_tensor *serializer_tensor_stack(struct matrix **objects, int count);
+
+/**
+ * Destroys a tensor.
+ *
+ * @param struct serializer_tensor *tensor
+ *   The tensor to destroy.
+ */
+void serializer_tensor_destroy(struct serializer_tensor *tensor);
+
+/**
+ * Returns the number of matrix slices of a tensor.
+ *
+ * A slice spans the innermost two dimensions, a rank 1 tensor is a single
+ * one-row slice.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor.
+ *
+ * @return int
+ *   The number of slices, or 0 if the tensor is NULL.
+ */
+int serializer_tensor_slice_count(const struct serializer_tensor *tensor);
+
+/**
+ * Views one matrix slice of a tensor in place.
+ *
+ * The view borrows the tensor memory: it is valid until the tensor is
+ * destroyed and must not be passed to matrix_unmap(). Use
+ * matrix_view_to_matrix() to copy a slice into a Matrix object.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor.
+ * @param int index
+ *   The slice index, below serializer_tensor_slice_count().
+ * @param struct matrix_view *view
+ *   Pointer receiving the view.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the index is out of range.
+ */
+int serializer_tensor_slice(const struct serializer_tensor *tensor, int index, struct matrix_view *view);
+
+/**
+ * Streams the JSON representation of a tensor into a buffer.
+ *
+ * The tensor is written as {"format":"tensor","shape":[...],"values":[...]},
+ * with every element in a single flat array.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults. The sparse and layout
+ *   options are ignored, tensors are always dense and row-major.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int tensor_serialize_to_stream(const struct serializer_tensor *tensor, const struct serializer_options *options, struct serializer_buffer *buffer);
+
+/**
+ * Generates the JSON representation of a tensor.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return char*
+ *   Returns the JSON string, or NULL if the serialization fails.
+ */
+char *tensor_serialize(const struct serializer_tensor *tensor, const struct serializer_options *options);
+
+/**
+ * Creates a tensor from its JSON representation.
+ *
+ * The shape must come before the values, so the tensor is allocated once and
+ * the values are parsed straight into it.
+ *
+ * @param const char *data
+ *   The serialized tensor string.
+ *
+ * @return struct serializer_tensor*
+ *   The unserialized tensor is returned, otherwise NULL.
+ */
+struct serializer_tensor *tensor_unserialize(const char *data);
+
+/**
+ * Generates the binary representation of a tensor.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, only the element type is used, or NULL to use the
+ *   defaults.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+unsigned char *tensor_serialize_binary(const struct serializer_tensor *tensor, const struct serializer_options *options, size_t *length);
+
+/**
+ * Creates a tensor from its binary representation.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   The number of bytes in the payload.
+ *
+ * @return struct serializer_tensor*
+ *   The unserialized tensor is returned, otherwise NULL.
+ */
+struct serializer_tensor *tensor_unserialize_binary(const unsigned char *data, size_t length);
+
+#endif // TENSOR_SERIALIZER_H
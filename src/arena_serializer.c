@@ -0,0 +1,80 @@
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * {@inheritdoc}
+ */
+char *vector_serialize_arena(struct vector *object, const struct serializer_options *options, struct serializer_arena *arena, size_t *length) {
+  // Prepare an output buffer backed by the arena.
+  struct serializer_buffer buffer;
+  if (object == NULL || serializer_buffer_init_arena(&buffer, arena, 0) == 1) {
+    return NULL;
+  }
+  // Stream the Vector representation straight into the buffer.
+  if (vector_serialize_to_stream(object, options, &buffer) == 1) {
+    return NULL;
+  }
+  return serializer_buffer_detach(&buffer, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *matrix_serialize_arena(struct matrix *object, const struct serializer_options *options, struct serializer_arena *arena, size_t *length) {
+  // Prepare an output buffer backed by the arena.
+  struct serializer_buffer buffer;
+  if (object == NULL || serializer_buffer_init_arena(&buffer, arena, 0) == 1) {
+    return NULL;
+  }
+  // Stream the Matrix representation straight into the buffer.
+  if (matrix_serialize_to_stream(object, options, &buffer) == 1) {
+    return NULL;
+  }
+  return serializer_buffer_detach(&buffer, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+long double *vector_unserialize_arena(const char *data, struct serializer_arena *arena, int *capacity) {
+  // Validates the input.
+  if (data == NULL || arena == NULL || capacity == NULL) {
+    return NULL;
+  }
+  // Scan the shape, then parse straight into arena memory.
+  if (serializer_scan_vector_shape(data, capacity) == 1) {
+    return NULL;
+  }
+  long double *values = serializer_arena_alloc(arena, (size_t)*capacity * sizeof(long double));
+  if (values == NULL || serializer_parse_vector_values(data, values, *capacity) == 1) {
+    return NULL;
+  }
+  return values;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix_view *matrix_unserialize_arena(const char *data, struct serializer_arena *arena) {
+  // Validates the input.
+  if (data == NULL || arena == NULL) {
+    return NULL;
+  }
+  // Scan the shape, then parse straight into arena memory.
+  int rows = 0;
+  int columns = 0;
+  if (serializer_scan_matrix_shape(data, &rows, &columns) == 1) {
+    return NULL;
+  }
+  struct matrix_view *view = serializer_arena_alloc(arena, sizeof(struct matrix_view));
+  long double *values = serializer_arena_alloc(arena, (size_t)rows * columns * sizeof(long double));
+  if (view == NULL || values == NULL || serializer_parse_matrix_values(data, values, rows, columns) == 1) {
+    return NULL;
+  }
+  view->rows = rows;
+  view->columns = columns;
+  view->values = values;
+  view->mapping = NULL;
+  view->mapping_length = 0;
+  return view;
+}
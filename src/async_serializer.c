@@ -0,0 +1,647 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Kinds of asynchronous jobs.
+ */
+enum serializer_job_kind {
+  // Serialize a matrix.
+  SERIALIZER_JOB_ENCODE = 0,
+  // Decode a matrix from a buffer.
+  SERIALIZER_JOB_DECODE = 1,
+  // Decode a matrix read from a file descriptor.
+  SERIALIZER_JOB_DECODE_FD = 2,
+};
+
+/**
+ * An asynchronous job, shared by its handle and the pool.
+ */
+struct serializer_job {
+  // The serializer_job_kind value.
+  int kind;
+  // The serializer_async_flag values.
+  int flags;
+  // The matrix to serialize, owned by the job unless borrowed.
+  struct matrix *object;
+  // The serializer options.
+  struct serializer_options options;
+  // The bytes to decode, owned by the job unless borrowed.
+  const char *data;
+  // The number of bytes to decode.
+  size_t length;
+  // The file descriptor to read.
+  int fd;
+  // The completion callback and its context.
+  serializer_async_callback callback;
+  void *context;
+  // Lock guarding the fields below.
+  pthread_mutex_t lock;
+  // Signaled once the callback has returned.
+  pthread_cond_t completed_signal;
+  // Whether a cancellation was requested.
+  int cancelled;
+  // Whether the outcome is decided, cancelling then has no effect.
+  int finished;
+  // Whether the callback has returned.
+  int completed;
+  // The serializer_async_status value reported.
+  int status;
+  // The number of references, the handle and the pool.
+  int references;
+};
+
+/**
+ * Bounded pool of worker threads, opaque to the callers.
+ */
+struct serializer_pool {
+  // The worker threads.
+  pthread_t *workers;
+  // The number of worker threads.
+  int worker_count;
+  // Ring buffer of queued jobs.
+  struct serializer_job **queue;
+  // The number of queue slots.
+  int capacity;
+  // Index of the oldest queued job.
+  int head;
+  // The number of queued jobs.
+  int count;
+  // The number of slots taken, queued jobs plus submissions in progress.
+  int reserved;
+  // Whether the pool is being destroyed.
+  int stopping;
+  // Lock guarding the queue.
+  pthread_mutex_t lock;
+  // Signaled when a job is queued or the pool stops.
+  pthread_cond_t not_empty;
+  // Signaled when a slot frees up or the pool stops.
+  pthread_cond_t not_full;
+};
+
+/**
+ * Reads the cancellation flag of a job.
+ *
+ * @param struct serializer_job *job
+ *   The job.
+ *
+ * @return int
+ *   Returns 1 if a cancellation was requested, otherwise 0.
+ */
+static int serializer_job_cancelled(struct serializer_job *job) {
+  pthread_mutex_lock(&job->lock);
+  int cancelled = job->cancelled;
+  pthread_mutex_unlock(&job->lock);
+  return cancelled;
+}
+
+/**
+ * Drops one reference to a job, freeing it with the last one.
+ *
+ * @param struct serializer_job *job
+ *   The job.
+ */
+static void serializer_job_unref(struct serializer_job *job) {
+  pthread_mutex_lock(&job->lock);
+  int references = --job->references;
+  pthread_mutex_unlock(&job->lock);
+  if (references > 0) {
+    return;
+  }
+  // The inputs were released by the worker.
+  pthread_mutex_destroy(&job->lock);
+  pthread_cond_destroy(&job->completed_signal);
+  free(job);
+}
+
+/**
+ * Frees the inputs owned by a job.
+ *
+ * @param struct serializer_job *job
+ *   The job.
+ */
+static void serializer_job_release_inputs(struct serializer_job *job) {
+  if ((job->flags & SERIALIZER_ASYNC_BORROW) == 0) {
+    matrix_destroy(job->object);
+    free((char *)job->data);
+  }
+  job->object = NULL;
+  job->data = NULL;
+}
+
+/**
+ * Destination of an asynchronous encode, checking for cancellation at every
+ * output block.
+ */
+struct serializer_job_output {
+  // The job being run.
+  struct serializer_job *job;
+  // The collected output.
+  struct serializer_buffer buffer;
+};
+
+/**
+ * Sink appending an output block to the job output.
+ *
+ * @param const char *data
+ *   The bytes to append.
+ * @param size_t length
+ *   The number of bytes.
+ * @param void *context
+ *   The struct serializer_job_output.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the job was cancelled or the
+ *   output could not grow.
+ */
+static int serializer_job_output_write(const char *data, size_t length, void *context) {
+  struct serializer_job_output *output = context;
+  if (serializer_job_cancelled(output->job)) {
+    return 1;
+  }
+  return serializer_buffer_write(&output->buffer, data, length);
+}
+
+/**
+ * Serializes the matrix of a job.
+ *
+ * @param struct serializer_job *job
+ *   The job.
+ * @param struct serializer_async_result *result
+ *   The result receiving the serialized bytes.
+ */
+static void serializer_job_encode(struct serializer_job *job, struct serializer_async_result *result) {
+  if ((job->flags & SERIALIZER_ASYNC_BINARY) != 0) {
+    result->data = (char *)matrix_serialize_binary_with_options(job->object, &job->options, &result->length);
+    return;
+  }
+  // Stream through a sink so a cancellation stops the encoder early.
+  struct serializer_job_output output;
+  output.job = job;
+  if (serializer_buffer_init(&output.buffer, 0) == 1) {
+    return;
+  }
+  if (matrix_serialize_to_sink(job->object, &job->options, serializer_job_output_write, &output) == 1) {
+    serializer_buffer_release(&output.buffer);
+    return;
+  }
+  result->data = serializer_buffer_detach(&output.buffer, &result->length);
+}
+
+/**
+ * Decodes the matrix of a job from bytes.
+ *
+ * @param struct serializer_job *job
+ *   The job.
+ * @param const char *data
+ *   The serialized matrix, NUL-terminated when it is JSON.
+ * @param size_t length
+ *   The number of bytes.
+ * @param struct serializer_async_result *result
+ *   The result receiving the matrix.
+ */
+static void serializer_job_decode(struct serializer_job *job, const char *data, size_t length, struct serializer_async_result *result) {
+  if ((job->flags & SERIALIZER_ASYNC_BINARY) != 0) {
+    result->matrix = matrix_unserialize_binary((const unsigned char *)data, length);
+    return;
+  }
+  result->matrix = matrix_unserialize((char *)data);
+}
+
+/**
+ * Reads the file descriptor of a job to its end, then decodes it.
+ *
+ * @param struct serializer_job *job
+ *   The job.
+ * @param struct serializer_async_result *result
+ *   The result receiving the matrix.
+ */
+static void serializer_job_decode_fd(struct serializer_job *job, struct serializer_async_result *result) {
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init(&buffer, 0) == 1) {
+    return;
+  }
+  // Read block by block, checking for cancellation in between.
+  while (!serializer_job_cancelled(job)) {
+    if (serializer_buffer_reserve(&buffer, 65536) == 1) {
+      break;
+    }
+    ssize_t count = read(job->fd, buffer.data + buffer.length, buffer.capacity - buffer.length - 1);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      break;
+    }
+    if (count == 0) {
+      // The buffer keeps a spare byte for the terminator.
+      buffer.data[buffer.length] = '\0';
+      serializer_job_decode(job, buffer.data, buffer.length, result);
+      break;
+    }
+    buffer.length += (size_t)count;
+  }
+  serializer_buffer_release(&buffer);
+}
+
+/**
+ * Runs a job and reports its result.
+ *
+ * @param struct serializer_job *job
+ *   The job, cancelled when the pool is stopping.
+ */
+static void serializer_job_run(struct serializer_job *job) {
+  struct serializer_async_result result;
+  memset(&result, 0, sizeof(struct serializer_async_result));
+  if (!serializer_job_cancelled(job)) {
+    if (job->kind == SERIALIZER_JOB_ENCODE) {
+      serializer_job_encode(job, &result);
+    }
+    else if (job->kind == SERIALIZER_JOB_DECODE) {
+      serializer_job_decode(job, job->data, job->length, &result);
+    }
+    else {
+      serializer_job_decode_fd(job, &result);
+    }
+  }
+  serializer_job_release_inputs(job);
+  // Decide the outcome, a late cancellation still discards the result.
+  pthread_mutex_lock(&job->lock);
+  job->finished = 1;
+  if (job->cancelled) {
+    free(result.data);
+    matrix_destroy(result.matrix);
+    memset(&result, 0, sizeof(struct serializer_async_result));
+    result.status = SERIALIZER_ASYNC_CANCELLED;
+  }
+  else {
+    result.status = result.data != NULL || result.matrix != NULL ? SERIALIZER_ASYNC_DONE : SERIALIZER_ASYNC_FAILED;
+  }
+  job->status = result.status;
+  pthread_mutex_unlock(&job->lock);
+  job->callback(&result, job->context);
+  // Wake the waiters, then drop the pool reference.
+  pthread_mutex_lock(&job->lock);
+  job->completed = 1;
+  pthread_cond_broadcast(&job->completed_signal);
+  pthread_mutex_unlock(&job->lock);
+  serializer_job_unref(job);
+}
+
+/**
+ * Thread entry point of a pool worker.
+ *
+ * @param void *argument
+ *   The pool.
+ *
+ * @return void*
+ *   Always NULL.
+ */
+static void *serializer_pool_work(void *argument) {
+  struct serializer_pool *pool = argument;
+  pthread_mutex_lock(&pool->lock);
+  while (1) {
+    while (pool->count == 0 && !pool->stopping) {
+      pthread_cond_wait(&pool->not_empty, &pool->lock);
+    }
+    if (pool->count == 0) {
+      break;
+    }
+    struct serializer_job *job = pool->queue[pool->head];
+    pool->head = (pool->head + 1) % pool->capacity;
+    pool->count--;
+    pool->reserved--;
+    int stopping = pool->stopping;
+    pthread_cond_signal(&pool->not_full);
+    pthread_mutex_unlock(&pool->lock);
+    // Jobs still queued when the pool stops are cancelled.
+    if (stopping) {
+      serializer_job_cancel(job);
+    }
+    serializer_job_run(job);
+    pthread_mutex_lock(&pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_pool *serializer_pool_create(int workers, int queue_capacity) {
+  // Validates the input.
+  if (workers <= 0 || queue_capacity <= 0) {
+    return NULL;
+  }
+  struct serializer_pool *pool = calloc(1, sizeof(struct serializer_pool));
+  if (pool == NULL) {
+    return NULL;
+  }
+  pool->workers = calloc(workers, sizeof(pthread_t));
+  pool->queue = calloc(queue_capacity, sizeof(struct serializer_job *));
+  if (pool->workers == NULL || pool->queue == NULL) {
+    free(pool->workers);
+    free(pool->queue);
+    free(pool);
+    return NULL;
+  }
+  pool->capacity = queue_capacity;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->not_empty, NULL);
+  pthread_cond_init(&pool->not_full, NULL);
+  // Start the workers, stopping the ones already running on failure.
+  for (int i = 0; i < workers; i++) {
+    if (pthread_create(&pool->workers[i], NULL, serializer_pool_work, pool) != 0) {
+      serializer_pool_destroy(pool);
+      return NULL;
+    }
+    pool->worker_count++;
+  }
+  return pool;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_pool_destroy(struct serializer_pool *pool) {
+  if (pool == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = 1;
+  pthread_cond_broadcast(&pool->not_empty);
+  pthread_cond_broadcast(&pool->not_full);
+  pthread_mutex_unlock(&pool->lock);
+  // The workers drain the queue before they exit.
+  for (int i = 0; i < pool->worker_count; i++) {
+    pthread_join(pool->workers[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->not_empty);
+  pthread_cond_destroy(&pool->not_full);
+  free(pool->workers);
+  free(pool->queue);
+  free(pool);
+}
+
+/**
+ * Takes a queue slot for a job about to be submitted.
+ *
+ * @param struct serializer_pool *pool
+ *   The pool.
+ * @param int flags
+ *   The serializer_async_flag values.
+ *
+ * @return int
+ *   Returns 0 if a slot was taken, otherwise 1 if the queue is full or the
+ *   pool is stopping.
+ */
+static int serializer_pool_reserve(struct serializer_pool *pool, int flags) {
+  pthread_mutex_lock(&pool->lock);
+  while ((flags & SERIALIZER_ASYNC_BLOCK) != 0 && pool->reserved == pool->capacity && !pool->stopping) {
+    pthread_cond_wait(&pool->not_full, &pool->lock);
+  }
+  int status = pool->reserved == pool->capacity || pool->stopping ? 1 : 0;
+  if (status == 0) {
+    pool->reserved++;
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return status;
+}
+
+/**
+ * Gives back a queue slot taken by a submission that failed.
+ *
+ * @param struct serializer_pool *pool
+ *   The pool.
+ */
+static void serializer_pool_unreserve(struct serializer_pool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->reserved--;
+  pthread_cond_signal(&pool->not_full);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Creates a job and takes a queue slot for it.
+ *
+ * @param struct serializer_pool *pool
+ *   The pool.
+ * @param int kind
+ *   The serializer_job_kind value.
+ * @param int flags
+ *   The serializer_async_flag values.
+ * @param serializer_async_callback callback
+ *   The completion callback.
+ * @param void *context
+ *   Context passed to the callback.
+ *
+ * @return struct serializer_job*
+ *   The job, or NULL if the queue is full or the allocation failed.
+ */
+static struct serializer_job *serializer_job_create(struct serializer_pool *pool, int kind, int flags, serializer_async_callback callback, void *context) {
+  if (pool == NULL || callback == NULL || serializer_pool_reserve(pool, flags) == 1) {
+    return NULL;
+  }
+  struct serializer_job *job = calloc(1, sizeof(struct serializer_job));
+  if (job == NULL) {
+    serializer_pool_unreserve(pool);
+    return NULL;
+  }
+  job->kind = kind;
+  job->flags = flags;
+  job->fd = -1;
+  job->callback = callback;
+  job->context = context;
+  job->references = 2;
+  pthread_mutex_init(&job->lock, NULL);
+  pthread_cond_init(&job->completed_signal, NULL);
+  return job;
+}
+
+/**
+ * Discards a job that could not be prepared, giving back its slot.
+ *
+ * @param struct serializer_pool *pool
+ *   The pool.
+ * @param struct serializer_job *job
+ *   The job.
+ */
+static void serializer_job_discard(struct serializer_pool *pool, struct serializer_job *job) {
+  serializer_job_release_inputs(job);
+  pthread_mutex_destroy(&job->lock);
+  pthread_cond_destroy(&job->completed_signal);
+  free(job);
+  serializer_pool_unreserve(pool);
+}
+
+/**
+ * Queues a prepared job in its reserved slot.
+ *
+ * @param struct serializer_pool *pool
+ *   The pool.
+ * @param struct serializer_job *job
+ *   The job.
+ *
+ * @return struct serializer_job*
+ *   The job handle.
+ */
+static struct serializer_job *serializer_pool_push(struct serializer_pool *pool, struct serializer_job *job) {
+  pthread_mutex_lock(&pool->lock);
+  pool->queue[(pool->head + pool->count) % pool->capacity] = job;
+  pool->count++;
+  pthread_cond_signal(&pool->not_empty);
+  pthread_mutex_unlock(&pool->lock);
+  return job;
+}
+
+/**
+ * Copies the values of a matrix into a new one.
+ *
+ * @param struct matrix *object
+ *   The matrix to copy.
+ *
+ * @return struct matrix*
+ *   The copy, or NULL if the allocation or reading a value failed.
+ */
+static struct matrix *serializer_matrix_snapshot(struct matrix *object) {
+  struct matrix *copy = matrix_create(object->rows, object->columns);
+  if (copy == NULL) {
+    return NULL;
+  }
+  for (int j = 0; j < object->rows; j++) {
+    long double *source = serializer_matrix_row(object, j);
+    long double *target = serializer_matrix_row(copy, j);
+    if (source != NULL && target != NULL) {
+      memcpy(target, source, (size_t)object->columns * sizeof(long double));
+      continue;
+    }
+    for (int k = 0; k < object->columns; k++) {
+      long double *lvalue = matrix_getl(object, j, k);
+      if (lvalue == NULL) {
+        matrix_destroy(copy);
+        return NULL;
+      }
+      matrix_setl(copy, j, k, *lvalue);
+    }
+  }
+  return copy;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_job *matrix_serialize_async(struct serializer_pool *pool, struct matrix *object, const struct serializer_options *options, int flags, serializer_async_callback callback, void *context) {
+  // Validates the input.
+  if (object == NULL || object->rows <= 0 || object->columns <= 0) {
+    return NULL;
+  }
+  struct serializer_job *job = serializer_job_create(pool, SERIALIZER_JOB_ENCODE, flags, callback, context);
+  if (job == NULL) {
+    return NULL;
+  }
+  if (options != NULL) {
+    job->options = *options;
+  }
+  else {
+    serializer_options_init(&job->options);
+  }
+  // Capture the values now unless the caller keeps them stable.
+  job->object = (flags & SERIALIZER_ASYNC_BORROW) != 0 ? object : serializer_matrix_snapshot(object);
+  if (job->object == NULL) {
+    serializer_job_discard(pool, job);
+    return NULL;
+  }
+  return serializer_pool_push(pool, job);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_job *matrix_unserialize_async(struct serializer_pool *pool, const char *data, size_t length, int flags, serializer_async_callback callback, void *context) {
+  // Validates the input.
+  if (data == NULL) {
+    return NULL;
+  }
+  struct serializer_job *job = serializer_job_create(pool, SERIALIZER_JOB_DECODE, flags, callback, context);
+  if (job == NULL) {
+    return NULL;
+  }
+  job->length = length;
+  if ((flags & SERIALIZER_ASYNC_BORROW) != 0) {
+    job->data = data;
+    return serializer_pool_push(pool, job);
+  }
+  // Copy the bytes, terminated so JSON can be scanned in place.
+  char *copy = malloc(length + 1);
+  if (copy == NULL) {
+    serializer_job_discard(pool, job);
+    return NULL;
+  }
+  memcpy(copy, data, length);
+  copy[length] = '\0';
+  job->data = copy;
+  return serializer_pool_push(pool, job);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_job *matrix_unserialize_fd_async(struct serializer_pool *pool, int fd, int flags, serializer_async_callback callback, void *context) {
+  // Validates the input.
+  if (fd < 0) {
+    return NULL;
+  }
+  // Nothing is borrowed, the bytes are read by the worker.
+  struct serializer_job *job = serializer_job_create(pool, SERIALIZER_JOB_DECODE_FD, flags & ~SERIALIZER_ASYNC_BORROW, callback, context);
+  if (job == NULL) {
+    return NULL;
+  }
+  job->fd = fd;
+  return serializer_pool_push(pool, job);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_job_cancel(struct serializer_job *job) {
+  if (job == NULL) {
+    return 1;
+  }
+  pthread_mutex_lock(&job->lock);
+  int status = job->finished;
+  if (!job->finished) {
+    job->cancelled = 1;
+  }
+  pthread_mutex_unlock(&job->lock);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_job_wait(struct serializer_job *job) {
+  if (job == NULL) {
+    return SERIALIZER_ASYNC_FAILED;
+  }
+  pthread_mutex_lock(&job->lock);
+  while (!job->completed) {
+    pthread_cond_wait(&job->completed_signal, &job->lock);
+  }
+  int status = job->status;
+  pthread_mutex_unlock(&job->lock);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_job_release(struct serializer_job *job) {
+  if (job != NULL) {
+    serializer_job_unref(job);
+  }
+}
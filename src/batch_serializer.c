@@ -0,0 +1,770 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Location of one member of a serialized batch.
+ */
+struct serializer_batch_member {
+  // The key, not terminated.
+  const char *key;
+  // The key length.
+  size_t key_length;
+  // The serialized value of a JSON batch.
+  const char *value;
+  // The number of rows and columns of the value.
+  int rows;
+  int columns;
+  // The binary payload of a bundle entry.
+  const unsigned char *payload;
+  // The binary payload length.
+  size_t payload_length;
+};
+
+/**
+ * Checks that a key can be written without escaping.
+ *
+ * @param const char *key
+ *   The key.
+ * @param size_t length
+ *   The key length.
+ *
+ * @return int
+ *   Returns 1 if the key is valid, otherwise 0.
+ */
+static int serializer_batch_key_valid(const char *key, size_t length) {
+  if (key == NULL || length > UINT32_MAX) {
+    return 0;
+  }
+  for (size_t i = 0; i < length; i++) {
+    unsigned char character = (unsigned char)key[i];
+    if (character == '"' || character == '\\' || character < 0x20) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Checks the arguments shared by the batch encoders.
+ *
+ * @param const char **keys
+ *   The keys.
+ * @param struct vector **vectors
+ *   The vectors, or NULL for a batch of matrices.
+ * @param struct matrix **matrices
+ *   The matrices, or NULL for a batch of vectors.
+ * @param int count
+ *   The number of objects.
+ *
+ * @return int
+ *   Returns 0 if every key and object can be written, otherwise 1.
+ */
+static int serializer_batch_check(const char **keys, struct vector **vectors, struct matrix **matrices, int count) {
+  if (count < 0 || (count > 0 && (keys == NULL || (vectors == NULL && matrices == NULL)))) {
+    return 1;
+  }
+  for (int i = 0; i < count; i++) {
+    if (keys[i] == NULL || !serializer_batch_key_valid(keys[i], strlen(keys[i]))) {
+      return 1;
+    }
+    // Empty objects have no serialized form.
+    if (vectors != NULL && (vectors[i] == NULL || vectors[i]->capacity <= 0)) {
+      return 1;
+    }
+    if (matrices != NULL && (matrices[i] == NULL || matrices[i]->rows <= 0 || matrices[i]->columns <= 0)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Writes a batch as a JSON object into a shared buffer.
+ *
+ * @param const char **keys
+ *   The keys.
+ * @param struct vector **vectors
+ *   The vectors, or NULL for a batch of matrices.
+ * @param struct matrix **matrices
+ *   The matrices, or NULL for a batch of vectors.
+ * @param int count
+ *   The number of objects.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int serializer_batch_write(const char **keys, struct vector **vectors, struct matrix **matrices, int count, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  // Validates the input.
+  if (buffer == NULL || serializer_batch_check(keys, vectors, matrices, count) == 1) {
+    return 1;
+  }
+  // The buffer is only flushed once, after the last member.
+  serializer_buffer_putc(buffer, '{');
+  for (int i = 0; i < count; i++) {
+    if (i > 0) {
+      serializer_buffer_putc(buffer, ',');
+    }
+    serializer_buffer_putc(buffer, '"');
+    serializer_buffer_write_text(buffer, keys[i]);
+    serializer_buffer_write_text(buffer, "\":");
+    int status;
+    if (vectors != NULL) {
+      status = serializer_write_vector(buffer, vectors[i], options);
+    }
+    else {
+      serializer_buffer_putc(buffer, '[');
+      status = serializer_write_matrix_rows(buffer, matrices[i], options, 0, matrices[i]->rows);
+      serializer_buffer_putc(buffer, ']');
+    }
+    if (status == 1) {
+      return 1;
+    }
+  }
+  serializer_buffer_putc(buffer, '}');
+  return serializer_buffer_flush(buffer);
+}
+
+/**
+ * Runs the batch encoder into a growable buffer.
+ *
+ * @param const char **keys
+ *   The keys.
+ * @param struct vector **vectors
+ *   The vectors, or NULL for a batch of matrices.
+ * @param struct matrix **matrices
+ *   The matrices, or NULL for a batch of vectors.
+ * @param int count
+ *   The number of objects.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return char*
+ *   Returns the JSON string, or NULL if an error occurred.
+ */
+static char *serializer_batch_serialize(const char **keys, struct vector **vectors, struct matrix **matrices, int count, const struct serializer_options *options) {
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init(&buffer, 0) == 1) {
+    return NULL;
+  }
+  if (serializer_batch_write(keys, vectors, matrices, count, options, &buffer) == 1) {
+    serializer_buffer_release(&buffer);
+    return NULL;
+  }
+  return serializer_buffer_detach(&buffer, NULL);
+}
+
+/**
+ * Appends a member to a growable member array.
+ *
+ * @param struct serializer_batch_member **members
+ *   The member array.
+ * @param int *count
+ *   The number of members, incremented.
+ * @param int *capacity
+ *   The capacity of the array.
+ *
+ * @return struct serializer_batch_member*
+ *   Returns the zero-filled new member, or NULL if the allocation failed.
+ */
+static struct serializer_batch_member *serializer_batch_push(struct serializer_batch_member **members, int *count, int *capacity) {
+  if (*count == *capacity) {
+    int grown_capacity = *capacity > 0 ? *capacity * 2 : 16;
+    struct serializer_batch_member *grown = realloc(*members, grown_capacity * sizeof(struct serializer_batch_member));
+    if (grown == NULL) {
+      return NULL;
+    }
+    *members = grown;
+    *capacity = grown_capacity;
+  }
+  struct serializer_batch_member *member = &(*members)[(*count)++];
+  memset(member, 0, sizeof(struct serializer_batch_member));
+  return member;
+}
+
+/**
+ * Scans a JSON batch once, recording the key, position and shape of every member.
+ *
+ * @param const char *data
+ *   The serialized batch.
+ * @param int matrices
+ *   Non-zero when the members are matrices, otherwise they are vectors.
+ * @param struct serializer_batch_member **members
+ *   Pointer receiving the malloc'd member array, the caller must free it.
+ * @param int *count
+ *   Pointer receiving the number of members.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_batch_locate(const char *data, int matrices, struct serializer_batch_member **members, int *count) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  *members = NULL;
+  *count = 0;
+  if (!serializer_scanner_consume(&scanner, '{')) {
+    return 1;
+  }
+  int capacity = 0;
+  int status = 0;
+  if (!serializer_scanner_consume(&scanner, '}')) {
+    do {
+      struct serializer_batch_member *member = serializer_batch_push(members, count, &capacity);
+      if (member == NULL || serializer_scanner_read_key(&scanner, &member->key, &member->key_length) == 1
+          || !serializer_batch_key_valid(member->key, member->key_length)) {
+        status = 1;
+        break;
+      }
+      serializer_scanner_skip_whitespace(&scanner);
+      member->value = scanner.cursor;
+      member->rows = 1;
+      if (matrices) {
+        status = serializer_scanner_scan_matrix(&scanner, &member->rows, &member->columns);
+      }
+      else {
+        status = serializer_scanner_scan_vector(&scanner, &member->columns);
+      }
+    } while (status == 0 && serializer_scanner_consume(&scanner, ','));
+    if (status == 0 && !serializer_scanner_consume(&scanner, '}')) {
+      status = 1;
+    }
+  }
+  if (status == 1 || !serializer_scanner_at_end(&scanner)) {
+    free(*members);
+    *members = NULL;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Copies the member keys into one NUL-terminated block.
+ *
+ * @param const struct serializer_batch_member *members
+ *   The members.
+ * @param int count
+ *   The number of members.
+ *
+ * @return char**
+ *   Returns the key array, whose strings live in the same allocation, or NULL
+ *   if the allocation failed.
+ */
+static char **serializer_batch_keys(const struct serializer_batch_member *members, int count) {
+  size_t total = (size_t)count * sizeof(char *);
+  for (int i = 0; i < count; i++) {
+    total += members[i].key_length + 1;
+  }
+  char **keys = malloc(total > 0 ? total : 1);
+  if (keys == NULL) {
+    return NULL;
+  }
+  char *cursor = (char *)(keys + count);
+  for (int i = 0; i < count; i++) {
+    keys[i] = cursor;
+    memcpy(cursor, members[i].key, members[i].key_length);
+    cursor[members[i].key_length] = '\0';
+    cursor += members[i].key_length + 1;
+  }
+  return keys;
+}
+
+/**
+ * Decodes one located vector member.
+ *
+ * @param const struct serializer_batch_member *member
+ *   The member.
+ *
+ * @return struct vector*
+ *   Returns the vector, or NULL if an error occurred.
+ */
+static struct vector *serializer_batch_vector(const struct serializer_batch_member *member) {
+  if (member->payload != NULL) {
+    return vector_unserialize_binary(member->payload, member->payload_length);
+  }
+  struct vector *object = vector_create(member->columns);
+  if (object != NULL && serializer_parse_vector(member->value, object) == 1) {
+    vector_destroy(object);
+    return NULL;
+  }
+  return object;
+}
+
+/**
+ * Decodes one located matrix member.
+ *
+ * @param const struct serializer_batch_member *member
+ *   The member.
+ *
+ * @return struct matrix*
+ *   Returns the matrix, or NULL if an error occurred.
+ */
+static struct matrix *serializer_batch_matrix(const struct serializer_batch_member *member) {
+  if (member->payload != NULL) {
+    return matrix_unserialize_binary(member->payload, member->payload_length);
+  }
+  struct matrix *object = matrix_create(member->rows, member->columns);
+  if (object != NULL && serializer_parse_matrix(member->value, object) == 1) {
+    matrix_destroy(object);
+    return NULL;
+  }
+  return object;
+}
+
+/**
+ * Builds a vector batch from located members.
+ *
+ * @param struct serializer_batch_member *members
+ *   The members, freed by this function.
+ * @param int count
+ *   The number of members.
+ *
+ * @return struct vector_batch*
+ *   Returns the batch, or NULL if a member could not be decoded.
+ */
+static struct vector_batch *serializer_batch_build_vectors(struct serializer_batch_member *members, int count) {
+  struct vector_batch *batch = calloc(1, sizeof(struct vector_batch));
+  if (batch == NULL) {
+    free(members);
+    return NULL;
+  }
+  batch->keys = serializer_batch_keys(members, count);
+  batch->objects = calloc(count > 0 ? count : 1, sizeof(struct vector *));
+  int status = batch->keys == NULL || batch->objects == NULL ? 1 : 0;
+  for (int i = 0; i < count && status == 0; i++) {
+    batch->objects[batch->count] = serializer_batch_vector(&members[i]);
+    status = batch->objects[batch->count] == NULL ? 1 : 0;
+    batch->count += 1 - status;
+  }
+  free(members);
+  if (status == 1) {
+    vector_batch_destroy(batch);
+    return NULL;
+  }
+  return batch;
+}
+
+/**
+ * Builds a matrix batch from located members.
+ *
+ * @param struct serializer_batch_member *members
+ *   The members, freed by this function.
+ * @param int count
+ *   The number of members.
+ *
+ * @return struct matrix_batch*
+ *   Returns the batch, or NULL if a member could not be decoded.
+ */
+static struct matrix_batch *serializer_batch_build_matrices(struct serializer_batch_member *members, int count) {
+  struct matrix_batch *batch = calloc(1, sizeof(struct matrix_batch));
+  if (batch == NULL) {
+    free(members);
+    return NULL;
+  }
+  batch->keys = serializer_batch_keys(members, count);
+  batch->objects = calloc(count > 0 ? count : 1, sizeof(struct matrix *));
+  int status = batch->keys == NULL || batch->objects == NULL ? 1 : 0;
+  for (int i = 0; i < count && status == 0; i++) {
+    batch->objects[batch->count] = serializer_batch_matrix(&members[i]);
+    status = batch->objects[batch->count] == NULL ? 1 : 0;
+    batch->count += 1 - status;
+  }
+  free(members);
+  if (status == 1) {
+    matrix_batch_destroy(batch);
+    return NULL;
+  }
+  return batch;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int vector_serialize_batch_to_stream(const char **keys, struct vector **objects, int count, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  return serializer_batch_write(keys, objects, NULL, count, options, buffer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *vector_serialize_batch(const char **keys, struct vector **objects, int count, const struct serializer_options *options) {
+  return serializer_batch_serialize(keys, objects, NULL, count, options);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct vector_batch *vector_unserialize_batch(const char *data) {
+  struct serializer_batch_member *members;
+  int count;
+  if (data == NULL || serializer_batch_locate(data, 0, &members, &count) == 1) {
+    return NULL;
+  }
+  return serializer_batch_build_vectors(members, count);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void vector_batch_destroy(struct vector_batch *batch) {
+  if (batch == NULL) {
+    return;
+  }
+  for (int i = 0; i < batch->count; i++) {
+    vector_destroy(batch->objects[i]);
+  }
+  free(batch->objects);
+  free(batch->keys);
+  free(batch);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_serialize_batch_to_stream(const char **keys, struct matrix **objects, int count, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  return serializer_batch_write(keys, NULL, objects, count, options, buffer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *matrix_serialize_batch(const char **keys, struct matrix **objects, int count, const struct serializer_options *options) {
+  return serializer_batch_serialize(keys, NULL, objects, count, options);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix_batch *matrix_unserialize_batch(const char *data) {
+  struct serializer_batch_member *members;
+  int count;
+  if (data == NULL || serializer_batch_locate(data, 1, &members, &count) == 1) {
+    return NULL;
+  }
+  return serializer_batch_build_matrices(members, count);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void matrix_batch_destroy(struct matrix_batch *batch) {
+  if (batch == NULL) {
+    return;
+  }
+  for (int i = 0; i < batch->count; i++) {
+    matrix_destroy(batch->objects[i]);
+  }
+  free(batch->objects);
+  free(batch->keys);
+  free(batch);
+}
+
+/**
+ * Writes a binary bundle header.
+ *
+ * @param unsigned char *data
+ *   Pointer to at least SERIALIZER_BUNDLE_HEADER_SIZE bytes.
+ * @param const struct serializer_bundle_header *header
+ *   The header to write, in host byte order.
+ */
+static void serializer_bundle_write_header(unsigned char *data, const struct serializer_bundle_header *header) {
+  memset(data, 0, SERIALIZER_BUNDLE_HEADER_SIZE);
+  memcpy(data, SERIALIZER_BUNDLE_MAGIC, 4);
+  memcpy(data + 4, &header->version, 2);
+  data[6] = header->kind;
+  data[7] = header->endianness;
+  data[8] = header->flags;
+  memcpy(data + 12, &header->count, 4);
+  memcpy(data + 16, &header->checksum, 4);
+  memcpy(data + 20, &header->keys_length, 4);
+  memcpy(data + 24, &header->length, 8);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_bundle_read_header(const unsigned char *data, size_t length, struct serializer_bundle_header *header) {
+  // Validates the input.
+  if (data == NULL || header == NULL || length < SERIALIZER_BUNDLE_HEADER_SIZE) {
+    return 1;
+  }
+  if (memcmp(data, SERIALIZER_BUNDLE_MAGIC, 4) != 0) {
+    return 1;
+  }
+  // Only bundles written with the host byte order can be read.
+  header->endianness = data[7];
+  if (header->endianness != serializer_host_endianness()) {
+    return 1;
+  }
+  memcpy(&header->version, data + 4, 2);
+  header->kind = data[6];
+  header->flags = data[8];
+  memcpy(&header->count, data + 12, 4);
+  memcpy(&header->checksum, data + 16, 4);
+  memcpy(&header->keys_length, data + 20, 4);
+  memcpy(&header->length, data + 24, 8);
+  if (header->version != SERIALIZER_BUNDLE_VERSION || (header->flags & ~SERIALIZER_BUNDLE_FLAG_SORTED) != 0) {
+    return 1;
+  }
+  if (header->kind != SERIALIZER_BINARY_VECTOR && header->kind != SERIALIZER_BINARY_MATRIX) {
+    return 1;
+  }
+  // The index and the key block must fit the bundle, which must fit the data.
+  uint64_t keys_end = SERIALIZER_BUNDLE_HEADER_SIZE + (uint64_t)header->count * SERIALIZER_BUNDLE_ENTRY_SIZE + header->keys_length;
+  if (header->length > length || keys_end > header->length || header->keys_length % sizeof(long double) != 0) {
+    return 1;
+  }
+  uint32_t checksum = serializer_crc32(0, data + SERIALIZER_BUNDLE_HEADER_SIZE, keys_end - SERIALIZER_BUNDLE_HEADER_SIZE);
+  return checksum == header->checksum ? 0 : 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_bundle_read_entry(const unsigned char *data, const struct serializer_bundle_header *header, uint32_t index, struct serializer_bundle_entry *entry) {
+  // Validates the input.
+  if (data == NULL || header == NULL || entry == NULL || index >= header->count) {
+    return 1;
+  }
+  const unsigned char *cursor = data + SERIALIZER_BUNDLE_HEADER_SIZE + (size_t)index * SERIALIZER_BUNDLE_ENTRY_SIZE;
+  memcpy(&entry->key_offset, cursor, 8);
+  memcpy(&entry->key_length, cursor + 8, 4);
+  memcpy(&entry->payload_offset, cursor + 16, 8);
+  memcpy(&entry->payload_length, cursor + 24, 8);
+  // Keys live in the key block and are NUL-terminated.
+  uint64_t keys_start = SERIALIZER_BUNDLE_HEADER_SIZE + (uint64_t)header->count * SERIALIZER_BUNDLE_ENTRY_SIZE;
+  uint64_t keys_end = keys_start + header->keys_length;
+  if (entry->key_offset < keys_start || entry->key_offset >= keys_end || entry->key_length >= keys_end - entry->key_offset) {
+    return 1;
+  }
+  if (data[entry->key_offset + entry->key_length] != '\0' || memchr(data + entry->key_offset, '\0', entry->key_length) != NULL) {
+    return 1;
+  }
+  // Payloads follow the key block, aligned like the elements they hold.
+  if (entry->payload_offset < keys_end || entry->payload_offset > header->length || entry->payload_offset % sizeof(long double) != 0) {
+    return 1;
+  }
+  if (entry->payload_length < SERIALIZER_BINARY_HEADER_SIZE || entry->payload_length > header->length - entry->payload_offset) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * A key and the position of its object in the caller arrays.
+ */
+struct serializer_bundle_key {
+  // The key.
+  const char *key;
+  // The index of the object.
+  int index;
+};
+
+/**
+ * Orders bundle keys bytewise, like serializer_bundle_find() compares them.
+ *
+ * @param const void *a
+ *   The first struct serializer_bundle_key.
+ * @param const void *b
+ *   The second struct serializer_bundle_key.
+ *
+ * @return int
+ *   Returns a negative, zero or positive value like strcmp().
+ */
+static int serializer_bundle_key_compare(const void *a, const void *b) {
+  return strcmp(((const struct serializer_bundle_key *)a)->key, ((const struct serializer_bundle_key *)b)->key);
+}
+
+/**
+ * Lists the objects in the order they are written to a bundle.
+ *
+ * @param const char **keys
+ *   The keys.
+ * @param int count
+ *   The number of objects.
+ * @param uint8_t flags
+ *   The serializer_bundle_flag values.
+ *
+ * @return struct serializer_bundle_key*
+ *   Returns the malloc'd order, or NULL if the allocation failed or a sorted
+ *   bundle would hold the same key twice.
+ */
+static struct serializer_bundle_key *serializer_bundle_order(const char **keys, int count, uint8_t flags) {
+  struct serializer_bundle_key *order = malloc((count > 0 ? count : 1) * sizeof(struct serializer_bundle_key));
+  if (order == NULL) {
+    return NULL;
+  }
+  for (int i = 0; i < count; i++) {
+    order[i].key = keys[i];
+    order[i].index = i;
+  }
+  if ((flags & SERIALIZER_BUNDLE_FLAG_SORTED) == 0) {
+    return order;
+  }
+  // Lookups bisect the index, so every key must be unique.
+  qsort(order, count, sizeof(struct serializer_bundle_key), serializer_bundle_key_compare);
+  for (int i = 1; i < count; i++) {
+    if (strcmp(order[i - 1].key, order[i].key) == 0) {
+      free(order);
+      return NULL;
+    }
+  }
+  return order;
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *serializer_bundle_serialize(const char **keys, struct vector **vectors, struct matrix **matrices, int count, uint8_t kind, uint8_t flags, size_t *length) {
+  // Validates the input.
+  if (length == NULL || serializer_batch_check(keys, vectors, matrices, count) == 1) {
+    return NULL;
+  }
+  struct serializer_bundle_key *order = serializer_bundle_order(keys, count, flags);
+  if (order == NULL) {
+    return NULL;
+  }
+  // Size every block first, the bundle is allocated once.
+  size_t keys_length = 0;
+  size_t payloads_length = 0;
+  for (int i = 0; i < count; i++) {
+    keys_length += strlen(keys[i]) + 1;
+    size_t elements = vectors != NULL ? (size_t)vectors[i]->capacity : (size_t)matrices[i]->rows * matrices[i]->columns;
+    payloads_length += SERIALIZER_BINARY_HEADER_SIZE + elements * sizeof(long double);
+  }
+  keys_length = (keys_length + sizeof(long double) - 1) / sizeof(long double) * sizeof(long double);
+  size_t keys_start = SERIALIZER_BUNDLE_HEADER_SIZE + (size_t)count * SERIALIZER_BUNDLE_ENTRY_SIZE;
+  *length = keys_start + keys_length + payloads_length;
+  unsigned char *data = keys_length <= UINT32_MAX ? calloc(1, *length) : NULL;
+  if (data == NULL) {
+    free(order);
+    return NULL;
+  }
+  // Write the index, the keys and the payloads side by side.
+  size_t key_offset = keys_start;
+  size_t payload_offset = keys_start + keys_length;
+  for (int i = 0; i < count; i++) {
+    int source = order[i].index;
+    uint32_t key_length = (uint32_t)strlen(keys[source]);
+    uint64_t offsets[2] = {key_offset, payload_offset};
+    unsigned char *entry = data + SERIALIZER_BUNDLE_HEADER_SIZE + (size_t)i * SERIALIZER_BUNDLE_ENTRY_SIZE;
+    memcpy(data + key_offset, keys[source], key_length);
+    key_offset += key_length + 1;
+    int status;
+    uint64_t payload_length;
+    if (vectors != NULL) {
+      payload_length = SERIALIZER_BINARY_HEADER_SIZE + (uint64_t)vectors[source]->capacity * sizeof(long double);
+      status = serializer_binary_write_vector(data + payload_offset, vectors[source]);
+    }
+    else {
+      payload_length = SERIALIZER_BINARY_HEADER_SIZE + (uint64_t)matrices[source]->rows * matrices[source]->columns * sizeof(long double);
+      status = serializer_binary_write_matrix(data + payload_offset, matrices[source]);
+    }
+    if (status == 1) {
+      free(order);
+      free(data);
+      return NULL;
+    }
+    memcpy(entry, &offsets[0], 8);
+    memcpy(entry + 8, &key_length, 4);
+    memcpy(entry + 16, &offsets[1], 8);
+    memcpy(entry + 24, &payload_length, 8);
+    payload_offset += payload_length;
+  }
+  free(order);
+  struct serializer_bundle_header header = {
+    .version = SERIALIZER_BUNDLE_VERSION,
+    .kind = kind,
+    .endianness = serializer_host_endianness(),
+    .flags = flags,
+    .count = count,
+    .checksum = serializer_crc32(0, data + SERIALIZER_BUNDLE_HEADER_SIZE, keys_start + keys_length - SERIALIZER_BUNDLE_HEADER_SIZE),
+    .keys_length = keys_length,
+    .length = *length,
+  };
+  serializer_bundle_write_header(data, &header);
+  return data;
+}
+
+/**
+ * Reads the index of a binary bundle into members.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary bundle.
+ * @param size_t length
+ *   Number of bytes available at data.
+ * @param uint8_t kind
+ *   The expected kind of object.
+ * @param struct serializer_batch_member **members
+ *   Pointer receiving the malloc'd member array, the caller must free it.
+ * @param int *count
+ *   Pointer receiving the number of members.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the bundle is invalid.
+ */
+static int serializer_bundle_locate(const unsigned char *data, size_t length, uint8_t kind, struct serializer_batch_member **members, int *count) {
+  struct serializer_bundle_header header;
+  if (serializer_bundle_read_header(data, length, &header) == 1 || header.kind != kind || header.count > INT32_MAX) {
+    return 1;
+  }
+  *count = (int)header.count;
+  *members = calloc(*count > 0 ? *count : 1, sizeof(struct serializer_batch_member));
+  if (*members == NULL) {
+    return 1;
+  }
+  for (int i = 0; i < *count; i++) {
+    struct serializer_bundle_entry entry;
+    if (serializer_bundle_read_entry(data, &header, i, &entry) == 1) {
+      free(*members);
+      return 1;
+    }
+    (*members)[i].key = (const char *)data + entry.key_offset;
+    (*members)[i].key_length = entry.key_length;
+    (*members)[i].payload = data + entry.payload_offset;
+    (*members)[i].payload_length = entry.payload_length;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *vector_serialize_batch_binary(const char **keys, struct vector **objects, int count, size_t *length) {
+  return serializer_bundle_serialize(keys, objects, NULL, count, SERIALIZER_BINARY_VECTOR, 0, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct vector_batch *vector_unserialize_batch_binary(const unsigned char *data, size_t length) {
+  struct serializer_batch_member *members;
+  int count;
+  if (serializer_bundle_locate(data, length, SERIALIZER_BINARY_VECTOR, &members, &count) == 1) {
+    return NULL;
+  }
+  return serializer_batch_build_vectors(members, count);
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *matrix_serialize_batch_binary(const char **keys, struct matrix **objects, int count, size_t *length) {
+  return serializer_bundle_serialize(keys, NULL, objects, count, SERIALIZER_BINARY_MATRIX, 0, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix_batch *matrix_unserialize_batch_binary(const unsigned char *data, size_t length) {
+  struct serializer_batch_member *members;
+  int count;
+  if (serializer_bundle_locate(data, length, SERIALIZER_BINARY_MATRIX, &members, &count) == 1) {
+    return NULL;
+  }
+  return serializer_batch_build_matrices(members, count);
+}
@@ -0,0 +1,1154 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * CRC32 lookup table for the reflected IEEE 802.3 polynomial 0xEDB88320.
+ */
+static const uint32_t serializer_crc32_table[256] = {
+  0x00000000U, 0x77073096U, 0xee0e612cU, 0x990951baU, 0x076dc419U, 0x706af48fU,
+  0xe963a535U, 0x9e6495a3U, 0x0edb8832U, 0x79dcb8a4U, 0xe0d5e91eU, 0x97d2d988U,
+  0x09b64c2bU, 0x7eb17cbdU, 0xe7b82d07U, 0x90bf1d91U, 0x1db71064U, 0x6ab020f2U,
+  0xf3b97148U, 0x84be41deU, 0x1adad47dU, 0x6ddde4ebU, 0xf4d4b551U, 0x83d385c7U,
+  0x136c9856U, 0x646ba8c0U, 0xfd62f97aU, 0x8a65c9ecU, 0x14015c4fU, 0x63066cd9U,
+  0xfa0f3d63U, 0x8d080df5U, 0x3b6e20c8U, 0x4c69105eU, 0xd56041e4U, 0xa2677172U,
+  0x3c03e4d1U, 0x4b04d447U, 0xd20d85fdU, 0xa50ab56bU, 0x35b5a8faU, 0x42b2986cU,
+  0xdbbbc9d6U, 0xacbcf940U, 0x32d86ce3U, 0x45df5c75U, 0xdcd60dcfU, 0xabd13d59U,
+  0x26d930acU, 0x51de003aU, 0xc8d75180U, 0xbfd06116U, 0x21b4f4b5U, 0x56b3c423U,
+  0xcfba9599U, 0xb8bda50fU, 0x2802b89eU, 0x5f058808U, 0xc60cd9b2U, 0xb10be924U,
+  0x2f6f7c87U, 0x58684c11U, 0xc1611dabU, 0xb6662d3dU, 0x76dc4190U, 0x01db7106U,
+  0x98d220bcU, 0xefd5102aU, 0x71b18589U, 0x06b6b51fU, 0x9fbfe4a5U, 0xe8b8d433U,
+  0x7807c9a2U, 0x0f00f934U, 0x9609a88eU, 0xe10e9818U, 0x7f6a0dbbU, 0x086d3d2dU,
+  0x91646c97U, 0xe6635c01U, 0x6b6b51f4U, 0x1c6c6162U, 0x856530d8U, 0xf262004eU,
+  0x6c0695edU, 0x1b01a57bU, 0x8208f4c1U, 0xf50fc457U, 0x65b0d9c6U, 0x12b7e950U,
+  0x8bbeb8eaU, 0xfcb9887cU, 0x62dd1ddfU, 0x15da2d49U, 0x8cd37cf3U, 0xfbd44c65U,
+  0x4db26158U, 0x3ab551ceU, 0xa3bc0074U, 0xd4bb30e2U, 0x4adfa541U, 0x3dd895d7U,
+  0xa4d1c46dU, 0xd3d6f4fbU, 0x4369e96aU, 0x346ed9fcU, 0xad678846U, 0xda60b8d0U,
+  0x44042d73U, 0x33031de5U, 0xaa0a4c5fU, 0xdd0d7cc9U, 0x5005713cU, 0x270241aaU,
+  0xbe0b1010U, 0xc90c2086U, 0x5768b525U, 0x206f85b3U, 0xb966d409U, 0xce61e49fU,
+  0x5edef90eU, 0x29d9c998U, 0xb0d09822U, 0xc7d7a8b4U, 0x59b33d17U, 0x2eb40d81U,
+  0xb7bd5c3bU, 0xc0ba6cadU, 0xedb88320U, 0x9abfb3b6U, 0x03b6e20cU, 0x74b1d29aU,
+  0xead54739U, 0x9dd277afU, 0x04db2615U, 0x73dc1683U, 0xe3630b12U, 0x94643b84U,
+  0x0d6d6a3eU, 0x7a6a5aa8U, 0xe40ecf0bU, 0x9309ff9dU, 0x0a00ae27U, 0x7d079eb1U,
+  0xf00f9344U, 0x8708a3d2U, 0x1e01f268U, 0x6906c2feU, 0xf762575dU, 0x806567cbU,
+  0x196c3671U, 0x6e6b06e7U, 0xfed41b76U, 0x89d32be0U, 0x10da7a5aU, 0x67dd4accU,
+  0xf9b9df6fU, 0x8ebeeff9U, 0x17b7be43U, 0x60b08ed5U, 0xd6d6a3e8U, 0xa1d1937eU,
+  0x38d8c2c4U, 0x4fdff252U, 0xd1bb67f1U, 0xa6bc5767U, 0x3fb506ddU, 0x48b2364bU,
+  0xd80d2bdaU, 0xaf0a1b4cU, 0x36034af6U, 0x41047a60U, 0xdf60efc3U, 0xa867df55U,
+  0x316e8eefU, 0x4669be79U, 0xcb61b38cU, 0xbc66831aU, 0x256fd2a0U, 0x5268e236U,
+  0xcc0c7795U, 0xbb0b4703U, 0x220216b9U, 0x5505262fU, 0xc5ba3bbeU, 0xb2bd0b28U,
+  0x2bb45a92U, 0x5cb36a04U, 0xc2d7ffa7U, 0xb5d0cf31U, 0x2cd99e8bU, 0x5bdeae1dU,
+  0x9b64c2b0U, 0xec63f226U, 0x756aa39cU, 0x026d930aU, 0x9c0906a9U, 0xeb0e363fU,
+  0x72076785U, 0x05005713U, 0x95bf4a82U, 0xe2b87a14U, 0x7bb12baeU, 0x0cb61b38U,
+  0x92d28e9bU, 0xe5d5be0dU, 0x7cdcefb7U, 0x0bdbdf21U, 0x86d3d2d4U, 0xf1d4e242U,
+  0x68ddb3f8U, 0x1fda836eU, 0x81be16cdU, 0xf6b9265bU, 0x6fb077e1U, 0x18b74777U,
+  0x88085ae6U, 0xff0f6a70U, 0x66063bcaU, 0x11010b5cU, 0x8f659effU, 0xf862ae69U,
+  0x616bffd3U, 0x166ccf45U, 0xa00ae278U, 0xd70dd2eeU, 0x4e048354U, 0x3903b3c2U,
+  0xa7672661U, 0xd06016f7U, 0x4969474dU, 0x3e6e77dbU, 0xaed16a4aU, 0xd9d65adcU,
+  0x40df0b66U, 0x37d83bf0U, 0xa9bcae53U, 0xdebb9ec5U, 0x47b2cf7fU, 0x30b5ffe9U,
+  0xbdbdf21cU, 0xcabac28aU, 0x53b39330U, 0x24b4a3a6U, 0xbad03605U, 0xcdd70693U,
+  0x54de5729U, 0x23d967bfU, 0xb3667a2eU, 0xc4614ab8U, 0x5d681b02U, 0x2a6f2b94U,
+  0xb40bbe37U, 0xc30c8ea1U, 0x5a05df1bU, 0x2d02ef8dU
+};
+
+/**
+ * {@inheritdoc}
+ */
+uint32_t serializer_crc32(uint32_t crc, const void *data, size_t length) {
+  const unsigned char *bytes = data;
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc = serializer_crc32_table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/**
+ * {@inheritdoc}
+ */
+uint8_t serializer_host_endianness(void) {
+  const uint16_t probe = 1;
+  return *(const uint8_t *)&probe == 1 ? SERIALIZER_LITTLE_ENDIAN : SERIALIZER_BIG_ENDIAN;
+}
+
+/**
+ * Returns the element type code recorded for the host long double format.
+ *
+ * @return uint8_t
+ *   One of the serializer_element_type values.
+ */
+static uint8_t serializer_element_host_code(void) {
+#if LDBL_MANT_DIG == 64
+  return SERIALIZER_ELEMENT_EXTENDED80;
+#elif LDBL_MANT_DIG == 113
+  return SERIALIZER_ELEMENT_BINARY128;
+#elif LDBL_MANT_DIG == 106
+  return SERIALIZER_ELEMENT_DOUBLE_DOUBLE;
+#elif LDBL_MANT_DIG == 53
+  return SERIALIZER_ELEMENT_FLOAT64;
+#else
+  return SERIALIZER_ELEMENT_LONG_DOUBLE;
+#endif
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_binary_write_header(unsigned char *data, const struct serializer_binary_header *header) {
+  memset(data, 0, SERIALIZER_BINARY_HEADER_SIZE);
+  memcpy(data, SERIALIZER_BINARY_MAGIC, 4);
+  memcpy(data + 4, &header->version, 2);
+  data[6] = header->kind;
+  // Long double elements record which format they were written in.
+  data[7] = header->element_type == SERIALIZER_ELEMENT_LONG_DOUBLE ? serializer_element_host_code() : header->element_type;
+  data[8] = header->endianness;
+  data[9] = header->flags;
+  memcpy(data + 10, &header->element_size, 2);
+  memcpy(data + 12, &header->rows, 4);
+  memcpy(data + 16, &header->columns, 4);
+  memcpy(data + 20, &header->checksum, 4);
+  memcpy(data + 24, &header->payload_length, 8);
+}
+
+/**
+ * Rounds a block length up to a multiple of the element size.
+ *
+ * @param uint64_t length
+ *   The block length.
+ *
+ * @return uint64_t
+ *   Returns the padded block length.
+ */
+static uint64_t serializer_binary_align(uint64_t length) {
+  return (length + sizeof(long double) - 1) / sizeof(long double) * sizeof(long double);
+}
+
+/**
+ * Returns the stored size of an element type.
+ *
+ * @param uint8_t element_type
+ *   One of the serializer_element_type values.
+ *
+ * @return size_t
+ *   Returns the element size in bytes, or 0 if the element type is unknown.
+ */
+static size_t serializer_element_size(uint8_t element_type) {
+  switch (element_type) {
+    case SERIALIZER_ELEMENT_LONG_DOUBLE:
+      return sizeof(long double);
+
+    case SERIALIZER_ELEMENT_FLOAT64:
+      return sizeof(double);
+
+    case SERIALIZER_ELEMENT_FLOAT32:
+      return sizeof(float);
+
+    case SERIALIZER_ELEMENT_FLOAT16:
+    case SERIALIZER_ELEMENT_BFLOAT16:
+      return sizeof(uint16_t);
+
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Packs a value already rounded to a 16-bit binary format into its bits.
+ *
+ * @param long double value
+ *   The rounded value, see serializer_element_round().
+ * @param int fraction_bits
+ *   The number of stored significand bits of the format.
+ * @param int min_exponent
+ *   The exponent of the smallest normal value of the format.
+ *
+ * @return uint16_t
+ *   Returns the sign, biased exponent and fraction fields.
+ */
+static uint16_t serializer_narrow_pack(long double value, int fraction_bits, int min_exponent) {
+  uint16_t sign = signbit(value) ? 0x8000U : 0;
+  uint16_t special = (uint16_t)(0x7FFFU >> fraction_bits << fraction_bits);
+  if (isnan(value)) {
+    return (uint16_t)(sign | special | 1U << (fraction_bits - 1));
+  }
+  if (isinf(value)) {
+    return (uint16_t)(sign | special);
+  }
+  if (value == 0) {
+    return sign;
+  }
+  // Subnormals keep a zero exponent field and no implicit bit.
+  long double magnitude = fabsl(value);
+  int exponent = ilogbl(magnitude);
+  if (exponent < min_exponent) {
+    return (uint16_t)(sign | (uint16_t)ldexpl(magnitude, fraction_bits - min_exponent));
+  }
+  uint16_t fraction = (uint16_t)(ldexpl(magnitude, fraction_bits - exponent) - (1U << fraction_bits));
+  return (uint16_t)(sign | (uint16_t)(exponent - min_exponent + 1) << fraction_bits | fraction);
+}
+
+/**
+ * Widens the bits of a 16-bit binary format back to a long double.
+ *
+ * @param uint16_t bits
+ *   The sign, biased exponent and fraction fields.
+ * @param int fraction_bits
+ *   The number of stored significand bits of the format.
+ * @param int min_exponent
+ *   The exponent of the smallest normal value of the format.
+ *
+ * @return long double
+ *   Returns the exact value of the bits.
+ */
+static long double serializer_narrow_unpack(uint16_t bits, int fraction_bits, int min_exponent) {
+  unsigned field = (bits & 0x7FFFU) >> fraction_bits;
+  unsigned fraction = bits & ((1U << fraction_bits) - 1);
+  long double value;
+  if (field == 0x7FFFU >> fraction_bits) {
+    value = fraction != 0 ? NAN : INFINITY;
+  }
+  else if (field == 0) {
+    value = ldexpl(fraction, min_exponent - fraction_bits);
+  }
+  else {
+    value = ldexpl(fraction + (1U << fraction_bits), (int)field - 1 + min_exponent - fraction_bits);
+  }
+  return (bits & 0x8000U) != 0 ? -value : value;
+}
+
+/**
+ * Stores a value as an element of the given type.
+ *
+ * @param unsigned char *target
+ *   Zero-filled memory of the element size.
+ * @param long double value
+ *   The value to store, rounded to the element type.
+ * @param uint8_t element_type
+ *   One of the serializer_element_type values.
+ */
+static void serializer_element_encode(unsigned char *target, long double value, uint8_t element_type) {
+  switch (element_type) {
+    case SERIALIZER_ELEMENT_LONG_DOUBLE:
+      // Copy only the meaningful bytes, padding stays zeroed.
+      memcpy(target, &value, SERIALIZER_LDBL_BYTES);
+      break;
+
+    case SERIALIZER_ELEMENT_FLOAT64: {
+      double element = (double)value;
+      memcpy(target, &element, sizeof(double));
+      break;
+    }
+
+    case SERIALIZER_ELEMENT_FLOAT32: {
+      float element = (float)value;
+      memcpy(target, &element, sizeof(float));
+      break;
+    }
+
+    case SERIALIZER_ELEMENT_FLOAT16: {
+      uint16_t element = serializer_narrow_pack(serializer_element_round(value, element_type), 10, -14);
+      memcpy(target, &element, sizeof(uint16_t));
+      break;
+    }
+
+    case SERIALIZER_ELEMENT_BFLOAT16: {
+      uint16_t element = serializer_narrow_pack(serializer_element_round(value, element_type), 7, -126);
+      memcpy(target, &element, sizeof(uint16_t));
+      break;
+    }
+  }
+}
+
+/**
+ * Loads an element of the given type, widened to long double.
+ *
+ * @param const unsigned char *source
+ *   Pointer to the element.
+ * @param uint8_t element_type
+ *   One of the serializer_element_type values.
+ *
+ * @return long double
+ *   Returns the exact value of the element.
+ */
+static long double serializer_element_decode(const unsigned char *source, uint8_t element_type) {
+  switch (element_type) {
+    case SERIALIZER_ELEMENT_FLOAT64: {
+      double element;
+      memcpy(&element, source, sizeof(double));
+      return element;
+    }
+
+    case SERIALIZER_ELEMENT_FLOAT32: {
+      float element;
+      memcpy(&element, source, sizeof(float));
+      return element;
+    }
+
+    case SERIALIZER_ELEMENT_FLOAT16: {
+      uint16_t element;
+      memcpy(&element, source, sizeof(uint16_t));
+      return serializer_narrow_unpack(element, 10, -14);
+    }
+
+    case SERIALIZER_ELEMENT_BFLOAT16: {
+      uint16_t element;
+      memcpy(&element, source, sizeof(uint16_t));
+      return serializer_narrow_unpack(element, 7, -126);
+    }
+
+    default: {
+      long double element;
+      memcpy(&element, source, sizeof(long double));
+      return element;
+    }
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_binary_read_header(const unsigned char *data, size_t length, struct serializer_binary_header *header) {
+  // Validates the input.
+  if (data == NULL || header == NULL || length < SERIALIZER_BINARY_HEADER_SIZE) {
+    return 1;
+  }
+  if (memcmp(data, SERIALIZER_BINARY_MAGIC, 4) != 0) {
+    return 1;
+  }
+  // Only payloads written with the host byte order can be read.
+  header->endianness = data[8];
+  if (header->endianness != serializer_host_endianness()) {
+    return 1;
+  }
+  memcpy(&header->version, data + 4, 2);
+  header->kind = data[6];
+  header->element_type = data[7];
+  header->flags = data[9];
+  memcpy(&header->element_size, data + 10, 2);
+  memcpy(&header->rows, data + 12, 4);
+  memcpy(&header->columns, data + 16, 4);
+  memcpy(&header->checksum, data + 20, 4);
+  memcpy(&header->payload_length, data + 24, 8);
+  if (header->version != SERIALIZER_BINARY_VERSION) {
+    return 1;
+  }
+  // Long double elements are only read back in the format they were written
+  // in; other long double formats have no element size and are rejected below.
+  if (header->element_type == serializer_element_host_code()) {
+    header->element_type = SERIALIZER_ELEMENT_LONG_DOUBLE;
+  }
+  else if (header->element_type == SERIALIZER_ELEMENT_LONG_DOUBLE) {
+    return 1;
+  }
+  // Check the element block fits the declared shape and the given length.
+  if (serializer_element_size(header->element_type) == 0 || header->element_size != serializer_element_size(header->element_type)) {
+    return 1;
+  }
+  if (header->rows == 0 || header->columns == 0 || header->rows > INT32_MAX || header->columns > INT32_MAX) {
+    return 1;
+  }
+  if ((header->flags & ~(SERIALIZER_BINARY_FLAG_SPARSE | SERIALIZER_BINARY_FLAG_COLUMN_MAJOR | SERIALIZER_BINARY_FLAG_SHAPE)) != 0
+      || header->payload_length > length - SERIALIZER_BINARY_HEADER_SIZE) {
+    return 1;
+  }
+  // Tensors, and only them, open with their shape, which the decoder checks
+  // against the rows and columns.
+  if (((header->flags & SERIALIZER_BINARY_FLAG_SHAPE) != 0) != (header->kind == SERIALIZER_BINARY_TENSOR)) {
+    return 1;
+  }
+  if (header->kind == SERIALIZER_BINARY_TENSOR) {
+    return header->flags != SERIALIZER_BINARY_FLAG_SHAPE || header->payload_length < serializer_binary_align(2 * sizeof(uint32_t)) ? 1 : 0;
+  }
+  // Only dense matrices have a column-major form.
+  if ((header->flags & SERIALIZER_BINARY_FLAG_COLUMN_MAJOR) != 0 && (header->kind != SERIALIZER_BINARY_MATRIX || (header->flags & SERIALIZER_BINARY_FLAG_SPARSE) != 0)) {
+    return 1;
+  }
+  // Sparse matrices hold at least their row offsets, the rest depends on them.
+  if ((header->flags & SERIALIZER_BINARY_FLAG_SPARSE) != 0) {
+    if (header->kind != SERIALIZER_BINARY_MATRIX || header->payload_length < serializer_binary_align(((uint64_t)header->rows + 1) * sizeof(uint64_t))) {
+      return 1;
+    }
+    return 0;
+  }
+  if ((uint64_t)header->rows * header->columns > UINT64_MAX / header->element_size
+      || header->payload_length != (uint64_t)header->rows * header->columns * header->element_size) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Writes the header of a binary payload.
+ *
+ * @param unsigned char *data
+ *   Pointer to the binary payload.
+ * @param uint8_t kind
+ *   The kind of object stored.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ * @param size_t payload_length
+ *   The length of the element block.
+ * @param uint8_t flags
+ *   The serializer_binary_flag values describing the element block.
+ */
+static void serializer_binary_init(unsigned char *data, uint8_t kind, uint8_t element_type, int rows, int columns, size_t payload_length, uint8_t flags) {
+  struct serializer_binary_header header = {
+    .version = SERIALIZER_BINARY_VERSION,
+    .kind = kind,
+    .element_type = element_type,
+    .endianness = serializer_host_endianness(),
+    .flags = flags,
+    .element_size = serializer_element_size(element_type),
+    .rows = rows,
+    .columns = columns,
+    .payload_length = payload_length,
+  };
+  serializer_binary_write_header(data, &header);
+}
+
+/**
+ * Allocates a binary payload and writes its header.
+ *
+ * @param uint8_t kind
+ *   The kind of object stored.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ * @param size_t payload_length
+ *   The length of the element block.
+ * @param uint8_t flags
+ *   The serializer_binary_flag values describing the element block.
+ * @param size_t *length
+ *   Pointer receiving the total payload length.
+ *
+ * @return unsigned char*
+ *   Returns the zero-filled payload, or NULL if the allocation failed.
+ */
+static unsigned char *serializer_binary_allocate(uint8_t kind, uint8_t element_type, int rows, int columns, size_t payload_length, uint8_t flags, size_t *length) {
+  *length = SERIALIZER_BINARY_HEADER_SIZE + payload_length;
+  unsigned char *data = calloc(1, *length);
+  if (data == NULL) {
+    return NULL;
+  }
+  serializer_binary_init(data, kind, element_type, rows, columns, payload_length, flags);
+  return data;
+}
+
+/**
+ * Computes and stores the checksum of a binary payload.
+ *
+ * @param unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   The total payload length.
+ */
+static void serializer_binary_seal(unsigned char *data, size_t length) {
+  uint32_t checksum = serializer_crc32(0, data + SERIALIZER_BINARY_HEADER_SIZE, length - SERIALIZER_BINARY_HEADER_SIZE);
+  memcpy(data + 20, &checksum, 4);
+}
+
+/**
+ * Validates a binary payload of the given kind, including its checksum.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   Number of bytes available at data.
+ * @param uint8_t kind
+ *   The expected kind of object.
+ * @param struct serializer_binary_header *header
+ *   Pointer receiving the decoded header.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the payload is invalid.
+ */
+static int serializer_binary_check(const unsigned char *data, size_t length, uint8_t kind, struct serializer_binary_header *header) {
+  if (serializer_binary_read_header(data, length, header) == 1 || header->kind != kind) {
+    return 1;
+  }
+  uint32_t checksum = serializer_crc32(0, data + SERIALIZER_BINARY_HEADER_SIZE, header->payload_length);
+  return checksum == header->checksum ? 0 : 1;
+}
+
+/**
+ * Writes the dense binary payload of a vector with the given element type.
+ *
+ * @param unsigned char *data
+ *   Zero-filled memory of SERIALIZER_BINARY_HEADER_SIZE bytes plus one element
+ *   per vector element.
+ * @param struct vector *object
+ *   The vector to write, holding at least one element.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an element could not be read.
+ */
+static int serializer_binary_encode_vector(unsigned char *data, struct vector *object, uint8_t element_type) {
+  size_t element_size = serializer_element_size(element_type);
+  size_t payload_length = (size_t)object->capacity * element_size;
+  serializer_binary_init(data, SERIALIZER_BINARY_VECTOR, element_type, 1, object->capacity, payload_length, 0);
+  unsigned char *cursor = data + SERIALIZER_BINARY_HEADER_SIZE;
+  for (int i = 0; i < object->capacity; i++) {
+    long double *lvalue = vector_getl(object, i);
+    if (lvalue == NULL) {
+      return 1;
+    }
+    serializer_element_encode(cursor, *lvalue, element_type);
+    cursor += element_size;
+  }
+  serializer_binary_seal(data, SERIALIZER_BINARY_HEADER_SIZE + payload_length);
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_binary_write_vector(unsigned char *data, struct vector *object) {
+  return serializer_binary_encode_vector(data, object, SERIALIZER_ELEMENT_LONG_DOUBLE);
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *vector_serialize_binary(struct vector *object, size_t *length) {
+  return vector_serialize_binary_with_options(object, NULL, length);
+}
+
+/**
+ * Generates the binary representation of a Vector object.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+static unsigned char *vector_binary_encode(struct vector *object, const struct serializer_options *options, size_t *length) {
+  uint8_t element_type = options != NULL ? options->element_type : SERIALIZER_ELEMENT_LONG_DOUBLE;
+  // Validates the input.
+  if (object == NULL || length == NULL || object->capacity <= 0 || serializer_element_size(element_type) == 0) {
+    return NULL;
+  }
+  *length = SERIALIZER_BINARY_HEADER_SIZE + (size_t)object->capacity * serializer_element_size(element_type);
+  unsigned char *data = calloc(1, *length);
+  if (data == NULL) {
+    return NULL;
+  }
+  if (serializer_binary_encode_vector(data, object, element_type) == 1) {
+    free(data);
+    return NULL;
+  }
+  return data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *vector_serialize_binary_with_options(struct vector *object, const struct serializer_options *options, size_t *length) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  unsigned char *data = vector_binary_encode(object, options, length);
+  if (data != NULL) {
+    serializer_metrics_count(0, *length, *length);
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return data;
+}
+
+/**
+ * Creates a Vector object from its binary representation.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   The number of bytes in the payload.
+ *
+ * @return struct vector*
+ *   The unserialized Vector object is returned, otherwise NULL.
+ */
+static struct vector *vector_binary_decode(const unsigned char *data, size_t length) {
+  struct serializer_binary_header header;
+  if (serializer_binary_check(data, length, SERIALIZER_BINARY_VECTOR, &header) == 1 || header.rows != 1) {
+    return NULL;
+  }
+  struct vector *vector_object = serializer_vector_create(header.columns);
+  if (vector_object == NULL) {
+    return NULL;
+  }
+  // Copy the element block into the vector storage, narrower elements are
+  // widened one at a time.
+  long double *first = vector_getl(vector_object, 0);
+  long double *last = vector_getl(vector_object, vector_object->capacity - 1);
+  const unsigned char *payload = data + SERIALIZER_BINARY_HEADER_SIZE;
+  if (header.element_type == SERIALIZER_ELEMENT_LONG_DOUBLE && first != NULL && last != NULL && last - first == vector_object->capacity - 1) {
+    memcpy(first, payload, header.payload_length);
+    return vector_object;
+  }
+  for (int i = 0; i < vector_object->capacity; i++) {
+    vector_setl(vector_object, i, serializer_element_decode(payload + (size_t)i * header.element_size, header.element_type));
+  }
+  return vector_object;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct vector *vector_unserialize_binary(const unsigned char *data, size_t length) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  serializer_metrics_count(length, 0, 0);
+  struct vector *vector_object = vector_binary_decode(data, length);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return vector_object;
+}
+
+/**
+ * Writes the dense binary payload of a matrix with the given element type.
+ *
+ * @param unsigned char *data
+ *   Zero-filled memory of SERIALIZER_BINARY_HEADER_SIZE bytes plus one element
+ *   per matrix element.
+ * @param struct matrix *object
+ *   The matrix to write, holding at least one element.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an element could not be read.
+ */
+static int serializer_binary_encode_matrix(unsigned char *data, struct matrix *object, uint8_t element_type) {
+  size_t element_size = serializer_element_size(element_type);
+  size_t payload_length = (size_t)object->rows * object->columns * element_size;
+  serializer_binary_init(data, SERIALIZER_BINARY_MATRIX, element_type, object->rows, object->columns, payload_length, 0);
+  unsigned char *cursor = data + SERIALIZER_BINARY_HEADER_SIZE;
+  for (int j = 0; j < object->rows; j++) {
+    for (int k = 0; k < object->columns; k++) {
+      long double *lvalue = matrix_getl(object, j, k);
+      if (lvalue == NULL) {
+        return 1;
+      }
+      serializer_element_encode(cursor, *lvalue, element_type);
+      cursor += element_size;
+    }
+  }
+  serializer_binary_seal(data, SERIALIZER_BINARY_HEADER_SIZE + payload_length);
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_binary_write_matrix(unsigned char *data, struct matrix *object) {
+  return serializer_binary_encode_matrix(data, object, SERIALIZER_ELEMENT_LONG_DOUBLE);
+}
+
+/**
+ * Generates the dense binary representation of a Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+static unsigned char *matrix_serialize_binary_dense(struct matrix *object, uint8_t element_type, size_t *length) {
+  *length = SERIALIZER_BINARY_HEADER_SIZE + (size_t)object->rows * object->columns * serializer_element_size(element_type);
+  unsigned char *data = calloc(1, *length);
+  if (data == NULL) {
+    return NULL;
+  }
+  if (serializer_binary_encode_matrix(data, object, element_type) == 1) {
+    free(data);
+    return NULL;
+  }
+  return data;
+}
+
+/**
+ * Generates the dense column-major binary representation of a Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+static unsigned char *matrix_serialize_binary_columns(struct matrix *object, uint8_t element_type, size_t *length) {
+  size_t element_size = serializer_element_size(element_type);
+  size_t payload_length = (size_t)object->rows * object->columns * element_size;
+  unsigned char *data = serializer_binary_allocate(SERIALIZER_BINARY_MATRIX, element_type, object->rows, object->columns, payload_length, SERIALIZER_BINARY_FLAG_COLUMN_MAJOR, length);
+  long double *strip = malloc((size_t)SERIALIZER_TRANSPOSE_TILE * object->rows * sizeof(long double));
+  if (data == NULL || strip == NULL) {
+    free(data);
+    free(strip);
+    return NULL;
+  }
+  // Each transposed strip is already in storage order, it is encoded in one run.
+  unsigned char *cursor = data + SERIALIZER_BINARY_HEADER_SIZE;
+  int status = 0;
+  for (int first = 0; first < object->columns && status == 0; first += SERIALIZER_TRANSPOSE_TILE) {
+    int width = object->columns - first < SERIALIZER_TRANSPOSE_TILE ? object->columns - first : SERIALIZER_TRANSPOSE_TILE;
+    status = serializer_matrix_gather_columns(object, first, width, strip);
+    for (size_t i = 0; i < (size_t)width * object->rows && status == 0; i++) {
+      serializer_element_encode(cursor, strip[i], element_type);
+      cursor += element_size;
+    }
+  }
+  free(strip);
+  if (status == 1) {
+    free(data);
+    return NULL;
+  }
+  serializer_binary_seal(data, *length);
+  return data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *matrix_serialize_binary(struct matrix *object, size_t *length) {
+  return matrix_serialize_binary_with_options(object, NULL, length);
+}
+
+/**
+ * Generates the sparse binary representation of a Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param uint8_t element_type
+ *   The type of the stored elements.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+static unsigned char *matrix_serialize_binary_sparse(struct matrix *object, uint8_t element_type, size_t *length) {
+  // Count the stored elements first, the block sizes depend on it.
+  uint64_t stored = 0;
+  for (int j = 0; j < object->rows; j++) {
+    for (int k = 0; k < object->columns; k++) {
+      long double *lvalue = matrix_getl(object, j, k);
+      if (lvalue == NULL) {
+        return NULL;
+      }
+      stored += serializer_sparse_stored(*lvalue);
+    }
+  }
+  size_t offsets_length = serializer_binary_align(((uint64_t)object->rows + 1) * sizeof(uint64_t));
+  size_t indices_length = serializer_binary_align(stored * sizeof(uint32_t));
+  size_t element_size = serializer_element_size(element_type);
+  size_t payload_length = offsets_length + indices_length + stored * element_size;
+  unsigned char *data = serializer_binary_allocate(SERIALIZER_BINARY_MATRIX, element_type, object->rows, object->columns, payload_length, SERIALIZER_BINARY_FLAG_SPARSE, length);
+  if (data == NULL) {
+    return NULL;
+  }
+  // The first row offset stays zero from the allocation.
+  unsigned char *offsets = data + SERIALIZER_BINARY_HEADER_SIZE;
+  unsigned char *indices = offsets + offsets_length;
+  unsigned char *values = indices + indices_length;
+  uint64_t count = 0;
+  for (int j = 0; j < object->rows; j++) {
+    for (int k = 0; k < object->columns; k++) {
+      long double *lvalue = matrix_getl(object, j, k);
+      if (!serializer_sparse_stored(*lvalue)) {
+        continue;
+      }
+      uint32_t column = (uint32_t)k;
+      memcpy(indices + count * sizeof(uint32_t), &column, sizeof(uint32_t));
+      serializer_element_encode(values + count * element_size, *lvalue, element_type);
+      count++;
+    }
+    memcpy(offsets + ((size_t)j + 1) * sizeof(uint64_t), &count, sizeof(uint64_t));
+  }
+  serializer_binary_seal(data, *length);
+  return data;
+}
+
+/**
+ * Generates the binary representation of a Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+static unsigned char *matrix_binary_encode(struct matrix *object, const struct serializer_options *options, size_t *length) {
+  uint8_t element_type = options != NULL ? options->element_type : SERIALIZER_ELEMENT_LONG_DOUBLE;
+  int layout = options != NULL ? options->layout : SERIALIZER_LAYOUT_ROW_MAJOR;
+  // Validates the input.
+  if (object == NULL || length == NULL || object->rows <= 0 || object->columns <= 0 || serializer_element_size(element_type) == 0) {
+    return NULL;
+  }
+  if (layout == SERIALIZER_LAYOUT_COLUMN_MAJOR) {
+    return matrix_serialize_binary_columns(object, element_type, length);
+  }
+  if (layout != SERIALIZER_LAYOUT_ROW_MAJOR) {
+    return NULL;
+  }
+  if (serializer_matrix_use_sparse(object, options)) {
+    return matrix_serialize_binary_sparse(object, element_type, length);
+  }
+  return matrix_serialize_binary_dense(object, element_type, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *matrix_serialize_binary_with_options(struct matrix *object, const struct serializer_options *options, size_t *length) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  unsigned char *data = matrix_binary_encode(object, options, length);
+  if (data != NULL) {
+    serializer_metrics_count(0, *length, *length);
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return data;
+}
+
+/**
+ * Creates a Matrix object from a sparse binary payload.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload, already checked by serializer_binary_check().
+ * @param const struct serializer_binary_header *header
+ *   The decoded header.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_unserialize_binary_sparse(const unsigned char *data, const struct serializer_binary_header *header) {
+  // The last row offset gives the number of stored elements, which fixes the
+  // size of the other two blocks.
+  const unsigned char *offsets = data + SERIALIZER_BINARY_HEADER_SIZE;
+  uint64_t offsets_length = serializer_binary_align(((uint64_t)header->rows + 1) * sizeof(uint64_t));
+  uint64_t stored;
+  memcpy(&stored, offsets + (size_t)header->rows * sizeof(uint64_t), sizeof(uint64_t));
+  if (stored > (uint64_t)header->rows * header->columns) {
+    return NULL;
+  }
+  uint64_t indices_length = serializer_binary_align(stored * sizeof(uint32_t));
+  if (header->payload_length != offsets_length + indices_length + stored * header->element_size) {
+    return NULL;
+  }
+  const unsigned char *indices = offsets + offsets_length;
+  const unsigned char *values = indices + indices_length;
+  struct matrix *matrix_object = serializer_matrix_create(header->rows, header->columns);
+  if (matrix_object == NULL) {
+    return NULL;
+  }
+  // Zero each row, then set its stored elements; the offsets never decrease
+  // and the columns strictly increase within a row.
+  uint64_t previous;
+  memcpy(&previous, offsets, sizeof(uint64_t));
+  int status = previous == 0 ? 0 : 1;
+  for (int j = 0; j < matrix_object->rows && status == 0; j++) {
+    uint64_t offset;
+    memcpy(&offset, offsets + ((size_t)j + 1) * sizeof(uint64_t), sizeof(uint64_t));
+    if (offset < previous || offset > stored) {
+      status = 1;
+      break;
+    }
+    long double *row = serializer_matrix_row(matrix_object, j);
+    if (row != NULL) {
+      memset(row, 0, (size_t)matrix_object->columns * sizeof(long double));
+    }
+    else {
+      for (int k = 0; k < matrix_object->columns; k++) {
+        matrix_setl(matrix_object, j, k, 0.0L);
+      }
+    }
+    uint32_t next_column = 0;
+    for (uint64_t i = previous; i < offset; i++) {
+      uint32_t column;
+      memcpy(&column, indices + i * sizeof(uint32_t), sizeof(uint32_t));
+      if (column < next_column || column >= (uint32_t)matrix_object->columns) {
+        status = 1;
+        break;
+      }
+      long double value = serializer_element_decode(values + i * header->element_size, header->element_type);
+      if (row != NULL) {
+        row[column] = value;
+      }
+      else {
+        matrix_setl(matrix_object, j, (int)column, value);
+      }
+      next_column = column + 1;
+    }
+    previous = offset;
+  }
+  if (status == 1) {
+    matrix_destroy(matrix_object);
+    return NULL;
+  }
+  return matrix_object;
+}
+
+/**
+ * Creates a Matrix object from a dense column-major binary payload.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload, already checked by serializer_binary_check().
+ * @param const struct serializer_binary_header *header
+ *   The decoded header.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_unserialize_binary_columns(const unsigned char *data, const struct serializer_binary_header *header) {
+  struct matrix *matrix_object = serializer_matrix_create(header->rows, header->columns);
+  long double *strip = malloc((size_t)SERIALIZER_TRANSPOSE_TILE * header->rows * sizeof(long double));
+  if (matrix_object == NULL || strip == NULL) {
+    matrix_destroy(matrix_object);
+    free(strip);
+    return NULL;
+  }
+  // Decode a strip of columns in one run, then move it into the rows.
+  const unsigned char *cursor = data + SERIALIZER_BINARY_HEADER_SIZE;
+  for (int first = 0; first < matrix_object->columns; first += SERIALIZER_TRANSPOSE_TILE) {
+    int width = matrix_object->columns - first < SERIALIZER_TRANSPOSE_TILE ? matrix_object->columns - first : SERIALIZER_TRANSPOSE_TILE;
+    for (size_t i = 0; i < (size_t)width * matrix_object->rows; i++) {
+      strip[i] = serializer_element_decode(cursor, header->element_type);
+      cursor += header->element_size;
+    }
+    serializer_matrix_scatter_columns(matrix_object, first, width, strip);
+  }
+  free(strip);
+  return matrix_object;
+}
+
+/**
+ * Creates a Matrix object from its binary representation.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   The number of bytes in the payload.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_binary_decode(const unsigned char *data, size_t length) {
+  struct serializer_binary_header header;
+  if (serializer_binary_check(data, length, SERIALIZER_BINARY_MATRIX, &header) == 1) {
+    return NULL;
+  }
+  if ((header.flags & SERIALIZER_BINARY_FLAG_SPARSE) != 0) {
+    return matrix_unserialize_binary_sparse(data, &header);
+  }
+  if ((header.flags & SERIALIZER_BINARY_FLAG_COLUMN_MAJOR) != 0) {
+    return matrix_unserialize_binary_columns(data, &header);
+  }
+  struct matrix *matrix_object = serializer_matrix_create(header.rows, header.columns);
+  if (matrix_object == NULL) {
+    return NULL;
+  }
+  // Copy the element block into the matrix storage, one row at a time;
+  // narrower elements are widened one at a time.
+  const unsigned char *payload = data + SERIALIZER_BINARY_HEADER_SIZE;
+  size_t row_length = (size_t)matrix_object->columns * header.element_size;
+  for (int j = 0; j < matrix_object->rows; j++) {
+    const unsigned char *source = payload + (size_t)j * row_length;
+    long double *row = serializer_matrix_row(matrix_object, j);
+    if (row != NULL && header.element_type == SERIALIZER_ELEMENT_LONG_DOUBLE) {
+      memcpy(row, source, row_length);
+      continue;
+    }
+    for (int k = 0; k < matrix_object->columns; k++) {
+      long double value = serializer_element_decode(source + (size_t)k * header.element_size, header.element_type);
+      if (row != NULL) {
+        row[k] = value;
+      }
+      else {
+        matrix_setl(matrix_object, j, k, value);
+      }
+    }
+  }
+  return matrix_object;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize_binary(const unsigned char *data, size_t length) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  serializer_metrics_count(length, 0, 0);
+  struct matrix *matrix_object = matrix_binary_decode(data, length);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return matrix_object;
+}
+
+/**
+ * Returns the length of the shape block of a tensor binary payload.
+ *
+ * @param int rank
+ *   The number of dimensions.
+ *
+ * @return size_t
+ *   The rank and the extents as uint32 values, padded to keep the elements
+ *   aligned.
+ */
+static size_t serializer_binary_shape_length(int rank) {
+  return serializer_binary_align(((uint64_t)rank + 1) * sizeof(uint32_t));
+}
+
+/**
+ * Generates the binary representation of a tensor.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param size_t *length
+ *   Pointer receiving the number of bytes written.
+ *
+ * @return unsigned char*
+ *   Returns the binary payload, or NULL if the serialization fails.
+ */
+static unsigned char *tensor_binary_encode(const struct serializer_tensor *tensor, const struct serializer_options *options, size_t *length) {
+  uint8_t element_type = options != NULL ? options->element_type : SERIALIZER_ELEMENT_LONG_DOUBLE;
+  size_t element_size = serializer_element_size(element_type);
+  // Validates the input.
+  if (tensor == NULL || length == NULL || element_size == 0) {
+    return NULL;
+  }
+  int columns = tensor->shape[tensor->rank - 1];
+  size_t shape_length = serializer_binary_shape_length(tensor->rank);
+  unsigned char *data = serializer_binary_allocate(SERIALIZER_BINARY_TENSOR, element_type, (int)(tensor->count / columns), columns,
+    shape_length + tensor->count * element_size, SERIALIZER_BINARY_FLAG_SHAPE, length);
+  if (data == NULL) {
+    return NULL;
+  }
+  unsigned char *cursor = data + SERIALIZER_BINARY_HEADER_SIZE;
+  uint32_t extent = (uint32_t)tensor->rank;
+  memcpy(cursor, &extent, sizeof(uint32_t));
+  for (int i = 0; i < tensor->rank; i++) {
+    extent = (uint32_t)tensor->shape[i];
+    memcpy(cursor + ((size_t)i + 1) * sizeof(uint32_t), &extent, sizeof(uint32_t));
+  }
+  // The elements are already contiguous, full-width ones are copied at once.
+  cursor += shape_length;
+  if (element_type == SERIALIZER_ELEMENT_LONG_DOUBLE && SERIALIZER_LDBL_BYTES == sizeof(long double)) {
+    memcpy(cursor, tensor->values, tensor->count * element_size);
+  }
+  else {
+    for (size_t i = 0; i < tensor->count; i++) {
+      serializer_element_encode(cursor + i * element_size, tensor->values[i], element_type);
+    }
+  }
+  serializer_binary_seal(data, *length);
+  return data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *tensor_serialize_binary(const struct serializer_tensor *tensor, const struct serializer_options *options, size_t *length) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  unsigned char *data = tensor_binary_encode(tensor, options, length);
+  if (data != NULL) {
+    serializer_metrics_count(0, *length, *length);
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return data;
+}
+
+/**
+ * Creates a tensor from its binary representation.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the binary payload.
+ * @param size_t length
+ *   The number of bytes in the payload.
+ *
+ * @return struct serializer_tensor*
+ *   The unserialized tensor is returned, otherwise NULL.
+ */
+static struct serializer_tensor *tensor_binary_decode(const unsigned char *data, size_t length) {
+  struct serializer_binary_header header;
+  if (serializer_binary_check(data, length, SERIALIZER_BINARY_TENSOR, &header) == 1) {
+    return NULL;
+  }
+  // The shape must fit its block and agree with the rows and columns.
+  const unsigned char *payload = data + SERIALIZER_BINARY_HEADER_SIZE;
+  uint32_t rank;
+  memcpy(&rank, payload, sizeof(uint32_t));
+  if (rank == 0 || rank > SERIALIZER_TENSOR_MAX_RANK || serializer_binary_shape_length((int)rank) > header.payload_length) {
+    return NULL;
+  }
+  int shape[SERIALIZER_TENSOR_MAX_RANK];
+  uint64_t rows = 1;
+  for (uint32_t i = 0; i < rank; i++) {
+    uint32_t extent;
+    memcpy(&extent, payload + ((size_t)i + 1) * sizeof(uint32_t), sizeof(uint32_t));
+    if (extent == 0 || extent > INT32_MAX) {
+      return NULL;
+    }
+    shape[i] = (int)extent;
+    rows *= i + 1 < rank ? extent : 1;
+    if (rows > INT32_MAX) {
+      return NULL;
+    }
+  }
+  size_t shape_length = serializer_binary_shape_length((int)rank);
+  if (rows != header.rows || (uint32_t)shape[rank - 1] != header.columns
+      || header.payload_length != shape_length + (uint64_t)header.rows * header.columns * header.element_size) {
+    return NULL;
+  }
+  struct serializer_tensor *tensor = serializer_tensor_create((int)rank, shape);
+  if (tensor == NULL) {
+    return NULL;
+  }
+  // One copy for full-width elements, narrower ones are widened one at a time.
+  const unsigned char *source = payload + shape_length;
+  if (header.element_type == SERIALIZER_ELEMENT_LONG_DOUBLE) {
+    memcpy(tensor->values, source, tensor->count * header.element_size);
+  }
+  else {
+    for (size_t i = 0; i < tensor->count; i++) {
+      tensor->values[i] = serializer_element_decode(source + i * header.element_size, header.element_type);
+    }
+  }
+  return tensor;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_tensor *tensor_unserialize_binary(const unsigned char *data, size_t length) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  serializer_metrics_count(length, 0, 0);
+  struct serializer_tensor *tensor = tensor_binary_decode(data, length);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return tensor;
+}
@@ -0,0 +1,206 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *vector_serialize_indexed(const char **keys, struct vector **objects, int count, size_t *length) {
+  return serializer_bundle_serialize(keys, objects, NULL, count, SERIALIZER_BINARY_VECTOR, SERIALIZER_BUNDLE_FLAG_SORTED, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *matrix_serialize_indexed(const char **keys, struct matrix **objects, int count, size_t *length) {
+  return serializer_bundle_serialize(keys, NULL, objects, count, SERIALIZER_BINARY_MATRIX, SERIALIZER_BUNDLE_FLAG_SORTED, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_write_indexed_file(const char *path, const char **keys, struct matrix **objects, int count) {
+  // Validates the input.
+  if (path == NULL) {
+    return 1;
+  }
+  // Serialize the bundle.
+  size_t length = 0;
+  unsigned char *data = matrix_serialize_indexed(keys, objects, count, &length);
+  if (data == NULL) {
+    return 1;
+  }
+  // Write the bundle to the file.
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    free(data);
+    return 1;
+  }
+  int status = fwrite(data, 1, length, file) == length ? 0 : 1;
+  if (fclose(file) != 0) {
+    status = 1;
+  }
+  free(data);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_bundle *serializer_bundle_open(const unsigned char *data, size_t length) {
+  struct serializer_bundle_header header;
+  if (serializer_bundle_read_header(data, length, &header) == 1 || (header.flags & SERIALIZER_BUNDLE_FLAG_SORTED) == 0) {
+    return NULL;
+  }
+  struct serializer_bundle *bundle = malloc(sizeof(struct serializer_bundle));
+  if (bundle == NULL) {
+    return NULL;
+  }
+  bundle->data = data;
+  bundle->length = length;
+  bundle->header = header;
+  bundle->mapping = NULL;
+  bundle->mapping_length = 0;
+  return bundle;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_bundle *serializer_bundle_map_file(const char *path) {
+  // Validates the input.
+  if (path == NULL) {
+    return NULL;
+  }
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < SERIALIZER_BUNDLE_HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+  // Map the whole file, the descriptor is not needed once mapped.
+  size_t length = (size_t)info.st_size;
+  void *mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return NULL;
+  }
+  // Only the header and the index are read here.
+  struct serializer_bundle *bundle = serializer_bundle_open(mapping, length);
+  if (bundle == NULL) {
+    munmap(mapping, length);
+    return NULL;
+  }
+  bundle->mapping = mapping;
+  bundle->mapping_length = length;
+  return bundle;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_bundle_close(struct serializer_bundle *bundle) {
+  if (bundle == NULL) {
+    return;
+  }
+  if (bundle->mapping != NULL) {
+    munmap(bundle->mapping, bundle->mapping_length);
+  }
+  free(bundle);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_bundle_find(const struct serializer_bundle *bundle, const char *key, struct serializer_bundle_entry *entry) {
+  // Validates the input.
+  if (bundle == NULL || key == NULL || entry == NULL) {
+    return 1;
+  }
+  // Bisect the index, comparing keys bytewise like the writer sorted them.
+  size_t length = strlen(key);
+  uint32_t low = 0;
+  uint32_t high = bundle->header.count;
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (serializer_bundle_read_entry(bundle->data, &bundle->header, middle, entry) == 1) {
+      return 1;
+    }
+    size_t shortest = length < entry->key_length ? length : entry->key_length;
+    int order = memcmp(key, bundle->data + entry->key_offset, shortest);
+    if (order == 0) {
+      order = length < entry->key_length ? -1 : length > entry->key_length ? 1 : 0;
+    }
+    if (order == 0) {
+      return 0;
+    }
+    if (order < 0) {
+      high = middle;
+    }
+    else {
+      low = middle + 1;
+    }
+  }
+  return 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct vector *vector_bundle_get(const struct serializer_bundle *bundle, const char *key) {
+  struct serializer_bundle_entry entry;
+  if (serializer_bundle_find(bundle, key, &entry) == 1) {
+    return NULL;
+  }
+  // Only this payload is touched, it carries its own checksum.
+  return vector_unserialize_binary(bundle->data + entry.payload_offset, entry.payload_length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_bundle_get(const struct serializer_bundle *bundle, const char *key) {
+  struct serializer_bundle_entry entry;
+  if (serializer_bundle_find(bundle, key, &entry) == 1) {
+    return NULL;
+  }
+  // Only this payload is touched, it carries its own checksum.
+  return matrix_unserialize_binary(bundle->data + entry.payload_offset, entry.payload_length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_bundle_view(const struct serializer_bundle *bundle, const char *key, struct matrix_view *view) {
+  struct serializer_bundle_entry entry;
+  if (view == NULL || serializer_bundle_find(bundle, key, &entry) == 1) {
+    return 1;
+  }
+  const unsigned char *payload = bundle->data + entry.payload_offset;
+  struct serializer_binary_header header;
+  if (serializer_binary_read_header(payload, entry.payload_length, &header) == 1 || header.kind != SERIALIZER_BINARY_MATRIX || header.flags != 0
+      || header.element_type != SERIALIZER_ELEMENT_LONG_DOUBLE) {
+    return 1;
+  }
+  // The elements are read in place, so they must be aligned in memory.
+  const unsigned char *values = payload + SERIALIZER_BINARY_HEADER_SIZE;
+  if ((uintptr_t)values % sizeof(long double) != 0) {
+    return 1;
+  }
+  view->rows = header.rows;
+  view->columns = header.columns;
+  view->values = (const long double *)values;
+  view->mapping = NULL;
+  view->mapping_length = 0;
+  return 0;
+}
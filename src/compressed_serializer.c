@@ -0,0 +1,411 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * State of a compressed string being parsed into a matrix.
+ */
+struct compressed_text_reader {
+  // The matrix being filled.
+  struct matrix *object;
+  // The incremental parser fed with each plaintext block.
+  struct matrix_reader *reader;
+  // The number of rows read so far.
+  int rows;
+};
+
+/**
+ * State of a compressed binary payload being copied into a matrix.
+ */
+struct compressed_binary_reader {
+  // The matrix being filled, created once the payload header is read.
+  struct matrix *object;
+  // The shape recorded in the frame header.
+  uint32_t rows;
+  uint32_t columns;
+  // The payload header, then the bytes of the current element.
+  unsigned char staging[SERIALIZER_BINARY_HEADER_SIZE];
+  // The number of bytes in the staging area.
+  size_t staged;
+  // The decoded payload header.
+  struct serializer_binary_header header;
+  // The number of elements copied so far.
+  uint64_t elements;
+  // Checksum of the element block read so far.
+  uint32_t checksum;
+};
+
+/**
+ * Sink appending bytes to a growable buffer.
+ *
+ * @param const char *data
+ *   The bytes to append.
+ * @param size_t length
+ *   The number of bytes.
+ * @param void *context
+ *   The struct serializer_buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int compressed_collect(const char *data, size_t length, void *context) {
+  return serializer_buffer_write(context, data, length);
+}
+
+/**
+ * Runs an encoder into a growable buffer and returns the collected bytes.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The initialized buffer the encoder wrote into.
+ * @param int status
+ *   The encoder status.
+ * @param size_t *length
+ *   Pointer receiving the frame length.
+ *
+ * @return unsigned char*
+ *   Returns the frame, or NULL if the encoder failed.
+ */
+static unsigned char *compressed_detach(struct serializer_buffer *buffer, int status, size_t *length) {
+  if (status == 1) {
+    serializer_buffer_release(buffer);
+    return NULL;
+  }
+  return (unsigned char *)serializer_buffer_detach(buffer, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_serialize_compressed_to_sink(struct matrix *object, const struct serializer_options *options, serializer_sink sink, void *context) {
+  // Validates the input.
+  if (object == NULL || sink == NULL || object->rows <= 0 || object->columns <= 0) {
+    return 1;
+  }
+  // Keep the dense row-major form, the decoder reads the frame row by row.
+  struct serializer_options dense;
+  if (options != NULL) {
+    dense = *options;
+  }
+  else {
+    serializer_options_init(&dense);
+  }
+  dense.sparse = SERIALIZER_SPARSE_NEVER;
+  dense.layout = SERIALIZER_LAYOUT_ROW_MAJOR;
+  struct serializer_compressor *compressor = serializer_compressor_begin(sink, context, SERIALIZER_CONTENT_MATRIX_TEXT, object->rows, object->columns, SERIALIZER_FILTER_NONE, 1);
+  if (compressor == NULL) {
+    return 1;
+  }
+  // The text is compressed block by block while it is being written.
+  if (matrix_serialize_to_sink(object, &dense, serializer_compressor_write, compressor) == 1) {
+    compressor->error = 1;
+  }
+  return serializer_compressor_finish(compressor);
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *matrix_serialize_compressed(struct matrix *object, const struct serializer_options *options, size_t *length) {
+  struct serializer_buffer buffer;
+  if (length == NULL || serializer_buffer_init(&buffer, 0) == 1) {
+    return NULL;
+  }
+  int status = matrix_serialize_compressed_to_sink(object, options, compressed_collect, &buffer);
+  return compressed_detach(&buffer, status, length);
+}
+
+/**
+ * Streams the dense binary payload of a matrix into a compressor.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param struct serializer_compressor *compressor
+ *   The compressor.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrix_write_binary_compressed(struct matrix *object, struct serializer_compressor *compressor) {
+  // The checksum goes first, so it is computed in a pass of its own.
+  unsigned char header[SERIALIZER_BINARY_HEADER_SIZE];
+  struct serializer_binary_header fields = {
+    .version = SERIALIZER_BINARY_VERSION,
+    .kind = SERIALIZER_BINARY_MATRIX,
+    .element_type = SERIALIZER_ELEMENT_LONG_DOUBLE,
+    .endianness = serializer_host_endianness(),
+    .flags = 0,
+    .element_size = sizeof(long double),
+    .rows = object->rows,
+    .columns = object->columns,
+    .checksum = matrix_checksum(object),
+    .payload_length = (uint64_t)object->rows * object->columns * sizeof(long double),
+  };
+  serializer_binary_write_header(header, &fields);
+  if (serializer_compressor_write((const char *)header, sizeof(header), compressor) == 1) {
+    return 1;
+  }
+  // Same element bytes as matrix_serialize_binary(), padding zeroed.
+  unsigned char element[sizeof(long double)] = {0};
+  for (int j = 0; j < object->rows; j++) {
+    for (int k = 0; k < object->columns; k++) {
+      long double *lvalue = matrix_getl(object, j, k);
+      if (lvalue == NULL) {
+        return 1;
+      }
+      memcpy(element, lvalue, SERIALIZER_LDBL_BYTES);
+      if (serializer_compressor_write((const char *)element, sizeof(element), compressor) == 1) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+unsigned char *matrix_serialize_binary_compressed(struct matrix *object, size_t *length) {
+  // Validates the input.
+  if (object == NULL || length == NULL || object->rows <= 0 || object->columns <= 0) {
+    return NULL;
+  }
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init(&buffer, 0) == 1) {
+    return NULL;
+  }
+  int filter = SERIALIZER_FILTER_DELTA | SERIALIZER_FILTER_SHUFFLE;
+  struct serializer_compressor *compressor = serializer_compressor_begin(compressed_collect, &buffer, SERIALIZER_CONTENT_MATRIX_BINARY, object->rows, object->columns, filter, sizeof(long double));
+  if (compressor == NULL) {
+    serializer_buffer_release(&buffer);
+    return NULL;
+  }
+  if (matrix_write_binary_compressed(object, compressor) == 1) {
+    compressor->error = 1;
+  }
+  int status = serializer_compressor_finish(compressor);
+  return compressed_detach(&buffer, status, length);
+}
+
+/**
+ * Row callback copying the parsed rows into the matrix.
+ *
+ * @param const long double *row
+ *   The row values.
+ * @param int columns
+ *   The number of values in the row.
+ * @param void *context
+ *   The struct compressed_text_reader.
+ *
+ * @return int
+ *   Returns 0 to continue reading, otherwise 1 if the row does not fit.
+ */
+static int compressed_text_row(const long double *row, int columns, void *context) {
+  struct compressed_text_reader *state = context;
+  struct matrix *object = state->object;
+  if (columns != object->columns || state->rows >= object->rows) {
+    return 1;
+  }
+  long double *destination = serializer_matrix_row(object, state->rows);
+  if (destination != NULL) {
+    memcpy(destination, row, (size_t)columns * sizeof(long double));
+  }
+  else {
+    for (int k = 0; k < columns; k++) {
+      matrix_setl(object, state->rows, k, row[k]);
+    }
+  }
+  state->rows++;
+  return 0;
+}
+
+/**
+ * Sink feeding decompressed text to the incremental parser.
+ *
+ * @param const char *data
+ *   The plaintext block.
+ * @param size_t length
+ *   The block length.
+ * @param void *context
+ *   The struct compressed_text_reader.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int compressed_text_feed(const char *data, size_t length, void *context) {
+  struct compressed_text_reader *state = context;
+  return matrix_reader_feed(state->reader, data, length);
+}
+
+/**
+ * Checks the shape recorded in a frame header against the frame length.
+ *
+ * The header is not covered by any checksum, so the shape is only trusted when
+ * the frame could expand to enough plaintext to hold every element.
+ *
+ * @param size_t length
+ *   Number of bytes of the compressed frame.
+ * @param const struct serializer_compressed_header *header
+ *   The frame header.
+ * @param uint64_t element_bytes
+ *   The fewest plaintext bytes a single element can take.
+ *
+ * @return int
+ *   Returns 0 if the shape is plausible, otherwise 1.
+ */
+static int compressed_check_shape(size_t length, const struct serializer_compressed_header *header, uint64_t element_bytes) {
+  uint64_t plaintext = (uint64_t)(length - SERIALIZER_COMPRESSED_HEADER_SIZE) * SERIALIZER_COMPRESSION_MAX_EXPANSION;
+  return (uint64_t)header->rows * header->columns > plaintext / element_bytes ? 1 : 0;
+}
+
+/**
+ * Decodes a compressed matrix string.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the compressed frame.
+ * @param size_t length
+ *   Number of bytes of the compressed frame.
+ * @param const struct serializer_compressed_header *header
+ *   The frame header.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_unserialize_compressed_text(const unsigned char *data, size_t length, const struct serializer_compressed_header *header) {
+  // Every value takes at least one character and one separator.
+  if (compressed_check_shape(length, header, 2) == 1) {
+    return NULL;
+  }
+  struct compressed_text_reader state = {0};
+  state.object = matrix_create(header->rows, header->columns);
+  state.reader = matrix_reader_create(compressed_text_row, &state);
+  int status = state.object == NULL || state.reader == NULL ? 1 : 0;
+  if (status == 0) {
+    status = serializer_decompress(data, length, compressed_text_feed, &state);
+  }
+  // The text must be complete and hold exactly the recorded rows.
+  if (status == 0 && (matrix_reader_finish(state.reader) == 1 || state.rows != state.object->rows)) {
+    status = 1;
+  }
+  matrix_reader_destroy(state.reader);
+  if (status == 1) {
+    matrix_destroy(state.object);
+    return NULL;
+  }
+  return state.object;
+}
+
+/**
+ * Sink copying a decompressed binary payload into the matrix.
+ *
+ * @param const char *data
+ *   The plaintext block.
+ * @param size_t length
+ *   The block length.
+ * @param void *context
+ *   The struct compressed_binary_reader.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the payload is malformed.
+ */
+static int compressed_binary_feed(const char *data, size_t length, void *context) {
+  struct compressed_binary_reader *state = context;
+  const unsigned char *bytes = (const unsigned char *)data;
+  // Assemble the payload header, elements may only follow a valid one.
+  if (state->object == NULL) {
+    size_t take = SERIALIZER_BINARY_HEADER_SIZE - state->staged;
+    take = take < length ? take : length;
+    memcpy(state->staging + state->staged, bytes, take);
+    state->staged += take;
+    bytes += take;
+    length -= take;
+    if (state->staged < SERIALIZER_BINARY_HEADER_SIZE) {
+      return 0;
+    }
+    struct serializer_binary_header *header = &state->header;
+    if (serializer_binary_read_header(state->staging, SIZE_MAX, header) == 1 || header->kind != SERIALIZER_BINARY_MATRIX || header->flags != 0
+        || header->element_type != SERIALIZER_ELEMENT_LONG_DOUBLE) {
+      return 1;
+    }
+    if (header->rows != state->rows || header->columns != state->columns) {
+      return 1;
+    }
+    state->object = matrix_create(header->rows, header->columns);
+    if (state->object == NULL) {
+      return 1;
+    }
+    state->staged = 0;
+  }
+  uint64_t total = (uint64_t)state->rows * state->columns;
+  while (length > 0) {
+    if (state->elements == total) {
+      return 1;
+    }
+    size_t take = sizeof(long double) - state->staged;
+    take = take < length ? take : length;
+    memcpy(state->staging + state->staged, bytes, take);
+    state->staged += take;
+    bytes += take;
+    length -= take;
+    if (state->staged < sizeof(long double)) {
+      break;
+    }
+    state->checksum = serializer_crc32(state->checksum, state->staging, sizeof(long double));
+    long double value;
+    memcpy(&value, state->staging, sizeof(long double));
+    matrix_setl(state->object, (int)(state->elements / state->columns), (int)(state->elements % state->columns), value);
+    state->elements++;
+    state->staged = 0;
+  }
+  return 0;
+}
+
+/**
+ * Decodes a compressed binary matrix payload.
+ *
+ * @param const unsigned char *data
+ *   Pointer to the compressed frame.
+ * @param size_t length
+ *   Number of bytes of the compressed frame.
+ * @param const struct serializer_compressed_header *header
+ *   The frame header.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_unserialize_compressed_binary(const unsigned char *data, size_t length, const struct serializer_compressed_header *header) {
+  if (compressed_check_shape(length, header, sizeof(long double)) == 1) {
+    return NULL;
+  }
+  struct compressed_binary_reader state = {0};
+  state.rows = header->rows;
+  state.columns = header->columns;
+  int status = serializer_decompress(data, length, compressed_binary_feed, &state);
+  // Every element must be there and match the payload checksum.
+  if (status == 0 && (state.object == NULL || state.staged != 0 || state.elements != (uint64_t)state.rows * state.columns || state.checksum != state.header.checksum)) {
+    status = 1;
+  }
+  if (status == 1) {
+    matrix_destroy(state.object);
+    return NULL;
+  }
+  return state.object;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize_compressed(const unsigned char *data, size_t length) {
+  struct serializer_compressed_header header;
+  if (serializer_compressed_read_header(data, length, &header) == 1) {
+    return NULL;
+  }
+  switch (header.content) {
+    case SERIALIZER_CONTENT_MATRIX_TEXT:
+      return matrix_unserialize_compressed_text(data, length, &header);
+
+    case SERIALIZER_CONTENT_MATRIX_BINARY:
+      return matrix_unserialize_compressed_binary(data, length, &header);
+  }
+  return NULL;
+}
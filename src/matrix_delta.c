@@ -0,0 +1,371 @@
+#include <stdint.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Fields of a delta object, used to check that each appears exactly once.
+ */
+enum serializer_delta_field {
+  SERIALIZER_DELTA_FIELD_FORMAT = 1,
+  SERIALIZER_DELTA_FIELD_ROWS = 2,
+  SERIALIZER_DELTA_FIELD_COLUMNS = 4,
+  SERIALIZER_DELTA_FIELD_BASE = 8,
+  SERIALIZER_DELTA_FIELD_VERSION = 16,
+  SERIALIZER_DELTA_FIELD_CHANGES = 32,
+  SERIALIZER_DELTA_FIELD_ALL = 63,
+};
+
+/**
+ * How deep serializer_delta_walk() goes.
+ */
+enum serializer_delta_mode {
+  // Only check the syntax, the shape is not known yet.
+  SERIALIZER_DELTA_SKIP,
+  // Check the runs against the shape and convert every value.
+  SERIALIZER_DELTA_CHECK,
+  // Write the values into the destination.
+  SERIALIZER_DELTA_APPLY,
+};
+
+/**
+ * Location of the parts of a serialized delta.
+ */
+struct serializer_delta_layout {
+  // The number of rows.
+  int rows;
+  // The number of columns.
+  int columns;
+  // Version tag of the snapshot the delta applies to.
+  uint32_t base;
+  // Version tag of the snapshot the delta produces.
+  uint32_t version;
+  // Opening bracket of the changes array.
+  const char *changes;
+};
+
+/**
+ * Adds one element to a running version tag.
+ *
+ * @param uint32_t crc
+ *   The tag of the previous elements.
+ * @param const long double *value
+ *   The element.
+ *
+ * @return uint32_t
+ *   Returns the updated tag.
+ */
+static uint32_t serializer_delta_crc32(uint32_t crc, const long double *value) {
+  // Same bytes as a binary payload, the padding is zeroed.
+  unsigned char bytes[sizeof(long double)] = {0};
+  memcpy(bytes, value, SERIALIZER_LDBL_BYTES);
+  return serializer_crc32(crc, bytes, sizeof(bytes));
+}
+
+/**
+ * {@inheritdoc}
+ */
+uint32_t matrix_checksum(struct matrix *object) {
+  // Validates the input.
+  if (object == NULL || object->rows <= 0 || object->columns <= 0) {
+    return 0;
+  }
+  uint32_t crc = 0;
+  for (int j = 0; j < object->rows; j++) {
+    for (int k = 0; k < object->columns; k++) {
+      long double *lvalue = matrix_getl(object, j, k);
+      if (lvalue == NULL) {
+        return 0;
+      }
+      crc = serializer_delta_crc32(crc, lvalue);
+    }
+  }
+  return crc;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_serialize_delta_to_stream(struct matrix *previous, struct matrix *current, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  // Validates the input.
+  if (previous == NULL || current == NULL || buffer == NULL || current->rows <= 0 || current->columns <= 0
+      || previous->rows != current->rows || previous->columns != current->columns) {
+    return 1;
+  }
+  serializer_buffer_write_text(buffer, "{\"format\":\"delta\",\"rows\":");
+  serializer_buffer_write_integer(buffer, current->rows);
+  serializer_buffer_write_text(buffer, ",\"columns\":");
+  serializer_buffer_write_integer(buffer, current->columns);
+  serializer_buffer_write_text(buffer, ",\"changes\":[");
+  // One pass compares the snapshots and computes both version tags, which is
+  // why the tags are written after the changes.
+  uint32_t base = 0;
+  uint32_t version = 0;
+  int runs = 0;
+  int open = 0;
+  for (int j = 0; j < current->rows; j++) {
+    for (int k = 0; k < current->columns; k++) {
+      long double *before = matrix_getl(previous, j, k);
+      long double *after = matrix_getl(current, j, k);
+      if (before == NULL || after == NULL) {
+        return 1;
+      }
+      base = serializer_delta_crc32(base, before);
+      version = serializer_delta_crc32(version, after);
+      if (memcmp(before, after, SERIALIZER_LDBL_BYTES) == 0) {
+        if (open) {
+          serializer_buffer_write_text(buffer, "]]");
+          open = 0;
+        }
+        continue;
+      }
+      // Start a run at the first changed element, later ones extend it.
+      if (open) {
+        serializer_buffer_putc(buffer, ',');
+      }
+      else {
+        if (runs++ > 0) {
+          serializer_buffer_putc(buffer, ',');
+        }
+        serializer_buffer_putc(buffer, '[');
+        serializer_buffer_write_integer(buffer, j);
+        serializer_buffer_putc(buffer, ',');
+        serializer_buffer_write_integer(buffer, k);
+        serializer_buffer_write_text(buffer, ",[");
+        open = 1;
+      }
+      if (serializer_buffer_write_number(buffer, *after, options) == 1) {
+        return 1;
+      }
+    }
+  }
+  if (open) {
+    serializer_buffer_write_text(buffer, "]]");
+  }
+  serializer_buffer_write_text(buffer, "],\"base\":");
+  serializer_buffer_write_integer(buffer, base);
+  serializer_buffer_write_text(buffer, ",\"version\":");
+  serializer_buffer_write_integer(buffer, version);
+  serializer_buffer_putc(buffer, '}');
+  // Push any staged bytes into the sink, the error flag is sticky.
+  return serializer_buffer_flush(buffer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *matrix_serialize_delta(struct matrix *previous, struct matrix *current, const struct serializer_options *options) {
+  // Prepare the output buffer.
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init(&buffer, 0) == 1) {
+    return NULL;
+  }
+  if (matrix_serialize_delta_to_stream(previous, current, options, &buffer) == 1) {
+    serializer_buffer_release(&buffer);
+    return NULL;
+  }
+  return serializer_buffer_detach(&buffer, NULL);
+}
+
+/**
+ * Walks the changes array of a delta.
+ *
+ * Runs must be non-empty, start inside the matrix, stay inside it and come in
+ * row-major order without overlapping.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner, positioned before the opening bracket.
+ * @param const struct serializer_delta_layout *layout
+ *   The delta layout, only read past SERIALIZER_DELTA_SKIP.
+ * @param struct matrix *destination
+ *   The matrix written by SERIALIZER_DELTA_APPLY.
+ * @param int mode
+ *   One of the serializer_delta_mode values.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_delta_walk(struct serializer_scanner *scanner, const struct serializer_delta_layout *layout, struct matrix *destination, int mode) {
+  if (!serializer_scanner_consume(scanner, '[')) {
+    return 1;
+  }
+  if (serializer_scanner_consume(scanner, ']')) {
+    return 0;
+  }
+  uint64_t elements = mode == SERIALIZER_DELTA_SKIP ? 0 : (uint64_t)layout->rows * layout->columns;
+  uint64_t end = 0;
+  do {
+    uint64_t row = 0;
+    uint64_t column = 0;
+    if (!serializer_scanner_consume(scanner, '[') || serializer_scanner_read_integer(scanner, INT32_MAX, &row) == 1
+        || !serializer_scanner_consume(scanner, ',') || serializer_scanner_read_integer(scanner, INT32_MAX, &column) == 1
+        || !serializer_scanner_consume(scanner, ',') || !serializer_scanner_consume(scanner, '[')) {
+      return 1;
+    }
+    uint64_t position = 0;
+    if (mode != SERIALIZER_DELTA_SKIP) {
+      if (row >= (uint64_t)layout->rows || column >= (uint64_t)layout->columns) {
+        return 1;
+      }
+      position = row * layout->columns + column;
+      if (position < end) {
+        return 1;
+      }
+    }
+    // A run continues on the next row when it reaches the last column.
+    do {
+      long double value;
+      int token = mode == SERIALIZER_DELTA_SKIP ? serializer_scanner_skip_value(scanner) : serializer_scanner_read_value(scanner, &value);
+      if (token != SERIALIZER_TOKEN_NUMBER) {
+        return 1;
+      }
+      if (mode == SERIALIZER_DELTA_SKIP) {
+        continue;
+      }
+      if (position++ >= elements) {
+        return 1;
+      }
+      if (mode == SERIALIZER_DELTA_APPLY) {
+        matrix_setl(destination, (int)row, (int)column, value);
+      }
+      if (++column == (uint64_t)layout->columns) {
+        column = 0;
+        row++;
+      }
+    } while (serializer_scanner_consume(scanner, ','));
+    if (!serializer_scanner_consume(scanner, ']') || !serializer_scanner_consume(scanner, ']')) {
+      return 1;
+    }
+    end = position;
+  } while (serializer_scanner_consume(scanner, ','));
+  return serializer_scanner_consume(scanner, ']') ? 0 : 1;
+}
+
+/**
+ * Maps an object key to the delta field it names.
+ *
+ * @param const char *name
+ *   The first character of the key.
+ * @param size_t length
+ *   The key length.
+ *
+ * @return int
+ *   Returns one of the serializer_delta_field values, or 0 if the key is unknown.
+ */
+static int serializer_delta_field(const char *name, size_t length) {
+  static const char *names[] = {"format", "rows", "columns", "base", "version", "changes"};
+  for (int i = 0; i < 6; i++) {
+    if (strlen(names[i]) == length && memcmp(names[i], name, length) == 0) {
+      return 1 << i;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Finds the shape, the version tags and the changes of a serialized delta.
+ *
+ * The keys may come in any order, but each must appear exactly once.
+ *
+ * @param const char *data
+ *   The delta string.
+ * @param struct serializer_delta_layout *layout
+ *   Pointer receiving the layout.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_delta_locate(const char *data, struct serializer_delta_layout *layout) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  memset(layout, 0, sizeof(struct serializer_delta_layout));
+  if (!serializer_scanner_consume(&scanner, '{')) {
+    return 1;
+  }
+  int seen = 0;
+  do {
+    const char *name;
+    size_t length;
+    uint64_t value = 0;
+    if (serializer_scanner_read_key(&scanner, &name, &length) == 1) {
+      return 1;
+    }
+    int field = serializer_delta_field(name, length);
+    if (field == 0 || (seen & field) != 0) {
+      return 1;
+    }
+    seen |= field;
+    int status = 0;
+    switch (field) {
+      case SERIALIZER_DELTA_FIELD_FORMAT:
+        status = serializer_scanner_consume(&scanner, '"') && strncmp(scanner.cursor, "delta\"", 6) == 0 ? 0 : 1;
+        scanner.cursor += status == 0 ? 6 : 0;
+        break;
+
+      case SERIALIZER_DELTA_FIELD_ROWS:
+        status = serializer_scanner_read_integer(&scanner, INT32_MAX, &value);
+        layout->rows = (int)value;
+        break;
+
+      case SERIALIZER_DELTA_FIELD_COLUMNS:
+        status = serializer_scanner_read_integer(&scanner, INT32_MAX, &value);
+        layout->columns = (int)value;
+        break;
+
+      case SERIALIZER_DELTA_FIELD_BASE:
+        status = serializer_scanner_read_integer(&scanner, UINT32_MAX, &value);
+        layout->base = (uint32_t)value;
+        break;
+
+      case SERIALIZER_DELTA_FIELD_VERSION:
+        status = serializer_scanner_read_integer(&scanner, UINT32_MAX, &value);
+        layout->version = (uint32_t)value;
+        break;
+
+      default:
+        serializer_scanner_skip_whitespace(&scanner);
+        layout->changes = scanner.cursor;
+        status = serializer_delta_walk(&scanner, layout, NULL, SERIALIZER_DELTA_SKIP);
+        break;
+    }
+    if (status == 1) {
+      return 1;
+    }
+  } while (serializer_scanner_consume(&scanner, ','));
+  if (!serializer_scanner_consume(&scanner, '}') || !serializer_scanner_at_end(&scanner)) {
+    return 1;
+  }
+  return seen != SERIALIZER_DELTA_FIELD_ALL || layout->rows == 0 || layout->columns == 0 ? 1 : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_apply_delta(struct matrix *destination, const char *data, uint32_t *version) {
+  // Validates the input.
+  if (destination == NULL || data == NULL) {
+    return 1;
+  }
+  struct serializer_delta_layout layout;
+  if (serializer_delta_locate(data, &layout) == 1 || layout.rows != destination->rows || layout.columns != destination->columns) {
+    return 1;
+  }
+  // A delta only applies to the snapshot it was computed against.
+  if (version != NULL && *version != layout.base) {
+    return 1;
+  }
+  // Check every run and value first, so a bad delta writes nothing.
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, layout.changes);
+  if (serializer_delta_walk(&scanner, &layout, NULL, SERIALIZER_DELTA_CHECK) == 1) {
+    return 1;
+  }
+  serializer_scanner_init(&scanner, layout.changes);
+  if (serializer_delta_walk(&scanner, &layout, destination, SERIALIZER_DELTA_APPLY) == 1) {
+    return 1;
+  }
+  if (version != NULL) {
+    *version = layout.version;
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdlib.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_matrix_gather_columns(struct matrix *object, int first_column, int width, long double *target) {
+  long double *rows[SERIALIZER_TRANSPOSE_TILE];
+  for (int block = 0; block < object->rows; block += SERIALIZER_TRANSPOSE_TILE) {
+    int last = object->rows - block < SERIALIZER_TRANSPOSE_TILE ? object->rows : block + SERIALIZER_TRANSPOSE_TILE;
+    for (int j = block; j < last; j++) {
+      rows[j - block] = serializer_matrix_row(object, j);
+    }
+    // Transpose the tile, each column segment is written contiguously.
+    for (int k = 0; k < width; k++) {
+      long double *column = target + (size_t)k * object->rows;
+      for (int j = block; j < last; j++) {
+        const long double *row = rows[j - block];
+        if (row != NULL) {
+          column[j] = row[first_column + k];
+          continue;
+        }
+        // Rows that are not contiguous are read element by element.
+        long double *lvalue = matrix_getl(object, j, first_column + k);
+        if (lvalue == NULL) {
+          return 1;
+        }
+        column[j] = *lvalue;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_matrix_scatter_columns(struct matrix *object, int first_column, int width, const long double *source) {
+  long double *rows[SERIALIZER_TRANSPOSE_TILE];
+  for (int block = 0; block < object->rows; block += SERIALIZER_TRANSPOSE_TILE) {
+    int last = object->rows - block < SERIALIZER_TRANSPOSE_TILE ? object->rows : block + SERIALIZER_TRANSPOSE_TILE;
+    for (int j = block; j < last; j++) {
+      rows[j - block] = serializer_matrix_row(object, j);
+    }
+    // Transpose the tile, each row segment is written contiguously.
+    for (int j = block; j < last; j++) {
+      long double *row = rows[j - block];
+      for (int k = 0; k < width; k++) {
+        long double value = source[(size_t)k * object->rows + j];
+        if (row != NULL) {
+          row[first_column + k] = value;
+        }
+        else {
+          matrix_setl(object, j, first_column + k, value);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_write_matrix_columns(struct serializer_buffer *buffer, struct matrix *object, const struct serializer_options *options) {
+  // Columns are transposed a strip at a time, then formatted sequentially.
+  long double *strip = malloc((size_t)SERIALIZER_TRANSPOSE_TILE * object->rows * sizeof(long double));
+  if (strip == NULL) {
+    buffer->error = 1;
+    return 1;
+  }
+  int status = 0;
+  for (int first = 0; first < object->columns && status == 0; first += SERIALIZER_TRANSPOSE_TILE) {
+    int width = object->columns - first < SERIALIZER_TRANSPOSE_TILE ? object->columns - first : SERIALIZER_TRANSPOSE_TILE;
+    status = serializer_matrix_gather_columns(object, first, width, strip);
+    for (int k = 0; k < width && status == 0; k++) {
+      const long double *column = strip + (size_t)k * object->rows;
+      if (first + k > 0) {
+        serializer_buffer_putc(buffer, ',');
+      }
+      serializer_buffer_putc(buffer, '[');
+      for (int j = 0; j < object->rows && status == 0; j++) {
+        if (j > 0) {
+          serializer_buffer_putc(buffer, ',');
+        }
+        status = serializer_buffer_write_number(buffer, column[j], options);
+      }
+      serializer_buffer_putc(buffer, ']');
+    }
+  }
+  free(strip);
+  return status == 1 ? 1 : buffer->error;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize_with_options(const char *data, const struct serializer_options *options) {
+  int layout = options != NULL ? options->layout : SERIALIZER_LAYOUT_ROW_MAJOR;
+  // Validates the input.
+  if (data == NULL || (layout != SERIALIZER_LAYOUT_ROW_MAJOR && layout != SERIALIZER_LAYOUT_COLUMN_MAJOR)) {
+    return NULL;
+  }
+  if (layout == SERIALIZER_LAYOUT_ROW_MAJOR || serializer_sparse_text(data)) {
+    return matrix_unserialize((char *)data);
+  }
+  // The text holds one inner array per column.
+  int rows = 0;
+  int columns = 0;
+  if (serializer_scan_matrix_shape(data, &columns, &rows) == 1) {
+    return NULL;
+  }
+  struct matrix *matrix_object = serializer_matrix_create(rows, columns);
+  if (matrix_object == NULL) {
+    return NULL;
+  }
+  if (serializer_parse_matrix_columns(data, matrix_object) == 1) {
+    matrix_destroy(matrix_object);
+    return NULL;
+  }
+  return matrix_object;
+}
@@ -0,0 +1,147 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_write_binary_file(const char *path, struct matrix *object) {
+  // Validates the input.
+  if (path == NULL) {
+    return 1;
+  }
+  // Serialize the matrix.
+  size_t length = 0;
+  unsigned char *data = matrix_serialize_binary(object, &length);
+  if (data == NULL) {
+    return 1;
+  }
+  // Write the payload to the file.
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    free(data);
+    return 1;
+  }
+  int status = fwrite(data, 1, length, file) == length ? 0 : 1;
+  if (fclose(file) != 0) {
+    status = 1;
+  }
+  free(data);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix_view *matrix_map_file(const char *path) {
+  // Validates the input.
+  if (path == NULL) {
+    return NULL;
+  }
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < SERIALIZER_BINARY_HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+  // Map the whole file, the descriptor is not needed once mapped.
+  size_t length = (size_t)info.st_size;
+  void *mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return NULL;
+  }
+  // Only the header is read here, the element block is paged in on demand.
+  struct serializer_binary_header header;
+  if (serializer_binary_read_header(mapping, length, &header) == 1 || header.kind != SERIALIZER_BINARY_MATRIX || header.flags != 0
+      || header.element_type != SERIALIZER_ELEMENT_LONG_DOUBLE) {
+    munmap(mapping, length);
+    return NULL;
+  }
+  struct matrix_view *view = malloc(sizeof(struct matrix_view));
+  if (view == NULL) {
+    munmap(mapping, length);
+    return NULL;
+  }
+  view->rows = header.rows;
+  view->columns = header.columns;
+  view->values = (const long double *)((const unsigned char *)mapping + SERIALIZER_BINARY_HEADER_SIZE);
+  view->mapping = mapping;
+  view->mapping_length = length;
+  return view;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void matrix_unmap(struct matrix_view *view) {
+  if (view == NULL) {
+    return;
+  }
+  if (view->mapping != NULL) {
+    munmap(view->mapping, view->mapping_length);
+  }
+  free(view);
+}
+
+/**
+ * {@inheritdoc}
+ */
+const long double *matrix_view_getl(const struct matrix_view *view, int row, int column) {
+  if (view == NULL || row < 0 || column < 0 || row >= view->rows || column >= view->columns) {
+    return NULL;
+  }
+  return view->values + (size_t)row * view->columns + column;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_view_verify(const struct matrix_view *view) {
+  // Only mapped views carry a header with a checksum.
+  if (view == NULL || view->mapping == NULL) {
+    return 1;
+  }
+  struct serializer_binary_header header;
+  if (serializer_binary_read_header(view->mapping, view->mapping_length, &header) == 1) {
+    return 1;
+  }
+  uint32_t checksum = serializer_crc32(0, view->values, header.payload_length);
+  return checksum == header.checksum ? 0 : 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_view_to_matrix(const struct matrix_view *view) {
+  // Validates the input.
+  if (view == NULL) {
+    return NULL;
+  }
+  struct matrix *matrix_object = matrix_create(view->rows, view->columns);
+  if (matrix_object == NULL) {
+    return NULL;
+  }
+  // Copy the view into the matrix storage, one row at a time.
+  for (int j = 0; j < view->rows; j++) {
+    const long double *source = view->values + (size_t)j * view->columns;
+    long double *row = serializer_matrix_row(matrix_object, j);
+    if (row != NULL) {
+      memcpy(row, source, (size_t)view->columns * sizeof(long double));
+      continue;
+    }
+    for (int k = 0; k < view->columns; k++) {
+      matrix_setl(matrix_object, j, k, source[k]);
+    }
+  }
+  return matrix_object;
+}
@@ -1,29 +1,191 @@
 #include <stddef.h>
+#include <string.h>
 #include <json.h>
 #include <strutils.h>
 #include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
 
 /**
  * {@inheritdoc}
  */
 char *matrix_serialize(struct matrix *object) {
-  // Generates a JSON representation of the given Matrix object.
-  struct json *jobject = matrix_serialize_to_json(object);
-  if (jobject == NULL) {
+  return matrix_serialize_with_options(object, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *matrix_serialize_with_options(struct matrix *object, const struct serializer_options *options) {
+  // Check if NULL matrix object passed for serialization.
+  if (object == NULL) {
     return NULL;
   }
-  // Encode the JSON Matrix representation into a string.
-  char *json_string = json_encode(jobject);
-  // Clean up JSON Matrix object after encoding.
-  json_destroy(jobject);
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  // Prepare the output buffer, then stream the Matrix representation into it.
+  struct serializer_buffer buffer;
+  char *data = NULL;
+  if (serializer_buffer_init(&buffer, 0) == 0) {
+    if (matrix_serialize_to_stream(object, options, &buffer) == 1) {
+      serializer_buffer_release(&buffer);
+    }
+    else {
+      data = serializer_buffer_detach(&buffer, NULL);
+    }
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
   // Returning the JSON string.
-  return json_string;
+  return data;
 }
 
 /**
  * {@inheritdoc}
  */
-struct json *matrix_serialize_to_json(struct matrix *object) {
+int serializer_write_matrix_rows(struct serializer_buffer *buffer, struct matrix *object, const struct serializer_options *options, int first_row, int last_row) {
+  // Write the rows one element at a time, no intermediate JSON tree is built.
+  long double *lvalue;
+  for (int j = first_row; j < last_row; j++) {
+    if (j > 0) {
+      serializer_buffer_putc(buffer, ',');
+    }
+    serializer_buffer_putc(buffer, '[');
+    for (int k = 0; k < object->columns; k++) {
+      lvalue = matrix_getl(object, j, k);
+      if (lvalue == NULL) {
+        return 1;
+      }
+      if (k > 0) {
+        serializer_buffer_putc(buffer, ',');
+      }
+      if (serializer_buffer_write_number(buffer, *lvalue, options) == 1) {
+        return 1;
+      }
+    }
+    serializer_buffer_putc(buffer, ']');
+  }
+  return buffer->error;
+}
+
+/**
+ * Streams the JSON representation of a Matrix object into a buffer.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrix_write_stream(struct matrix *object, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  // Validates the input.
+  if (object == NULL || buffer == NULL) {
+    return 1;
+  }
+  int layout = options != NULL ? options->layout : SERIALIZER_LAYOUT_ROW_MAJOR;
+  if (layout != SERIALIZER_LAYOUT_ROW_MAJOR && layout != SERIALIZER_LAYOUT_COLUMN_MAJOR) {
+    return 1;
+  }
+  // Sparse matrices may be written in the CSR form instead.
+  uint64_t format = serializer_metrics_start();
+  int status = 0;
+  if (serializer_matrix_use_sparse(object, options)) {
+    status = serializer_write_matrix_sparse(buffer, object, options);
+  }
+  else {
+    serializer_buffer_putc(buffer, '[');
+    status = layout == SERIALIZER_LAYOUT_COLUMN_MAJOR
+      ? serializer_write_matrix_columns(buffer, object, options)
+      : serializer_write_matrix_rows(buffer, object, options, 0, object->rows);
+    serializer_buffer_putc(buffer, ']');
+  }
+  serializer_metrics_stop(SERIALIZER_PHASE_FORMAT, format);
+  if (status == 1) {
+    return 1;
+  }
+  // Push any staged bytes into the sink, the error flag is sticky.
+  return serializer_buffer_flush(buffer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_serialize_to_stream(struct matrix *object, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  // Sink buffers count their bytes as they are flushed.
+  size_t length = buffer != NULL ? buffer->length : 0;
+  int status = matrix_write_stream(object, options, buffer);
+  if (buffer != NULL && buffer->sink == NULL) {
+    serializer_metrics_count(0, buffer->length - length, 0);
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_serialize_to_sink(struct matrix *object, const struct serializer_options *options, serializer_sink sink, void *context) {
+  // Prepare a staging buffer attached to the sink.
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init_sink(&buffer, sink, context, 0) == 1) {
+    return 1;
+  }
+  // Stream the Matrix representation into the sink.
+  int status = matrix_serialize_to_stream(object, options, &buffer);
+  serializer_buffer_release(&buffer);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+size_t matrix_serialized_size(struct matrix *object, const struct serializer_options *options) {
+  // Validates the input.
+  if (object == NULL || object->rows <= 0 || object->columns <= 0) {
+    return 0;
+  }
+  // The legacy text has no fixed bound, its exact length is measured instead.
+  if (options != NULL && options->precision == SERIALIZER_PRECISION_LEGACY) {
+    size_t total = 0;
+    return matrix_serialize_to_sink(object, options, serializer_count_sink, &total) == 0 ? total : 0;
+  }
+  return serializer_matrix_size_bound(object->rows, object->columns, options);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_serialize_to_buffer(struct matrix *object, const struct serializer_options *options, char *data, size_t capacity, size_t *length) {
+  // Wrap the caller memory, nothing is allocated.
+  struct serializer_buffer buffer;
+  if (object == NULL || serializer_buffer_init_fixed(&buffer, data, capacity) == 1) {
+    return 1;
+  }
+  if (matrix_serialize_to_stream(object, options, &buffer) == 1) {
+    return 1;
+  }
+  // Terminate the string, the fixed buffer always keeps a spare byte.
+  data[buffer.length] = '\0';
+  if (length != NULL) {
+    *length = buffer.length;
+  }
+  return 0;
+}
+
+/**
+ * Builds the JSON tree of a Matrix object.
+ *
+ * @param struct matrix *object
+ *   The Matrix object to serialize.
+ *
+ * @return struct json*
+ *   The JSON array, or NULL if the serialization fails.
+ */
+static struct json *matrix_json_build(struct matrix *object) {
   // Check if NULL matrix object passed for serialization.
   if (object == NULL) {
     return NULL;
@@ -58,6 +220,19 @@ struct json *matrix_serialize_to_json(struct matrix *object) {
   return jobject;
 }
 
+/**
+ * {@inheritdoc}
+ */
+struct json *matrix_serialize_to_json(struct matrix *object) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  uint64_t tree = serializer_metrics_start();
+  struct json *jobject = matrix_json_build(object);
+  serializer_metrics_stop(SERIALIZER_PHASE_TREE, tree);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return jobject;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -78,73 +253,81 @@ struct json *matrix_serialize_to_json_object(const char *key, struct matrix *obj
 }
 
 /**
- * {@inheritdoc}
+ * Calculates the shape of a matrix stored in a JSON array.
+ *
+ * Null rows and null values are skipped, every other row must hold the same
+ * number of non-null values, as in the tree-less scanner.
+ *
+ * @param struct json *jobject
+ *   The JSON array representing the matrix.
+ * @param int *rows
+ *   Pointer receiving the number of rows.
+ * @param int *columns
+ *   Pointer receiving the number of columns.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the array holds no values or its
+ *   rows differ in width.
  */
-struct matrix *matrix_unserialize_from_json_object(struct json *jobject) {
-  // Validates the input.
-  if (jobject == NULL) {
-    return NULL;
-  }
-  // Check if the data passed is a JSON array.
-  if (jobject->type != JSON_array) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Check if the JSON array is empty.
-  struct json *current = jobject->value;
-  if (current == NULL) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Calculate the size of the matrix.
-  int rows = 0;
-  int columns = 0;
-  struct json *current_row = NULL;
-  for (struct json *rows_iterator = current; rows_iterator != NULL; rows_iterator = rows_iterator->next) {
+static int matrix_json_shape(struct json *jobject, int *rows, int *columns) {
+  uint64_t tree = serializer_metrics_start();
+  int status = 0;
+  *rows = 0;
+  *columns = 0;
+  for (struct json *rows_iterator = jobject->value; rows_iterator != NULL; rows_iterator = rows_iterator->next) {
     // Only count non-null values in the array.
-    if (rows_iterator->value != NULL) {
-      rows++;
-      current_row = rows_iterator->value;
+    if (rows_iterator->value == NULL) {
+      continue;
     }
-  }
-  if (current_row == NULL) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  for (struct json *columns_iterator = current_row; columns_iterator != NULL; columns_iterator = columns_iterator->next) {
-    // Only count non-null values in the array.
-    if (columns_iterator->value != NULL) {
-      columns++;
+    int count = 0;
+    for (struct json *columns_iterator = rows_iterator->value; columns_iterator != NULL; columns_iterator = columns_iterator->next) {
+      if (columns_iterator->value != NULL) {
+        count++;
+      }
+    }
+    // Every row must match the width of the first one.
+    if (*rows > 0 && count != *columns) {
+      status = 1;
+      break;
     }
+    *columns = count;
+    (*rows)++;
   }
+  serializer_metrics_stop(SERIALIZER_PHASE_TREE, tree);
   // Verify if the matrix contains only numeric values (no null values).
-  if (rows == 0 || columns == 0) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Create the matrix.
-  struct matrix *matrix_object = matrix_create(rows, columns);
-  if (matrix_object == NULL) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Fill the matrix.
+  return status == 1 || *rows == 0 || *columns == 0 ? 1 : 0;
+}
+
+/**
+ * Fills a matrix with the values stored in a JSON array.
+ *
+ * @param struct json *jobject
+ *   The JSON array representing the matrix.
+ * @param struct matrix *matrix_object
+ *   The matrix to fill, its shape must match matrix_json_shape().
+ */
+static void matrix_json_fill(struct json *jobject, struct matrix *matrix_object) {
+  uint64_t parse = serializer_metrics_start();
   int j = 0;
   int k = 0;
-  for (struct json *rows_iterator = current; rows_iterator != NULL; rows_iterator = rows_iterator->next) {
+  for (struct json *rows_iterator = jobject->value; rows_iterator != NULL; rows_iterator = rows_iterator->next) {
     // Only count non-null values in the array.
     if (rows_iterator->value == NULL) {
       continue;
     }
-    current_row = rows_iterator->value;
     k = 0;
-    for (struct json *columns_iterator = current_row; columns_iterator != NULL; columns_iterator = columns_iterator->next) {
+    for (struct json *columns_iterator = rows_iterator->value; columns_iterator != NULL; columns_iterator = columns_iterator->next) {
       // Only count non-null values in the array.
       if (columns_iterator->value == NULL) {
         continue;
       }
-      // Convert the number string into a long double value.
-      long double numeric_value = stold((char *)columns_iterator->value);
+      // Convert the number string into a long double value, the fast parser
+      // defers to stold() for anything it does not recognize.
+      char *number_string = (char *)columns_iterator->value;
+      long double numeric_value;
+      if (serializer_parse_number(number_string, strlen(number_string), &numeric_value) == 1) {
+        numeric_value = stold(number_string);
+      }
       // Add the long double value to the matrix object.
       matrix_setl(matrix_object, j, k, numeric_value);
       // Increment the column index.
@@ -153,6 +336,38 @@ struct matrix *matrix_unserialize_from_json_object(struct json *jobject) {
     // Increment the row index.
     j++;
   }
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+}
+
+/**
+ * Creates a Matrix object from a JSON array.
+ *
+ * @param struct json *jobject
+ *   The JSON array, destroyed if the conversion fails.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_json_read(struct json *jobject) {
+  // Validates the input.
+  if (jobject == NULL) {
+    return NULL;
+  }
+  // Check if the data passed is a non-empty JSON array.
+  int rows = 0;
+  int columns = 0;
+  if (jobject->type != JSON_array || matrix_json_shape(jobject, &rows, &columns) == 1) {
+    json_destroy(jobject);
+    return NULL;
+  }
+  // Create the matrix.
+  struct matrix *matrix_object = serializer_matrix_create(rows, columns);
+  if (matrix_object == NULL) {
+    json_destroy(jobject);
+    return NULL;
+  }
+  // Fill the matrix.
+  matrix_json_fill(jobject, matrix_object);
   // Return the matrix object.
   return matrix_object;
 }
@@ -160,28 +375,108 @@ struct matrix *matrix_unserialize_from_json_object(struct json *jobject) {
 /**
  * {@inheritdoc}
  */
-struct matrix *matrix_unserialize(char *data) {
+struct matrix *matrix_unserialize_from_json_object(struct json *jobject) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  struct matrix *matrix_object = matrix_json_read(jobject);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return matrix_object;
+}
+
+/**
+ * Creates a Matrix object from its JSON string.
+ *
+ * @param char *data
+ *   The serialized matrix string.
+ *
+ * @return struct matrix*
+ *   The unserialized Matrix object is returned, otherwise NULL.
+ */
+static struct matrix *matrix_text_read(char *data) {
   // Check if NULL JSON data passed for unserialization.
   if (data == NULL) {
     return NULL;
   }
-  // Decodes the given JSON array string.
-  struct json *jobject = json_decode(data);
-  if (jobject == NULL) {
+  // Scan the text once to infer the shape, no JSON tree is built.
+  int rows = 0;
+  int columns = 0;
+  if (serializer_scan_matrix_shape(data, &rows, &columns) == 1) {
     return NULL;
   }
-  // Unserialize the matrix object.
-  struct matrix *matrix_object = matrix_unserialize_from_json_object(jobject);
+  // Create the matrix object.
+  struct matrix *matrix_object = serializer_matrix_create(rows, columns);
   if (matrix_object == NULL) {
-    json_destroy(jobject);
     return NULL;
   }
-  // Clean up JSON container after unserializing.
-  json_destroy(jobject);
+  // Parse the values straight into the matrix storage.
+  uint64_t parse = serializer_metrics_start();
+  int status = serializer_parse_matrix(data, matrix_object);
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+  if (status == 1) {
+    matrix_destroy(matrix_object);
+    return NULL;
+  }
   // Return the matrix object.
   return matrix_object;
 }
 
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize(char *data) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  if (metrics && data != NULL) {
+    serializer_metrics_count(strlen(data), 0, 0);
+  }
+  struct matrix *matrix_object = matrix_text_read(data);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return matrix_object;
+}
+
+/**
+ * Parses a JSON string into the storage of an existing Matrix object.
+ *
+ * @param struct matrix *destination
+ *   The destination Matrix object.
+ * @param const char *data
+ *   The serialized matrix string.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrix_text_fill(struct matrix *destination, const char *data) {
+  // Validates the input.
+  if (destination == NULL || data == NULL) {
+    return 1;
+  }
+  // Check the serialized shape against the destination before writing anything.
+  int rows = 0;
+  int columns = 0;
+  if (serializer_scan_matrix_shape(data, &rows, &columns) == 1 || rows != destination->rows || columns != destination->columns) {
+    return 1;
+  }
+  // Parse the values straight into the destination storage.
+  uint64_t parse = serializer_metrics_start();
+  int status = serializer_parse_matrix(data, destination);
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_unserialize_into(struct matrix *destination, const char *data) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  if (metrics && data != NULL) {
+    serializer_metrics_count(strlen(data), 0, 0);
+  }
+  int status = matrix_text_fill(destination, data);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return status;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -196,21 +491,46 @@ struct matrix *matrix_get_and_unserialize_from_json_object(const char *key, stru
 }
 
 /**
- * {@inheritdoc}
+ * Fills an existing Matrix object from a keyed JSON array.
+ *
+ * @param struct matrix *destination
+ *   The destination Matrix object.
+ * @param const char *key
+ *   The key of the JSON array.
+ * @param struct json *json_object
+ *   The JSON object holding the array.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
  */
-int matrix_set_from_json_object(struct matrix *destination, const char *key, struct json *json_object) {
-  // Retrieve and unserialize the matrix from the JSON object.
-  struct matrix *source = matrix_get_and_unserialize_from_json_object(key, json_object);
-  if (source == NULL) {
+static int matrix_json_set(struct matrix *destination, const char *key, struct json *json_object) {
+  // Validates the input.
+  if (destination == NULL) {
     return 1;
   }
-  // Try to copy the source matrix into the destination matrix.
-  if (matrix_copy(source, destination) == 1) {
-    matrix_destroy(source);
+  // Get the JSON array associated with the key.
+  struct json *json_array = json_get_array(json_object, key);
+  if (json_array == NULL) {
+    return 1;
+  }
+  // Check the shape before writing, then fill the destination in place.
+  int rows = 0;
+  int columns = 0;
+  if (matrix_json_shape(json_array, &rows, &columns) == 1 || rows != destination->rows || columns != destination->columns) {
     return 1;
   }
-  // Free memory.
-  matrix_destroy(source);
+  matrix_json_fill(json_array, destination);
   // Operation successfully completed.
   return 0;
 }
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_set_from_json_object(struct matrix *destination, const char *key, struct json *json_object) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  int status = matrix_json_set(destination, key, json_object);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return status;
+}
@@ -0,0 +1,454 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+
+/**
+ * The size of the chunks read from files and file descriptors.
+ */
+#define MATRIX_READER_CHUNK_SIZE 65536
+
+/**
+ * States of the incremental matrix reader.
+ */
+enum matrix_reader_state {
+  // Expecting the opening bracket of the matrix.
+  MATRIX_READER_START,
+  // Expecting the opening bracket of a row.
+  MATRIX_READER_ROW,
+  // Right after the opening bracket of a row.
+  MATRIX_READER_ROW_BEGIN,
+  // Expecting a value after a comma.
+  MATRIX_READER_VALUE,
+  // Reading a value token.
+  MATRIX_READER_TOKEN,
+  // Expecting a comma or the end of the row.
+  MATRIX_READER_AFTER_VALUE,
+  // Expecting a comma or the end of the matrix.
+  MATRIX_READER_AFTER_ROW,
+  // The matrix is complete, only whitespace may follow.
+  MATRIX_READER_DONE,
+};
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix_writer *matrix_writer_begin(serializer_sink sink, void *context, const struct serializer_options *options) {
+  struct matrix_writer *writer = malloc(sizeof(struct matrix_writer));
+  if (writer == NULL) {
+    return NULL;
+  }
+  if (serializer_buffer_init_sink(&writer->buffer, sink, context, 0) == 1) {
+    free(writer);
+    return NULL;
+  }
+  // Keep a copy of the options, the caller may reuse theirs.
+  if (options != NULL) {
+    writer->options = *options;
+  }
+  else {
+    serializer_options_init(&writer->options);
+  }
+  writer->rows = 0;
+  writer->columns = 0;
+  writer->error = 0;
+  serializer_buffer_putc(&writer->buffer, '[');
+  return writer;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_writer_push_row(struct matrix_writer *writer, const long double *row, int columns) {
+  // Validates the input, every row must have the width of the first one.
+  if (writer == NULL || writer->error || row == NULL || columns <= 0 || (writer->rows > 0 && columns != writer->columns)) {
+    return 1;
+  }
+  struct serializer_buffer *buffer = &writer->buffer;
+  if (writer->rows > 0) {
+    serializer_buffer_putc(buffer, ',');
+  }
+  serializer_buffer_putc(buffer, '[');
+  for (int k = 0; k < columns; k++) {
+    if (k > 0) {
+      serializer_buffer_putc(buffer, ',');
+    }
+    // Part of the row may already be in the sink, so the failure is sticky.
+    if (serializer_buffer_write_number(buffer, row[k], &writer->options) == 1) {
+      writer->error = 1;
+      return 1;
+    }
+  }
+  serializer_buffer_putc(buffer, ']');
+  if (buffer->error) {
+    writer->error = 1;
+    return 1;
+  }
+  writer->rows++;
+  writer->columns = columns;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_writer_end(struct matrix_writer *writer) {
+  if (writer == NULL) {
+    return 1;
+  }
+  // A failed row is never closed, the output is incomplete either way.
+  int status = 1;
+  if (!writer->error) {
+    serializer_buffer_putc(&writer->buffer, ']');
+    status = serializer_buffer_flush(&writer->buffer);
+  }
+  if (writer->rows == 0) {
+    status = 1;
+  }
+  serializer_buffer_release(&writer->buffer);
+  free(writer);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix_reader *matrix_reader_create(matrix_row_callback callback, void *context) {
+  if (callback == NULL) {
+    return NULL;
+  }
+  struct matrix_reader *reader = calloc(1, sizeof(struct matrix_reader));
+  if (reader == NULL) {
+    return NULL;
+  }
+  reader->state = MATRIX_READER_START;
+  reader->callback = callback;
+  reader->context = context;
+  return reader;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void matrix_reader_destroy(struct matrix_reader *reader) {
+  if (reader == NULL) {
+    return;
+  }
+  free(reader->row);
+  free(reader->token);
+  free(reader);
+}
+
+/**
+ * Checks whether the given character is JSON whitespace.
+ *
+ * @param char character
+ *   The character to check.
+ *
+ * @return int
+ *   Returns 1 if the character is whitespace, otherwise 0.
+ */
+static int matrix_reader_is_whitespace(char character) {
+  return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+}
+
+/**
+ * Checks whether the given character can be part of a bare value token.
+ *
+ * @param char character
+ *   The character to check.
+ *
+ * @return int
+ *   Returns 1 if the character belongs to a bare token, otherwise 0.
+ */
+static int matrix_reader_is_token_character(char character) {
+  return (character >= '0' && character <= '9') || character == '-' || character == '+' || character == '.'
+    || character == 'e' || character == 'E' || character == 'n' || character == 'u' || character == 'l';
+}
+
+/**
+ * Appends a character to the value token being read.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ * @param char character
+ *   The character to append.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the token buffer can not grow.
+ */
+static int matrix_reader_push_character(struct matrix_reader *reader, char character) {
+  // Keep room for the terminator added by matrix_reader_end_token().
+  if (reader->token_length + 1 >= reader->token_capacity) {
+    if (reader->token_capacity > INT_MAX / 2) {
+      return 1;
+    }
+    int capacity = reader->token_capacity > 0 ? reader->token_capacity * 2 : SERIALIZER_NUMBER_MAX_LENGTH;
+    char *token = realloc(reader->token, capacity);
+    if (token == NULL) {
+      return 1;
+    }
+    reader->token = token;
+    reader->token_capacity = capacity;
+  }
+  reader->token[reader->token_length++] = character;
+  return 0;
+}
+
+/**
+ * Converts the completed value token and appends it to the current row.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrix_reader_end_token(struct matrix_reader *reader) {
+  int length = reader->token_length;
+  reader->token_length = 0;
+  // Empty quoted values are not numbers.
+  if (length == 0) {
+    return 1;
+  }
+  // Terminate the token, the exact fallback parser reads up to a delimiter.
+  reader->token[length] = '\0';
+  // Null values are skipped.
+  if (!reader->quoted && length == 4 && memcmp(reader->token, "null", 4) == 0) {
+    return 0;
+  }
+  long double value;
+  if (serializer_parse_number(reader->token, length, &value) == 1) {
+    return 1;
+  }
+  // The first row fixes the width, later rows can not grow past it.
+  if (reader->row_length == reader->row_capacity) {
+    if (reader->rows > 0) {
+      return 1;
+    }
+    int capacity = reader->row_capacity > 0 ? reader->row_capacity * 2 : 64;
+    long double *row = realloc(reader->row, capacity * sizeof(long double));
+    if (row == NULL) {
+      return 1;
+    }
+    reader->row = row;
+    reader->row_capacity = capacity;
+  }
+  reader->row[reader->row_length++] = value;
+  return 0;
+}
+
+/**
+ * Completes the current row and hands it to the callback.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrix_reader_end_row(struct matrix_reader *reader) {
+  int length = reader->row_length;
+  reader->row_length = 0;
+  // Empty rows are skipped, the others must all have the same width.
+  if (length == 0) {
+    return 0;
+  }
+  if (reader->rows > 0 && length != reader->columns) {
+    return 1;
+  }
+  reader->columns = length;
+  reader->rows++;
+  return reader->callback(reader->row, length, reader->context) != 0 ? 1 : 0;
+}
+
+/**
+ * Processes one input character.
+ *
+ * @param struct matrix_reader *reader
+ *   The matrix reader.
+ * @param char character
+ *   The character to process.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrix_reader_step(struct matrix_reader *reader, char character) {
+  // A bare token ends at the first character that can not be part of it,
+  // which is then processed in the next state.
+  if (reader->state == MATRIX_READER_TOKEN) {
+    if (reader->quoted) {
+      if (character == '"') {
+        reader->state = MATRIX_READER_AFTER_VALUE;
+        return matrix_reader_end_token(reader);
+      }
+    }
+    else if (!matrix_reader_is_token_character(character)) {
+      reader->state = MATRIX_READER_AFTER_VALUE;
+      if (matrix_reader_end_token(reader) == 1) {
+        return 1;
+      }
+      return matrix_reader_step(reader, character);
+    }
+    return matrix_reader_push_character(reader, character);
+  }
+  if (matrix_reader_is_whitespace(character)) {
+    return 0;
+  }
+  switch (reader->state) {
+    case MATRIX_READER_START:
+      if (character != '[') {
+        return 1;
+      }
+      reader->state = MATRIX_READER_ROW;
+      return 0;
+
+    case MATRIX_READER_ROW:
+      if (character != '[') {
+        return 1;
+      }
+      reader->state = MATRIX_READER_ROW_BEGIN;
+      return 0;
+
+    case MATRIX_READER_ROW_BEGIN:
+    case MATRIX_READER_VALUE:
+      // Empty rows close right after their opening bracket.
+      if (character == ']' && reader->state == MATRIX_READER_ROW_BEGIN) {
+        reader->state = MATRIX_READER_AFTER_ROW;
+        return matrix_reader_end_row(reader);
+      }
+      reader->state = MATRIX_READER_TOKEN;
+      reader->token_length = 0;
+      reader->quoted = character == '"';
+      if (reader->quoted) {
+        return 0;
+      }
+      if (!matrix_reader_is_token_character(character)) {
+        return 1;
+      }
+      return matrix_reader_push_character(reader, character);
+
+    case MATRIX_READER_AFTER_VALUE:
+      if (character == ',') {
+        reader->state = MATRIX_READER_VALUE;
+        return 0;
+      }
+      if (character == ']') {
+        reader->state = MATRIX_READER_AFTER_ROW;
+        return matrix_reader_end_row(reader);
+      }
+      return 1;
+
+    case MATRIX_READER_AFTER_ROW:
+      if (character == ',') {
+        reader->state = MATRIX_READER_ROW;
+        return 0;
+      }
+      if (character == ']') {
+        reader->state = MATRIX_READER_DONE;
+        return 0;
+      }
+      return 1;
+
+    default:
+      return 1;
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_reader_feed(struct matrix_reader *reader, const char *data, size_t length) {
+  if (reader == NULL || reader->error || (data == NULL && length > 0)) {
+    return 1;
+  }
+  for (size_t i = 0; i < length; i++) {
+    if (matrix_reader_step(reader, data[i]) == 1) {
+      reader->offset += i;
+      reader->error = 1;
+      return 1;
+    }
+  }
+  reader->offset += length;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_reader_finish(struct matrix_reader *reader) {
+  if (reader == NULL || reader->error || reader->state != MATRIX_READER_DONE || reader->rows == 0) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_reader_read_file(FILE *file, matrix_row_callback callback, void *context) {
+  if (file == NULL) {
+    return 1;
+  }
+  struct matrix_reader *reader = matrix_reader_create(callback, context);
+  char *chunk = malloc(MATRIX_READER_CHUNK_SIZE);
+  if (reader == NULL || chunk == NULL) {
+    matrix_reader_destroy(reader);
+    free(chunk);
+    return 1;
+  }
+  // Feed the file one bounded chunk at a time.
+  int status = 0;
+  size_t length;
+  while (status == 0 && (length = fread(chunk, 1, MATRIX_READER_CHUNK_SIZE, file)) > 0) {
+    status = matrix_reader_feed(reader, chunk, length);
+  }
+  if (status == 0 && (ferror(file) || matrix_reader_finish(reader) == 1)) {
+    status = 1;
+  }
+  matrix_reader_destroy(reader);
+  free(chunk);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_reader_read_fd(int fd, matrix_row_callback callback, void *context) {
+  if (fd < 0) {
+    return 1;
+  }
+  struct matrix_reader *reader = matrix_reader_create(callback, context);
+  char *chunk = malloc(MATRIX_READER_CHUNK_SIZE);
+  if (reader == NULL || chunk == NULL) {
+    matrix_reader_destroy(reader);
+    free(chunk);
+    return 1;
+  }
+  // Feed the descriptor one bounded chunk at a time.
+  int status = 0;
+  for (;;) {
+    ssize_t length = read(fd, chunk, MATRIX_READER_CHUNK_SIZE);
+    if (length < 0 && errno == EINTR) {
+      continue;
+    }
+    if (length < 0) {
+      status = 1;
+    }
+    if (length <= 0) {
+      break;
+    }
+    if (matrix_reader_feed(reader, chunk, (size_t)length) == 1) {
+      status = 1;
+      break;
+    }
+  }
+  if (status == 0 && matrix_reader_finish(reader) == 1) {
+    status = 1;
+  }
+  matrix_reader_destroy(reader);
+  free(chunk);
+  return status;
+}
@@ -0,0 +1,1099 @@
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+#ifndef LDBL_DECIMAL_DIG
+#define LDBL_DECIMAL_DIG DECIMAL_DIG
+#endif
+
+#ifndef DBL_DECIMAL_DIG
+#define DBL_DECIMAL_DIG 17
+#endif
+
+#ifndef FLT_DECIMAL_DIG
+#define FLT_DECIMAL_DIG 9
+#endif
+
+/**
+ * 125-bit approximations of 2^k / 5^q, rounded up, for the shortest formatter.
+ *
+ * Entry q holds the low and high 64 bits of floor(2^(124 + serializer_pow5_bits(q)) / 5^q) + 1.
+ */
+static const uint64_t serializer_pow5_inverse[292][2] = {
+  {0x0000000000000001U, 0x2000000000000000U}, {0x999999999999999aU, 0x1999999999999999U},
+  {0x47ae147ae147ae15U, 0x147ae147ae147ae1U}, {0x6c8b4395810624deU, 0x10624dd2f1a9fbe7U},
+  {0x7a786c226809d496U, 0x1a36e2eb1c432ca5U}, {0x61f9f01b866e43abU, 0x14f8b588e368f084U},
+  {0xb4c7f34938583622U, 0x10c6f7a0b5ed8d36U}, {0x87a6520ec08d236aU, 0x1ad7f29abcaf4857U},
+  {0x9fb841a566d74f88U, 0x15798ee2308c39dfU}, {0xe62d01511f12a607U, 0x112e0be826d694b2U},
+  {0xd6ae6881cb5109a4U, 0x1b7cdfd9d7bdbab7U}, {0xdef1ed34a2a73aeaU, 0x15fd7fe17964955fU},
+  {0x7f27f0f6e885c8bbU, 0x119799812dea1119U}, {0x650cb4be40d60df8U, 0x1c25c268497681c2U},
+  {0xea70909833de7193U, 0x16849b86a12b9b01U}, {0x21f3a6e0297ec143U, 0x1203af9ee756159bU},
+  {0x6985d7cd0f313537U, 0x1cd2b297d889bc2bU}, {0x2137dfd73f5a90f9U, 0x170ef54646d49689U},
+  {0xe75fe645cc4873faU, 0x12725dd1d243aba0U}, {0xa5663d3c7a0d865dU, 0x1d83c94fb6d2ac34U},
+  {0x511e976394d79eb1U, 0x179ca10c9242235dU}, {0xda7edf82dd794bc1U, 0x12e3b40a0e9b4f7dU},
+  {0x2a6498d1625bac68U, 0x1e392010175ee596U}, {0xeeb6e0a781e2f053U, 0x182db34012b25144U},
+  {0x58924d52ce4f26a9U, 0x1357c299a88ea76aU}, {0x27507bb7b07ea441U, 0x1ef2d0f5da7dd8aaU},
+  {0x52a6c95fc0655034U, 0x18c240c4aecb13bbU}, {0x0eebd44c99eaa690U, 0x13ce9a36f23c0fc9U},
+  {0xb17953adc3110a80U, 0x1fb0f6be50601941U}, {0xc12ddc8b02740867U, 0x195a5efea6b34767U},
+  {0x3424b06f3529a052U, 0x14484bfeebc29f86U}, {0x901d59f290ee19dbU, 0x1039d66589687f9eU},
+  {0x4cfbc31db4b0295fU, 0x19f623d5a8a73297U}, {0x3d9635b15d59bab2U, 0x14c4e977ba1f5bacU},
+  {0x97ab5e277de16228U, 0x109d8792fb4c4956U}, {0xf2abc9d8c9689d0dU, 0x1a95a5b7f87a0ef0U},
+  {0x5bbca17a3aba173eU, 0x154484932d2e725aU}, {0xafca1ac82efb45cbU, 0x11039d428a8b8eaeU},
+  {0xb2dcf7a6b1920945U, 0x1b38fb9daa78e44aU}, {0xf57d92ebc141a104U, 0x15c72fb1552d836eU},
+  {0xc46475896767b403U, 0x116c262777579c58U}, {0x6d6d88dbd8a5ecd2U, 0x1be03d0bf225c6f4U},
+  {0x8abe071646eb23dbU, 0x164cfda3281e38c3U}, {0x6efe6c11d255b649U, 0x11d7314f534b609cU},
+  {0xb197134fb6ef8a0eU, 0x1c8b821885456760U}, {0x27ac0f72f8bfa1a5U, 0x16d601ad376ab91aU},
+  {0xb95672c260994e1eU, 0x1244ce242c5560e1U}, {0xf5571e03cdc21695U, 0x1d3ae36d13bbce35U},
+  {0x2aac18030b01ababU, 0x17624f8a762fd82bU}, {0xbbbce0026f348956U, 0x12b50c6ec4f31355U},
+  {0x92c7ccd0b1eda889U, 0x1dee7a4ad4b81eefU}, {0xdbd30a408e57ba07U, 0x17f1fb6f10934bf2U},
+  {0x7ca8d50071dfc806U, 0x1327fc58da0f6ff5U}, {0xfaa7bb33e9660cd6U, 0x1ea6608e29b24cbbU},
+  {0x9552fc298784d711U, 0x18851a0b548ea3c9U}, {0xaaa8c9bad2d0ac0eU, 0x139dae6f76d88307U},
+  {0xdddadc5e1e1aace3U, 0x1f62b0b257c0d1a5U}, {0x7e48b04b4b488a4fU, 0x191bc08eac9a4151U},
+  {0xcb6d59d5d5d3a1d9U, 0x141633a556e1cddaU}, {0x3c577b1177dc817bU, 0x1011c2eaabe7d7e2U},
+  {0xc6f25e825960cf2aU, 0x19b604aaaca62636U}, {0x6bf518684780a5bbU, 0x14919d5556eb51c5U},
+  {0x232a79ed06008496U, 0x10747ddddf22a7d1U}, {0xd1dd8fe1a3340756U, 0x1a53fc9631d10c81U},
+  {0xa7e4731ae8f66c45U, 0x150ffd44f4a73d34U}, {0x531d28e253f8569eU, 0x10d9976a5d52975dU},
+  {0xeb61db03b98d5762U, 0x1af5bf109550f22eU}, {0xbc4e48cfc7a445e8U, 0x159165a6ddda5b58U},
+  {0x6371d3d96c836b20U, 0x11411e1f17e1e2adU}, {0x9f1c8628ad9f11cdU, 0x1b9b6364f3030448U},
+  {0xe5b06b53be18db0bU, 0x1615e91d8f359d06U}, {0xeaf3890fcb4715a2U, 0x11ab20e472914a6bU},
+  {0x44b8db4c7871bc37U, 0x1c45016d841baa46U}, {0x03c715d6c6c1635fU, 0x169d9abe03495505U},
+  {0x3638de456bcde919U, 0x1217aefe69077737U}, {0x56c163a2461641c1U, 0x1cf2b1970e725858U},
+  {0xdf011c81d1ab67ceU, 0x17288e1271f51379U}, {0x7f3416ce4155eca5U, 0x1286d80ec190dc61U},
+  {0x6520247d3556476eU, 0x1da48ce468e7c702U}, {0xea801d30f7783925U, 0x17b6d71d20b96c01U},
+  {0xbb99b0f3f92cfa84U, 0x12f8ac174d612334U}, {0x5f5c4e532847f739U, 0x1e5aacf215683854U},
+  {0x7f7d0b75b9d32c2eU, 0x18488a5b44536043U}, {0x9930d5f7c7dc2358U, 0x136d3b7c36a919cfU},
+  {0x8eb4898c72f9d226U, 0x1f152bf9f10e8fb2U}, {0x722a07a38f2e41b8U, 0x18ddbcc7f40ba628U},
+  {0xc1bb394fa5be9afaU, 0x13e497065cd61e86U}, {0x9c5ec2190930f7f6U, 0x1fd424d6faf030d7U},
+  {0x49e56814075a5ff8U, 0x197683df2f268d79U}, {0x6e51201005e1e660U, 0x145ecfe5bf520ac7U},
+  {0xf1da800cd181851aU, 0x104bd984990e6f05U}, {0x4fc400148268d4f5U, 0x1a12f5a0f4e3e4d6U},
+  {0xd96999aa01ed772bU, 0x14dbf7b3f71cb711U}, {0xadee1488018ac5bcU, 0x10aff95cc5b09274U},
+  {0x497ceda668de092cU, 0x1ab328946f80ea54U}, {0x3aca57b853e4d424U, 0x155c2076bf9a5510U},
+  {0x623b7960431d7683U, 0x1116805effaeaa73U}, {0x9d2bf566d1c8bd9eU, 0x1b5733cb32b110b8U},
+  {0x7dbcc452416d647fU, 0x15df5ca28ef40d60U}, {0xcafd69db678ab6ccU, 0x117f7d4ed8c33de6U},
+  {0xab2f0fc572778adfU, 0x1bff2ee48e052fd7U}, {0x88f273045b92d580U, 0x1665bf1d3e6a8cacU},
+  {0xd3f528d049424466U, 0x11eaff4a98553d56U}, {0xb988414d4203a0a3U, 0x1cab3210f3bb9557U},
+  {0x6139cdd76802e6e9U, 0x16ef5b40c2fc7779U}, {0xe761717920025254U, 0x125915cd68c9f92dU},
+  {0xa568b58e999d5086U, 0x1d5b561574765b7cU}, {0x5120913ee14aa6d2U, 0x177c44ddf6c515fdU},
+  {0xa74d40ff1aa21f0eU, 0x12c9d0b1923744caU}, {0x0baece64f769cb4aU, 0x1e0fb44f50586e11U},
+  {0x3c8bd850c5ee3c3bU, 0x180c903f7379f1a7U}, {0xca0979da37f1c9c9U, 0x133d4032c2c7f485U},
+  {0xa9a8c2f6bfe942dbU, 0x1ec866b79e0cba6fU}, {0x2153cf2bccba9be3U, 0x18a0522c7e709526U},
+  {0x1aa9728970954982U, 0x13b374f06526ddb8U}, {0xf775840f1a88759dU, 0x1f8587e7083e2f8cU},
+  {0x5f9136727ba05e17U, 0x19379fec0698260aU}, {0x1940f85b9619e4dfU, 0x142c7ff0054684d5U},
+  {0xe100c6afab47ea4cU, 0x1023998cd1053710U}, {0xce67a44c453fdd47U, 0x19d28f47b4d524e7U},
+  {0xd852e9d69dccb106U, 0x14a8729fc3ddb71fU}, {0x79dbee454b0a2738U, 0x1086c219697e2c19U},
+  {0x295fe3a211a9d859U, 0x1a71368f0f30468fU}, {0xbab31c81a7bb137aU, 0x15275ed8d8f36ba5U},
+  {0x6228e39aec95a92fU, 0x10ec4be0ad8f8951U}, {0x9d0e38f7e0ef7517U, 0x1b13ac9aaf4c0ee8U},
+  {0xb0d82d931a592a79U, 0x15a956e225d67253U}, {0x8d79be0f4847552eU, 0x11544581b7dec1dcU},
+  {0x158f967eda0bbb7cU, 0x1bba08cf8c979c94U}, {0x77a611ff14d62f97U, 0x162e6d72d6dfb076U},
+  {0xf951a7ff43de8c79U, 0x11bebdf578b2f391U}, {0xc21c3ffed2fdad8eU, 0x1c6463225ab7ec1cU},
+  {0x01b0333242648ad8U, 0x16b6b5b5155ff017U}, {0x0159c28e9b83a246U, 0x122bc490dde659acU},
+  {0xcef604175f3903a3U, 0x1d12d41afca3c2acU}, {0x725e69ac4c2d9c83U, 0x17424348ca1c9bbdU},
+  {0xf5185489d68ae39cU, 0x129b69070816e2fdU}, {0xee8d540fbdab05c6U, 0x1dc574d80cf16b2fU},
+  {0xbed77672fe226b05U, 0x17d12a4670c1228cU}, {0xff12c528cb4ebc04U, 0x130dbb6b8d674ed6U},
+  {0xcb513b74787df9a0U, 0x1e7c5f127bd87e24U}, {0x090dc929f9fe614dU, 0x18637f41fcad31b7U},
+  {0xa0d7d42194cb810aU, 0x1382cc34ca2427c5U}, {0x67bfb9cf5478ce77U, 0x1f37ad21436d0c6fU},
+  {0x1fcc94a5dd2d71f9U, 0x18f9574dcf8a7059U}, {0x7fd6dd517dbdf4c7U, 0x13faac3e3fa1f37aU},
+  {0xffbe2ee8c92fee0bU, 0x1ff779fd329cb8c3U}, {0x6631bf20a0f324d6U, 0x1992c7fdc216fa36U},
+  {0xb827cc1a1a5c1d78U, 0x14756ccb01abfb5eU}, {0x935309ae7b7ce460U, 0x105df0a267bcc918U},
+  {0x1eeb42b0c594a099U, 0x1a2fe76a3f9474f4U}, {0xe58902270476e6e1U, 0x14f31f8832dd2a5cU},
+  {0xb7a0ce859d2bebe7U, 0x10c27fa028b0eeb0U}, {0x59014a6f61dfdfd8U, 0x1ad0cc33744e4ab4U},
+  {0xe0cdd525e7e64cadU, 0x1573d68f903ea229U}, {0x4d7177518651d6f1U, 0x11297872d9cbb4eeU},
+  {0x7be8bee8d6e957e8U, 0x1b758d848fac54b0U}, {0xfcba3253df211320U, 0x15f7a46a0c89dd59U},
+  {0x63c8284318e74280U, 0x1192e9ee706e4aaeU}, {0x060d0d3827d86a66U, 0x1c1e43171a4a1117U},
+  {0x6b3da42cecad21ebU, 0x167e9c127b6e7412U}, {0x88fe1cf0bd574e56U, 0x11fee341fc585cdbU},
+  {0x419694b462254a23U, 0x1ccb0536608d615fU}, {0x67abaa29e81dd4e9U, 0x1708d0f84d3de77fU},
+  {0xb95621bb2017dd87U, 0x126d73f9d764b932U}, {0xc223692b668c95a5U, 0x1d7becc2f23ac1eaU},
+  {0xce82ba891ed6de1dU, 0x179657025b6234bbU}, {0xa53562074bdf1818U, 0x12deac01e2b4f6fcU},
+  {0x3b889cd87964f359U, 0x1e3113363787f194U}, {0xfc6d4a46c783f5e1U, 0x18274291c6065adcU},
+  {0x30576e9f06032b1aU, 0x13529ba7d19eaf17U}, {0x1a257dcb3cd1de90U, 0x1eea92a61c311825U},
+  {0x481dfe3c30a7e540U, 0x18bba884e35a79b7U}, {0xd34b31c9c0865100U, 0x13c9539d82aec7c5U},
+  {0x5211e942cda3b4cdU, 0x1fa885c8d117a609U}, {0x74db21023e1c90a4U, 0x19539e3a40dfb807U},
+  {0xf715b401cb4a0d50U, 0x1442e4fb67196005U}, {0xf8de299b09080aa7U, 0x103583fc527ab337U},
+  {0x8e304291a80cddd7U, 0x19ef3993b72ab859U}, {0x3e8d020e200a4b13U, 0x14bf6142f8eef9e1U},
+  {0x653d9b3e80083c0fU, 0x10991a9bfa58c7e7U}, {0x6ec8f864000d2ce4U, 0x1a8e90f9908e0ca5U},
+  {0x8bd3f9e999a423eaU, 0x153eda614071a3b7U}, {0x3ca994bae1501cbbU, 0x10ff151a99f482f9U},
+  {0xc775bac49bb3612bU, 0x1b31bb5dc320d18eU}, {0xd2c4956a16291a89U, 0x15c162b168e70e0bU},
+  {0xdbd0778811ba7ba1U, 0x11678227871f3e6fU}, {0x2c80bf401c5d929bU, 0x1bd8d03f3e9863e6U},
+  {0xbd33cc3349e47549U, 0x16470cff6546b651U}, {0xca8fd68f6e505dd4U, 0x11d270cc51055ea7U},
+  {0x4419574be3b3c953U, 0x1c83e7ad4e6efdd9U}, {0x0347790982f63aa9U, 0x16cfec8aa52597e1U},
+  {0xcf6c60d468c4fbbaU, 0x123ff06eea847980U}, {0xe57a34870e07f92aU, 0x1d331a4b10d3f59aU},
+  {0x512e906c0b399422U, 0x175c1508da432ae2U}, {0xda8ba6bcd5c7a9b5U, 0x12b010d3e1cf5581U},
+  {0x90df712e22d90f87U, 0x1de6815302e5559cU}, {0xda4c5a8b4f140c6cU, 0x17eb9aa8cf1dde16U},
+  {0xaea37ba2a5a9a38aU, 0x1322e220a5b17e78U}, {0x7dd25f6aa2a905a9U, 0x1e9e369aa2b59727U},
+  {0x97db7f888220d154U, 0x187e92154ef7ac1fU}, {0x797c6606ce80a777U, 0x139874ddd8c6234cU},
+  {0x8f2d700ae4010bf1U, 0x1f5a549627a36badU}, {0x0c2459a25000d65aU, 0x191510781fb5efbeU},
+  {0x701d1481d99a4515U, 0x1410d9f9b2f7f2feU}, {0xc017439b147b6a77U, 0x100d7b2e28c65bfeU},
+  {0xccf205c4ed9243f2U, 0x19af2b7d0e0a2ccaU}, {0x0a5b37d0be0e9cc2U, 0x148c22ca71a1bd6fU},
+  {0x0848f973cb3ee3ceU, 0x10701bd527b4978cU}, {0xda0e5bec78649fb0U, 0x1a4cf9550c5425acU},
+  {0x7b3eaff060507fc0U, 0x150a6110d6a9b7bdU}, {0x95cbbff380406633U, 0x10d51a73deee2c97U},
+  {0xefac665266cd7052U, 0x1aee90b964b04758U}, {0x2623850eb8a459dbU, 0x158ba6fab6f36c47U},
+  {0x1e82d0d893b6ae49U, 0x113c85955f29236cU}, {0xfd9e1af41f8ab075U, 0x1b9408eefea838acU},
+  {0x97b1af29b2d559f7U, 0x16100725988693bdU}, {0xac8e25baf5777b2cU, 0x11a66c1e139edc97U},
+  {0x7a7d092b2258c513U, 0x1c3d79c9b8fe2dbfU}, {0x61fda0ef4ead6a76U, 0x169794a160cb57ccU},
+  {0xe7fe1a590bbdeec5U, 0x1212dd4de7091309U}, {0xa6635d5b45fcb13aU, 0x1ceafbafd80e84dcU},
+  {0x851c4aaf6b308dc8U, 0x172262f3133ed0b0U}, {0xd0e36ef2bc26d7d4U, 0x1281e8c275cbda26U},
+  {0xb49f17eac6a48c86U, 0x1d9ca79d894629d7U}, {0x2a18dfef0550706bU, 0x17b08617a104ee46U},
+  {0x54e0b3259dd9f389U, 0x12f39e794d9d8b6bU}, {0x87cdeb6f62f65274U, 0x1e5297287c2f4578U},
+  {0xd30b22bf825ea85dU, 0x18421286c9bf6ac6U}, {0x0f3c1bcc684bb9e4U, 0x13680ed23aff889fU},
+  {0x18602c7a4079296dU, 0x1f0ce4839198da98U}, {0x46b356c833942124U, 0x18d71d360e13e213U},
+  {0x388f78a029434db6U, 0x13df4a91a4dcb4dcU}, {0x5a7f2766a86baf8aU, 0x1fcbaa82a1612160U},
+  {0x153285ebb9efbfa2U, 0x196fbb9bb44db44dU}, {0xaa8ed189618c994eU, 0x145962e2f6a4903dU},
+  {0xeed8a7a11ad6e10cU, 0x1047824f2bb6d9caU}, {0x7e27729b5e249b45U, 0x1a0c03b1df8af611U},
+  {0xfe85f549181d4904U, 0x14d6695b193bf80dU}, {0xcb9e5dd4134aa0d0U, 0x10ab877c142ff9a4U},
+  {0xdf63c9535211014dU, 0x1aac0bf9b9e65c3aU}, {0x191ca10f74da6771U, 0x15566ffafb1eb02fU},
+  {0xadb080d92a4852c1U, 0x1111f32f2f4bc025U}, {0x15e7348eaa0d5134U, 0x1b4feb7eb212cd09U},
+  {0xab1f5d3eee710dc4U, 0x15d98932280f0a6dU}, {0xbc1917658b8da49dU, 0x117ad428200c0857U},
+  {0x2cf4f23c127c3a94U, 0x1bf7b9d9cce00d59U}, {0xf0c3f4fcdb969543U, 0x165fc7e170b33de0U},
+  {0x5a365d9716121103U, 0x11e6398126f5cb1aU}, {0x9056fc24f01ce804U, 0x1ca38f350b22de90U},
+  {0xd9df301d8ce3ecd0U, 0x16e93f5da2824ba6U}, {0xe17f59b13d8323daU, 0x125432b14ecea2ebU},
+  {0x68cbc2b52f38395cU, 0x1d53844ee47dd179U}, {0x53d6355dbf602de3U, 0x177603725064a794U},
+  {0xa9782ab165e68b1cU, 0x12c4cf8ea6b6ec76U}, {0x0f26aab56fd744faU, 0x1e07b27dd78b13f1U},
+  {0x3f52222abfdf6a62U, 0x18062864ac6f4327U}, {0x65db4e88997f884eU, 0x1338205089f29c1fU},
+  {0x6fc54a7428cc0d4aU, 0x1ec033b40fea9365U}, {0x596aa1f68709a43bU, 0x1899c2f673220f84U},
+  {0xadeee7f86c07b696U, 0x13ae3591f5b4d936U}, {0x497e3ff3e00c5756U, 0x1f7d228322baf524U},
+  {0xd464fff64cd6ac45U, 0x1930e868e89590e9U}, {0x4383fff83d7889d1U, 0x14272053ed4473eeU},
+  {0xcf9cccc69793a174U, 0x101f4d0ff1038ff1U}, {0x7f6147a425b90252U, 0x19cbae7fe805b31cU},
+  {0xcc4dd2e9b7c7350fU, 0x14a2f1ffecd15c16U}, {0x3d0b0f215fd290d9U, 0x10825b3323dab012U},
+  {0x61ab4b689950e7c1U, 0x1a6a2b85062ab350U}, {0x4e22a2ba1440b967U, 0x1521bc6a6b555c40U},
+  {0x0b4ee894dd009453U, 0x10e7c9eebc4449cdU}, {0x1217da87c800ed51U, 0x1b0c764ac6d3a948U},
+  {0xdb46486ca000bddaU, 0x15a391d56bdc876cU}, {0x490506bd4ccd64afU, 0x114fa7ddefe39f8aU},
+  {0xa8080ac87ae23ab1U, 0x1bb2a62fe638ff43U}, {0x5339a239fbe82ef4U, 0x162884f31e93ff69U},
+  {0x75c7b4fb2fecf25dU, 0x11ba03f5b20fff87U}, {0x22d92191e647ea2eU, 0x1c5cd322b67fff3fU},
+  {0xb57a8141850654f2U, 0x16b0a8e891ffff65U}, {0xc4620101373843f5U, 0x1226ed86db3332b7U},
+  {0x3a366801f1f39feeU, 0x1d0b15a491eb8459U}, {0xfb5eb99b27f6198bU, 0x173c115074bc69e0U},
+  {0x2f7efae2865e7ad6U, 0x129674405d6387e7U}, {0xe597f7d0d6fd9156U, 0x1dbd86cd6238d971U},
+  {0x8479930d78cadaabU, 0x17cad23de82d7ac1U}, {0xd06142712d6f1556U, 0x1308a831868ac89aU},
+  {0x4d686a4eaf182222U, 0x1e74404f3daada91U}, {0xa453883ef279b4e8U, 0x185d003f6488aedaU},
+  {0xe9dc6cff28615d87U, 0x137d99cc506d58aeU}, {0xa960ae650d6895a4U, 0x1f2f5c7a1a488de4U},
+  {0xbab3beb73ded4483U, 0x18f2b061aea07183U}, {0x2ef6322c318a9d36U, 0x13f559e7bee6c136U}
+};
+
+/**
+ * 125-bit approximations of 5^i, truncated, for the shortest formatter.
+ *
+ * Entry i holds the low and high 64 bits of the 125 leading bits of 5^i.
+ */
+static const uint64_t serializer_pow5[326][2] = {
+  {0x0000000000000000U, 0x1000000000000000U}, {0x0000000000000000U, 0x1400000000000000U},
+  {0x0000000000000000U, 0x1900000000000000U}, {0x0000000000000000U, 0x1f40000000000000U},
+  {0x0000000000000000U, 0x1388000000000000U}, {0x0000000000000000U, 0x186a000000000000U},
+  {0x0000000000000000U, 0x1e84800000000000U}, {0x0000000000000000U, 0x1312d00000000000U},
+  {0x0000000000000000U, 0x17d7840000000000U}, {0x0000000000000000U, 0x1dcd650000000000U},
+  {0x0000000000000000U, 0x12a05f2000000000U}, {0x0000000000000000U, 0x174876e800000000U},
+  {0x0000000000000000U, 0x1d1a94a200000000U}, {0x0000000000000000U, 0x12309ce540000000U},
+  {0x0000000000000000U, 0x16bcc41e90000000U}, {0x0000000000000000U, 0x1c6bf52634000000U},
+  {0x0000000000000000U, 0x11c37937e0800000U}, {0x0000000000000000U, 0x16345785d8a00000U},
+  {0x0000000000000000U, 0x1bc16d674ec80000U}, {0x0000000000000000U, 0x1158e460913d0000U},
+  {0x0000000000000000U, 0x15af1d78b58c4000U}, {0x0000000000000000U, 0x1b1ae4d6e2ef5000U},
+  {0x0000000000000000U, 0x10f0cf064dd59200U}, {0x0000000000000000U, 0x152d02c7e14af680U},
+  {0x0000000000000000U, 0x1a784379d99db420U}, {0x0000000000000000U, 0x108b2a2c28029094U},
+  {0x0000000000000000U, 0x14adf4b7320334b9U}, {0x4000000000000000U, 0x19d971e4fe8401e7U},
+  {0x8800000000000000U, 0x1027e72f1f128130U}, {0xaa00000000000000U, 0x1431e0fae6d7217cU},
+  {0xd480000000000000U, 0x193e5939a08ce9dbU}, {0xc9a0000000000000U, 0x1f8def8808b02452U},
+  {0xbe04000000000000U, 0x13b8b5b5056e16b3U}, {0xad85000000000000U, 0x18a6e32246c99c60U},
+  {0xd8e6400000000000U, 0x1ed09bead87c0378U}, {0x878fe80000000000U, 0x13426172c74d822bU},
+  {0x6973e20000000000U, 0x1812f9cf7920e2b6U}, {0x03d0da8000000000U, 0x1e17b84357691b64U},
+  {0x8262889000000000U, 0x12ced32a16a1b11eU}, {0x22fb2ab400000000U, 0x178287f49c4a1d66U},
+  {0xabb9f56100000000U, 0x1d6329f1c35ca4bfU}, {0xcb54395ca0000000U, 0x125dfa371a19e6f7U},
+  {0xbe2947b3c8000000U, 0x16f578c4e0a060b5U}, {0x2db399a0ba000000U, 0x1cb2d6f618c878e3U},
+  {0xfc90400474400000U, 0x11efc659cf7d4b8dU}, {0x7bb4500591500000U, 0x166bb7f0435c9e71U},
+  {0xdaa16406f5a40000U, 0x1c06a5ec5433c60dU}, {0xa8a4de8459868000U, 0x118427b3b4a05bc8U},
+  {0xd2ce16256fe82000U, 0x15e531a0a1c872baU}, {0x87819baecbe22800U, 0x1b5e7e08ca3a8f69U},
+  {0xf4b1014d3f6d5900U, 0x111b0ec57e6499a1U}, {0x71dd41a08f48af40U, 0x1561d276ddfdc00aU},
+  {0x0e549208b31adb10U, 0x1aba4714957d300dU}, {0x28f4db456ff0c8eaU, 0x10b46c6cdd6e3e08U},
+  {0x33321216cbecfb24U, 0x14e1878814c9cd8aU}, {0xbffe969c7ee839edU, 0x1a19e96a19fc40ecU},
+  {0xf7ff1e21cf512434U, 0x105031e2503da893U}, {0xf5fee5aa43256d41U, 0x14643e5ae44d12b8U},
+  {0x337e9f14d3eec892U, 0x197d4df19d605767U}, {0x005e46da08ea7ab6U, 0x1fdca16e04b86d41U},
+  {0xa03aec4845928cb2U, 0x13e9e4e4c2f34448U}, {0xc849a75a56f72fdeU, 0x18e45e1df3b0155aU},
+  {0x7a5c1130ecb4fbd6U, 0x1f1d75a5709c1ab1U}, {0xec798abe93f11d65U, 0x13726987666190aeU},
+  {0xa797ed6e38ed64bfU, 0x184f03e93ff9f4daU}, {0x517de8c9c728bdefU, 0x1e62c4e38ff87211U},
+  {0xd2eeb17e1c7976b5U, 0x12fdbb0e39fb474aU}, {0x87aa5ddda397d462U, 0x17bd29d1c87a191dU},
+  {0xe994f5550c7dc97bU, 0x1dac74463a989f64U}, {0x11fd195527ce9dedU, 0x128bc8abe49f639fU},
+  {0xd67c5faa71c24568U, 0x172ebad6ddc73c86U}, {0x8c1b77950e32d6c2U, 0x1cfa698c95390ba8U},
+  {0x57912abd28dfc639U, 0x121c81f7dd43a749U}, {0xad75756c7317b7c8U, 0x16a3a275d494911bU},
+  {0x98d2d2c78fdda5baU, 0x1c4c8b1349b9b562U}, {0x9f83c3bcb9ea8794U, 0x11afd6ec0e14115dU},
+  {0x0764b4abe8652979U, 0x161bcca7119915b5U}, {0x493de1d6e27e73d7U, 0x1ba2bfd0d5ff5b22U},
+  {0x6dc6ad264d8f0866U, 0x1145b7e285bf98f5U}, {0xc938586fe0f2ca80U, 0x159725db272f7f32U},
+  {0x7b866e8bd92f7d20U, 0x1afcef51f0fb5effU}, {0xad34051767bdae34U, 0x10de1593369d1b5fU},
+  {0x9881065d41ad19c1U, 0x15159af804446237U}, {0x7ea147f492186032U, 0x1a5b01b605557ac5U},
+  {0x6f24ccf8db4f3c1fU, 0x1078e111c3556cbbU}, {0x4aee003712230b27U, 0x14971956342ac7eaU},
+  {0xdda98044d6abcdf0U, 0x19bcdfabc13579e4U}, {0x0a89f02b062b60b6U, 0x10160bcb58c16c2fU},
+  {0xcd2c6c35c7b638e4U, 0x141b8ebe2ef1c73aU}, {0x8077874339a3c71dU, 0x1922726dbaae3909U},
+  {0xe0956914080cb8e4U, 0x1f6b0f092959c74bU}, {0x6c5d61ac8507f38eU, 0x13a2e965b9d81c8fU},
+  {0x4774ba17a649f072U, 0x188ba3bf284e23b3U}, {0x1951e89d8fdc6c8fU, 0x1eae8caef261aca0U},
+  {0x0fd3316279e9c3d9U, 0x132d17ed577d0be4U}, {0x13c7fdbb186434cfU, 0x17f85de8ad5c4eddU},
+  {0x58b9fd29de7d4203U, 0x1df67562d8b36294U}, {0xb7743e3a2b0e4942U, 0x12ba095dc7701d9cU},
+  {0xe5514dc8b5d1db92U, 0x17688bb5394c2503U}, {0xdea5a13ae3465277U, 0x1d42aea2879f2e44U},
+  {0x0b2784c4ce0bf38aU, 0x1249ad2594c37cebU}, {0xcdf165f6018ef06dU, 0x16dc186ef9f45c25U},
+  {0x416dbf7381f2ac88U, 0x1c931e8ab871732fU}, {0x88e497a83137abd5U, 0x11dbf316b346e7fdU},
+  {0xeb1dbd923d8596caU, 0x1652efdc6018a1fcU}, {0x25e52cf6cce6fc7dU, 0x1be7abd3781eca7cU},
+  {0x97af3c1a40105dceU, 0x1170cb642b133e8dU}, {0xfd9b0b20d0147542U, 0x15ccfe3d35d80e30U},
+  {0x3d01cde904199292U, 0x1b403dcc834e11bdU}, {0x462120b1a28ffb9bU, 0x1108269fd210cb16U},
+  {0xd7a968de0b33fa82U, 0x154a3047c694fddbU}, {0xcd93c3158e00f923U, 0x1a9cbc59b83a3d52U},
+  {0xc07c59ed78c09bb6U, 0x10a1f5b813246653U}, {0xb09b7068d6f0c2a3U, 0x14ca732617ed7fe8U},
+  {0xdcc24c830cacf34cU, 0x19fd0fef9de8dfe2U}, {0xc9f96fd1e7ec180fU, 0x103e29f5c2b18bedU},
+  {0x3c77cbc661e71e13U, 0x144db473335deee9U}, {0x8b95beb7fa60e598U, 0x1961219000356aa3U},
+  {0x6e7b2e65f8f91efeU, 0x1fb969f40042c54cU}, {0xc50cfcffbb9bb35fU, 0x13d3e2388029bb4fU},
+  {0xb6503c3faa82a037U, 0x18c8dac6a0342a23U}, {0xa3e44b4f95234844U, 0x1efb1178484134acU},
+  {0xe66eaf11bd360d2bU, 0x135ceaeb2d28c0ebU}, {0xe00a5ad62c839075U, 0x183425a5f872f126U},
+  {0x980cf18bb7a47493U, 0x1e412f0f768fad70U}, {0x5f0816f752c6c8dcU, 0x12e8bd69aa19cc66U},
+  {0xf6ca1cb527787b13U, 0x17a2ecc414a03f7fU}, {0xf47ca3e2715699d7U, 0x1d8ba7f519c84f5fU},
+  {0xf8cde66d86d62026U, 0x127748f9301d319bU}, {0xf7016008e88ba830U, 0x17151b377c247e02U},
+  {0xb4c1b80b22ae923cU, 0x1cda62055b2d9d83U}, {0x50f91306f5ad1b65U, 0x12087d4358fc8272U},
+  {0xe53757c8b318623fU, 0x168a9c942f3ba30eU}, {0x9e852dbadfde7acfU, 0x1c2d43b93b0a8bd2U},
+  {0xa3133c94cbeb0cc1U, 0x119c4a53c4e69763U}, {0x8bd80bb9fee5cff1U, 0x16035ce8b6203d3cU},
+  {0xaece0ea87e9f43eeU, 0x1b843422e3a84c8bU}, {0x4d40c9294f238a75U, 0x1132a095ce492fd7U},
+  {0x2090fb73a2ec6d12U, 0x157f48bb41db7bcdU}, {0x68b53a508ba78856U, 0x1adf1aea12525ac0U},
+  {0x417144725748b536U, 0x10cb70d24b7378b8U}, {0x51cd958eed1ae283U, 0x14fe4d06de5056e6U},
+  {0xe640faf2a8619b24U, 0x1a3de04895e46c9fU}, {0xefe89cd7a93d00f7U, 0x1066ac2d5daec3e3U},
+  {0xebe2c40d938c4134U, 0x14805738b51a74dcU}, {0x26db7510f86f5181U, 0x19a06d06e2611214U},
+  {0x9849292a9b4592f1U, 0x100444244d7cab4cU}, {0xbe5b73754216f7adU, 0x1405552d60dbd61fU},
+  {0xadf25052929cb598U, 0x1906aa78b912cba7U}, {0x996ee4673743e2ffU, 0x1f485516e7577e91U},
+  {0xffe54ec0828a6ddfU, 0x138d352e5096af1aU}, {0xbfdea270a32d0957U, 0x18708279e4bc5ae1U},
+  {0x2fd64b0ccbf84badU, 0x1e8ca3185deb719aU}, {0x5de5eee7ff7b2f4cU, 0x1317e5ef3ab32700U},
+  {0x755f6aa1ff59fb1fU, 0x17dddf6b095ff0c0U}, {0x92b7454a7f3079e7U, 0x1dd55745cbb7ecf0U},
+  {0x5bb28b4e8f7e4c30U, 0x12a5568b9f52f416U}, {0xf29f2e22335ddf3cU, 0x174eac2e8727b11bU},
+  {0xef46f9aac035570bU, 0x1d22573a28f19d62U}, {0xd58c5c0ab8215667U, 0x123576845997025dU},
+  {0x4aef730d6629ac01U, 0x16c2d4256ffcc2f5U}, {0x9dab4fd0bfb41701U, 0x1c73892ecbfbf3b2U},
+  {0xa28b11e277d08e60U, 0x11c835bd3f7d784fU}, {0x8b2dd65b15c4b1f9U, 0x163a432c8f5cd663U},
+  {0x6df94bf1db35de77U, 0x1bc8d3f7b3340bfcU}, {0xc4bbcf772901ab0aU, 0x115d847ad000877dU},
+  {0x35eac354f34215cdU, 0x15b4e5998400a95dU}, {0x8365742a30129b40U, 0x1b221effe500d3b4U},
+  {0xd21f689a5e0ba108U, 0x10f5535fef208450U}, {0x06a742c0f58e894aU, 0x1532a837eae8a565U},
+  {0x4851137132f22b9dU, 0x1a7f5245e5a2cebeU}, {0xed32ac26bfd75b42U, 0x108f936baf85c136U},
+  {0xa87f57306fcd3212U, 0x14b378469b673184U}, {0xd29f2cfc8bc07e97U, 0x19e056584240fde5U},
+  {0xa3a37c1dd7584f1eU, 0x102c35f729689eafU}, {0x8c8c5b254d2e62e6U, 0x14374374f3c2c65bU},
+  {0x6faf71eea079fb9fU, 0x1945145230b377f2U}, {0x0b9b4e6a48987a87U, 0x1f965966bce055efU},
+  {0x674111026d5f4c94U, 0x13bdf7e0360c35b5U}, {0xc111554308b71fbaU, 0x18ad75d8438f4322U},
+  {0x7155aa93cae4e7a8U, 0x1ed8d34e547313ebU}, {0x26d58a9c5ecf10c9U, 0x13478410f4c7ec73U},
+  {0xf08aed437682d4fbU, 0x1819651531f9e78fU}, {0xecada89454238a3aU, 0x1e1fbe5a7e786173U},
+  {0x73ec895cb4963664U, 0x12d3d6f88f0b3ce8U}, {0x90e7abb3e1bbc3fdU, 0x1788ccb6b2ce0c22U},
+  {0x352196a0da2ab4fdU, 0x1d6affe45f818f2bU}, {0x0134fe24885ab11eU, 0x1262dfeebbb0f97bU},
+  {0xc1823dadaa715d65U, 0x16fb97ea6a9d37d9U}, {0x31e2cd19150db4bfU, 0x1cba7de5054485d0U},
+  {0x1f2dc02fad2890f7U, 0x11f48eaf234ad3a2U}, {0xa6f9303b9872b535U, 0x1671b25aec1d888aU},
+  {0x50b77c4a7e8f6282U, 0x1c0e1ef1a724eaadU}, {0x5272adae8f199d91U, 0x1188d357087712acU},
+  {0x670f591a32e004f6U, 0x15eb082cca94d757U}, {0x40d32f60bf980633U, 0x1b65ca37fd3a0d2dU},
+  {0x4883fd9c77bf03e0U, 0x111f9e62fe44483cU}, {0x5aa4fd0395aec4d8U, 0x156785fbbdd55a4bU},
+  {0x314e3c447b1a760eU, 0x1ac1677aad4ab0deU}, {0xded0e5aaccf089c9U, 0x10b8e0acac4eae8aU},
+  {0x96851f15802cac3bU, 0x14e718d7d7625a2dU}, {0xfc2666dae037d74aU, 0x1a20df0dcd3af0b8U},
+  {0x9d980048cc22e68eU, 0x10548b68a044d673U}, {0x84fe005aff2ba032U, 0x1469ae42c8560c10U},
+  {0xa63d8071bef6883eU, 0x198419d37a6b8f14U}, {0xcfcce08e2eb42a4eU, 0x1fe52048590672d9U},
+  {0x21e00c58dd309a70U, 0x13ef342d37a407c8U}, {0x2a580f6f147cc10dU, 0x18eb0138858d09baU},
+  {0xb4ee134ad99bf150U, 0x1f25c186a6f04c28U}, {0x7114cc0ec80176d2U, 0x137798f428562f99U},
+  {0xcd59ff127a01d486U, 0x18557f31326bbb7fU}, {0xc0b07ed7188249a8U, 0x1e6adefd7f06aa5fU},
+  {0xd86e4f466f516e09U, 0x1302cb5e6f642a7bU}, {0xce89e3180b25c98bU, 0x17c37e360b3d351aU},
+  {0x822c5bde0def3beeU, 0x1db45dc38e0c8261U}, {0xf15bb96ac8b58575U, 0x1290ba9a38c7d17cU},
+  {0x2db2a7c57ae2e6d2U, 0x1734e940c6f9c5dcU}, {0x391f51b6d99ba086U, 0x1d022390f8b83753U},
+  {0x03b3931248014454U, 0x1221563a9b732294U}, {0x04a077d6da019569U, 0x16a9abc9424feb39U},
+  {0x45c895cc9081fac3U, 0x1c5416bb92e3e607U}, {0x8b9d5d9fda513cbaU, 0x11b48e353bce6fc4U},
+  {0xae84b507d0e58be8U, 0x1621b1c28ac20bb5U}, {0x1a25e249c51eeee3U, 0x1baa1e332d728ea3U},
+  {0xf057ad6e1b33554dU, 0x114a52dffc679925U}, {0x6c6d98c9a2002aa1U, 0x159ce797fb817f6fU},
+  {0x4788fefc0a803549U, 0x1b04217dfa61df4bU}, {0x0cb59f5d8690214eU, 0x10e294eebc7d2b8fU},
+  {0xcfe30734e83429a1U, 0x151b3a2a6b9c7672U}, {0x83dbc9022241340aU, 0x1a6208b50683940fU},
+  {0xb2695da15568c086U, 0x107d457124123c89U}, {0x1f03b509aac2f0a7U, 0x149c96cd6d16cbacU},
+  {0x26c4a24c1573acd1U, 0x19c3bc80c85c7e97U}, {0x783ae56f8d684c03U, 0x101a55d07d39cf1eU},
+  {0x16499ecb70c25f03U, 0x1420eb449c8842e6U}, {0x9bdc067e4cf2f6c4U, 0x19292615c3aa539fU},
+  {0x82d3081de02fb476U, 0x1f736f9b3494e887U}, {0xb1c3e512ac1dd0c9U, 0x13a825c100dd1154U},
+  {0xde34de57572544fcU, 0x18922f31411455a9U}, {0x55c215ed2cee963bU, 0x1eb6bafd91596b14U},
+  {0xb5994db43c151de5U, 0x133234de7ad7e2ecU}, {0xe2ffa1214b1a655eU, 0x17fec216198ddba7U},
+  {0xdbbf89699de0feb6U, 0x1dfe729b9ff15291U}, {0x2957b5e202ac9f31U, 0x12bf07a143f6d39bU},
+  {0xf3ada35a8357c6feU, 0x176ec98994f48881U}, {0x70990c31242db8bdU, 0x1d4a7bebfa31aaa2U},
+  {0x865fa79eb69c9376U, 0x124e8d737c5f0aa5U}, {0xe7f791866443b854U, 0x16e230d05b76cd4eU},
+  {0xa1f575e7fd54a669U, 0x1c9abd04725480a2U}, {0xa53969b0fe54e801U, 0x11e0b622c774d065U},
+  {0x0e87c41d3dea2202U, 0x1658e3ab7952047fU}, {0xd229b5248d64aa82U, 0x1bef1c9657a6859eU},
+  {0x435a1136d85eea91U, 0x117571ddf6c81383U}, {0x143095848e76a536U, 0x15d2ce55747a1864U},
+  {0x193cbae5b2144e83U, 0x1b4781ead1989e7dU}, {0x2fc5f4cf8f4cb112U, 0x110cb132c2ff630eU},
+  {0xbbb77203731fdd56U, 0x154fdd7f73bf3bd1U}, {0x2aa54e844fe7d4acU, 0x1aa3d4df50af0ac6U},
+  {0xdaa75112b1f0e4ebU, 0x10a6650b926d66bbU}, {0xd15125575e6d1e26U, 0x14cffe4e7708c06aU},
+  {0x85a56ead360865b0U, 0x1a03fde214caf085U}, {0x7387652c41c53f8eU, 0x10427ead4cfed653U},
+  {0x50693e7752368f71U, 0x14531e58a03e8be8U}, {0x64838e1526c4334eU, 0x1967e5eec84e2ee2U},
+  {0xfda4719a70754022U, 0x1fc1df6a7a61ba9aU}, {0xde86c70086494815U, 0x13d92ba28c7d14a0U},
+  {0x162878c0a7db9a1aU, 0x18cf768b2f9c59c9U}, {0x5bb296f0d1d280a1U, 0x1f03542dfb83703bU},
+  {0x194f9e5683239064U, 0x1362149cbd322625U}, {0x5fa385ec23ec747eU, 0x183a99c3ec7eafaeU},
+  {0xf78c67672ce7919dU, 0x1e494034e79e5b99U}, {0x3ab7c0a07c10bb02U, 0x12edc82110c2f940U},
+  {0x4965b0c89b14e9c3U, 0x17a93a2954f3b790U}, {0x5bbf1cfac1da2433U, 0x1d9388b3aa30a574U},
+  {0xb957721cb92856a0U, 0x127c35704a5e6768U}, {0xe7ad4ea3e7726c48U, 0x171b42cc5cf60142U},
+  {0xa198a24ce14f075aU, 0x1ce2137f74338193U}, {0x44ff65700cd16498U, 0x120d4c2fa8a030fcU},
+  {0x563f3ecc1005bdbeU, 0x16909f3b92c83d3bU}, {0x2bcf0e7f14072d2eU, 0x1c34c70a777a4c8aU},
+  {0x5b61690f6c847c3dU, 0x11a0fc668aac6fd6U}, {0xf239c35347a59b4cU, 0x16093b802d578bcbU},
+  {0xeec83428198f021fU, 0x1b8b8a6038ad6ebeU}, {0x553d20990ff96153U, 0x1137367c236c6537U},
+  {0x2a8c68bf53f7b9a8U, 0x1585041b2c477e85U}, {0x752f82ef28f5a812U, 0x1ae64521f7595e26U},
+  {0x093db1d57999890bU, 0x10cfeb353a97dad8U}, {0x0b8d1e4ad7ffeb4eU, 0x1503e602893dd18eU},
+  {0x8e7065dd8dffe622U, 0x1a44df832b8d45f1U}, {0xf9063faa78bfefd5U, 0x106b0bb1fb384bb6U},
+  {0xb747cf9516efebcaU, 0x1485ce9e7a065ea4U}, {0xe519c37a5cabe6bdU, 0x19a742461887f64dU},
+  {0xaf301a2c79eb7036U, 0x1008896bcf54f9f0U}, {0xdafc20b798664c43U, 0x140aabc6c32a386cU},
+  {0x11bb28e57e7fdf54U, 0x190d56b873f4c688U}, {0x1629f31ede1fd72aU, 0x1f50ac6690f1f82aU},
+  {0x4dda37f34ad3e67aU, 0x13926bc01a973b1aU}, {0xe150c5f01d88e019U, 0x187706b0213d09e0U},
+  {0x19a4f76c24eb181fU, 0x1e94c85c298c4c59U}, {0xb0071aa39712ef13U, 0x131cfd3999f7afb7U},
+  {0x9c08e14c7cd7aad8U, 0x17e43c8800759ba5U}, {0x030b199f9c0d958eU, 0x1ddd4baa0093028fU},
+  {0x61e6f003c1887d79U, 0x12aa4f4a405be199U}, {0xba60ac04b1ea9cd7U, 0x1754e31cd072d9ffU},
+  {0xa8f8d705de65440dU, 0x1d2a1be4048f907fU}, {0xc99b8663aaff4a88U, 0x123a516e82d9ba4fU},
+  {0xbc0267fc95bf1d2aU, 0x16c8e5ca239028e3U}, {0xab0301fbbb2ee474U, 0x1c7b1f3cac74331cU},
+  {0xeae1e13d54fd4ec9U, 0x11ccf385ebc89ff1U}, {0x659a598caa3ca27bU, 0x1640306766bac7eeU},
+  {0xff00efefd4cbcb1aU, 0x1bd03c81406979e9U}, {0x3f6095f5e4ff5ef0U, 0x116225d0c841ec32U},
+  {0xcf38bb735e3f36acU, 0x15baaf44fa52673eU}, {0x8306ea5035cf0457U, 0x1b295b1638e7010eU},
+  {0x11e4527221a162b6U, 0x10f9d8ede39060a9U}, {0x565d670eaa09bb64U, 0x15384f295c7478d3U},
+  {0x2bf4c0d2548c2a3dU, 0x1a8662f3b3919708U}, {0x1b78f88374d79a66U, 0x1093fdd8503afe65U},
+  {0x625736a4520d8100U, 0x14b8fd4e6449bdfeU}, {0xfaed044d6690e140U, 0x19e73ca1fd5c2d7dU},
+  {0xbcd422b0601a8cc8U, 0x103085e53e599c6eU}, {0x6c092b5c78212ffaU, 0x143ca75e8df0038aU},
+  {0x070b763396297bf8U, 0x194bd136316c046dU}, {0x48ce53c07bb3daf6U, 0x1f9ec583bdc70588U},
+  {0x2d80f4584d5068daU, 0x13c33b72569c6375U}, {0x78e1316e60a48310U, 0x18b40a4eec437c52U}
+};
+
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_options_init(struct serializer_options *options) {
+  if (options == NULL) {
+    return;
+  }
+  memset(options, 0, sizeof(struct serializer_options));
+  options->precision = SERIALIZER_PRECISION_SHORTEST;
+  options->digits = DBL_DECIMAL_DIG;
+  options->parallel_threshold = SERIALIZER_PARALLEL_THRESHOLD;
+  options->sparse = SERIALIZER_SPARSE_NEVER;
+  options->sparse_density = SERIALIZER_SPARSE_DENSITY;
+  options->element_type = SERIALIZER_ELEMENT_LONG_DOUBLE;
+  options->layout = SERIALIZER_LAYOUT_ROW_MAJOR;
+  options->non_finite = SERIALIZER_NON_FINITE_REJECT;
+}
+
+/**
+ * Formats the special values that have no digits: zero, infinities and NaN.
+ *
+ * @param long double value
+ *   The value to format.
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ *
+ * @return int
+ *   Returns the length of the formatted text, or 0 if the value is not special.
+ */
+static int serializer_format_special(long double value, char *buffer) {
+  const char *text = NULL;
+  if (isnan(value)) {
+    text = signbit(value) ? "-nan" : "nan";
+  }
+  else if (isinf(value)) {
+    text = value < 0 ? "-inf" : "inf";
+  }
+  else if (value == 0) {
+    text = signbit(value) ? "-0" : "0";
+  }
+  if (text == NULL) {
+    return 0;
+  }
+  size_t length = strlen(text);
+  memcpy(buffer, text, length + 1);
+  return (int)length;
+}
+
+/**
+ * Formats an integral value with plain digits.
+ *
+ * Integral values below 2^63 are exact in every long double format, so their
+ * digits always round trip and no printf-style formatting is needed.
+ *
+ * @param long double value
+ *   The value to format.
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ *
+ * @return int
+ *   Returns the length of the formatted text, or 0 if the value is not a small
+ *   integer.
+ */
+static int serializer_format_integer(long double value, char *buffer) {
+  if (!(value > -9.2e18L && value < 9.2e18L)) {
+    return 0;
+  }
+  long long integer = (long long)value;
+  if ((long double)integer != value) {
+    return 0;
+  }
+  // Write the digits backwards into a scratch area, then copy them in place.
+  char digits[24];
+  int count = 0;
+  unsigned long long magnitude = integer < 0 ? 0ULL - (unsigned long long)integer : (unsigned long long)integer;
+  do {
+    digits[count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  int length = 0;
+  if (integer < 0) {
+    buffer[length++] = '-';
+  }
+  while (count > 0) {
+    buffer[length++] = digits[--count];
+  }
+  buffer[length] = '\0';
+  return length;
+}
+
+/**
+ * Returns the number of bits of 5^e, or 1 for e = 0.
+ *
+ * @param int e
+ *   The exponent, from 0 to 3528.
+ *
+ * @return int
+ *   Returns the bit length.
+ */
+static int serializer_pow5_bits(int e) {
+  return (int)(((uint32_t)e * 1217359U) >> 19) + 1;
+}
+
+/**
+ * Returns floor(log10(2^e)).
+ *
+ * @param int e
+ *   The exponent, from 0 to 1650.
+ *
+ * @return int
+ *   Returns the logarithm.
+ */
+static int serializer_log10_pow2(int e) {
+  return (int)(((uint32_t)e * 78913U) >> 18);
+}
+
+/**
+ * Returns floor(log10(5^e)).
+ *
+ * @param int e
+ *   The exponent, from 0 to 2620.
+ *
+ * @return int
+ *   Returns the logarithm.
+ */
+static int serializer_log10_pow5(int e) {
+  return (int)(((uint32_t)e * 732923U) >> 20);
+}
+
+/**
+ * Checks whether a value is a multiple of 5^p.
+ *
+ * @param uint64_t value
+ *   The nonzero value to check.
+ * @param int p
+ *   The power of five.
+ *
+ * @return int
+ *   Returns 1 if the value is a multiple, otherwise 0.
+ */
+static int serializer_multiple_of_pow5(uint64_t value, int p) {
+  int count = 0;
+  while (value % 5 == 0) {
+    value /= 5;
+    count++;
+  }
+  return count >= p;
+}
+
+/**
+ * Multiplies a 64-bit value by a 125-bit table entry and shifts the product.
+ *
+ * @param uint64_t m
+ *   The value, below 2^58.
+ * @param const uint64_t *multiplier
+ *   The low and high 64 bits of the table entry.
+ * @param int shift
+ *   The right shift, from 65 to 127.
+ *
+ * @return uint64_t
+ *   Returns the 64 low bits of (m * multiplier) >> shift.
+ */
+static uint64_t serializer_multiply_shift(uint64_t m, const uint64_t *multiplier, int shift) {
+  // Portable 64 x 64 -> 128 bit products, on 32-bit halves.
+  uint64_t words[2][2];
+  for (int i = 0; i < 2; i++) {
+    uint64_t a_low = m & 0xFFFFFFFFU;
+    uint64_t a_high = m >> 32;
+    uint64_t b_low = multiplier[i] & 0xFFFFFFFFU;
+    uint64_t b_high = multiplier[i] >> 32;
+    uint64_t low = a_low * b_low;
+    uint64_t middle = a_high * b_low + (low >> 32);
+    uint64_t cross = a_low * b_high + (middle & 0xFFFFFFFFU);
+    words[i][0] = (cross << 32) | (low & 0xFFFFFFFFU);
+    words[i][1] = a_high * b_high + (middle >> 32) + (cross >> 32);
+  }
+  // Add the high half of the low product to the high product.
+  uint64_t sum = words[0][1] + words[1][0];
+  uint64_t high = words[1][1] + (sum < words[0][1] ? 1 : 0);
+  shift -= 64;
+  return (high << (64 - shift)) | (sum >> shift);
+}
+
+/**
+ * Finds the shortest decimal digits that round trip to a binary float.
+ *
+ * This is the Ryu algorithm: the bounds of the rounding interval of the value
+ * are scaled by a power of ten using the 125-bit tables, then digits are
+ * removed while the bounds still differ. The value is m2 * 2^e2 with the
+ * interval bounds at (4 * m2 - 1 - mm_shift) / 4 and (4 * m2 + 2) / 4 ulps.
+ *
+ * @param uint64_t m2
+ *   The significand, including the implicit bit, below 2^54.
+ * @param int e2
+ *   The binary exponent, minus two.
+ * @param int mm_shift
+ *   Whether the lower bound is half an ulp away, which is not the case for
+ *   powers of two.
+ * @param int *exponent
+ *   Pointer receiving the decimal exponent of the last digit.
+ *
+ * @return uint64_t
+ *   Returns the digits, which have no trailing zeros.
+ */
+static uint64_t serializer_shortest_digits(uint64_t m2, int e2, int mm_shift, int *exponent) {
+  // Ties to even keep the bounds when the significand is even.
+  int accept_bounds = (m2 & 1) == 0;
+  uint64_t mv = 4 * m2;
+  uint64_t vr;
+  uint64_t vp;
+  uint64_t vm;
+  int e10;
+  int vm_trailing_zeros = 0;
+  int vr_trailing_zeros = 0;
+  if (e2 >= 0) {
+    int q = serializer_log10_pow2(e2) - (e2 > 3 ? 1 : 0);
+    int shift = -e2 + q + 124 + serializer_pow5_bits(q);
+    e10 = q;
+    vr = serializer_multiply_shift(mv, serializer_pow5_inverse[q], shift);
+    vp = serializer_multiply_shift(mv + 2, serializer_pow5_inverse[q], shift);
+    vm = serializer_multiply_shift(mv - 1 - mm_shift, serializer_pow5_inverse[q], shift);
+    // Only small powers of ten may divide the scaled values exactly.
+    if (q <= 21) {
+      if (mv % 5 == 0) {
+        vr_trailing_zeros = serializer_multiple_of_pow5(mv, q);
+      }
+      else if (accept_bounds) {
+        vm_trailing_zeros = serializer_multiple_of_pow5(mv - 1 - mm_shift, q);
+      }
+      else {
+        vp -= serializer_multiple_of_pow5(mv + 2, q);
+      }
+    }
+  }
+  else {
+    int q = serializer_log10_pow5(-e2) - (-e2 > 1 ? 1 : 0);
+    int i = -e2 - q;
+    int shift = q - (serializer_pow5_bits(i) - 125);
+    e10 = q + e2;
+    vr = serializer_multiply_shift(mv, serializer_pow5[i], shift);
+    vp = serializer_multiply_shift(mv + 2, serializer_pow5[i], shift);
+    vm = serializer_multiply_shift(mv - 1 - mm_shift, serializer_pow5[i], shift);
+    if (q <= 1) {
+      // The scaled value has at least q trailing zeros, mv being a multiple of 4.
+      vr_trailing_zeros = 1;
+      if (accept_bounds) {
+        vm_trailing_zeros = mm_shift == 1;
+      }
+      else {
+        vp--;
+      }
+    }
+    else if (q < 63) {
+      vr_trailing_zeros = (mv & ((1ULL << q) - 1)) == 0;
+    }
+  }
+  // Remove digits while the bounds still differ, rounding the last one.
+  int removed = 0;
+  int last_digit = 0;
+  uint64_t output;
+  if (vm_trailing_zeros || vr_trailing_zeros) {
+    // The rare case where a bound, or the value, is exactly representable.
+    while (vp / 10 > vm / 10) {
+      vm_trailing_zeros &= vm % 10 == 0;
+      vr_trailing_zeros &= last_digit == 0;
+      last_digit = (int)(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed++;
+    }
+    if (vm_trailing_zeros) {
+      while (vm % 10 == 0) {
+        vr_trailing_zeros &= last_digit == 0;
+        last_digit = (int)(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed++;
+      }
+    }
+    // An exact tie rounds to even.
+    if (vr_trailing_zeros && last_digit == 5 && vr % 2 == 0) {
+      last_digit = 4;
+    }
+    output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_digit >= 5 ? 1 : 0);
+  }
+  else {
+    int round_up = 0;
+    while (vp / 10 > vm / 10) {
+      round_up = vr % 10 >= 5;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed++;
+    }
+    output = vr + (vr == vm || round_up ? 1 : 0);
+  }
+  // Rounding up may leave trailing zeros.
+  while (output % 10 == 0) {
+    output /= 10;
+    removed++;
+  }
+  *exponent = e10 + removed;
+  return output;
+}
+
+/**
+ * Writes decimal digits the way printf's %g conversion does.
+ *
+ * The precision is the number of digits, so the fixed notation is used for
+ * decimal exponents from -4 to count - 1 and the exponent notation otherwise.
+ *
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ * @param int negative
+ *   Whether to write a minus sign.
+ * @param const char *digits
+ *   The significant digits, without trailing zeros.
+ * @param int count
+ *   The number of digits, at most LDBL_DECIMAL_DIG.
+ * @param int exponent
+ *   The decimal exponent of the first digit.
+ *
+ * @return int
+ *   Returns the length of the formatted text.
+ */
+static int serializer_format_digits(char *buffer, int negative, const char *digits, int count, int exponent) {
+  int length = 0;
+  if (negative) {
+    buffer[length++] = '-';
+  }
+  if (exponent < -4 || exponent >= count) {
+    buffer[length++] = digits[0];
+    if (count > 1) {
+      buffer[length++] = '.';
+      memcpy(buffer + length, digits + 1, (size_t)count - 1);
+      length += count - 1;
+    }
+    buffer[length++] = 'e';
+    buffer[length++] = exponent < 0 ? '-' : '+';
+    int magnitude = exponent < 0 ? -exponent : exponent;
+    char scratch[8];
+    int written = 0;
+    do {
+      scratch[written++] = (char)('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    // At least two exponent digits, like printf.
+    if (written == 1) {
+      scratch[written++] = '0';
+    }
+    while (written > 0) {
+      buffer[length++] = scratch[--written];
+    }
+  }
+  else if (exponent >= 0) {
+    memcpy(buffer + length, digits, (size_t)exponent + 1);
+    length += exponent + 1;
+    if (count > exponent + 1) {
+      buffer[length++] = '.';
+      memcpy(buffer + length, digits + exponent + 1, (size_t)(count - exponent - 1));
+      length += count - exponent - 1;
+    }
+  }
+  else {
+    buffer[length++] = '0';
+    buffer[length++] = '.';
+    memset(buffer + length, '0', (size_t)(-exponent - 1));
+    length += -exponent - 1;
+    memcpy(buffer + length, digits, (size_t)count);
+    length += count;
+  }
+  buffer[length] = '\0';
+  return length;
+}
+
+/**
+ * Writes the shortest digits of a binary float in the %g notation.
+ *
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ * @param int negative
+ *   Whether the value is negative.
+ * @param uint64_t mantissa
+ *   The stored significand field.
+ * @param int biased_exponent
+ *   The stored exponent field, neither 0 with a zero significand nor all ones.
+ * @param int mantissa_bits
+ *   The width of the significand field.
+ * @param int bias
+ *   The exponent bias of the format.
+ *
+ * @return int
+ *   Returns the length of the formatted text.
+ */
+static int serializer_format_shortest(char *buffer, int negative, uint64_t mantissa, int biased_exponent, int mantissa_bits, int bias) {
+  // Subnormals have no implicit bit and the exponent of the smallest normal.
+  uint64_t m2 = mantissa;
+  int e2 = 1 - bias - mantissa_bits - 2;
+  if (biased_exponent != 0) {
+    m2 |= 1ULL << mantissa_bits;
+    e2 = biased_exponent - bias - mantissa_bits - 2;
+  }
+  int exponent;
+  uint64_t output = serializer_shortest_digits(m2, e2, mantissa != 0 || biased_exponent <= 1, &exponent);
+  char scratch[24];
+  char digits[24];
+  int count = 0;
+  do {
+    scratch[count++] = (char)('0' + output % 10);
+    output /= 10;
+  } while (output > 0);
+  for (int i = 0; i < count; i++) {
+    digits[i] = scratch[count - 1 - i];
+  }
+  return serializer_format_digits(buffer, negative, digits, count, exponent + count - 1);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_format_long_double(long double value, char *buffer) {
+  int length = serializer_format_special(value, buffer);
+  if (length == 0) {
+    length = serializer_format_integer(value, buffer);
+  }
+  if (length > 0) {
+    return length;
+  }
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+  return serializer_format_double((double)value, buffer);
+#else
+  // Print every digit needed to round trip once, as d.ddd...e[+-]x.
+  char text[SERIALIZER_NUMBER_MAX_LENGTH];
+  int written = snprintf(text, sizeof(text), "%.*Le", LDBL_DECIMAL_DIG - 1, value);
+  if (written <= 0 || written >= (int)sizeof(text)) {
+    return snprintf(buffer, SERIALIZER_NUMBER_MAX_LENGTH, "%.*Lg", LDBL_DECIMAL_DIG, value);
+  }
+  int negative = text[0] == '-';
+  const char *cursor = text + negative;
+  char digits[LDBL_DECIMAL_DIG + 1];
+  digits[0] = *cursor;
+  memcpy(digits + 1, cursor + 2, LDBL_DECIMAL_DIG - 1);
+  int exponent = atoi(cursor + LDBL_DECIMAL_DIG + 2);
+  // A value with a round trip form of up to LDBL_DIG digits rounds to it at
+  // LDBL_DIG digits, so a single parse tells whether that form is enough.
+  // Such a form is less than half an ulp, under 10^LDBL_DECIMAL_DIG /
+  // 2^LDBL_MANT_DIG < 100 units of the last printed digit, plus the printing
+  // error away, so other digit tails skip the parse.
+  int tail = 0;
+  int units = 1;
+  for (int i = LDBL_DIG; i < LDBL_DECIMAL_DIG; i++) {
+    tail = tail * 10 + (digits[i] - '0');
+    units *= 10;
+  }
+  int count = LDBL_DECIMAL_DIG;
+  if (tail > 101 && tail < units - 101) {
+    while (count > 1 && digits[count - 1] == '0') {
+      count--;
+    }
+    return serializer_format_digits(buffer, negative, digits, count, exponent);
+  }
+  char rounded[LDBL_DECIMAL_DIG + 1];
+  int rounded_exponent = exponent;
+  memcpy(rounded, digits, LDBL_DIG);
+  if (digits[LDBL_DIG] >= '5') {
+    int i = LDBL_DIG - 1;
+    while (i >= 0 && rounded[i] == '9') {
+      rounded[i--] = '0';
+    }
+    if (i >= 0) {
+      rounded[i]++;
+    }
+    else {
+      rounded[0] = '1';
+      rounded_exponent++;
+    }
+  }
+  count = LDBL_DIG;
+  while (count > 1 && rounded[count - 1] == '0') {
+    count--;
+  }
+  length = serializer_format_digits(buffer, negative, rounded, count, rounded_exponent);
+  if (strtold(buffer, NULL) == value) {
+    return length;
+  }
+  // Otherwise keep every digit, dropping only the trailing zeros.
+  count = LDBL_DECIMAL_DIG;
+  while (count > 1 && digits[count - 1] == '0') {
+    count--;
+  }
+  return serializer_format_digits(buffer, negative, digits, count, exponent);
+#endif
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_format_double(double value, char *buffer) {
+  int length = serializer_format_special(value, buffer);
+  if (length == 0) {
+    length = serializer_format_integer(value, buffer);
+  }
+  if (length > 0) {
+    return length;
+  }
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(double));
+  return serializer_format_shortest(buffer, (int)(bits >> 63), bits & ((1ULL << 52) - 1), (int)((bits >> 52) & 0x7FF), 52, 1023);
+}
+
+/**
+ * Formats a float with the shortest text that round trips exactly.
+ *
+ * @param float value
+ *   The value to format.
+ * @param char *buffer
+ *   Output buffer of at least SERIALIZER_NUMBER_MAX_LENGTH bytes.
+ *
+ * @return int
+ *   Returns the length of the formatted text.
+ */
+static int serializer_format_float(float value, char *buffer) {
+  int length = serializer_format_special(value, buffer);
+  // Larger integers are shorter in exponent form, which also keeps the text
+  // within serializer_number_max_length().
+  if (length == 0 && value > -1e9f && value < 1e9f) {
+    length = serializer_format_integer(value, buffer);
+  }
+  if (length > 0) {
+    return length;
+  }
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(float));
+  return serializer_format_shortest(buffer, (int)(bits >> 31), bits & ((1U << 23) - 1), (int)((bits >> 23) & 0xFF), 23, 127);
+}
+
+/**
+ * Rounds a finite value to a binary format narrower than float.
+ *
+ * Scaling by a power of two is exact, so rounding the scaled value to an
+ * integer rounds the significand once, to nearest with ties to even.
+ *
+ * @param long double value
+ *   The value to round.
+ * @param int digits
+ *   The number of significand bits of the format, including the implicit one.
+ * @param int min_exponent
+ *   The exponent of the smallest normal value of the format.
+ * @param long double max
+ *   The largest finite value of the format.
+ *
+ * @return long double
+ *   Returns the rounded value.
+ */
+static long double serializer_round_narrow(long double value, int digits, int min_exponent, long double max) {
+  if (!isfinite(value) || value == 0) {
+    return value;
+  }
+  // Subnormals share the exponent of the smallest normal value.
+  int exponent = ilogbl(value);
+  if (exponent < min_exponent) {
+    exponent = min_exponent;
+  }
+  long double rounded = ldexpl(nearbyintl(ldexpl(value, digits - 1 - exponent)), exponent - (digits - 1));
+  return fabsl(rounded) > max ? copysignl(INFINITY, value) : rounded;
+}
+
+/**
+ * {@inheritdoc}
+ */
+long double serializer_element_round(long double value, int element_type) {
+  switch (element_type) {
+    case SERIALIZER_ELEMENT_LONG_DOUBLE:
+      return value;
+
+    case SERIALIZER_ELEMENT_FLOAT64:
+      return (double)value;
+
+    case SERIALIZER_ELEMENT_FLOAT32:
+      return (float)value;
+
+    case SERIALIZER_ELEMENT_FLOAT16:
+      return serializer_round_narrow(value, 11, -14, 65504.0L);
+
+    case SERIALIZER_ELEMENT_BFLOAT16:
+      return serializer_round_narrow(value, 8, -126, ldexpl(255.0L, 120));
+
+    default:
+      return NAN;
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+long double serializer_element_epsilon(int element_type) {
+  switch (element_type) {
+    case SERIALIZER_ELEMENT_LONG_DOUBLE:
+      return LDBL_EPSILON / 2;
+
+    case SERIALIZER_ELEMENT_FLOAT64:
+      return DBL_EPSILON / 2;
+
+    case SERIALIZER_ELEMENT_FLOAT32:
+      return FLT_EPSILON / 2;
+
+    case SERIALIZER_ELEMENT_FLOAT16:
+      return ldexpl(1.0L, -11);
+
+    case SERIALIZER_ELEMENT_BFLOAT16:
+      return ldexpl(1.0L, -8);
+
+    default:
+      return -1;
+  }
+}
+
+/**
+ * Checks whether the text encoders support an element type.
+ *
+ * @param int element_type
+ *   One of the serializer_element_type values.
+ *
+ * @return int
+ *   Returns 1 if the element type can be written as text, otherwise 0.
+ */
+static int serializer_text_element_type(int element_type) {
+  return element_type == SERIALIZER_ELEMENT_LONG_DOUBLE || element_type == SERIALIZER_ELEMENT_FLOAT64 || element_type == SERIALIZER_ELEMENT_FLOAT32;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct json *serializer_format_legacy(long double value, int element_type) {
+  if (!serializer_text_element_type(element_type)) {
+    return NULL;
+  }
+  // Reuse the JSON library formatter for byte-compatible output.
+  struct json *jvalue = json_number_string(serializer_element_round(value, element_type));
+  if (jvalue == NULL || jvalue->value == NULL) {
+    json_destroy(jvalue);
+    return NULL;
+  }
+  return jvalue;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_format_number(long double value, const struct serializer_options *options, char *buffer) {
+  int precision = options != NULL ? options->precision : SERIALIZER_PRECISION_SHORTEST;
+  int element_type = options != NULL ? options->element_type : SERIALIZER_ELEMENT_LONG_DOUBLE;
+  // Round to the element type first, every mode then formats the rounded value.
+  if (!serializer_text_element_type(element_type)) {
+    return -1;
+  }
+  value = serializer_element_round(value, element_type);
+  switch (precision) {
+    case SERIALIZER_PRECISION_SHORTEST:
+      if (element_type == SERIALIZER_ELEMENT_FLOAT32) {
+        return serializer_format_float((float)value, buffer);
+      }
+      if (element_type == SERIALIZER_ELEMENT_FLOAT64) {
+        return serializer_format_double((double)value, buffer);
+      }
+      return serializer_format_long_double(value, buffer);
+
+    case SERIALIZER_PRECISION_DOUBLE:
+      if (serializer_format_special(value, buffer) > 0) {
+        return (int)strlen(buffer);
+      }
+      return snprintf(buffer, SERIALIZER_NUMBER_MAX_LENGTH, "%.*g", DBL_DECIMAL_DIG, (double)value);
+
+    case SERIALIZER_PRECISION_FIXED: {
+      if (serializer_format_special(value, buffer) > 0) {
+        return (int)strlen(buffer);
+      }
+      int digits = options->digits;
+      if (digits < 1 || digits > LDBL_DECIMAL_DIG) {
+        return -1;
+      }
+      return snprintf(buffer, SERIALIZER_NUMBER_MAX_LENGTH, "%.*Lg", digits, value);
+    }
+
+    case SERIALIZER_PRECISION_LEGACY: {
+      // Only text that fits the fixed buffer is returned here, the buffer
+      // writers take the library text at its real length.
+      struct json *jvalue = serializer_format_legacy(value, element_type);
+      if (jvalue == NULL) {
+        return -1;
+      }
+      size_t length = strlen((const char *)jvalue->value);
+      if (length >= SERIALIZER_NUMBER_MAX_LENGTH) {
+        json_destroy(jvalue);
+        return -1;
+      }
+      memcpy(buffer, jvalue->value, length + 1);
+      json_destroy(jvalue);
+      return (int)length;
+    }
+
+    default:
+      return -1;
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_number_max_length(const struct serializer_options *options) {
+  int precision = options != NULL ? options->precision : SERIALIZER_PRECISION_SHORTEST;
+  int element_type = options != NULL ? options->element_type : SERIALIZER_ELEMENT_LONG_DOUBLE;
+  if (!serializer_text_element_type(element_type)) {
+    return -1;
+  }
+  // Sign, digits, decimal point and the longest exponent ("e-4951").
+  switch (precision) {
+    case SERIALIZER_PRECISION_SHORTEST:
+      if (element_type == SERIALIZER_ELEMENT_FLOAT32) {
+        return FLT_DECIMAL_DIG + 7;
+      }
+      if (element_type == SERIALIZER_ELEMENT_FLOAT64) {
+        return DBL_DECIMAL_DIG + 7;
+      }
+      return LDBL_DECIMAL_DIG + 8;
+
+    case SERIALIZER_PRECISION_DOUBLE:
+      return DBL_DECIMAL_DIG + 7;
+
+    case SERIALIZER_PRECISION_FIXED:
+      return options->digits < 1 || options->digits > LDBL_DECIMAL_DIG ? -1 : options->digits + 8;
+
+    case SERIALIZER_PRECISION_LEGACY:
+      // The JSON library text has no fixed bound.
+      return -1;
+
+    default:
+      return -1;
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+size_t serializer_text_size_bound(int rows, int columns, int number_length) {
+  // Every row holds its quoted numbers separated by commas inside brackets, and
+  // the rows are separated by commas inside the outer brackets.
+  size_t row_length = (size_t)columns * (number_length + 3) + 1;
+  return (size_t)rows * (row_length + 1) + 1;
+}
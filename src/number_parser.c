@@ -0,0 +1,207 @@
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+
+/**
+ * The largest power of ten exactly representable as a long double.
+ *
+ * 10^n is exact when 5^n fits in the significand, which holds up to 10^27 for
+ * the 64-bit x87 significand and up to 10^22 for a plain double.
+ */
+#if LDBL_MANT_DIG >= 64
+#define SERIALIZER_MAX_EXACT_POWER 27
+#else
+#define SERIALIZER_MAX_EXACT_POWER 22
+#endif
+
+/**
+ * The largest decimal significand converted exactly to long double.
+ */
+#if LDBL_MANT_DIG >= 64
+#define SERIALIZER_MAX_EXACT_SIGNIFICAND UINT64_MAX
+#else
+#define SERIALIZER_MAX_EXACT_SIGNIFICAND (UINT64_C(1) << 53)
+#endif
+
+/**
+ * Exact powers of ten used by the fast path.
+ */
+static const long double serializer_powers_of_ten[] = {
+  1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+  1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+  1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+/**
+ * Checks whether eight bytes are all ASCII digits, eight at a time.
+ *
+ * @param uint64_t chunk
+ *   Eight bytes loaded in little-endian order.
+ *
+ * @return int
+ *   Returns 1 if all bytes are digits, otherwise 0.
+ */
+static int serializer_is_eight_digits(uint64_t chunk) {
+  return (((chunk & UINT64_C(0xF0F0F0F0F0F0F0F0)) | (((chunk + UINT64_C(0x0606060606060606)) & UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4))
+    == UINT64_C(0x3333333333333333));
+}
+
+/**
+ * Converts eight ASCII digits to their integer value with three multiplications.
+ *
+ * @param uint64_t chunk
+ *   Eight digit bytes loaded in little-endian order.
+ *
+ * @return uint32_t
+ *   Returns the value of the eight digits.
+ */
+static uint32_t serializer_parse_eight_digits(uint64_t chunk) {
+  chunk = (chunk & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561 >> 8;
+  chunk = (chunk & UINT64_C(0x00FF00FF00FF00FF)) * 6553601 >> 16;
+  return (uint32_t)((chunk & UINT64_C(0x0000FFFF0000FFFF)) * UINT64_C(42949672960001) >> 32);
+}
+
+/**
+ * Parses a run of digits into the significand.
+ *
+ * @param const char **cursor
+ *   Pointer to the scan position, advanced past the digits.
+ * @param const char *limit
+ *   End of the number text.
+ * @param uint64_t *significand
+ *   The accumulated significand.
+ * @param int *digits
+ *   The number of significant digits accumulated so far.
+ *
+ * @return int
+ *   Returns the number of digits consumed.
+ */
+static int serializer_parse_digits(const char **cursor, const char *limit, uint64_t *significand, int *digits) {
+  const char *start = *cursor;
+  const char *current = start;
+  // Skip leading zeros, they are not significant.
+  if (*digits == 0) {
+    while (current < limit && *current == '0') {
+      current++;
+    }
+  }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Consume eight digits at a time while they fit in the significand.
+  while (limit - current >= 8 && *digits <= 11) {
+    uint64_t chunk;
+    memcpy(&chunk, current, 8);
+    if (!serializer_is_eight_digits(chunk)) {
+      break;
+    }
+    *significand = *significand * 100000000 + serializer_parse_eight_digits(chunk);
+    *digits += 8;
+    current += 8;
+  }
+#endif
+  // Consume the remaining digits one at a time.
+  while (current < limit && *current >= '0' && *current <= '9') {
+    if (*digits < 19) {
+      *significand = *significand * 10 + (uint64_t)(*current - '0');
+    }
+    // Digits past the 19th are only counted, they send the parse to the slow path.
+    if (*digits > 0 || *current != '0') {
+      (*digits)++;
+    }
+    current++;
+  }
+  *cursor = current;
+  return (int)(current - start);
+}
+
+/**
+ * Parses a number with the exact C library conversion.
+ *
+ * @param const char *text
+ *   Pointer to the number text.
+ * @param size_t length
+ *   Number of bytes of the number text.
+ * @param long double *value
+ *   Pointer receiving the parsed value.
+ *
+ * @return int
+ *   Returns 0 if the whole span is a valid number, otherwise 1.
+ */
+static int serializer_parse_number_slow(const char *text, size_t length, long double *value) {
+  char *end = NULL;
+  *value = strtold(text, &end);
+  return end == text + length && length > 0 ? 0 : 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_number(const char *text, size_t length, long double *value) {
+  const char *cursor = text;
+  const char *limit = text + length;
+  // Sign.
+  int negative = 0;
+  if (cursor < limit && (*cursor == '-' || *cursor == '+')) {
+    negative = *cursor == '-';
+    cursor++;
+  }
+  // Integer and fractional digits.
+  uint64_t significand = 0;
+  int digits = 0;
+  int consumed = serializer_parse_digits(&cursor, limit, &significand, &digits);
+  int exponent = 0;
+  if (cursor < limit && *cursor == '.') {
+    cursor++;
+    const char *fraction = cursor;
+    int fraction_digits = serializer_parse_digits(&cursor, limit, &significand, &digits);
+    consumed += fraction_digits;
+    exponent -= (int)(cursor - fraction);
+  }
+  // Hexadecimal numbers, infinities, NaN and other forms take the slow path.
+  if (consumed == 0) {
+    return serializer_parse_number_slow(text, length, value);
+  }
+  // Exponent.
+  if (cursor < limit && (*cursor == 'e' || *cursor == 'E')) {
+    cursor++;
+    int exponent_negative = 0;
+    if (cursor < limit && (*cursor == '-' || *cursor == '+')) {
+      exponent_negative = *cursor == '-';
+      cursor++;
+    }
+    if (cursor == limit || *cursor < '0' || *cursor > '9') {
+      return serializer_parse_number_slow(text, length, value);
+    }
+    int explicit_exponent = 0;
+    while (cursor < limit && *cursor >= '0' && *cursor <= '9') {
+      if (explicit_exponent < 100000) {
+        explicit_exponent = explicit_exponent * 10 + (*cursor - '0');
+      }
+      cursor++;
+    }
+    exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+  }
+  if (cursor != limit) {
+    return serializer_parse_number_slow(text, length, value);
+  }
+  // Zero is exact whatever the exponent.
+  if (significand == 0) {
+    *value = negative ? -0.0L : 0.0L;
+    return 0;
+  }
+  // Too many digits, or a power of ten that is not exact: use the exact path.
+  if (digits > 19 || significand > SERIALIZER_MAX_EXACT_SIGNIFICAND || exponent > SERIALIZER_MAX_EXACT_POWER
+      || exponent < -SERIALIZER_MAX_EXACT_POWER) {
+    return serializer_parse_number_slow(text, length, value);
+  }
+  // Both operands are exact, so a single multiplication or division rounds correctly.
+  long double result = (long double)significand;
+  if (exponent >= 0) {
+    result *= serializer_powers_of_ten[exponent];
+  }
+  else {
+    result /= serializer_powers_of_ten[-exponent];
+  }
+  *value = negative ? -result : result;
+  return 0;
+}
@@ -0,0 +1,231 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Work item of the parallel matrix encoder, one per chunk of rows.
+ */
+struct serializer_encode_chunk {
+  // The matrix being serialized.
+  struct matrix *object;
+  // The serializer options.
+  const struct serializer_options *options;
+  // Index of the first row of the chunk.
+  int first_row;
+  // Index one past the last row of the chunk.
+  int last_row;
+  // The chunk output buffer.
+  struct serializer_buffer buffer;
+  // The chunk status, 0 on success.
+  int status;
+};
+
+/**
+ * Thread entry point formatting one chunk of rows.
+ *
+ * @param void *argument
+ *   The chunk to encode.
+ *
+ * @return void*
+ *   Always NULL, the status is stored in the chunk.
+ */
+static void *serializer_encode_chunk_run(void *argument) {
+  struct serializer_encode_chunk *chunk = argument;
+  chunk->status = serializer_write_matrix_rows(&chunk->buffer, chunk->object, chunk->options, chunk->first_row, chunk->last_row);
+  return NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *matrix_serialize_parallel(struct matrix *object, const struct serializer_options *options, int threads) {
+  // Validates the input.
+  if (object == NULL) {
+    return NULL;
+  }
+  // Small matrices are not worth the thread start-up cost.
+  size_t threshold = options != NULL ? options->parallel_threshold : SERIALIZER_PARALLEL_THRESHOLD;
+  if (threads > object->rows) {
+    threads = object->rows;
+  }
+  // The CSR form and the column-major form are written serially.
+  if (threads <= 1 || (size_t)object->rows * object->columns < threshold || serializer_matrix_use_sparse(object, options)
+      || (options != NULL && options->layout != SERIALIZER_LAYOUT_ROW_MAJOR)) {
+    return matrix_serialize_with_options(object, options);
+  }
+  struct serializer_encode_chunk *chunks = calloc(threads, sizeof(struct serializer_encode_chunk));
+  pthread_t *workers = calloc(threads, sizeof(pthread_t));
+  int *started = calloc(threads, sizeof(int));
+  if (chunks == NULL || workers == NULL || started == NULL) {
+    free(chunks);
+    free(workers);
+    free(started);
+    return NULL;
+  }
+  // Split the rows into contiguous chunks, sizing each buffer from a per-element estimate.
+  size_t row_estimate = (size_t)object->columns * 24 + 4;
+  for (int i = 0; i < threads; i++) {
+    struct serializer_encode_chunk *chunk = &chunks[i];
+    chunk->object = object;
+    chunk->options = options;
+    chunk->first_row = (int)((long long)object->rows * i / threads);
+    chunk->last_row = (int)((long long)object->rows * (i + 1) / threads);
+    chunk->status = serializer_buffer_init(&chunk->buffer, row_estimate * (chunk->last_row - chunk->first_row));
+  }
+  // Format every chunk on its own thread, the calling thread takes the first one.
+  for (int i = 1; i < threads; i++) {
+    if (chunks[i].status == 0) {
+      started[i] = pthread_create(&workers[i], NULL, serializer_encode_chunk_run, &chunks[i]) == 0;
+    }
+  }
+  if (chunks[0].status == 0) {
+    serializer_encode_chunk_run(&chunks[0]);
+  }
+  for (int i = 1; i < threads; i++) {
+    if (started[i]) {
+      pthread_join(workers[i], NULL);
+    }
+    // Run the chunk inline when its thread could not be started.
+    else if (chunks[i].status == 0) {
+      serializer_encode_chunk_run(&chunks[i]);
+    }
+  }
+  // Stitch the chunks together in order.
+  size_t length = 2;
+  int status = 0;
+  for (int i = 0; i < threads; i++) {
+    status |= chunks[i].status;
+    length += chunks[i].buffer.length;
+  }
+  char *output = status == 0 ? malloc(length + 1) : NULL;
+  if (output != NULL) {
+    char *cursor = output;
+    *cursor++ = '[';
+    for (int i = 0; i < threads; i++) {
+      memcpy(cursor, chunks[i].buffer.data, chunks[i].buffer.length);
+      cursor += chunks[i].buffer.length;
+    }
+    *cursor++ = ']';
+    *cursor = '\0';
+  }
+  // Clear the used memory.
+  for (int i = 0; i < threads; i++) {
+    serializer_buffer_release(&chunks[i].buffer);
+  }
+  free(chunks);
+  free(workers);
+  free(started);
+  return output;
+}
+
+/**
+ * Work item of the parallel matrix decoder, one per range of rows.
+ */
+struct serializer_decode_chunk {
+  // The destination matrix.
+  struct matrix *object;
+  // Position of the opening bracket of every row.
+  const char **row_starts;
+  // Index of the first row of the range.
+  int first_row;
+  // Index one past the last row of the range.
+  int last_row;
+  // The range status, 0 on success.
+  int status;
+};
+
+/**
+ * Thread entry point parsing one range of rows.
+ *
+ * @param void *argument
+ *   The range to decode.
+ *
+ * @return void*
+ *   Always NULL, the status is stored in the chunk.
+ */
+static void *serializer_decode_chunk_run(void *argument) {
+  struct serializer_decode_chunk *chunk = argument;
+  for (int j = chunk->first_row; j < chunk->last_row; j++) {
+    if (serializer_parse_matrix_row(chunk->row_starts[j], chunk->object, j) == 1) {
+      chunk->status = 1;
+      return NULL;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize_parallel(const char *data, const struct serializer_options *options, int threads) {
+  // Validates the input.
+  if (data == NULL) {
+    return NULL;
+  }
+  // CSR text has no row boundaries to split on, it is decoded serially, and
+  // so is column-major text.
+  if (serializer_sparse_text(data) || (options != NULL && options->layout != SERIALIZER_LAYOUT_ROW_MAJOR)) {
+    return matrix_unserialize_with_options(data, options);
+  }
+  // Structural pre-scan, finds the shape and the row boundaries.
+  int rows = 0;
+  int columns = 0;
+  const char **row_starts = NULL;
+  if (serializer_scan_matrix_layout(data, &rows, &columns, &row_starts) == 1) {
+    return NULL;
+  }
+  struct matrix *matrix_object = matrix_create(rows, columns);
+  if (matrix_object == NULL) {
+    free(row_starts);
+    return NULL;
+  }
+  // Small inputs are not worth the thread start-up cost.
+  size_t threshold = options != NULL ? options->parallel_threshold : SERIALIZER_PARALLEL_THRESHOLD;
+  if (threads > rows) {
+    threads = rows;
+  }
+  if (threads <= 1 || (size_t)rows * columns < threshold) {
+    threads = 1;
+  }
+  struct serializer_decode_chunk *chunks = calloc(threads, sizeof(struct serializer_decode_chunk));
+  pthread_t *workers = calloc(threads, sizeof(pthread_t));
+  int *started = calloc(threads, sizeof(int));
+  int status = chunks == NULL || workers == NULL || started == NULL ? 1 : 0;
+  if (status == 0) {
+    // Parse disjoint row ranges, the calling thread takes the first one.
+    for (int i = 0; i < threads; i++) {
+      chunks[i].object = matrix_object;
+      chunks[i].row_starts = row_starts;
+      chunks[i].first_row = (int)((long long)rows * i / threads);
+      chunks[i].last_row = (int)((long long)rows * (i + 1) / threads);
+    }
+    for (int i = 1; i < threads; i++) {
+      started[i] = pthread_create(&workers[i], NULL, serializer_decode_chunk_run, &chunks[i]) == 0;
+    }
+    serializer_decode_chunk_run(&chunks[0]);
+    for (int i = 1; i < threads; i++) {
+      if (started[i]) {
+        pthread_join(workers[i], NULL);
+      }
+      // Run the range inline when its thread could not be started.
+      else {
+        serializer_decode_chunk_run(&chunks[i]);
+      }
+    }
+    for (int i = 0; i < threads; i++) {
+      status |= chunks[i].status;
+    }
+  }
+  // Clear the used memory.
+  free(chunks);
+  free(workers);
+  free(started);
+  free(row_starts);
+  if (status == 1) {
+    matrix_destroy(matrix_object);
+    return NULL;
+  }
+  return matrix_object;
+}
@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+
+/**
+ * The default arena block size in bytes.
+ */
+#define SERIALIZER_ARENA_DEFAULT_BLOCK_SIZE 65536
+
+/**
+ * Rounds a size up to the arena alignment.
+ *
+ * @param size_t size
+ *   The size to round.
+ *
+ * @return size_t
+ *   Returns the rounded size.
+ */
+static size_t serializer_arena_align(size_t size) {
+  size_t alignment = _Alignof(max_align_t);
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * Allocates a new arena block.
+ *
+ * @param size_t capacity
+ *   Number of usable bytes in the block.
+ *
+ * @return struct serializer_arena_block*
+ *   Returns the block, or NULL if an error occurred.
+ */
+static struct serializer_arena_block *serializer_arena_block_create(size_t capacity) {
+  struct serializer_arena_block *block = malloc(sizeof(struct serializer_arena_block) + capacity);
+  if (block == NULL) {
+    return NULL;
+  }
+  block->next = NULL;
+  block->capacity = capacity;
+  block->used = 0;
+  return block;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_arena *serializer_arena_create(size_t block_size) {
+  struct serializer_arena *arena = malloc(sizeof(struct serializer_arena));
+  if (arena == NULL) {
+    return NULL;
+  }
+  arena->block_size = serializer_arena_align(block_size > 0 ? block_size : SERIALIZER_ARENA_DEFAULT_BLOCK_SIZE);
+  arena->first = serializer_arena_block_create(arena->block_size);
+  if (arena->first == NULL) {
+    free(arena);
+    return NULL;
+  }
+  arena->current = arena->first;
+  arena->last = NULL;
+  return arena;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void *serializer_arena_alloc(struct serializer_arena *arena, size_t size) {
+  if (arena == NULL) {
+    return NULL;
+  }
+  size = serializer_arena_align(size > 0 ? size : 1);
+  // Move on to the following blocks, kept from before the last reset, until
+  // one has room; append a new block when none does.
+  struct serializer_arena_block *block = arena->current;
+  while (block->capacity - block->used < size) {
+    if (block->next == NULL) {
+      size_t capacity = size > arena->block_size ? size : arena->block_size;
+      block->next = serializer_arena_block_create(capacity);
+      if (block->next == NULL) {
+        return NULL;
+      }
+    }
+    block = block->next;
+  }
+  arena->current = block;
+  void *pointer = (unsigned char *)block->data + block->used;
+  block->used += size;
+  arena->last = pointer;
+  return pointer;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void *serializer_arena_realloc(struct serializer_arena *arena, void *pointer, size_t old_size, size_t new_size) {
+  if (arena == NULL) {
+    return NULL;
+  }
+  if (pointer == NULL) {
+    return serializer_arena_alloc(arena, new_size);
+  }
+  // Grow the most recent allocation in place when its block has room.
+  struct serializer_arena_block *block = arena->current;
+  if (pointer == arena->last) {
+    size_t offset = (unsigned char *)pointer - (unsigned char *)block->data;
+    size_t size = serializer_arena_align(new_size > 0 ? new_size : 1);
+    if (offset + size <= block->capacity) {
+      block->used = offset + size;
+      return pointer;
+    }
+  }
+  // Otherwise move it, the old memory is reclaimed on the next reset.
+  void *moved = serializer_arena_alloc(arena, new_size);
+  if (moved == NULL) {
+    return NULL;
+  }
+  memcpy(moved, pointer, old_size < new_size ? old_size : new_size);
+  return moved;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_arena_reset(struct serializer_arena *arena) {
+  if (arena == NULL) {
+    return;
+  }
+  // Only the blocks that were used need rewinding, they all precede current.
+  for (struct serializer_arena_block *block = arena->first; block != arena->current->next; block = block->next) {
+    block->used = 0;
+  }
+  arena->current = arena->first;
+  arena->last = NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_arena_destroy(struct serializer_arena *arena) {
+  if (arena == NULL) {
+    return;
+  }
+  struct serializer_arena_block *block = arena->first;
+  while (block != NULL) {
+    struct serializer_arena_block *next = block->next;
+    free(block);
+    block = next;
+  }
+  free(arena);
+}
@@ -0,0 +1,312 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * The default buffer capacity in bytes.
+ */
+#define SERIALIZER_BUFFER_DEFAULT_CAPACITY 4096
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_reserve(struct serializer_buffer *buffer, size_t extra) {
+  if (buffer == NULL || buffer->error) {
+    return 1;
+  }
+  // Sink buffers are fixed-size staging areas.
+  if (buffer->sink != NULL) {
+    return 0;
+  }
+  // Caller-owned memory can not grow.
+  if (buffer->fixed) {
+    if (buffer->length + extra + 1 > buffer->capacity) {
+      buffer->error = 1;
+      return 1;
+    }
+    return 0;
+  }
+  // Keep one extra byte available for the NUL terminator.
+  size_t required = buffer->length + extra + 1;
+  if (required <= buffer->capacity) {
+    return 0;
+  }
+  // Grow geometrically to keep appends amortized O(1).
+  size_t capacity = buffer->capacity > 0 ? buffer->capacity : SERIALIZER_BUFFER_DEFAULT_CAPACITY;
+  while (capacity < required) {
+    capacity *= 2;
+  }
+  uint64_t allocate = serializer_metrics_start();
+  char *data = buffer->arena != NULL
+    ? serializer_arena_realloc(buffer->arena, buffer->data, buffer->length, capacity)
+    : realloc(buffer->data, capacity);
+  serializer_metrics_stop(SERIALIZER_PHASE_ALLOCATE, allocate);
+  if (data == NULL) {
+    buffer->error = 1;
+    return 1;
+  }
+  serializer_metrics_count(0, 0, capacity - buffer->capacity);
+  buffer->data = data;
+  buffer->capacity = capacity;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_init(struct serializer_buffer *buffer, size_t capacity) {
+  // Validates the input.
+  if (buffer == NULL) {
+    return 1;
+  }
+  memset(buffer, 0, sizeof(struct serializer_buffer));
+  // Allocate the initial buffer memory.
+  buffer->capacity = capacity > 0 ? capacity : SERIALIZER_BUFFER_DEFAULT_CAPACITY;
+  uint64_t allocate = serializer_metrics_start();
+  buffer->data = malloc(buffer->capacity);
+  serializer_metrics_stop(SERIALIZER_PHASE_ALLOCATE, allocate);
+  if (buffer->data == NULL) {
+    buffer->capacity = 0;
+    return 1;
+  }
+  serializer_metrics_count(0, 0, buffer->capacity);
+  buffer->data[0] = '\0';
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_init_sink(struct serializer_buffer *buffer, serializer_sink sink, void *context, size_t capacity) {
+  // Validates the input.
+  if (sink == NULL || serializer_buffer_init(buffer, capacity) == 1) {
+    return 1;
+  }
+  buffer->sink = sink;
+  buffer->context = context;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_init_arena(struct serializer_buffer *buffer, struct serializer_arena *arena, size_t capacity) {
+  // Validates the input.
+  if (buffer == NULL || arena == NULL) {
+    return 1;
+  }
+  memset(buffer, 0, sizeof(struct serializer_buffer));
+  // Take the initial buffer memory from the arena.
+  buffer->arena = arena;
+  buffer->capacity = capacity > 0 ? capacity : SERIALIZER_BUFFER_DEFAULT_CAPACITY;
+  buffer->data = serializer_arena_alloc(arena, buffer->capacity);
+  if (buffer->data == NULL) {
+    buffer->capacity = 0;
+    return 1;
+  }
+  buffer->data[0] = '\0';
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_init_fixed(struct serializer_buffer *buffer, char *data, size_t capacity) {
+  // Validates the input, the NUL terminator needs one byte.
+  if (buffer == NULL || data == NULL || capacity == 0) {
+    return 1;
+  }
+  memset(buffer, 0, sizeof(struct serializer_buffer));
+  buffer->data = data;
+  buffer->capacity = capacity;
+  buffer->fixed = 1;
+  buffer->data[0] = '\0';
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_flush(struct serializer_buffer *buffer) {
+  if (buffer == NULL || buffer->error) {
+    return 1;
+  }
+  // Growable buffers keep their contents until detached.
+  if (buffer->sink == NULL || buffer->length == 0) {
+    return 0;
+  }
+  if (buffer->sink(buffer->data, buffer->length, buffer->context) != 0) {
+    buffer->error = 1;
+    return 1;
+  }
+  serializer_metrics_count(0, buffer->length, 0);
+  buffer->length = 0;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_write(struct serializer_buffer *buffer, const char *data, size_t length) {
+  if (buffer == NULL || buffer->error) {
+    return 1;
+  }
+  if (buffer->sink != NULL) {
+    // Flush the staging area first when the data does not fit in it.
+    if (buffer->length + length >= buffer->capacity && serializer_buffer_flush(buffer) == 1) {
+      return 1;
+    }
+    // Hand oversized writes straight to the sink.
+    if (length >= buffer->capacity) {
+      if (buffer->sink(data, length, buffer->context) != 0) {
+        buffer->error = 1;
+        return 1;
+      }
+      serializer_metrics_count(0, length, 0);
+      return 0;
+    }
+  }
+  else if (serializer_buffer_reserve(buffer, length) == 1) {
+    return 1;
+  }
+  memcpy(buffer->data + buffer->length, data, length);
+  buffer->length += length;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_putc(struct serializer_buffer *buffer, char character) {
+  // Fast path, the character fits in the available space.
+  if (buffer != NULL && !buffer->error && buffer->length + 1 < buffer->capacity) {
+    buffer->data[buffer->length++] = character;
+    return 0;
+  }
+  return serializer_buffer_write(buffer, &character, 1);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_write_text(struct serializer_buffer *buffer, const char *text) {
+  return serializer_buffer_write(buffer, text, strlen(text));
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_write_integer(struct serializer_buffer *buffer, uint64_t value) {
+  // Digits are produced from the right, 20 hold any 64-bit value.
+  char digits[20];
+  int length = 0;
+  do {
+    digits[sizeof(digits) - ++length] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  return serializer_buffer_write(buffer, digits + sizeof(digits) - length, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_buffer_write_number(struct serializer_buffer *buffer, long double value, const struct serializer_options *options) {
+  if (buffer == NULL || buffer->error) {
+    return 1;
+  }
+  // The legacy text has no fixed bound, it is written at its real length.
+  if (options != NULL && options->precision == SERIALIZER_PRECISION_LEGACY) {
+    struct json *jvalue = serializer_format_legacy(value, options->element_type);
+    if (jvalue == NULL) {
+      buffer->error = 1;
+      return 1;
+    }
+    serializer_buffer_putc(buffer, '"');
+    serializer_buffer_write_text(buffer, (const char *)jvalue->value);
+    json_destroy(jvalue);
+    return serializer_buffer_putc(buffer, '"');
+  }
+  // Format straight into the buffer when there is room for the longest number.
+  if (buffer->length + SERIALIZER_NUMBER_MAX_LENGTH + 2 < buffer->capacity) {
+    char *cursor = buffer->data + buffer->length;
+    int length = serializer_format_number(value, options, cursor + 1);
+    if (length < 0) {
+      buffer->error = 1;
+      return 1;
+    }
+    cursor[0] = '"';
+    cursor[length + 1] = '"';
+    buffer->length += length + 2;
+    return 0;
+  }
+  // Otherwise format into a scratch area first.
+  char text[SERIALIZER_NUMBER_MAX_LENGTH + 2];
+  int length = serializer_format_number(value, options, text + 1);
+  if (length < 0) {
+    buffer->error = 1;
+    return 1;
+  }
+  text[0] = '"';
+  text[length + 1] = '"';
+  return serializer_buffer_write(buffer, text, length + 2);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_buffer_clear(struct serializer_buffer *buffer) {
+  if (buffer == NULL) {
+    return;
+  }
+  buffer->length = 0;
+  buffer->error = 0;
+  if (buffer->data != NULL) {
+    buffer->data[0] = '\0';
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *serializer_buffer_detach(struct serializer_buffer *buffer, size_t *length) {
+  if (buffer == NULL || buffer->error || buffer->data == NULL) {
+    return NULL;
+  }
+  // Terminate the string, the reserve logic always keeps a spare byte.
+  buffer->data[buffer->length] = '\0';
+  char *data = buffer->data;
+  if (length != NULL) {
+    *length = buffer->length;
+  }
+  buffer->data = NULL;
+  buffer->length = 0;
+  buffer->capacity = 0;
+  return data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_buffer_release(struct serializer_buffer *buffer) {
+  if (buffer == NULL) {
+    return;
+  }
+  // Arena memory is reclaimed when the arena is reset, fixed memory belongs
+  // to the caller.
+  if (buffer->arena == NULL && !buffer->fixed) {
+    free(buffer->data);
+  }
+  buffer->data = NULL;
+  buffer->length = 0;
+  buffer->capacity = 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_count_sink(const char *data, size_t length, void *context) {
+  (void)data;
+  *(size_t *)context += length;
+  return 0;
+}
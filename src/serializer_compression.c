@@ -0,0 +1,577 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Number of bits of the match finder hash.
+ */
+#define SERIALIZER_LZ_HASH_BITS 14
+
+/**
+ * The shortest match worth encoding.
+ */
+#define SERIALIZER_LZ_MIN_MATCH 4
+
+/**
+ * The farthest a match can reach back.
+ */
+#define SERIALIZER_LZ_MAX_OFFSET 65535
+
+/**
+ * High bit of the stored length, set when a block is stored uncompressed.
+ */
+#define SERIALIZER_BLOCK_STORED 0x80000000U
+
+/**
+ * Writes a little-endian 32-bit value.
+ *
+ * @param unsigned char *data
+ *   Pointer to 4 bytes.
+ * @param uint32_t value
+ *   The value to write.
+ */
+static void serializer_store32(unsigned char *data, uint32_t value) {
+  data[0] = (unsigned char)value;
+  data[1] = (unsigned char)(value >> 8);
+  data[2] = (unsigned char)(value >> 16);
+  data[3] = (unsigned char)(value >> 24);
+}
+
+/**
+ * Reads a little-endian 32-bit value.
+ *
+ * @param const unsigned char *data
+ *   Pointer to 4 bytes.
+ *
+ * @return uint32_t
+ *   Returns the value.
+ */
+static uint32_t serializer_load32(const unsigned char *data) {
+  return (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+/**
+ * Hashes the 4 bytes at a position for the match finder.
+ *
+ * @param const unsigned char *data
+ *   Pointer to 4 bytes.
+ *
+ * @return uint32_t
+ *   Returns the hash table slot.
+ */
+static uint32_t serializer_lz_hash(const unsigned char *data) {
+  uint32_t sequence;
+  memcpy(&sequence, data, 4);
+  return (sequence * 2654435761U) >> (32 - SERIALIZER_LZ_HASH_BITS);
+}
+
+/**
+ * Writes the extension bytes of a literal or match length.
+ *
+ * @param unsigned char *output
+ *   The output position.
+ * @param unsigned char *end
+ *   The end of the output.
+ * @param size_t length
+ *   The part of the length not held by the token.
+ *
+ * @return unsigned char*
+ *   Returns the new output position, or NULL if the output is full.
+ */
+static unsigned char *serializer_lz_write_length(unsigned char *output, unsigned char *end, size_t length) {
+  while (length >= 255) {
+    if (output >= end) {
+      return NULL;
+    }
+    *output++ = 255;
+    length -= 255;
+  }
+  if (output >= end) {
+    return NULL;
+  }
+  *output++ = (unsigned char)length;
+  return output;
+}
+
+/**
+ * Writes one sequence: a token, the literals and the match that follows them.
+ *
+ * The token holds the literal length in its high nibble and the match length
+ * minus SERIALIZER_LZ_MIN_MATCH in its low nibble, 15 meaning that extension
+ * bytes follow. The last sequence of a block has literals only.
+ *
+ * @param unsigned char *output
+ *   The output position.
+ * @param unsigned char *end
+ *   The end of the output.
+ * @param const unsigned char *literals
+ *   The literal bytes.
+ * @param size_t literal_length
+ *   The number of literal bytes.
+ * @param size_t offset
+ *   How far back the match starts.
+ * @param size_t match_length
+ *   The match length, or 0 for the last sequence.
+ *
+ * @return unsigned char*
+ *   Returns the new output position, or NULL if the output is full.
+ */
+static unsigned char *serializer_lz_write_sequence(unsigned char *output, unsigned char *end, const unsigned char *literals, size_t literal_length, size_t offset, size_t match_length) {
+  if (output >= end) {
+    return NULL;
+  }
+  size_t match_code = match_length > 0 ? match_length - SERIALIZER_LZ_MIN_MATCH : 0;
+  unsigned char *token = output++;
+  *token = (unsigned char)((literal_length < 15 ? literal_length : 15) << 4 | (match_code < 15 ? match_code : 15));
+  if (literal_length >= 15 && (output = serializer_lz_write_length(output, end, literal_length - 15)) == NULL) {
+    return NULL;
+  }
+  if ((size_t)(end - output) < literal_length) {
+    return NULL;
+  }
+  memcpy(output, literals, literal_length);
+  output += literal_length;
+  if (match_length == 0) {
+    return output;
+  }
+  if (end - output < 2) {
+    return NULL;
+  }
+  output[0] = (unsigned char)offset;
+  output[1] = (unsigned char)(offset >> 8);
+  output += 2;
+  if (match_code >= 15 && (output = serializer_lz_write_length(output, end, match_code - 15)) == NULL) {
+    return NULL;
+  }
+  return output;
+}
+
+/**
+ * Compresses one block.
+ *
+ * @param const unsigned char *input
+ *   The block to compress.
+ * @param size_t length
+ *   The block length.
+ * @param unsigned char *output
+ *   The output memory.
+ * @param size_t capacity
+ *   The output capacity.
+ * @param uint32_t *table
+ *   The match finder hash table.
+ *
+ * @return size_t
+ *   Returns the compressed length, or 0 if it does not fit the capacity.
+ */
+static size_t serializer_lz_compress(const unsigned char *input, size_t length, unsigned char *output, size_t capacity, uint32_t *table) {
+  // Slots hold a position plus one, zero marks an empty slot.
+  memset(table, 0, sizeof(uint32_t) << SERIALIZER_LZ_HASH_BITS);
+  unsigned char *cursor = output;
+  unsigned char *end = output + capacity;
+  size_t anchor = 0;
+  size_t position = 0;
+  size_t misses = 0;
+  while (length >= SERIALIZER_LZ_MIN_MATCH && position <= length - SERIALIZER_LZ_MIN_MATCH) {
+    uint32_t hash = serializer_lz_hash(input + position);
+    size_t candidate = table[hash];
+    table[hash] = (uint32_t)position + 1;
+    if (candidate == 0 || position - (candidate - 1) > SERIALIZER_LZ_MAX_OFFSET || memcmp(input + candidate - 1, input + position, SERIALIZER_LZ_MIN_MATCH) != 0) {
+      // Step faster through data that does not compress.
+      position += 1 + (misses++ >> 6);
+      continue;
+    }
+    misses = 0;
+    size_t match = candidate - 1;
+    size_t match_length = SERIALIZER_LZ_MIN_MATCH;
+    while (position + match_length < length && input[match + match_length] == input[position + match_length]) {
+      match_length++;
+    }
+    cursor = serializer_lz_write_sequence(cursor, end, input + anchor, position - anchor, position - match, match_length);
+    if (cursor == NULL) {
+      return 0;
+    }
+    position += match_length;
+    anchor = position;
+    // Index a position inside the match, repeated patterns are found sooner.
+    if (position - 2 <= length - SERIALIZER_LZ_MIN_MATCH) {
+      table[serializer_lz_hash(input + position - 2)] = (uint32_t)(position - 2) + 1;
+    }
+  }
+  cursor = serializer_lz_write_sequence(cursor, end, input + anchor, length - anchor, 0, 0);
+  return cursor != NULL ? (size_t)(cursor - output) : 0;
+}
+
+/**
+ * Reads the extension bytes of a literal or match length.
+ *
+ * @param const unsigned char **input
+ *   The input position, advanced past the bytes read.
+ * @param const unsigned char *end
+ *   The end of the input.
+ * @param size_t limit
+ *   The largest acceptable length.
+ * @param size_t *length
+ *   The length, increased by the bytes read.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the input is malformed.
+ */
+static int serializer_lz_read_length(const unsigned char **input, const unsigned char *end, size_t limit, size_t *length) {
+  unsigned char byte;
+  do {
+    if (*input >= end || *length > limit) {
+      return 1;
+    }
+    byte = *(*input)++;
+    *length += byte;
+  } while (byte == 255);
+  return 0;
+}
+
+/**
+ * Decompresses one block.
+ *
+ * @param const unsigned char *input
+ *   The compressed block.
+ * @param size_t length
+ *   The compressed length.
+ * @param unsigned char *output
+ *   The output memory.
+ * @param size_t expected
+ *   The plaintext length.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the block is malformed.
+ */
+static int serializer_lz_decompress(const unsigned char *input, size_t length, unsigned char *output, size_t expected) {
+  const unsigned char *end = input + length;
+  size_t position = 0;
+  for (;;) {
+    if (input >= end) {
+      return 1;
+    }
+    unsigned char token = *input++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && serializer_lz_read_length(&input, end, expected, &literal_length) == 1) {
+      return 1;
+    }
+    if ((size_t)(end - input) < literal_length || expected - position < literal_length) {
+      return 1;
+    }
+    memcpy(output + position, input, literal_length);
+    input += literal_length;
+    position += literal_length;
+    // Only the last sequence ends right after its literals.
+    if (input == end) {
+      break;
+    }
+    if (end - input < 2) {
+      return 1;
+    }
+    size_t offset = (size_t)input[0] | (size_t)input[1] << 8;
+    input += 2;
+    size_t match_length = token & 15;
+    if (match_length == 15 && serializer_lz_read_length(&input, end, expected, &match_length) == 1) {
+      return 1;
+    }
+    match_length += SERIALIZER_LZ_MIN_MATCH;
+    if (offset == 0 || offset > position || expected - position < match_length) {
+      return 1;
+    }
+    // Matches may overlap the bytes they produce, which repeats a pattern.
+    unsigned char *destination = output + position;
+    const unsigned char *source = destination - offset;
+    if (offset >= match_length) {
+      memcpy(destination, source, match_length);
+    }
+    else {
+      for (size_t i = 0; i < match_length; i++) {
+        destination[i] = source[i];
+      }
+    }
+    position += match_length;
+  }
+  return position == expected ? 0 : 1;
+}
+
+/**
+ * Applies the filters to a block before compression.
+ *
+ * Trailing bytes that do not form a whole element are copied unchanged.
+ *
+ * @param const unsigned char *input
+ *   The plaintext block.
+ * @param unsigned char *output
+ *   The filtered block.
+ * @param size_t length
+ *   The block length.
+ * @param int filter
+ *   The serializer_compression_filter values.
+ * @param size_t size
+ *   The element size.
+ */
+static void serializer_filter_encode(const unsigned char *input, unsigned char *output, size_t length, int filter, size_t size) {
+  size_t count = length / size;
+  int shuffle = (filter & SERIALIZER_FILTER_SHUFFLE) != 0;
+  int delta = (filter & SERIALIZER_FILTER_DELTA) != 0;
+  for (size_t i = 0; i < count; i++) {
+    const unsigned char *element = input + i * size;
+    const unsigned char *previous = i > 0 ? element - size : element;
+    for (size_t b = 0; b < size; b++) {
+      unsigned char byte = delta && i > 0 ? element[b] ^ previous[b] : element[b];
+      output[shuffle ? b * count + i : i * size + b] = byte;
+    }
+  }
+  memcpy(output + count * size, input + count * size, length - count * size);
+}
+
+/**
+ * Reverts the filters of a block after decompression.
+ *
+ * @param const unsigned char *input
+ *   The filtered block.
+ * @param unsigned char *output
+ *   The plaintext block.
+ * @param size_t length
+ *   The block length.
+ * @param int filter
+ *   The serializer_compression_filter values.
+ * @param size_t size
+ *   The element size.
+ */
+static void serializer_filter_decode(const unsigned char *input, unsigned char *output, size_t length, int filter, size_t size) {
+  size_t count = length / size;
+  int shuffle = (filter & SERIALIZER_FILTER_SHUFFLE) != 0;
+  int delta = (filter & SERIALIZER_FILTER_DELTA) != 0;
+  for (size_t i = 0; i < count; i++) {
+    unsigned char *element = output + i * size;
+    const unsigned char *previous = i > 0 ? element - size : element;
+    for (size_t b = 0; b < size; b++) {
+      unsigned char byte = input[shuffle ? b * count + i : i * size + b];
+      element[b] = delta && i > 0 ? byte ^ previous[b] : byte;
+    }
+  }
+  memcpy(output + count * size, input + count * size, length - count * size);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_compressed_read_header(const unsigned char *data, size_t length, struct serializer_compressed_header *header) {
+  // Validates the input.
+  if (data == NULL || header == NULL || length < SERIALIZER_COMPRESSED_HEADER_SIZE || memcmp(data, SERIALIZER_COMPRESSED_MAGIC, 4) != 0) {
+    return 1;
+  }
+  header->version = data[4];
+  header->content = data[5];
+  header->filter = data[6];
+  header->element_size = (uint16_t)(data[8] | data[9] << 8);
+  header->block_size = serializer_load32(data + 12);
+  header->rows = serializer_load32(data + 16);
+  header->columns = serializer_load32(data + 20);
+  if (header->version != SERIALIZER_COMPRESSED_VERSION || header->content > SERIALIZER_CONTENT_MATRIX_BINARY) {
+    return 1;
+  }
+  if ((header->filter & ~(SERIALIZER_FILTER_DELTA | SERIALIZER_FILTER_SHUFFLE)) != 0 || header->element_size == 0) {
+    return 1;
+  }
+  if (header->block_size == 0 || header->block_size > SERIALIZER_COMPRESSION_MAX_BLOCK_SIZE) {
+    return 1;
+  }
+  // Matrix frames record the shape, so the decoder can allocate up front.
+  if (header->content != SERIALIZER_CONTENT_BYTES
+      && (header->rows == 0 || header->columns == 0 || header->rows > INT32_MAX || header->columns > INT32_MAX)) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_compressor *serializer_compressor_begin(serializer_sink sink, void *context, uint8_t content, int rows, int columns, int filter, size_t element_size) {
+  // Validates the input.
+  if (sink == NULL || element_size == 0 || element_size > UINT16_MAX || (filter & ~(SERIALIZER_FILTER_DELTA | SERIALIZER_FILTER_SHUFFLE)) != 0) {
+    return NULL;
+  }
+  struct serializer_compressor *compressor = calloc(1, sizeof(struct serializer_compressor));
+  if (compressor == NULL) {
+    return NULL;
+  }
+  compressor->sink = sink;
+  compressor->context = context;
+  compressor->filter = filter;
+  compressor->element_size = element_size;
+  compressor->block = malloc(SERIALIZER_COMPRESSION_BLOCK_SIZE);
+  compressor->scratch = filter != SERIALIZER_FILTER_NONE ? malloc(SERIALIZER_COMPRESSION_BLOCK_SIZE) : NULL;
+  compressor->output = malloc(SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE + SERIALIZER_COMPRESSION_BLOCK_SIZE);
+  compressor->table = malloc(sizeof(uint32_t) << SERIALIZER_LZ_HASH_BITS);
+  if (compressor->block == NULL || (filter != SERIALIZER_FILTER_NONE && compressor->scratch == NULL) || compressor->output == NULL || compressor->table == NULL) {
+    compressor->error = 1;
+    serializer_compressor_finish(compressor);
+    return NULL;
+  }
+  // The frame header goes out right away.
+  unsigned char header[SERIALIZER_COMPRESSED_HEADER_SIZE] = {0};
+  memcpy(header, SERIALIZER_COMPRESSED_MAGIC, 4);
+  header[4] = SERIALIZER_COMPRESSED_VERSION;
+  header[5] = content;
+  header[6] = (unsigned char)filter;
+  header[8] = (unsigned char)element_size;
+  header[9] = (unsigned char)(element_size >> 8);
+  serializer_store32(header + 12, SERIALIZER_COMPRESSION_BLOCK_SIZE);
+  serializer_store32(header + 16, (uint32_t)rows);
+  serializer_store32(header + 20, (uint32_t)columns);
+  if (sink((const char *)header, sizeof(header), context) != 0) {
+    compressor->error = 1;
+    serializer_compressor_finish(compressor);
+    return NULL;
+  }
+  return compressor;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_compressor *serializer_compressor_create(serializer_sink sink, void *context, int filter, size_t element_size) {
+  return serializer_compressor_begin(sink, context, SERIALIZER_CONTENT_BYTES, 0, 0, filter, element_size);
+}
+
+/**
+ * Compresses the collected block and hands it to the sink.
+ *
+ * @param struct serializer_compressor *compressor
+ *   The compressor.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the sink failed.
+ */
+static int serializer_compressor_flush(struct serializer_compressor *compressor) {
+  size_t length = compressor->length;
+  compressor->length = 0;
+  uint32_t checksum = serializer_crc32(0, compressor->block, length);
+  const unsigned char *source = compressor->block;
+  if (compressor->filter != SERIALIZER_FILTER_NONE) {
+    serializer_filter_encode(compressor->block, compressor->scratch, length, compressor->filter, compressor->element_size);
+    source = compressor->scratch;
+  }
+  // Blocks that do not shrink are stored as they are.
+  unsigned char *payload = compressor->output + SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE;
+  uint32_t stored = (uint32_t)serializer_lz_compress(source, length, payload, length - 1, compressor->table);
+  if (stored == 0) {
+    memcpy(payload, source, length);
+    stored = (uint32_t)length | SERIALIZER_BLOCK_STORED;
+  }
+  serializer_store32(compressor->output, stored);
+  serializer_store32(compressor->output + 4, (uint32_t)length);
+  serializer_store32(compressor->output + 8, checksum);
+  size_t total = SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE + (stored & ~SERIALIZER_BLOCK_STORED);
+  if (compressor->sink((const char *)compressor->output, total, compressor->context) != 0) {
+    compressor->error = 1;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_compressor_write(const char *data, size_t length, void *compressor) {
+  struct serializer_compressor *state = compressor;
+  if (state == NULL || state->error || (data == NULL && length > 0)) {
+    return 1;
+  }
+  // Fill the block, compressing it each time it is full.
+  while (length > 0) {
+    size_t room = SERIALIZER_COMPRESSION_BLOCK_SIZE - state->length;
+    size_t take = length < room ? length : room;
+    memcpy(state->block + state->length, data, take);
+    state->length += take;
+    data += take;
+    length -= take;
+    if (state->length == SERIALIZER_COMPRESSION_BLOCK_SIZE && serializer_compressor_flush(state) == 1) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_compressor_finish(struct serializer_compressor *compressor) {
+  if (compressor == NULL) {
+    return 1;
+  }
+  int status = compressor->error;
+  if (status == 0 && compressor->length > 0) {
+    status = serializer_compressor_flush(compressor);
+  }
+  // An empty block ends the frame.
+  if (status == 0) {
+    unsigned char end[SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE] = {0};
+    status = compressor->sink((const char *)end, sizeof(end), compressor->context) != 0 ? 1 : 0;
+  }
+  free(compressor->block);
+  free(compressor->scratch);
+  free(compressor->output);
+  free(compressor->table);
+  free(compressor);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_decompress(const unsigned char *data, size_t length, serializer_sink sink, void *context) {
+  struct serializer_compressed_header header;
+  if (sink == NULL || serializer_compressed_read_header(data, length, &header) == 1) {
+    return 1;
+  }
+  unsigned char *plain = malloc(header.block_size);
+  unsigned char *scratch = header.filter != SERIALIZER_FILTER_NONE ? malloc(header.block_size) : NULL;
+  int status = plain == NULL || (header.filter != SERIALIZER_FILTER_NONE && scratch == NULL) ? 1 : 0;
+  size_t position = SERIALIZER_COMPRESSED_HEADER_SIZE;
+  while (status == 0) {
+    if (length - position < SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE) {
+      status = 1;
+      break;
+    }
+    uint32_t stored = serializer_load32(data + position);
+    uint32_t plain_length = serializer_load32(data + position + 4);
+    uint32_t checksum = serializer_load32(data + position + 8);
+    position += SERIALIZER_COMPRESSED_BLOCK_HEADER_SIZE;
+    // The empty block ends the frame, nothing may follow it.
+    if (plain_length == 0) {
+      status = stored == 0 && checksum == 0 && position == length ? 0 : 1;
+      break;
+    }
+    size_t stored_length = stored & ~SERIALIZER_BLOCK_STORED;
+    int raw = (stored & SERIALIZER_BLOCK_STORED) != 0;
+    if (plain_length > header.block_size || stored_length > length - position || (raw && stored_length != plain_length)) {
+      status = 1;
+      break;
+    }
+    // Decompress into the scratch block when the filters must be reverted.
+    unsigned char *target = scratch != NULL ? scratch : plain;
+    if (raw) {
+      memcpy(target, data + position, plain_length);
+    }
+    else if (serializer_lz_decompress(data + position, stored_length, target, plain_length) == 1) {
+      status = 1;
+      break;
+    }
+    if (scratch != NULL) {
+      serializer_filter_decode(scratch, plain, plain_length, header.filter, header.element_size);
+    }
+    if (serializer_crc32(0, plain, plain_length) != checksum || sink((const char *)plain, plain_length, context) != 0) {
+      status = 1;
+      break;
+    }
+    position += stored_length;
+  }
+  free(plain);
+  free(scratch);
+  return status;
+}
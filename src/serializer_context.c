@@ -0,0 +1,165 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Makes sure the context scratch space holds at least the given number of values.
+ *
+ * @param struct matrixmath_serializer_ctx *ctx
+ *   The serializer context.
+ * @param size_t count
+ *   The number of values required.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int matrixmath_serializer_ctx_scratch(struct matrixmath_serializer_ctx *ctx, size_t count) {
+  if (count <= ctx->scratch_capacity) {
+    return 0;
+  }
+  // The previous contents are never needed, so free before allocating.
+  free(ctx->scratch);
+  ctx->scratch = malloc(count * sizeof(long double));
+  ctx->scratch_capacity = ctx->scratch != NULL ? count : 0;
+  return ctx->scratch != NULL ? 0 : 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrixmath_serializer_ctx *matrixmath_serializer_ctx_create(const struct serializer_options *options) {
+  struct matrixmath_serializer_ctx *ctx = calloc(1, sizeof(struct matrixmath_serializer_ctx));
+  if (ctx == NULL) {
+    return NULL;
+  }
+  if (serializer_buffer_init(&ctx->buffer, 0) == 1) {
+    free(ctx);
+    return NULL;
+  }
+  // Keep a copy of the options, the caller may reuse theirs.
+  if (options != NULL) {
+    ctx->options = *options;
+  }
+  else {
+    serializer_options_init(&ctx->options);
+  }
+  return ctx;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrixmath_serializer_ctx_reserve(struct matrixmath_serializer_ctx *ctx, int rows, int columns) {
+  // Validates the input.
+  if (ctx == NULL || rows <= 0 || columns <= 0) {
+    return 1;
+  }
+  // The matrix bound also covers a vector of rows * columns elements.
+  size_t elements = (size_t)rows * columns;
+  // The legacy text has no fixed bound, its buffer grows on first use.
+  int legacy = ctx->options.precision == SERIALIZER_PRECISION_LEGACY;
+  size_t bytes = legacy ? 0 : serializer_matrix_size_bound(rows, columns, &ctx->options);
+  if (bytes == 0 && !legacy) {
+    return 1;
+  }
+  serializer_buffer_clear(&ctx->buffer);
+  if (bytes > 0 && serializer_buffer_reserve(&ctx->buffer, bytes) == 1) {
+    return 1;
+  }
+  return matrixmath_serializer_ctx_scratch(ctx, elements);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void matrixmath_serializer_ctx_destroy(struct matrixmath_serializer_ctx *ctx) {
+  if (ctx == NULL) {
+    return;
+  }
+  serializer_buffer_release(&ctx->buffer);
+  free(ctx->scratch);
+  free(ctx);
+}
+
+/**
+ * {@inheritdoc}
+ */
+const char *vector_serialize_ctx(struct matrixmath_serializer_ctx *ctx, struct vector *object, size_t *length) {
+  if (ctx == NULL || object == NULL) {
+    return NULL;
+  }
+  // Rewind the retained buffer and stream the Vector representation into it.
+  serializer_buffer_clear(&ctx->buffer);
+  if (vector_serialize_to_stream(object, &ctx->options, &ctx->buffer) == 1) {
+    return NULL;
+  }
+  // The reserve logic always keeps a spare byte for the terminator.
+  ctx->buffer.data[ctx->buffer.length] = '\0';
+  if (length != NULL) {
+    *length = ctx->buffer.length;
+  }
+  return ctx->buffer.data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+const char *matrix_serialize_ctx(struct matrixmath_serializer_ctx *ctx, struct matrix *object, size_t *length) {
+  if (ctx == NULL || object == NULL) {
+    return NULL;
+  }
+  // Rewind the retained buffer and stream the Matrix representation into it.
+  serializer_buffer_clear(&ctx->buffer);
+  if (matrix_serialize_to_stream(object, &ctx->options, &ctx->buffer) == 1) {
+    return NULL;
+  }
+  // The reserve logic always keeps a spare byte for the terminator.
+  ctx->buffer.data[ctx->buffer.length] = '\0';
+  if (length != NULL) {
+    *length = ctx->buffer.length;
+  }
+  return ctx->buffer.data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+const long double *vector_unserialize_ctx(struct matrixmath_serializer_ctx *ctx, const char *data, int *capacity) {
+  // Validates the input.
+  if (ctx == NULL || data == NULL || capacity == NULL) {
+    return NULL;
+  }
+  // Scan the shape, then parse straight into the scratch space.
+  if (serializer_scan_vector_shape(data, capacity) == 1 || matrixmath_serializer_ctx_scratch(ctx, *capacity) == 1) {
+    return NULL;
+  }
+  if (serializer_parse_vector_values(data, ctx->scratch, *capacity) == 1) {
+    return NULL;
+  }
+  return ctx->scratch;
+}
+
+/**
+ * {@inheritdoc}
+ */
+const struct matrix_view *matrix_unserialize_ctx(struct matrixmath_serializer_ctx *ctx, const char *data) {
+  // Validates the input.
+  if (ctx == NULL || data == NULL) {
+    return NULL;
+  }
+  // Scan the shape, then parse straight into the scratch space.
+  int rows = 0;
+  int columns = 0;
+  if (serializer_scan_matrix_shape(data, &rows, &columns) == 1 || matrixmath_serializer_ctx_scratch(ctx, (size_t)rows * columns) == 1) {
+    return NULL;
+  }
+  if (serializer_parse_matrix_values(data, ctx->scratch, rows, columns) == 1) {
+    return NULL;
+  }
+  memset(&ctx->view, 0, sizeof(struct matrix_view));
+  ctx->view.rows = rows;
+  ctx->view.columns = columns;
+  ctx->view.values = ctx->scratch;
+  return &ctx->view;
+}
@@ -0,0 +1,243 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+#ifndef SERIALIZER_NO_METRICS
+
+/**
+ * Whether the instrumentation is recording, read once per call.
+ */
+static atomic_int serializer_metrics_on = 0;
+
+/**
+ * Totals merged from every finished call, guarded by the lock.
+ */
+static struct serializer_metrics serializer_metrics_totals;
+
+/**
+ * The registered callback and its context, guarded by the lock.
+ */
+static serializer_metrics_callback serializer_metrics_hook = NULL;
+static void *serializer_metrics_hook_context = NULL;
+
+/**
+ * Lock guarding the totals and the callback.
+ */
+static pthread_mutex_t serializer_metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Nesting depth of the instrumented calls running on this thread.
+ */
+static _Thread_local int serializer_metrics_depth = 0;
+
+/**
+ * Counters of the outermost instrumented call running on this thread.
+ */
+static _Thread_local struct serializer_metrics serializer_metrics_call;
+
+/**
+ * Reads the monotonic clock.
+ *
+ * @return uint64_t
+ *   The clock value in nanoseconds.
+ */
+static uint64_t serializer_metrics_clock(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * Adds the counters of a call to the totals.
+ *
+ * @param struct serializer_metrics *totals
+ *   The totals to update.
+ * @param const struct serializer_metrics *call
+ *   The counters of the call.
+ */
+static void serializer_metrics_merge(struct serializer_metrics *totals, const struct serializer_metrics *call) {
+  totals->calls += call->calls;
+  for (int i = 0; i < SERIALIZER_PHASE_COUNT; i++) {
+    totals->phase_calls[i] += call->phase_calls[i];
+    totals->phase_nanoseconds[i] += call->phase_nanoseconds[i];
+  }
+  totals->bytes_in += call->bytes_in;
+  totals->bytes_out += call->bytes_out;
+  totals->allocated_bytes += call->allocated_bytes;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_metrics_enable(int enabled) {
+  atomic_store_explicit(&serializer_metrics_on, enabled != 0, memory_order_relaxed);
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_set_callback(serializer_metrics_callback callback, void *context) {
+  pthread_mutex_lock(&serializer_metrics_lock);
+  serializer_metrics_hook = callback;
+  serializer_metrics_hook_context = context;
+  pthread_mutex_unlock(&serializer_metrics_lock);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_snapshot(struct serializer_metrics *metrics) {
+  if (metrics == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&serializer_metrics_lock);
+  *metrics = serializer_metrics_totals;
+  pthread_mutex_unlock(&serializer_metrics_lock);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_reset(void) {
+  pthread_mutex_lock(&serializer_metrics_lock);
+  memset(&serializer_metrics_totals, 0, sizeof(struct serializer_metrics));
+  pthread_mutex_unlock(&serializer_metrics_lock);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_metrics_begin(void) {
+  if (!atomic_load_explicit(&serializer_metrics_on, memory_order_relaxed)) {
+    return 0;
+  }
+  // Only the outermost call starts a fresh record, nested calls add to it.
+  if (serializer_metrics_depth++ == 0) {
+    memset(&serializer_metrics_call, 0, sizeof(struct serializer_metrics));
+  }
+  return 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+uint64_t serializer_metrics_start(void) {
+  return serializer_metrics_depth > 0 ? serializer_metrics_clock() : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_stop(int phase, uint64_t start) {
+  if (serializer_metrics_depth == 0) {
+    return;
+  }
+  serializer_metrics_call.phase_calls[phase]++;
+  serializer_metrics_call.phase_nanoseconds[phase] += serializer_metrics_clock() - start;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_count(size_t bytes_in, size_t bytes_out, size_t allocated_bytes) {
+  if (serializer_metrics_depth == 0) {
+    return;
+  }
+  serializer_metrics_call.bytes_in += bytes_in;
+  serializer_metrics_call.bytes_out += bytes_out;
+  serializer_metrics_call.allocated_bytes += allocated_bytes;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_end(int metrics, int phase, uint64_t start, const char *operation) {
+  if (!metrics) {
+    return;
+  }
+  // Nested calls are part of the outermost one, which times the whole span.
+  if (serializer_metrics_depth > 1) {
+    serializer_metrics_depth--;
+    return;
+  }
+  serializer_metrics_stop(phase, start);
+  serializer_metrics_depth = 0;
+  // Publish a copy of the call, the callback runs outside the lock and may
+  // itself make instrumented calls.
+  struct serializer_metrics call = serializer_metrics_call;
+  call.calls = 1;
+  pthread_mutex_lock(&serializer_metrics_lock);
+  serializer_metrics_merge(&serializer_metrics_totals, &call);
+  serializer_metrics_callback callback = serializer_metrics_hook;
+  void *context = serializer_metrics_hook_context;
+  pthread_mutex_unlock(&serializer_metrics_lock);
+  if (callback != NULL) {
+    callback(operation, &call, context);
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *serializer_matrix_create(int rows, int columns) {
+  uint64_t start = serializer_metrics_start();
+  struct matrix *object = matrix_create(rows, columns);
+  serializer_metrics_stop(SERIALIZER_PHASE_ALLOCATE, start);
+  if (object != NULL) {
+    serializer_metrics_count(0, 0, (size_t)rows * columns * sizeof(long double));
+  }
+  return object;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct vector *serializer_vector_create(int capacity) {
+  uint64_t start = serializer_metrics_start();
+  struct vector *object = vector_create(capacity);
+  serializer_metrics_stop(SERIALIZER_PHASE_ALLOCATE, start);
+  if (object != NULL) {
+    serializer_metrics_count(0, 0, (size_t)capacity * sizeof(long double));
+  }
+  return object;
+}
+
+#else
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_metrics_enable(int enabled) {
+  // The instrumentation is compiled out.
+  return enabled != 0 ? 1 : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_set_callback(serializer_metrics_callback callback, void *context) {
+  (void)callback;
+  (void)context;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_snapshot(struct serializer_metrics *metrics) {
+  if (metrics != NULL) {
+    memset(metrics, 0, sizeof(struct serializer_metrics));
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_metrics_reset(void) {
+}
+
+#endif
@@ -0,0 +1,801 @@
+#ifndef SERIALIZER_PRIVATE_H
+#define SERIALIZER_PRIVATE_H
+
+#include <float.h>
+#include "../include/matrixmath_serializer.h"
+
+/**
+ * Number of meaningful bytes in a long double.
+ *
+ * The x87 extended format only uses 10 of its storage bytes, the remaining
+ * padding is left zeroed so binary payloads stay deterministic.
+ */
+#if LDBL_MANT_DIG == 64
+#define SERIALIZER_LDBL_BYTES 10
+#else
+#define SERIALIZER_LDBL_BYTES sizeof(long double)
+#endif
+
+/**
+ * Scanner state used to parse serialized text without building a JSON tree.
+ */
+struct serializer_scanner {
+  // Start of the text being scanned.
+  const char *start;
+  // Current scan position.
+  const char *cursor;
+};
+
+/**
+ * Value token kinds returned by the scanner.
+ */
+enum serializer_token {
+  // The token is malformed.
+  SERIALIZER_TOKEN_ERROR = -1,
+  // The token is a JSON null, which the decoders skip.
+  SERIALIZER_TOKEN_NULL = 0,
+  // The token is a numeric value, quoted or bare.
+  SERIALIZER_TOKEN_NUMBER = 1,
+};
+
+/**
+ * Initializes a scanner over a NUL-terminated string.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner to initialize.
+ * @param const char *data
+ *   The text to scan.
+ */
+void serializer_scanner_init(struct serializer_scanner *scanner, const char *data);
+
+/**
+ * Skips the whitespace at the current scanner position.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ */
+void serializer_scanner_skip_whitespace(struct serializer_scanner *scanner);
+
+/**
+ * Skips whitespace and consumes the given character if it is next.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param char character
+ *   The expected character.
+ *
+ * @return int
+ *   Returns 1 if the character was consumed, otherwise 0.
+ */
+int serializer_scanner_consume(struct serializer_scanner *scanner, char character);
+
+/**
+ * Checks that only whitespace remains after the current position.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ *
+ * @return int
+ *   Returns 1 if the input is fully consumed, otherwise 0.
+ */
+int serializer_scanner_at_end(struct serializer_scanner *scanner);
+
+/**
+ * Skips over the next value token without converting it.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ *
+ * @return int
+ *   Returns one of the serializer_token values.
+ */
+int serializer_scanner_skip_value(struct serializer_scanner *scanner);
+
+/**
+ * Reads and converts the next value token.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param long double *value
+ *   Pointer receiving the numeric value.
+ *
+ * @return int
+ *   Returns one of the serializer_token values.
+ */
+int serializer_scanner_read_value(struct serializer_scanner *scanner, long double *value);
+
+/**
+ * Reads a non-negative decimal integer.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param uint64_t limit
+ *   The largest accepted value.
+ * @param uint64_t *value
+ *   Pointer receiving the integer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the token is not an integer in range.
+ */
+int serializer_scanner_read_integer(struct serializer_scanner *scanner, uint64_t limit, uint64_t *value);
+
+/**
+ * Reads an object key and the colon following it.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param const char **name
+ *   Pointer receiving the first character of the key, which is not terminated.
+ * @param size_t *length
+ *   Pointer receiving the key length.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+int serializer_scanner_read_key(struct serializer_scanner *scanner, const char **name, size_t *length);
+
+/**
+ * Scans one serialized vector, leaving the scanner right after it.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param int *capacity
+ *   Pointer receiving the number of non-null elements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed or empty.
+ */
+int serializer_scanner_scan_vector(struct serializer_scanner *scanner, int *capacity);
+
+/**
+ * Scans one dense serialized matrix, leaving the scanner right after it.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param int *rows
+ *   Pointer receiving the number of rows.
+ * @param int *columns
+ *   Pointer receiving the number of columns.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed or empty.
+ */
+int serializer_scanner_scan_matrix(struct serializer_scanner *scanner, int *rows, int *columns);
+
+/**
+ * Scans a serialized vector to find its number of elements.
+ *
+ * @param const char *data
+ *   The serialized vector string.
+ * @param int *capacity
+ *   Pointer receiving the number of non-null elements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+int serializer_scan_vector_shape(const char *data, int *capacity);
+
+/**
+ * Scans a serialized matrix to find its shape.
+ *
+ * Empty rows and null elements are skipped, the remaining rows must all hold
+ * the same number of elements.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param int *rows
+ *   Pointer receiving the number of rows.
+ * @param int *columns
+ *   Pointer receiving the number of columns.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+int serializer_scan_matrix_shape(const char *data, int *rows, int *columns);
+
+/**
+ * Scans a serialized matrix to find its shape and where each row starts.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param int *rows
+ *   Pointer receiving the number of rows.
+ * @param int *columns
+ *   Pointer receiving the number of columns.
+ * @param const char ***row_starts
+ *   Optional pointer receiving a malloc'd array with the position of the
+ *   opening bracket of every non-empty row, the caller must free it.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+int serializer_scan_matrix_layout(const char *data, int *rows, int *columns, const char ***row_starts);
+
+/**
+ * Parses a serialized vector into the storage of an existing vector.
+ *
+ * The vector capacity must match the serialized data, see
+ * serializer_scan_vector_shape().
+ *
+ * @param const char *data
+ *   The serialized vector string.
+ * @param struct vector *object
+ *   The destination vector.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_vector(const char *data, struct vector *object);
+
+/**
+ * Parses a serialized matrix into the storage of an existing matrix.
+ *
+ * The matrix shape must match the serialized data, see
+ * serializer_scan_matrix_shape().
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param struct matrix *object
+ *   The destination matrix.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_matrix(const char *data, struct matrix *object);
+
+/**
+ * Parses one serialized matrix row into a row of an existing matrix.
+ *
+ * @param const char *row_start
+ *   Pointer to the opening bracket of the row.
+ * @param struct matrix *object
+ *   The destination matrix.
+ * @param int row
+ *   The destination row index.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_matrix_row(const char *row_start, struct matrix *object, int row);
+
+/**
+ * Parses a serialized matrix into a contiguous row-major block of values.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param long double *values
+ *   The destination block, holding rows * columns values.
+ * @param int rows
+ *   The number of rows, see serializer_scan_matrix_shape().
+ * @param int columns
+ *   The number of columns.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_matrix_values(const char *data, long double *values, int rows, int columns);
+
+/**
+ * Parses a serialized vector into a contiguous block of values.
+ *
+ * @param const char *data
+ *   The serialized vector string.
+ * @param long double *values
+ *   The destination block, holding capacity values.
+ * @param int capacity
+ *   The number of elements, see serializer_scan_vector_shape().
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_vector_values(const char *data, long double *values, int capacity);
+
+/**
+ * Returns a pointer to a matrix row when its elements are stored contiguously.
+ *
+ * @param struct matrix *object
+ *   The matrix object.
+ * @param int row
+ *   The row index.
+ *
+ * @return long double*
+ *   Returns the pointer to the first element of the row, or NULL if the row is
+ *   not contiguous and must be accessed element by element.
+ */
+long double *serializer_matrix_row(struct matrix *object, int row);
+
+/**
+ * Writes a vector as a JSON array, without flushing the buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ * @param struct vector *object
+ *   The vector to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_write_vector(struct serializer_buffer *buffer, struct vector *object, const struct serializer_options *options);
+
+/**
+ * Writes a range of matrix rows as comma-separated JSON arrays.
+ *
+ * A comma is written before every row except row 0, so consecutive ranges
+ * concatenate into the body of the outer array.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ * @param struct matrix *object
+ *   The matrix to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param int first_row
+ *   Index of the first row to write.
+ * @param int last_row
+ *   Index one past the last row to write.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_write_matrix_rows(struct serializer_buffer *buffer, struct matrix *object, const struct serializer_options *options, int first_row, int last_row);
+
+/**
+ * Appends a NUL-terminated piece of text to a buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ * @param const char *text
+ *   The text to append, without its terminator.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_write_text(struct serializer_buffer *buffer, const char *text);
+
+/**
+ * Appends the decimal text of a non-negative integer to a buffer.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ * @param uint64_t value
+ *   The integer to append.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_buffer_write_integer(struct serializer_buffer *buffer, uint64_t value);
+
+/**
+ * Returns the longest text serializer_format_number() produces for an option set.
+ *
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return int
+ *   Returns the maximum number of characters, or -1 if the options are invalid
+ *   or select SERIALIZER_PRECISION_LEGACY, whose text has no fixed bound.
+ */
+int serializer_number_max_length(const struct serializer_options *options);
+
+/**
+ * Formats a number with the JSON library formatter.
+ *
+ * @param long double value
+ *   The value to format.
+ * @param int element_type
+ *   The element type the value is rounded to first.
+ *
+ * @return struct json*
+ *   Returns the JSON string holding the text, to be freed with json_destroy(),
+ *   or NULL if an error occurred.
+ */
+struct json *serializer_format_legacy(long double value, int element_type);
+
+/**
+ * Sink counting the bytes it receives without storing them.
+ *
+ * @param const char *data
+ *   The data, ignored.
+ * @param size_t length
+ *   The number of bytes.
+ * @param void *context
+ *   Pointer to the size_t total, increased by length.
+ *
+ * @return int
+ *   Always returns 0.
+ */
+int serializer_count_sink(const char *data, size_t length, void *context);
+
+/**
+ * Calculates an upper bound of the text length of a matrix.
+ *
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ * @param int number_length
+ *   The maximum length of a number, see serializer_number_max_length().
+ *
+ * @return size_t
+ *   Returns the maximum text length, not counting the NUL terminator.
+ */
+size_t serializer_text_size_bound(int rows, int columns, int number_length);
+
+/**
+ * Checks whether a serialized matrix uses the CSR form.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ *
+ * @return int
+ *   Returns 1 if the text holds a CSR object, otherwise 0.
+ */
+int serializer_sparse_text(const char *data);
+
+/**
+ * Scans and validates a serialized CSR matrix to find its shape.
+ *
+ * Everything but the conversion of the stored values is checked, so a matrix
+ * of the reported shape is only written by serializer_parse_sparse_matrix()
+ * if the text is well formed.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param int *rows
+ *   Pointer receiving the number of rows.
+ * @param int *columns
+ *   Pointer receiving the number of columns.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+int serializer_scan_sparse_shape(const char *data, int *rows, int *columns);
+
+/**
+ * Parses a serialized CSR matrix into a matrix or a contiguous block of values.
+ *
+ * Every destination row is zero-filled before its stored elements are set.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param struct matrix *object
+ *   The destination matrix, or NULL to write into values.
+ * @param long double *values
+ *   The row-major destination block used when no matrix is given.
+ * @param int rows
+ *   The expected number of rows.
+ * @param int columns
+ *   The expected number of columns.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_sparse_matrix(const char *data, struct matrix *object, long double *values, int rows, int columns);
+
+/**
+ * Tells whether a matrix element is stored by the CSR forms.
+ *
+ * Negative zero is stored like any nonzero value, the decoders fill the
+ * missing elements with positive zeros.
+ *
+ * @param long double value
+ *   The element value.
+ *
+ * @return int
+ *   Returns 1 if the element is stored, otherwise 0.
+ */
+int serializer_sparse_stored(long double value);
+
+/**
+ * Decides whether a matrix is encoded in the CSR form.
+ *
+ * @param struct matrix *object
+ *   The matrix to encode.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return int
+ *   Returns 1 if the CSR form is used, otherwise 0.
+ */
+int serializer_matrix_use_sparse(struct matrix *object, const struct serializer_options *options);
+
+/**
+ * Writes a matrix in the CSR form.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ * @param struct matrix *object
+ *   The matrix to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_write_matrix_sparse(struct serializer_buffer *buffer, struct matrix *object, const struct serializer_options *options);
+
+/**
+ * Calculates an upper bound of the text length of a matrix for an option set.
+ *
+ * The bound covers whichever of the dense and CSR forms the options allow.
+ *
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return size_t
+ *   Returns the maximum text length, not counting the NUL terminator, or 0 if
+ *   the options are invalid.
+ */
+size_t serializer_matrix_size_bound(int rows, int columns, const struct serializer_options *options);
+
+/**
+ * Returns the byte order of the host.
+ *
+ * @return uint8_t
+ *   Returns one of the serializer_endianness values.
+ */
+uint8_t serializer_host_endianness(void);
+
+/**
+ * Writes a binary payload header.
+ *
+ * @param unsigned char *data
+ *   Pointer to at least SERIALIZER_BINARY_HEADER_SIZE bytes.
+ * @param const struct serializer_binary_header *header
+ *   The header to write, in host byte order.
+ */
+void serializer_binary_write_header(unsigned char *data, const struct serializer_binary_header *header);
+
+/**
+ * Writes the dense binary payload of a vector into caller memory.
+ *
+ * @param unsigned char *data
+ *   Zero-filled memory of SERIALIZER_BINARY_HEADER_SIZE bytes plus one
+ *   sizeof(long double) slot per element.
+ * @param struct vector *object
+ *   The vector to write, holding at least one element.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an element could not be read.
+ */
+int serializer_binary_write_vector(unsigned char *data, struct vector *object);
+
+/**
+ * Writes the dense binary payload of a matrix into caller memory.
+ *
+ * @param unsigned char *data
+ *   Zero-filled memory of SERIALIZER_BINARY_HEADER_SIZE bytes plus one
+ *   sizeof(long double) slot per element.
+ * @param struct matrix *object
+ *   The matrix to write, holding at least one element.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an element could not be read.
+ */
+int serializer_binary_write_matrix(unsigned char *data, struct matrix *object);
+
+/**
+ * Starts a compressed frame, writing its header to the sink.
+ *
+ * @param serializer_sink sink
+ *   The sink receiving the compressed frame.
+ * @param void *context
+ *   Context pointer passed to the sink.
+ * @param uint8_t content
+ *   One of the serializer_compressed_content values.
+ * @param int rows
+ *   The number of rows of a matrix frame, otherwise 0.
+ * @param int columns
+ *   The number of columns of a matrix frame, otherwise 0.
+ * @param int filter
+ *   The serializer_compression_filter values to apply.
+ * @param size_t element_size
+ *   The element size used by the filters.
+ *
+ * @return struct serializer_compressor*
+ *   Returns the compressor, or NULL if an error occurred.
+ */
+struct serializer_compressor *serializer_compressor_begin(serializer_sink sink, void *context, uint8_t content, int rows, int columns, int filter, size_t element_size);
+
+/**
+ * Generates a binary bundle holding vectors or matrices.
+ *
+ * @param const char **keys
+ *   The keys.
+ * @param struct vector **vectors
+ *   The vectors, or NULL for a bundle of matrices.
+ * @param struct matrix **matrices
+ *   The matrices, or NULL for a bundle of vectors.
+ * @param int count
+ *   The number of objects.
+ * @param uint8_t kind
+ *   The serializer_binary_kind of the objects.
+ * @param uint8_t flags
+ *   The serializer_bundle_flag values; with SERIALIZER_BUNDLE_FLAG_SORTED the
+ *   entries are written in key order and keys must be unique.
+ * @param size_t *length
+ *   Pointer receiving the bundle length.
+ *
+ * @return unsigned char*
+ *   Returns the binary bundle, or NULL if an error occurred.
+ */
+unsigned char *serializer_bundle_serialize(const char **keys, struct vector **vectors, struct matrix **matrices, int count, uint8_t kind, uint8_t flags, size_t *length);
+
+/**
+ * Side of the square tiles, and width of the column strips, used to reorder
+ * matrix elements between row-major and column-major order.
+ *
+ * A tile of long double elements spans 4 KiB, so the rows read and the
+ * columns written by the transpose both stay in the L1 cache.
+ */
+#define SERIALIZER_TRANSPOSE_TILE 16
+
+/**
+ * Copies a strip of matrix columns into column-major memory.
+ *
+ * The rows are walked SERIALIZER_TRANSPOSE_TILE at a time, so every tile of
+ * the strip is transposed while it is cache resident.
+ *
+ * @param struct matrix *object
+ *   The source matrix.
+ * @param int first_column
+ *   The first column of the strip.
+ * @param int width
+ *   The number of columns of the strip, at most SERIALIZER_TRANSPOSE_TILE.
+ * @param long double *target
+ *   Destination of width * rows values, one column after the other.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an element could not be read.
+ */
+int serializer_matrix_gather_columns(struct matrix *object, int first_column, int width, long double *target);
+
+/**
+ * Copies a strip of column-major values into matrix columns.
+ *
+ * This is the inverse of serializer_matrix_gather_columns().
+ *
+ * @param struct matrix *object
+ *   The destination matrix.
+ * @param int first_column
+ *   The first column of the strip.
+ * @param int width
+ *   The number of columns of the strip, at most SERIALIZER_TRANSPOSE_TILE.
+ * @param const long double *source
+ *   Source of width * rows values, one column after the other.
+ */
+void serializer_matrix_scatter_columns(struct matrix *object, int first_column, int width, const long double *source);
+
+/**
+ * Writes the columns of a matrix as JSON arrays, without the enclosing brackets.
+ *
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ * @param struct matrix *object
+ *   The matrix to write.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_write_matrix_columns(struct serializer_buffer *buffer, struct matrix *object, const struct serializer_options *options);
+
+/**
+ * Parses a dense column-major matrix into the storage of an existing matrix.
+ *
+ * Every inner array holds one column, the matrix shape must match the
+ * transpose of serializer_scan_matrix_shape().
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param struct matrix *object
+ *   The destination matrix.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+int serializer_parse_matrix_columns(const char *data, struct matrix *object);
+
+#ifndef SERIALIZER_NO_METRICS
+
+/**
+ * Starts recording an instrumented call.
+ *
+ * @return int
+ *   Returns 1 if the call is recorded, to be passed to serializer_metrics_end(),
+ *   otherwise 0 if the instrumentation is off.
+ */
+int serializer_metrics_begin(void);
+
+/**
+ * Reads the clock at the start of a phase.
+ *
+ * @return uint64_t
+ *   The clock value, or 0 if no call is being recorded on this thread.
+ */
+uint64_t serializer_metrics_start(void);
+
+/**
+ * Records a finished phase of the current call.
+ *
+ * @param int phase
+ *   The serializer_phase value.
+ * @param uint64_t start
+ *   The value returned by serializer_metrics_start().
+ */
+void serializer_metrics_stop(int phase, uint64_t start);
+
+/**
+ * Adds byte counts to the current call.
+ *
+ * @param size_t bytes_in
+ *   The number of serialized bytes read.
+ * @param size_t bytes_out
+ *   The number of serialized bytes written.
+ * @param size_t allocated_bytes
+ *   The number of bytes allocated.
+ */
+void serializer_metrics_count(size_t bytes_in, size_t bytes_out, size_t allocated_bytes);
+
+/**
+ * Finishes recording an instrumented call.
+ *
+ * The outermost call merges its counters into the totals and invokes the
+ * registered callback.
+ *
+ * @param int metrics
+ *   The value returned by serializer_metrics_begin().
+ * @param int phase
+ *   The serializer_phase value spanning the whole call.
+ * @param uint64_t start
+ *   The value returned by serializer_metrics_start() after beginning.
+ * @param const char *operation
+ *   The name of the public function.
+ */
+void serializer_metrics_end(int metrics, int phase, uint64_t start, const char *operation);
+
+/**
+ * Creates a Matrix object, recording the allocation in the current call.
+ *
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ *
+ * @return struct matrix*
+ *   The new Matrix object, or NULL if the allocation failed.
+ */
+struct matrix *serializer_matrix_create(int rows, int columns);
+
+/**
+ * Creates a Vector object, recording the allocation in the current call.
+ *
+ * @param int capacity
+ *   The number of elements.
+ *
+ * @return struct vector*
+ *   The new Vector object, or NULL if the allocation failed.
+ */
+struct vector *serializer_vector_create(int capacity);
+
+#else
+
+// The instrumentation is compiled out, the hooks cost nothing.
+#define serializer_metrics_begin() 0
+#define serializer_metrics_start() ((uint64_t)0)
+#define serializer_metrics_stop(phase, start) ((void)(start))
+#define serializer_metrics_count(bytes_in, bytes_out, allocated_bytes) ((void)(bytes_in), (void)(bytes_out), (void)(allocated_bytes))
+#define serializer_metrics_end(metrics, phase, start, operation) ((void)(metrics), (void)(start))
+#define serializer_matrix_create(rows, columns) matrix_create(rows, columns)
+#define serializer_vector_create(capacity) vector_create(capacity)
+
+#endif
+
+#endif // SERIALIZER_PRIVATE_H
@@ -0,0 +1,584 @@
+#include <stdlib.h>
+#include <string.h>
+#include "serializer_private.h"
+
+/**
+ * Checks whether the given character is JSON whitespace.
+ *
+ * @param char character
+ *   The character to check.
+ *
+ * @return int
+ *   Returns 1 if the character is whitespace, otherwise 0.
+ */
+static int serializer_is_whitespace(char character) {
+  return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_scanner_skip_whitespace(struct serializer_scanner *scanner) {
+  while (serializer_is_whitespace(*scanner->cursor)) {
+    scanner->cursor++;
+  }
+}
+
+/**
+ * Checks whether the given character can be part of a bare numeric token.
+ *
+ * @param char character
+ *   The character to check.
+ *
+ * @return int
+ *   Returns 1 if the character belongs to a numeric token, otherwise 0.
+ */
+static int serializer_is_number_character(char character) {
+  return (character >= '0' && character <= '9') || character == '-' || character == '+'
+    || character == '.' || character == 'e' || character == 'E';
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_scanner_init(struct serializer_scanner *scanner, const char *data) {
+  scanner->start = data;
+  scanner->cursor = data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_consume(struct serializer_scanner *scanner, char character) {
+  serializer_scanner_skip_whitespace(scanner);
+  if (*scanner->cursor != character) {
+    return 0;
+  }
+  scanner->cursor++;
+  return 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_at_end(struct serializer_scanner *scanner) {
+  serializer_scanner_skip_whitespace(scanner);
+  return *scanner->cursor == '\0';
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_skip_value(struct serializer_scanner *scanner) {
+  serializer_scanner_skip_whitespace(scanner);
+  const char *cursor = scanner->cursor;
+  // Quoted number string, jump to the closing quote.
+  if (*cursor == '"') {
+    const char *closing = strchr(cursor + 1, '"');
+    if (closing == NULL || closing == cursor + 1) {
+      return SERIALIZER_TOKEN_ERROR;
+    }
+    scanner->cursor = closing + 1;
+    return SERIALIZER_TOKEN_NUMBER;
+  }
+  // Null values are skipped by the decoders.
+  if (strncmp(cursor, "null", 4) == 0) {
+    scanner->cursor = cursor + 4;
+    return SERIALIZER_TOKEN_NULL;
+  }
+  // Bare JSON number.
+  while (serializer_is_number_character(*cursor)) {
+    cursor++;
+  }
+  if (cursor == scanner->cursor) {
+    return SERIALIZER_TOKEN_ERROR;
+  }
+  scanner->cursor = cursor;
+  return SERIALIZER_TOKEN_NUMBER;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_read_value(struct serializer_scanner *scanner, long double *value) {
+  serializer_scanner_skip_whitespace(scanner);
+  const char *cursor = scanner->cursor;
+  // Quoted number string, the whole content must be numeric.
+  if (*cursor == '"') {
+    const char *closing = strchr(cursor + 1, '"');
+    if (closing == NULL || serializer_parse_number(cursor + 1, closing - cursor - 1, value) == 1) {
+      return SERIALIZER_TOKEN_ERROR;
+    }
+    scanner->cursor = closing + 1;
+    return SERIALIZER_TOKEN_NUMBER;
+  }
+  // Null values are skipped by the decoders.
+  if (strncmp(cursor, "null", 4) == 0) {
+    scanner->cursor = cursor + 4;
+    return SERIALIZER_TOKEN_NULL;
+  }
+  // Bare JSON number.
+  const char *end = cursor;
+  while (serializer_is_number_character(*end)) {
+    end++;
+  }
+  if (end == cursor || serializer_parse_number(cursor, end - cursor, value) == 1) {
+    return SERIALIZER_TOKEN_ERROR;
+  }
+  scanner->cursor = end;
+  return SERIALIZER_TOKEN_NUMBER;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_read_integer(struct serializer_scanner *scanner, uint64_t limit, uint64_t *value) {
+  serializer_scanner_skip_whitespace(scanner);
+  const char *cursor = scanner->cursor;
+  uint64_t result = 0;
+  while (*cursor >= '0' && *cursor <= '9') {
+    uint64_t digit = (uint64_t)(*cursor - '0');
+    if (digit > limit || result > (limit - digit) / 10) {
+      return 1;
+    }
+    result = result * 10 + digit;
+    cursor++;
+  }
+  if (cursor == scanner->cursor) {
+    return 1;
+  }
+  scanner->cursor = cursor;
+  *value = result;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_read_key(struct serializer_scanner *scanner, const char **name, size_t *length) {
+  if (!serializer_scanner_consume(scanner, '"')) {
+    return 1;
+  }
+  const char *closing = strchr(scanner->cursor, '"');
+  if (closing == NULL) {
+    return 1;
+  }
+  *name = scanner->cursor;
+  *length = closing - scanner->cursor;
+  scanner->cursor = closing + 1;
+  return serializer_scanner_consume(scanner, ':') ? 0 : 1;
+}
+
+/**
+ * Scans one JSON array of values, counting its non-null elements.
+ *
+ * The scanner must be positioned right after the opening bracket.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param int *count
+ *   Pointer receiving the number of non-null elements.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_scan_values(struct serializer_scanner *scanner, int *count) {
+  *count = 0;
+  if (serializer_scanner_consume(scanner, ']')) {
+    return 0;
+  }
+  do {
+    int token = serializer_scanner_skip_value(scanner);
+    if (token == SERIALIZER_TOKEN_ERROR) {
+      return 1;
+    }
+    *count += token;
+  } while (serializer_scanner_consume(scanner, ','));
+  return serializer_scanner_consume(scanner, ']') ? 0 : 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_scan_vector(struct serializer_scanner *scanner, int *capacity) {
+  if (!serializer_scanner_consume(scanner, '[') || serializer_scan_values(scanner, capacity) == 1) {
+    return 1;
+  }
+  return *capacity == 0 ? 1 : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scan_vector_shape(const char *data, int *capacity) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (serializer_scanner_scan_vector(&scanner, capacity) == 1 || !serializer_scanner_at_end(&scanner)) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scan_matrix_shape(const char *data, int *rows, int *columns) {
+  return serializer_scan_matrix_layout(data, rows, columns, NULL);
+}
+
+/**
+ * Scans one dense serialized matrix, leaving the scanner right after it.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param int *rows
+ *   Pointer receiving the number of rows.
+ * @param int *columns
+ *   Pointer receiving the number of columns.
+ * @param const char ***row_starts
+ *   Optional pointer receiving a malloc'd array with the position of the
+ *   opening bracket of every non-empty row, the caller must free it.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_scan_dense_matrix(struct serializer_scanner *scanner, int *rows, int *columns, const char ***row_starts) {
+  *rows = 0;
+  *columns = 0;
+  const char **starts = NULL;
+  int capacity = 0;
+  if (!serializer_scanner_consume(scanner, '[') || serializer_scanner_consume(scanner, ']')) {
+    return 1;
+  }
+  int status = 0;
+  do {
+    int count = 0;
+    if (!serializer_scanner_consume(scanner, '[')) {
+      status = 1;
+      break;
+    }
+    const char *start = scanner->cursor - 1;
+    if (serializer_scan_values(scanner, &count) == 1) {
+      status = 1;
+      break;
+    }
+    // Empty rows are skipped, the others must all have the same width.
+    if (count == 0) {
+      continue;
+    }
+    if (*rows > 0 && count != *columns) {
+      status = 1;
+      break;
+    }
+    // Record where the row starts when the caller asked for it.
+    if (row_starts != NULL && *rows == capacity) {
+      capacity = capacity > 0 ? capacity * 2 : 64;
+      const char **grown = realloc(starts, capacity * sizeof(const char *));
+      if (grown == NULL) {
+        status = 1;
+        break;
+      }
+      starts = grown;
+    }
+    if (row_starts != NULL) {
+      starts[*rows] = start;
+    }
+    *columns = count;
+    (*rows)++;
+  } while (serializer_scanner_consume(scanner, ','));
+  if (status == 1 || !serializer_scanner_consume(scanner, ']') || *rows == 0) {
+    free(starts);
+    return 1;
+  }
+  if (row_starts != NULL) {
+    *row_starts = starts;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scanner_scan_matrix(struct serializer_scanner *scanner, int *rows, int *columns) {
+  return serializer_scan_dense_matrix(scanner, rows, columns, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scan_matrix_layout(const char *data, int *rows, int *columns, const char ***row_starts) {
+  // CSR objects have no row text to point at.
+  if (serializer_sparse_text(data)) {
+    return row_starts == NULL ? serializer_scan_sparse_shape(data, rows, columns) : 1;
+  }
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (serializer_scan_dense_matrix(&scanner, rows, columns, row_starts) == 1) {
+    return 1;
+  }
+  if (!serializer_scanner_at_end(&scanner)) {
+    if (row_starts != NULL) {
+      free(*row_starts);
+    }
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+long double *serializer_matrix_row(struct matrix *object, int row) {
+  long double *first = matrix_getl(object, row, 0);
+  long double *last = matrix_getl(object, row, object->columns - 1);
+  if (first == NULL || last == NULL || last - first != object->columns - 1) {
+    return NULL;
+  }
+  return first;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_vector(const char *data, struct vector *object) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (!serializer_scanner_consume(&scanner, '[')) {
+    return 1;
+  }
+  int index = 0;
+  long double value;
+  do {
+    int token = serializer_scanner_read_value(&scanner, &value);
+    if (token == SERIALIZER_TOKEN_ERROR) {
+      return 1;
+    }
+    if (token == SERIALIZER_TOKEN_NULL) {
+      continue;
+    }
+    long double *lvalue = vector_getl(object, index++);
+    if (lvalue == NULL) {
+      return 1;
+    }
+    *lvalue = value;
+  } while (serializer_scanner_consume(&scanner, ','));
+  if (!serializer_scanner_consume(&scanner, ']') || index != object->capacity) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Parses the values of one matrix row into contiguous storage or a matrix.
+ *
+ * The scanner must be positioned right after the opening bracket of the row.
+ * Rows holding no values (empty or only null) are accepted and report a count
+ * of zero; any other row must hold exactly one value per column.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param long double *row
+ *   The contiguous destination row, or NULL to write through the matrix.
+ * @param struct matrix *object
+ *   The destination matrix used when no row is given, or NULL if the row has
+ *   no destination, in which case any value is an error.
+ * @param int j
+ *   The destination row index in the matrix.
+ * @param int columns
+ *   The number of columns.
+ * @param int *count
+ *   Pointer receiving the number of values parsed.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int serializer_parse_row_values(struct serializer_scanner *scanner, long double *row, struct matrix *object, int j, int columns, int *count) {
+  *count = 0;
+  // Empty rows are skipped.
+  if (serializer_scanner_consume(scanner, ']')) {
+    return 0;
+  }
+  long double value;
+  int k = 0;
+  do {
+    int token = serializer_scanner_read_value(scanner, &value);
+    if (token == SERIALIZER_TOKEN_ERROR) {
+      return 1;
+    }
+    if (token == SERIALIZER_TOKEN_NULL) {
+      continue;
+    }
+    if ((row == NULL && object == NULL) || k >= columns) {
+      return 1;
+    }
+    // Write straight into the row storage when it is contiguous.
+    if (row != NULL) {
+      row[k] = value;
+    }
+    else {
+      matrix_setl(object, j, k, value);
+    }
+    k++;
+  } while (serializer_scanner_consume(scanner, ','));
+  if (!serializer_scanner_consume(scanner, ']')) {
+    return 1;
+  }
+  // Rows holding only null values are skipped too.
+  if (k != 0 && k != columns) {
+    return 1;
+  }
+  *count = k;
+  return 0;
+}
+
+/**
+ * Parses the values of one matrix row.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param struct matrix *object
+ *   The destination matrix.
+ * @param int j
+ *   The destination row index.
+ * @param int *count
+ *   Pointer receiving the number of values parsed.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int serializer_parse_row(struct serializer_scanner *scanner, struct matrix *object, int j, int *count) {
+  if (j >= object->rows) {
+    return serializer_parse_row_values(scanner, NULL, NULL, j, object->columns, count);
+  }
+  return serializer_parse_row_values(scanner, serializer_matrix_row(object, j), object, j, object->columns, count);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_matrix(const char *data, struct matrix *object) {
+  if (serializer_sparse_text(data)) {
+    return serializer_parse_sparse_matrix(data, object, NULL, object->rows, object->columns);
+  }
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (!serializer_scanner_consume(&scanner, '[')) {
+    return 1;
+  }
+  int j = 0;
+  do {
+    int count = 0;
+    if (!serializer_scanner_consume(&scanner, '[') || serializer_parse_row(&scanner, object, j, &count) == 1) {
+      return 1;
+    }
+    if (count > 0) {
+      j++;
+    }
+  } while (serializer_scanner_consume(&scanner, ','));
+  if (!serializer_scanner_consume(&scanner, ']') || j != object->rows) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_matrix_row(const char *row_start, struct matrix *object, int row) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, row_start);
+  int count = 0;
+  if (!serializer_scanner_consume(&scanner, '[') || serializer_parse_row(&scanner, object, row, &count) == 1) {
+    return 1;
+  }
+  return count == object->columns ? 0 : 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_matrix_values(const char *data, long double *values, int rows, int columns) {
+  if (serializer_sparse_text(data)) {
+    return serializer_parse_sparse_matrix(data, NULL, values, rows, columns);
+  }
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (!serializer_scanner_consume(&scanner, '[')) {
+    return 1;
+  }
+  int j = 0;
+  do {
+    int count = 0;
+    long double *row = j < rows ? values + (size_t)j * columns : NULL;
+    if (!serializer_scanner_consume(&scanner, '[') || serializer_parse_row_values(&scanner, row, NULL, j, columns, &count) == 1) {
+      return 1;
+    }
+    if (count > 0) {
+      j++;
+    }
+  } while (serializer_scanner_consume(&scanner, ','));
+  if (!serializer_scanner_consume(&scanner, ']') || j != rows) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_matrix_columns(const char *data, struct matrix *object) {
+  // Columns are parsed into a strip, then moved into the rows a tile at a time.
+  long double *strip = malloc((size_t)SERIALIZER_TRANSPOSE_TILE * object->rows * sizeof(long double));
+  if (strip == NULL) {
+    return 1;
+  }
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  int status = serializer_scanner_consume(&scanner, '[') ? 0 : 1;
+  int k = 0;
+  int width = 0;
+  while (status == 0) {
+    int count = 0;
+    long double *column = k < object->columns ? strip + (size_t)width * object->rows : NULL;
+    if (!serializer_scanner_consume(&scanner, '[') || serializer_parse_row_values(&scanner, column, NULL, k, object->rows, &count) == 1) {
+      status = 1;
+      break;
+    }
+    if (count > 0) {
+      k++;
+      width++;
+    }
+    if (width == SERIALIZER_TRANSPOSE_TILE) {
+      serializer_matrix_scatter_columns(object, k - width, width, strip);
+      width = 0;
+    }
+    if (!serializer_scanner_consume(&scanner, ',')) {
+      break;
+    }
+  }
+  if (status == 0 && width > 0) {
+    serializer_matrix_scatter_columns(object, k - width, width, strip);
+  }
+  if (status == 0 && (!serializer_scanner_consume(&scanner, ']') || k != object->columns)) {
+    status = 1;
+  }
+  free(strip);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_vector_values(const char *data, long double *values, int capacity) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (!serializer_scanner_consume(&scanner, '[')) {
+    return 1;
+  }
+  int count = 0;
+  // A vector has the same syntax as a single matrix row.
+  if (serializer_parse_row_values(&scanner, values, NULL, 0, capacity, &count) == 1 || count != capacity) {
+    return 1;
+  }
+  return 0;
+}
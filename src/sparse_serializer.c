@@ -0,0 +1,457 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Fields of a CSR object, used to check that each appears exactly once.
+ */
+enum serializer_sparse_field {
+  SERIALIZER_SPARSE_FIELD_FORMAT = 1,
+  SERIALIZER_SPARSE_FIELD_ROWS = 2,
+  SERIALIZER_SPARSE_FIELD_COLUMNS = 4,
+  SERIALIZER_SPARSE_FIELD_ROW_OFFSETS = 8,
+  SERIALIZER_SPARSE_FIELD_COLUMN_INDICES = 16,
+  SERIALIZER_SPARSE_FIELD_VALUES = 32,
+  SERIALIZER_SPARSE_FIELD_ALL = 63,
+};
+
+/**
+ * Location of the parts of a serialized CSR object.
+ */
+struct serializer_sparse_layout {
+  // The number of rows.
+  int rows;
+  // The number of columns.
+  int columns;
+  // Opening bracket of the row offsets array.
+  const char *row_offsets;
+  // Opening bracket of the column indices array.
+  const char *column_indices;
+  // Opening bracket of the values array.
+  const char *values;
+};
+
+/**
+ * Maps an object key to the CSR field it names.
+ *
+ * @param const char *name
+ *   The first character of the key.
+ * @param size_t length
+ *   The key length.
+ *
+ * @return int
+ *   Returns one of the serializer_sparse_field values, or 0 if the key is unknown.
+ */
+static int serializer_sparse_field(const char *name, size_t length) {
+  static const char *names[] = {"format", "rows", "columns", "row_offsets", "column_indices", "values"};
+  for (int i = 0; i < 6; i++) {
+    if (strlen(names[i]) == length && memcmp(names[i], name, length) == 0) {
+      return 1 << i;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Skips an array of numbers, recording where it starts.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner.
+ * @param const char **start
+ *   Pointer receiving the position of the opening bracket.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_sparse_skip_array(struct serializer_scanner *scanner, const char **start) {
+  serializer_scanner_skip_whitespace(scanner);
+  *start = scanner->cursor;
+  if (!serializer_scanner_consume(scanner, '[')) {
+    return 1;
+  }
+  if (serializer_scanner_consume(scanner, ']')) {
+    return 0;
+  }
+  do {
+    if (serializer_scanner_skip_value(scanner) != SERIALIZER_TOKEN_NUMBER) {
+      return 1;
+    }
+  } while (serializer_scanner_consume(scanner, ','));
+  return serializer_scanner_consume(scanner, ']') ? 0 : 1;
+}
+
+/**
+ * Finds the shape and the arrays of a serialized CSR object.
+ *
+ * The keys may come in any order, but each must appear exactly once.
+ *
+ * @param const char *data
+ *   The serialized matrix string.
+ * @param struct serializer_sparse_layout *layout
+ *   Pointer receiving the layout.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_sparse_locate(const char *data, struct serializer_sparse_layout *layout) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  memset(layout, 0, sizeof(struct serializer_sparse_layout));
+  if (!serializer_scanner_consume(&scanner, '{')) {
+    return 1;
+  }
+  int seen = 0;
+  do {
+    const char *name;
+    size_t length;
+    uint64_t value = 0;
+    if (serializer_scanner_read_key(&scanner, &name, &length) == 1) {
+      return 1;
+    }
+    int field = serializer_sparse_field(name, length);
+    if (field == 0 || (seen & field) != 0) {
+      return 1;
+    }
+    seen |= field;
+    int status = 0;
+    switch (field) {
+      case SERIALIZER_SPARSE_FIELD_FORMAT:
+        status = serializer_scanner_consume(&scanner, '"') && strncmp(scanner.cursor, "csr\"", 4) == 0 ? 0 : 1;
+        scanner.cursor += status == 0 ? 4 : 0;
+        break;
+
+      case SERIALIZER_SPARSE_FIELD_ROWS:
+        status = serializer_scanner_read_integer(&scanner, INT32_MAX, &value);
+        layout->rows = (int)value;
+        break;
+
+      case SERIALIZER_SPARSE_FIELD_COLUMNS:
+        status = serializer_scanner_read_integer(&scanner, INT32_MAX, &value);
+        layout->columns = (int)value;
+        break;
+
+      case SERIALIZER_SPARSE_FIELD_ROW_OFFSETS:
+        status = serializer_sparse_skip_array(&scanner, &layout->row_offsets);
+        break;
+
+      case SERIALIZER_SPARSE_FIELD_COLUMN_INDICES:
+        status = serializer_sparse_skip_array(&scanner, &layout->column_indices);
+        break;
+
+      default:
+        status = serializer_sparse_skip_array(&scanner, &layout->values);
+        break;
+    }
+    if (status == 1) {
+      return 1;
+    }
+  } while (serializer_scanner_consume(&scanner, ','));
+  if (!serializer_scanner_consume(&scanner, '}') || !serializer_scanner_at_end(&scanner)) {
+    return 1;
+  }
+  return seen != SERIALIZER_SPARSE_FIELD_ALL || layout->rows == 0 || layout->columns == 0 ? 1 : 0;
+}
+
+/**
+ * Walks the three CSR arrays in lockstep, optionally writing the matrix.
+ *
+ * Without a destination the values are only skipped, which validates
+ * everything but their conversion.
+ *
+ * @param const struct serializer_sparse_layout *layout
+ *   The layout found by serializer_sparse_locate().
+ * @param struct matrix *object
+ *   The destination matrix, or NULL.
+ * @param long double *values
+ *   The row-major destination block used when no matrix is given, or NULL.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_sparse_walk(const struct serializer_sparse_layout *layout, struct matrix *object, long double *values) {
+  struct serializer_scanner offsets;
+  struct serializer_scanner indices;
+  struct serializer_scanner elements;
+  serializer_scanner_init(&offsets, layout->row_offsets);
+  serializer_scanner_init(&indices, layout->column_indices);
+  serializer_scanner_init(&elements, layout->values);
+  if (!serializer_scanner_consume(&offsets, '[') || !serializer_scanner_consume(&indices, '[') || !serializer_scanner_consume(&elements, '[')) {
+    return 1;
+  }
+  // The offsets start at zero and never decrease.
+  uint64_t limit = (uint64_t)layout->rows * layout->columns;
+  uint64_t previous = 0;
+  if (serializer_scanner_read_integer(&offsets, 0, &previous) == 1) {
+    return 1;
+  }
+  int write = object != NULL || values != NULL;
+  for (int j = 0; j < layout->rows; j++) {
+    uint64_t offset = 0;
+    if (!serializer_scanner_consume(&offsets, ',') || serializer_scanner_read_integer(&offsets, limit, &offset) == 1 || offset < previous) {
+      return 1;
+    }
+    // Zero the row, then set its stored elements.
+    long double *row = values != NULL ? values + (size_t)j * layout->columns : NULL;
+    if (row == NULL && object != NULL) {
+      row = serializer_matrix_row(object, j);
+    }
+    if (row != NULL) {
+      memset(row, 0, (size_t)layout->columns * sizeof(long double));
+    }
+    else if (object != NULL) {
+      for (int k = 0; k < layout->columns; k++) {
+        matrix_setl(object, j, k, 0.0L);
+      }
+    }
+    uint64_t next_column = 0;
+    for (uint64_t i = previous; i < offset; i++) {
+      uint64_t column = 0;
+      long double value = 0.0L;
+      if (i > 0 && (!serializer_scanner_consume(&indices, ',') || !serializer_scanner_consume(&elements, ','))) {
+        return 1;
+      }
+      // Columns are strictly increasing within a row.
+      if (serializer_scanner_read_integer(&indices, layout->columns - 1, &column) == 1 || column < next_column) {
+        return 1;
+      }
+      int token = write ? serializer_scanner_read_value(&elements, &value) : serializer_scanner_skip_value(&elements);
+      if (token != SERIALIZER_TOKEN_NUMBER) {
+        return 1;
+      }
+      next_column = column + 1;
+      if (row != NULL) {
+        row[column] = value;
+      }
+      else if (object != NULL) {
+        matrix_setl(object, j, (int)column, value);
+      }
+    }
+    previous = offset;
+  }
+  // The arrays must hold exactly the elements the offsets describe.
+  if (!serializer_scanner_consume(&offsets, ']') || !serializer_scanner_consume(&indices, ']') || !serializer_scanner_consume(&elements, ']')) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_sparse_text(const char *data) {
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  serializer_scanner_skip_whitespace(&scanner);
+  return *scanner.cursor == '{' ? 1 : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_scan_sparse_shape(const char *data, int *rows, int *columns) {
+  struct serializer_sparse_layout layout;
+  if (serializer_sparse_locate(data, &layout) == 1 || serializer_sparse_walk(&layout, NULL, NULL) == 1) {
+    return 1;
+  }
+  *rows = layout.rows;
+  *columns = layout.columns;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_parse_sparse_matrix(const char *data, struct matrix *object, long double *values, int rows, int columns) {
+  struct serializer_sparse_layout layout;
+  if (serializer_sparse_locate(data, &layout) == 1 || layout.rows != rows || layout.columns != columns) {
+    return 1;
+  }
+  return serializer_sparse_walk(&layout, object, values);
+}
+
+/**
+ * Returns the largest number of nonzero elements encoded as CSR in auto mode.
+ *
+ * @param const struct serializer_options *options
+ *   The serializer options.
+ * @param size_t elements
+ *   The number of matrix elements.
+ *
+ * @return size_t
+ *   Returns the highest nonzero count, or SIZE_MAX if the density is invalid.
+ */
+static size_t serializer_sparse_limit(const struct serializer_options *options, size_t elements) {
+  double density = options->sparse_density;
+  if (!(density >= 0.0)) {
+    return SIZE_MAX;
+  }
+  return density >= 1.0 ? elements : (size_t)(density * (double)elements);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_sparse_stored(long double value) {
+  return value != 0 || signbit(value) ? 1 : 0;
+}
+
+/**
+ * Reads one matrix element.
+ *
+ * @param struct matrix *object
+ *   The matrix.
+ * @param long double *row
+ *   The contiguous row storage, or NULL to go through the matrix.
+ * @param int j
+ *   The row index.
+ * @param int k
+ *   The column index.
+ * @param long double *value
+ *   Pointer receiving the element.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the element does not exist.
+ */
+static int serializer_sparse_get(struct matrix *object, const long double *row, int j, int k, long double *value) {
+  if (row != NULL) {
+    *value = row[k];
+    return 0;
+  }
+  long double *lvalue = matrix_getl(object, j, k);
+  if (lvalue == NULL) {
+    return 1;
+  }
+  *value = *lvalue;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_matrix_use_sparse(struct matrix *object, const struct serializer_options *options) {
+  int mode = options != NULL ? options->sparse : SERIALIZER_SPARSE_NEVER;
+  // The CSR form is row-major by definition.
+  if (options != NULL && options->layout == SERIALIZER_LAYOUT_COLUMN_MAJOR) {
+    return 0;
+  }
+  if (mode == SERIALIZER_SPARSE_ALWAYS) {
+    return 1;
+  }
+  if (mode != SERIALIZER_SPARSE_AUTO) {
+    return 0;
+  }
+  // Count the nonzero elements, stopping as soon as the limit is exceeded.
+  size_t limit = serializer_sparse_limit(options, (size_t)object->rows * object->columns);
+  if (limit == SIZE_MAX) {
+    return 0;
+  }
+  size_t count = 0;
+  long double value;
+  for (int j = 0; j < object->rows; j++) {
+    long double *row = serializer_matrix_row(object, j);
+    for (int k = 0; k < object->columns; k++) {
+      if (serializer_sparse_get(object, row, j, k, &value) == 1) {
+        return 0;
+      }
+      if (serializer_sparse_stored(value) && ++count > limit) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_write_matrix_sparse(struct serializer_buffer *buffer, struct matrix *object, const struct serializer_options *options) {
+  serializer_buffer_write_text(buffer, "{\"format\":\"csr\",\"rows\":");
+  serializer_buffer_write_integer(buffer, object->rows);
+  serializer_buffer_write_text(buffer, ",\"columns\":");
+  serializer_buffer_write_integer(buffer, object->columns);
+  // Each array takes its own pass over the matrix, so no index is buffered.
+  serializer_buffer_write_text(buffer, ",\"row_offsets\":[0");
+  uint64_t count = 0;
+  long double value;
+  for (int j = 0; j < object->rows; j++) {
+    long double *row = serializer_matrix_row(object, j);
+    for (int k = 0; k < object->columns; k++) {
+      if (serializer_sparse_get(object, row, j, k, &value) == 1) {
+        return 1;
+      }
+      count += serializer_sparse_stored(value);
+    }
+    serializer_buffer_putc(buffer, ',');
+    serializer_buffer_write_integer(buffer, count);
+  }
+  serializer_buffer_write_text(buffer, "],\"column_indices\":[");
+  count = 0;
+  for (int j = 0; j < object->rows; j++) {
+    long double *row = serializer_matrix_row(object, j);
+    for (int k = 0; k < object->columns; k++) {
+      if (serializer_sparse_get(object, row, j, k, &value) == 1) {
+        return 1;
+      }
+      if (!serializer_sparse_stored(value)) {
+        continue;
+      }
+      if (count++ > 0) {
+        serializer_buffer_putc(buffer, ',');
+      }
+      serializer_buffer_write_integer(buffer, k);
+    }
+  }
+  serializer_buffer_write_text(buffer, "],\"values\":[");
+  count = 0;
+  for (int j = 0; j < object->rows; j++) {
+    long double *row = serializer_matrix_row(object, j);
+    for (int k = 0; k < object->columns; k++) {
+      if (serializer_sparse_get(object, row, j, k, &value) == 1) {
+        return 1;
+      }
+      if (!serializer_sparse_stored(value)) {
+        continue;
+      }
+      if (count++ > 0) {
+        serializer_buffer_putc(buffer, ',');
+      }
+      if (serializer_buffer_write_number(buffer, value, options) == 1) {
+        return 1;
+      }
+    }
+  }
+  serializer_buffer_write_text(buffer, "]}");
+  return buffer->error;
+}
+
+/**
+ * {@inheritdoc}
+ */
+size_t serializer_matrix_size_bound(int rows, int columns, const struct serializer_options *options) {
+  int number_length = serializer_number_max_length(options);
+  if (number_length < 0) {
+    return 0;
+  }
+  // Column-major text is the dense text of the transpose.
+  if (options != NULL && options->layout == SERIALIZER_LAYOUT_COLUMN_MAJOR) {
+    return serializer_text_size_bound(columns, rows, number_length);
+  }
+  size_t dense = serializer_text_size_bound(rows, columns, number_length);
+  int mode = options != NULL ? options->sparse : SERIALIZER_SPARSE_NEVER;
+  if (mode != SERIALIZER_SPARSE_ALWAYS && mode != SERIALIZER_SPARSE_AUTO) {
+    return dense;
+  }
+  // Auto mode only writes CSR up to the density limit.
+  size_t stored = (size_t)rows * columns;
+  if (mode == SERIALIZER_SPARSE_AUTO) {
+    size_t limit = serializer_sparse_limit(options, stored);
+    stored = limit < stored ? limit : stored;
+  }
+  // The keys and the shape, one offset of up to 20 digits per row plus one,
+  // and a column index of up to 10 digits and a quoted number per element,
+  // each followed by a separator.
+  size_t sparse = 128 + ((size_t)rows + 1) * 21 + stored * (11 + (size_t)number_length + 3);
+  return sparse > dense ? sparse : dense;
+}
@@ -0,0 +1,562 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * State of a strict decode.
+ */
+struct serializer_strict {
+  // Start of the text, NULL for JSON trees.
+  const char *start;
+  // Current position in the text.
+  const char *cursor;
+  // The serializer options.
+  struct serializer_options options;
+  // The first error.
+  struct serializer_error *error;
+  // The values parsed so far, in input order.
+  long double *values;
+  // The number of values parsed.
+  size_t count;
+  // The number of values the buffer holds.
+  size_t capacity;
+};
+
+/**
+ * Records an error.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param int code
+ *   The serializer_error_code value.
+ * @param int row
+ *   The row index, or -1.
+ * @param int column
+ *   The column index, or -1.
+ * @param const char *at
+ *   Position of the error in the text, ignored for JSON trees.
+ *
+ * @return int
+ *   Always 1, so callers can return it.
+ */
+static int serializer_strict_fail(struct serializer_strict *state, int code, int row, int column, const char *at) {
+  state->error->code = code;
+  state->error->row = row;
+  state->error->column = column;
+  state->error->offset = state->start != NULL ? (size_t)(at - state->start) : 0;
+  return 1;
+}
+
+/**
+ * Initializes a strict decode.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param const char *data
+ *   The text, or NULL for JSON trees.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_error *error
+ *   The error to fill, or NULL to use a local one.
+ * @param struct serializer_error *local
+ *   Storage used when no error was given.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the options are invalid.
+ */
+static int serializer_strict_init(struct serializer_strict *state, const char *data, const struct serializer_options *options, struct serializer_error *error, struct serializer_error *local) {
+  memset(state, 0, sizeof(struct serializer_strict));
+  state->start = data;
+  state->cursor = data;
+  state->error = error != NULL ? error : local;
+  if (options != NULL) {
+    state->options = *options;
+  }
+  else {
+    serializer_options_init(&state->options);
+  }
+  serializer_strict_fail(state, SERIALIZER_ERROR_NONE, -1, -1, data);
+  if (serializer_element_epsilon(state->options.element_type) < 0
+      || (state->options.layout != SERIALIZER_LAYOUT_ROW_MAJOR && state->options.layout != SERIALIZER_LAYOUT_COLUMN_MAJOR)
+      || (state->options.non_finite != SERIALIZER_NON_FINITE_REJECT && state->options.non_finite != SERIALIZER_NON_FINITE_ALLOW)) {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_ARGUMENT, -1, -1, data);
+  }
+  return 0;
+}
+
+/**
+ * Checks a non-finite spelling: nan, inf or infinity, in any case and signed.
+ *
+ * @param const char *text
+ *   The token text.
+ * @param size_t length
+ *   The token length.
+ * @param long double *value
+ *   Pointer receiving the value.
+ *
+ * @return int
+ *   Returns 1 if the token is a non-finite spelling, otherwise 0.
+ */
+static int serializer_strict_non_finite(const char *text, size_t length, long double *value) {
+  int negative = 0;
+  if (length > 0 && (*text == '-' || *text == '+')) {
+    negative = *text == '-';
+    text++;
+    length--;
+  }
+  if ((length == 3 && strncasecmp(text, "nan", 3) == 0)) {
+    *value = negative ? -NAN : NAN;
+    return 1;
+  }
+  if ((length == 3 && strncasecmp(text, "inf", 3) == 0) || (length == 8 && strncasecmp(text, "infinity", 8) == 0)) {
+    *value = negative ? -INFINITY : INFINITY;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Checks the JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ *
+ * @param const char *text
+ *   The token text.
+ * @param size_t length
+ *   The token length.
+ *
+ * @return int
+ *   Returns 0 if the token is a JSON number, otherwise 1.
+ */
+static int serializer_strict_number_syntax(const char *text, size_t length) {
+  const char *cursor = text;
+  const char *limit = text + length;
+  if (cursor < limit && *cursor == '-') {
+    cursor++;
+  }
+  // Integer part, without leading zeros.
+  if (cursor < limit && *cursor == '0') {
+    cursor++;
+  }
+  else if (cursor < limit && *cursor >= '1' && *cursor <= '9') {
+    while (cursor < limit && *cursor >= '0' && *cursor <= '9') {
+      cursor++;
+    }
+  }
+  else {
+    return 1;
+  }
+  // Fraction.
+  if (cursor < limit && *cursor == '.') {
+    const char *digits = ++cursor;
+    while (cursor < limit && *cursor >= '0' && *cursor <= '9') {
+      cursor++;
+    }
+    if (cursor == digits) {
+      return 1;
+    }
+  }
+  // Exponent.
+  if (cursor < limit && (*cursor == 'e' || *cursor == 'E')) {
+    cursor++;
+    if (cursor < limit && (*cursor == '-' || *cursor == '+')) {
+      cursor++;
+    }
+    const char *digits = cursor;
+    while (cursor < limit && *cursor >= '0' && *cursor <= '9') {
+      cursor++;
+    }
+    if (cursor == digits) {
+      return 1;
+    }
+  }
+  return cursor == limit ? 0 : 1;
+}
+
+/**
+ * Converts and checks one value, then appends it to the parsed values.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param const char *text
+ *   The number text.
+ * @param size_t length
+ *   The number length.
+ * @param int row
+ *   The row index.
+ * @param int column
+ *   The column index.
+ * @param const char *at
+ *   Position of the value in the text.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 with the error recorded.
+ */
+static int serializer_strict_value(struct serializer_strict *state, const char *text, size_t length, int row, int column, const char *at) {
+  long double value;
+  if (serializer_strict_non_finite(text, length, &value)) {
+    if (state->options.non_finite != SERIALIZER_NON_FINITE_ALLOW) {
+      return serializer_strict_fail(state, SERIALIZER_ERROR_NON_FINITE, row, column, at);
+    }
+  }
+  else if (serializer_strict_number_syntax(text, length) == 1 || serializer_parse_number(text, length, &value) == 1) {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_NUMBER, row, column, at);
+  }
+  // A finite spelling must stay finite once stored as the element type.
+  else if (isinf(value) || isinf(serializer_element_round(value, state->options.element_type))) {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_OVERFLOW, row, column, at);
+  }
+  // Grow the value buffer geometrically.
+  if (state->count == state->capacity) {
+    size_t capacity = state->capacity > 0 ? state->capacity * 2 : 64;
+    long double *values = realloc(state->values, capacity * sizeof(long double));
+    if (values == NULL) {
+      return serializer_strict_fail(state, SERIALIZER_ERROR_MEMORY, row, column, at);
+    }
+    state->values = values;
+    state->capacity = capacity;
+  }
+  state->values[state->count++] = value;
+  return 0;
+}
+
+/**
+ * Skips JSON whitespace.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ */
+static void serializer_strict_skip_whitespace(struct serializer_strict *state) {
+  while (*state->cursor == ' ' || *state->cursor == '\n' || *state->cursor == '\r' || *state->cursor == '\t') {
+    state->cursor++;
+  }
+}
+
+/**
+ * Reads one value of the text, quoted or bare.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param int row
+ *   The row index.
+ * @param int column
+ *   The column index.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 with the error recorded.
+ */
+static int serializer_strict_read_value(struct serializer_strict *state, int row, int column) {
+  serializer_strict_skip_whitespace(state);
+  const char *at = state->cursor;
+  if (*at == '"') {
+    const char *closing = strchr(at + 1, '"');
+    if (closing == NULL) {
+      return serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, row, column, at);
+    }
+    state->cursor = closing + 1;
+    return serializer_strict_value(state, at + 1, closing - at - 1, row, column, at);
+  }
+  // A bare token runs up to the next delimiter.
+  const char *end = at;
+  while (*end != '\0' && *end != ',' && *end != ']' && *end != '[' && *end != '"' && *end != ' ' && *end != '\n' && *end != '\r' && *end != '\t') {
+    end++;
+  }
+  if (end == at) {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, row, column, at);
+  }
+  if (end - at == 4 && strncmp(at, "null", 4) == 0) {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_NULL, row, column, at);
+  }
+  state->cursor = end;
+  return serializer_strict_value(state, at, end - at, row, column, at);
+}
+
+/**
+ * Reads one array of values, checking its length.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param int row
+ *   The row index.
+ * @param int expected
+ *   The required number of values, or -1 to accept any non-zero number.
+ * @param int *count
+ *   Pointer receiving the number of values read.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 with the error recorded.
+ */
+static int serializer_strict_read_array(struct serializer_strict *state, int row, int expected, int *count) {
+  serializer_strict_skip_whitespace(state);
+  if (*state->cursor != '[') {
+    if (strncmp(state->cursor, "null", 4) == 0) {
+      return serializer_strict_fail(state, SERIALIZER_ERROR_NULL, row, -1, state->cursor);
+    }
+    return serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, row, -1, state->cursor);
+  }
+  state->cursor++;
+  serializer_strict_skip_whitespace(state);
+  *count = 0;
+  if (*state->cursor == ']') {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_SHAPE, row, 0, state->cursor);
+  }
+  while (1) {
+    serializer_strict_skip_whitespace(state);
+    if (expected >= 0 && *count == expected) {
+      return serializer_strict_fail(state, SERIALIZER_ERROR_SHAPE, row, *count, state->cursor);
+    }
+    if (serializer_strict_read_value(state, row, *count) == 1) {
+      return 1;
+    }
+    (*count)++;
+    serializer_strict_skip_whitespace(state);
+    if (*state->cursor == ']') {
+      break;
+    }
+    if (*state->cursor != ',') {
+      return serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, row, *count, state->cursor);
+    }
+    state->cursor++;
+  }
+  // A short row is reported at its closing bracket.
+  if (expected >= 0 && *count != expected) {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_SHAPE, row, *count, state->cursor);
+  }
+  state->cursor++;
+  return 0;
+}
+
+/**
+ * Checks that only whitespace is left in the text.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 with the error recorded.
+ */
+static int serializer_strict_read_end(struct serializer_strict *state) {
+  serializer_strict_skip_whitespace(state);
+  if (*state->cursor != '\0') {
+    return serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, -1, -1, state->cursor);
+  }
+  return 0;
+}
+
+/**
+ * Moves the parsed values into a new matrix.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param int arrays
+ *   The number of inner arrays.
+ * @param int length
+ *   The number of values of each inner array.
+ *
+ * @return struct matrix*
+ *   The matrix, or NULL with the error recorded.
+ */
+static struct matrix *serializer_strict_matrix(struct serializer_strict *state, int arrays, int length) {
+  int column_major = state->options.layout == SERIALIZER_LAYOUT_COLUMN_MAJOR;
+  int rows = column_major ? length : arrays;
+  int columns = column_major ? arrays : length;
+  struct matrix *object = serializer_matrix_create(rows, columns);
+  if (object == NULL) {
+    serializer_strict_fail(state, SERIALIZER_ERROR_MEMORY, -1, -1, state->cursor);
+    return NULL;
+  }
+  for (int j = 0; j < rows; j++) {
+    long double *row = serializer_matrix_row(object, j);
+    for (int k = 0; k < columns; k++) {
+      long double value = column_major ? state->values[(size_t)k * rows + j] : state->values[(size_t)j * columns + k];
+      if (row != NULL) {
+        row[k] = value;
+      }
+      else {
+        matrix_setl(object, j, k, value);
+      }
+    }
+  }
+  return object;
+}
+
+/**
+ * Decodes the text of a strict matrix decode.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ *
+ * @return struct matrix*
+ *   The matrix, or NULL with the error recorded.
+ */
+static struct matrix *serializer_strict_read_matrix(struct serializer_strict *state) {
+  serializer_strict_skip_whitespace(state);
+  if (*state->cursor != '[') {
+    serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, -1, -1, state->cursor);
+    return NULL;
+  }
+  state->cursor++;
+  serializer_strict_skip_whitespace(state);
+  if (*state->cursor == ']') {
+    serializer_strict_fail(state, SERIALIZER_ERROR_SHAPE, -1, -1, state->cursor);
+    return NULL;
+  }
+  // The first row fixes the length of every other one.
+  int arrays = 0;
+  int length = -1;
+  while (1) {
+    int count = 0;
+    if (serializer_strict_read_array(state, arrays, length, &count) == 1) {
+      return NULL;
+    }
+    length = count;
+    arrays++;
+    serializer_strict_skip_whitespace(state);
+    if (*state->cursor == ']') {
+      break;
+    }
+    if (*state->cursor != ',') {
+      serializer_strict_fail(state, SERIALIZER_ERROR_SYNTAX, arrays, -1, state->cursor);
+      return NULL;
+    }
+    state->cursor++;
+  }
+  state->cursor++;
+  if (serializer_strict_read_end(state) == 1) {
+    return NULL;
+  }
+  return serializer_strict_matrix(state, arrays, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize_strict(const char *data, const struct serializer_options *options, struct serializer_error *error) {
+  struct serializer_error local;
+  struct serializer_strict state;
+  if (serializer_strict_init(&state, data, options, error, &local) == 1) {
+    return NULL;
+  }
+  if (data == NULL) {
+    serializer_strict_fail(&state, SERIALIZER_ERROR_ARGUMENT, -1, -1, data);
+    return NULL;
+  }
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  uint64_t parse = serializer_metrics_start();
+  struct matrix *matrix_object = serializer_strict_read_matrix(&state);
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+  serializer_metrics_count(state.cursor - data, 0, 0);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  free(state.values);
+  return matrix_object;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct vector *vector_unserialize_strict(const char *data, const struct serializer_options *options, struct serializer_error *error) {
+  struct serializer_error local;
+  struct serializer_strict state;
+  if (serializer_strict_init(&state, data, options, error, &local) == 1) {
+    return NULL;
+  }
+  if (data == NULL) {
+    serializer_strict_fail(&state, SERIALIZER_ERROR_ARGUMENT, -1, -1, data);
+    return NULL;
+  }
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  struct vector *vector_object = NULL;
+  int count = 0;
+  if (serializer_strict_read_array(&state, 0, -1, &count) == 0 && serializer_strict_read_end(&state) == 0) {
+    vector_object = serializer_vector_create(count);
+    if (vector_object == NULL) {
+      serializer_strict_fail(&state, SERIALIZER_ERROR_MEMORY, -1, -1, state.cursor);
+    }
+  }
+  // Move the parsed values into the vector storage.
+  for (int i = 0; vector_object != NULL && i < count; i++) {
+    vector_setl(vector_object, i, state.values[i]);
+  }
+  serializer_metrics_count(state.cursor - data, 0, 0);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  free(state.values);
+  return vector_object;
+}
+
+/**
+ * Decodes the rows of a JSON array for a strict matrix decode.
+ *
+ * @param struct serializer_strict *state
+ *   The decode state.
+ * @param struct json *jobject
+ *   The JSON array of rows.
+ *
+ * @return struct matrix*
+ *   The matrix, or NULL with the error recorded.
+ */
+static struct matrix *serializer_strict_read_tree(struct serializer_strict *state, struct json *jobject) {
+  if (jobject->type != JSON_array || jobject->value == NULL) {
+    serializer_strict_fail(state, jobject->type != JSON_array ? SERIALIZER_ERROR_SYNTAX : SERIALIZER_ERROR_SHAPE, -1, -1, NULL);
+    return NULL;
+  }
+  int arrays = 0;
+  int length = -1;
+  for (struct json *row = jobject->value; row != NULL; row = row->next, arrays++) {
+    if (row->type != JSON_array) {
+      serializer_strict_fail(state, row->type == JSON_null ? SERIALIZER_ERROR_NULL : SERIALIZER_ERROR_SYNTAX, arrays, -1, NULL);
+      return NULL;
+    }
+    int count = 0;
+    for (struct json *item = row->value; item != NULL; item = item->next, count++) {
+      // The first row fixes the length of every other one.
+      if (count == length) {
+        serializer_strict_fail(state, SERIALIZER_ERROR_SHAPE, arrays, count, NULL);
+        return NULL;
+      }
+      if (item->type == JSON_null || item->value == NULL) {
+        serializer_strict_fail(state, SERIALIZER_ERROR_NULL, arrays, count, NULL);
+        return NULL;
+      }
+      if (item->type != JSON_string && item->type != JSON_number) {
+        serializer_strict_fail(state, SERIALIZER_ERROR_NUMBER, arrays, count, NULL);
+        return NULL;
+      }
+      const char *text = item->value;
+      if (serializer_strict_value(state, text, strlen(text), arrays, count, NULL) == 1) {
+        return NULL;
+      }
+    }
+    if (count == 0 || (length >= 0 && count != length)) {
+      serializer_strict_fail(state, SERIALIZER_ERROR_SHAPE, arrays, count, NULL);
+      return NULL;
+    }
+    length = count;
+  }
+  return serializer_strict_matrix(state, arrays, length);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *matrix_unserialize_from_json_object_strict(struct json *jobject, const struct serializer_options *options, struct serializer_error *error) {
+  struct serializer_error local;
+  struct serializer_strict state;
+  if (serializer_strict_init(&state, NULL, options, error, &local) == 1) {
+    return NULL;
+  }
+  if (jobject == NULL) {
+    serializer_strict_fail(&state, SERIALIZER_ERROR_ARGUMENT, -1, -1, NULL);
+    return NULL;
+  }
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  uint64_t tree = serializer_metrics_start();
+  struct matrix *matrix_object = serializer_strict_read_tree(&state, jobject);
+  serializer_metrics_stop(SERIALIZER_PHASE_TREE, tree);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  free(state.values);
+  return matrix_object;
+}
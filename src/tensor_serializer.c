@@ -0,0 +1,415 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
+
+/**
+ * Bits of the keys found in a serialized tensor object.
+ */
+enum serializer_tensor_field {
+  SERIALIZER_TENSOR_FIELD_FORMAT = 1,
+  SERIALIZER_TENSOR_FIELD_SHAPE = 2,
+  SERIALIZER_TENSOR_FIELD_VALUES = 4,
+  SERIALIZER_TENSOR_FIELD_ALL = 7,
+};
+
+/**
+ * Returns the offset of the elements within the tensor allocation.
+ *
+ * @return size_t
+ *   The structure size rounded up to keep the elements aligned.
+ */
+static size_t serializer_tensor_offset(void) {
+  return (sizeof(struct serializer_tensor) + sizeof(long double) - 1) / sizeof(long double) * sizeof(long double);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_tensor *serializer_tensor_create(int rank, const int *shape) {
+  // Validates the input.
+  if (rank <= 0 || rank > SERIALIZER_TENSOR_MAX_RANK || shape == NULL) {
+    return NULL;
+  }
+  // Every dimension but the last one counts rows, which must fit an int.
+  size_t offset = serializer_tensor_offset();
+  uint64_t rows = 1;
+  for (int i = 0; i < rank; i++) {
+    if (shape[i] <= 0) {
+      return NULL;
+    }
+    if (i < rank - 1 && (rows *= (uint64_t)shape[i]) > INT32_MAX) {
+      return NULL;
+    }
+  }
+  if (rows > (SIZE_MAX - offset) / sizeof(long double) / (uint64_t)shape[rank - 1]) {
+    return NULL;
+  }
+  // The structure and the elements share one block.
+  size_t count = (size_t)rows * (size_t)shape[rank - 1];
+  uint64_t start = serializer_metrics_start();
+  struct serializer_tensor *tensor = calloc(1, offset + count * sizeof(long double));
+  serializer_metrics_stop(SERIALIZER_PHASE_ALLOCATE, start);
+  if (tensor == NULL) {
+    return NULL;
+  }
+  serializer_metrics_count(0, 0, offset + count * sizeof(long double));
+  tensor->rank = rank;
+  memcpy(tensor->shape, shape, (size_t)rank * sizeof(int));
+  tensor->count = count;
+  tensor->values = (long double *)((unsigned char *)tensor + offset);
+  return tensor;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_tensor *serializer_tensor_stack(struct matrix **objects, int count) {
+  // Validates the input.
+  if (objects == NULL || count <= 0 || objects[0] == NULL) {
+    return NULL;
+  }
+  int rows = objects[0]->rows;
+  int columns = objects[0]->columns;
+  for (int i = 1; i < count; i++) {
+    if (objects[i] == NULL || objects[i]->rows != rows || objects[i]->columns != columns) {
+      return NULL;
+    }
+  }
+  int shape[3] = {count, rows, columns};
+  struct serializer_tensor *tensor = serializer_tensor_create(3, shape);
+  if (tensor == NULL) {
+    return NULL;
+  }
+  // Copy each matrix into its slice, one row at a time when the storage allows.
+  long double *target = tensor->values;
+  for (int i = 0; i < count; i++) {
+    for (int j = 0; j < rows; j++) {
+      long double *row = serializer_matrix_row(objects[i], j);
+      if (row != NULL) {
+        memcpy(target, row, (size_t)columns * sizeof(long double));
+        target += columns;
+        continue;
+      }
+      for (int k = 0; k < columns; k++) {
+        long double *lvalue = matrix_getl(objects[i], j, k);
+        if (lvalue == NULL) {
+          serializer_tensor_destroy(tensor);
+          return NULL;
+        }
+        *target++ = *lvalue;
+      }
+    }
+  }
+  return tensor;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void serializer_tensor_destroy(struct serializer_tensor *tensor) {
+  free(tensor);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_tensor_slice_count(const struct serializer_tensor *tensor) {
+  if (tensor == NULL) {
+    return 0;
+  }
+  if (tensor->rank == 1) {
+    return 1;
+  }
+  return (int)(tensor->count / ((size_t)tensor->shape[tensor->rank - 2] * tensor->shape[tensor->rank - 1]));
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_tensor_slice(const struct serializer_tensor *tensor, int index, struct matrix_view *view) {
+  // Validates the input.
+  if (view == NULL || index < 0 || index >= serializer_tensor_slice_count(tensor)) {
+    return 1;
+  }
+  view->rows = tensor->rank == 1 ? 1 : tensor->shape[tensor->rank - 2];
+  view->columns = tensor->shape[tensor->rank - 1];
+  view->values = tensor->values + (size_t)index * view->rows * view->columns;
+  // The view borrows the tensor memory, there is nothing to unmap.
+  view->mapping = NULL;
+  view->mapping_length = 0;
+  return 0;
+}
+
+/**
+ * Streams the JSON representation of a tensor into a buffer.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int tensor_write_stream(const struct serializer_tensor *tensor, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  // Validates the input.
+  if (tensor == NULL || buffer == NULL) {
+    return 1;
+  }
+  uint64_t format = serializer_metrics_start();
+  serializer_buffer_write_text(buffer, "{\"format\":\"tensor\",\"shape\":[");
+  for (int i = 0; i < tensor->rank; i++) {
+    if (i > 0) {
+      serializer_buffer_putc(buffer, ',');
+    }
+    serializer_buffer_write_integer(buffer, (uint64_t)tensor->shape[i]);
+  }
+  // The elements form one flat array, whatever the rank.
+  serializer_buffer_write_text(buffer, "],\"values\":[");
+  int status = 0;
+  for (size_t i = 0; i < tensor->count && status == 0; i++) {
+    if (i > 0) {
+      serializer_buffer_putc(buffer, ',');
+    }
+    status = serializer_buffer_write_number(buffer, tensor->values[i], options);
+  }
+  serializer_buffer_write_text(buffer, "]}");
+  serializer_metrics_stop(SERIALIZER_PHASE_FORMAT, format);
+  if (status == 1) {
+    return 1;
+  }
+  // Push any staged bytes into the sink, the error flag is sticky.
+  return serializer_buffer_flush(buffer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int tensor_serialize_to_stream(const struct serializer_tensor *tensor, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  // Sink buffers count their bytes as they are flushed.
+  size_t length = buffer != NULL ? buffer->length : 0;
+  int status = tensor_write_stream(tensor, options, buffer);
+  if (buffer != NULL && buffer->sink == NULL) {
+    serializer_metrics_count(0, buffer->length - length, 0);
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *tensor_serialize(const struct serializer_tensor *tensor, const struct serializer_options *options) {
+  // Validates the input.
+  if (tensor == NULL) {
+    return NULL;
+  }
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  // Prepare the output buffer, then stream the tensor representation into it.
+  struct serializer_buffer buffer;
+  char *data = NULL;
+  if (serializer_buffer_init(&buffer, 0) == 0) {
+    if (tensor_serialize_to_stream(tensor, options, &buffer) == 1) {
+      serializer_buffer_release(&buffer);
+    }
+    else {
+      data = serializer_buffer_detach(&buffer, NULL);
+    }
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return data;
+}
+
+/**
+ * Maps an object key to the tensor field it names.
+ *
+ * @param const char *name
+ *   The first character of the key.
+ * @param size_t length
+ *   The key length.
+ *
+ * @return int
+ *   Returns one of the serializer_tensor_field values, or 0 if the key is unknown.
+ */
+static int serializer_tensor_field(const char *name, size_t length) {
+  static const char *names[] = {"format", "shape", "values"};
+  for (int i = 0; i < 3; i++) {
+    if (strlen(names[i]) == length && memcmp(names[i], name, length) == 0) {
+      return 1 << i;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Reads the shape array of a serialized tensor.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner, right before the opening bracket.
+ * @param int *shape
+ *   Pointer receiving up to SERIALIZER_TENSOR_MAX_RANK extents.
+ * @param int *rank
+ *   Pointer receiving the number of extents.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_tensor_read_shape(struct serializer_scanner *scanner, int *shape, int *rank) {
+  if (!serializer_scanner_consume(scanner, '[')) {
+    return 1;
+  }
+  *rank = 0;
+  do {
+    uint64_t extent = 0;
+    if (*rank == SERIALIZER_TENSOR_MAX_RANK || serializer_scanner_read_integer(scanner, INT32_MAX, &extent) == 1 || extent == 0) {
+      return 1;
+    }
+    shape[(*rank)++] = (int)extent;
+  } while (serializer_scanner_consume(scanner, ','));
+  return serializer_scanner_consume(scanner, ']') ? 0 : 1;
+}
+
+/**
+ * Checks that the text left after the shape can hold every element.
+ *
+ * The shape is read before any value, so without this bound a short input
+ * could request an arbitrarily large allocation.
+ *
+ * @param const int *shape
+ *   The tensor extents.
+ * @param int rank
+ *   The number of extents.
+ * @param const char *rest
+ *   The text following the shape.
+ *
+ * @return int
+ *   Returns 0 if the shape is plausible, otherwise 1.
+ */
+static int serializer_tensor_check_shape(const int *shape, int rank, const char *rest) {
+  // Every value takes at least one character and one separator.
+  uint64_t limit = strlen(rest) / 2;
+  uint64_t count = 1;
+  for (int i = 0; i < rank; i++) {
+    if (count > limit / (uint64_t)shape[i]) {
+      return 1;
+    }
+    count *= (uint64_t)shape[i];
+  }
+  return 0;
+}
+
+/**
+ * Reads the values array of a serialized tensor straight into its storage.
+ *
+ * @param struct serializer_scanner *scanner
+ *   Pointer to the scanner, right before the opening bracket.
+ * @param struct serializer_tensor *tensor
+ *   The tensor receiving exactly tensor->count values.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the text is malformed.
+ */
+static int serializer_tensor_read_values(struct serializer_scanner *scanner, struct serializer_tensor *tensor) {
+  if (!serializer_scanner_consume(scanner, '[')) {
+    return 1;
+  }
+  for (size_t i = 0; i < tensor->count; i++) {
+    if ((i > 0 && !serializer_scanner_consume(scanner, ',')) || serializer_scanner_read_value(scanner, &tensor->values[i]) != SERIALIZER_TOKEN_NUMBER) {
+      return 1;
+    }
+  }
+  return serializer_scanner_consume(scanner, ']') ? 0 : 1;
+}
+
+/**
+ * Creates a tensor from its JSON representation.
+ *
+ * @param const char *data
+ *   The serialized tensor string.
+ *
+ * @return struct serializer_tensor*
+ *   The unserialized tensor is returned, otherwise NULL.
+ */
+static struct serializer_tensor *tensor_text_read(const char *data) {
+  // Validates the input.
+  if (data == NULL) {
+    return NULL;
+  }
+  struct serializer_scanner scanner;
+  serializer_scanner_init(&scanner, data);
+  if (!serializer_scanner_consume(&scanner, '{')) {
+    return NULL;
+  }
+  // The shape comes first, so the values are parsed in place in a single pass.
+  uint64_t parse = serializer_metrics_start();
+  struct serializer_tensor *tensor = NULL;
+  int shape[SERIALIZER_TENSOR_MAX_RANK];
+  int rank = 0;
+  int seen = 0;
+  int status = 0;
+  do {
+    const char *name;
+    size_t length;
+    if (serializer_scanner_read_key(&scanner, &name, &length) == 1) {
+      status = 1;
+      break;
+    }
+    int field = serializer_tensor_field(name, length);
+    if (field == 0 || (seen & field) != 0) {
+      status = 1;
+      break;
+    }
+    seen |= field;
+    switch (field) {
+      case SERIALIZER_TENSOR_FIELD_FORMAT:
+        status = serializer_scanner_consume(&scanner, '"') && strncmp(scanner.cursor, "tensor\"", 7) == 0 ? 0 : 1;
+        scanner.cursor += status == 0 ? 7 : 0;
+        break;
+
+      case SERIALIZER_TENSOR_FIELD_SHAPE:
+        status = serializer_tensor_read_shape(&scanner, shape, &rank);
+        if (status == 0 && serializer_tensor_check_shape(shape, rank, scanner.cursor) == 1) {
+          status = 1;
+        }
+        if (status == 0) {
+          tensor = serializer_tensor_create(rank, shape);
+          status = tensor == NULL ? 1 : 0;
+        }
+        break;
+
+      default:
+        status = tensor == NULL ? 1 : serializer_tensor_read_values(&scanner, tensor);
+        break;
+    }
+  } while (status == 0 && serializer_scanner_consume(&scanner, ','));
+  if (status == 0 && (!serializer_scanner_consume(&scanner, '}') || !serializer_scanner_at_end(&scanner) || seen != SERIALIZER_TENSOR_FIELD_ALL)) {
+    status = 1;
+  }
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+  if (status == 1) {
+    serializer_tensor_destroy(tensor);
+    return NULL;
+  }
+  return tensor;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct serializer_tensor *tensor_unserialize(const char *data) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  if (metrics && data != NULL) {
+    serializer_metrics_count(strlen(data), 0, 0);
+  }
+  struct serializer_tensor *tensor = tensor_text_read(data);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return tensor;
+}
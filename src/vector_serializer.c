@@ -1,29 +1,177 @@
 #include <stddef.h>
+#include <string.h>
 #include <json.h>
 #include <strutils.h>
 #include "../include/matrixmath_serializer.h"
+#include "serializer_private.h"
 
 /**
  * {@inheritdoc}
  */
 char *vector_serialize(struct vector *object) {
-  // Generates a JSON representation of the given Vector object.
-  struct json *jobject = vector_serialize_to_json(object);
-  if (jobject == NULL) {
+  return vector_serialize_with_options(object, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+char *vector_serialize_with_options(struct vector *object, const struct serializer_options *options) {
+  // Check if NULL vector object passed for serialization.
+  if (object == NULL) {
     return NULL;
   }
-  // Encode the JSON object.
-  char *jstring = json_encode(jobject);
-  // Clean up JSON array object after encoding.
-  json_destroy(jobject);
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  // Prepare the output buffer, then stream the Vector representation into it.
+  struct serializer_buffer buffer;
+  char *data = NULL;
+  if (serializer_buffer_init(&buffer, 0) == 0) {
+    if (vector_serialize_to_stream(object, options, &buffer) == 1) {
+      serializer_buffer_release(&buffer);
+    }
+    else {
+      data = serializer_buffer_detach(&buffer, NULL);
+    }
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
   // Returning the JSON string.
-  return jstring;
+  return data;
 }
 
 /**
  * {@inheritdoc}
  */
-struct json *vector_serialize_to_json(struct vector *object) {
+int serializer_write_vector(struct serializer_buffer *buffer, struct vector *object, const struct serializer_options *options) {
+  // Write the elements one at a time, no intermediate JSON tree is built.
+  long double *lvalue;
+  serializer_buffer_putc(buffer, '[');
+  for (int i = 0; i < object->capacity; i++) {
+    lvalue = vector_getl(object, i);
+    if (lvalue == NULL) {
+      return 1;
+    }
+    if (i > 0) {
+      serializer_buffer_putc(buffer, ',');
+    }
+    if (serializer_buffer_write_number(buffer, *lvalue, options) == 1) {
+      return 1;
+    }
+  }
+  serializer_buffer_putc(buffer, ']');
+  return buffer->error;
+}
+
+/**
+ * Streams the JSON representation of a Vector object into a buffer.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ * @param const struct serializer_options *options
+ *   The serializer options, or NULL to use the defaults.
+ * @param struct serializer_buffer *buffer
+ *   The output buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int vector_write_stream(struct vector *object, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  // Validates the input.
+  if (object == NULL || buffer == NULL) {
+    return 1;
+  }
+  uint64_t format = serializer_metrics_start();
+  int status = serializer_write_vector(buffer, object, options);
+  serializer_metrics_stop(SERIALIZER_PHASE_FORMAT, format);
+  if (status == 1) {
+    return 1;
+  }
+  // Push any staged bytes into the sink, the error flag is sticky.
+  return serializer_buffer_flush(buffer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int vector_serialize_to_stream(struct vector *object, const struct serializer_options *options, struct serializer_buffer *buffer) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  // Sink buffers count their bytes as they are flushed.
+  size_t length = buffer != NULL ? buffer->length : 0;
+  int status = vector_write_stream(object, options, buffer);
+  if (buffer != NULL && buffer->sink == NULL) {
+    serializer_metrics_count(0, buffer->length - length, 0);
+  }
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int vector_serialize_to_sink(struct vector *object, const struct serializer_options *options, serializer_sink sink, void *context) {
+  // Prepare a staging buffer attached to the sink.
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init_sink(&buffer, sink, context, 0) == 1) {
+    return 1;
+  }
+  // Stream the Vector representation into the sink.
+  int status = vector_serialize_to_stream(object, options, &buffer);
+  serializer_buffer_release(&buffer);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+size_t vector_serialized_size(struct vector *object, const struct serializer_options *options) {
+  // Validates the input.
+  if (object == NULL || object->capacity <= 0) {
+    return 0;
+  }
+  // The legacy text has no fixed bound, its exact length is measured instead.
+  if (options != NULL && options->precision == SERIALIZER_PRECISION_LEGACY) {
+    size_t total = 0;
+    return vector_serialize_to_sink(object, options, serializer_count_sink, &total) == 0 ? total : 0;
+  }
+  int number_length = serializer_number_max_length(options);
+  if (number_length < 0) {
+    return 0;
+  }
+  // Every element is a quoted number followed by a comma, except the last
+  // one, inside the outer brackets.
+  return (size_t)object->capacity * (number_length + 3) + 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int vector_serialize_to_buffer(struct vector *object, const struct serializer_options *options, char *data, size_t capacity, size_t *length) {
+  // Wrap the caller memory, nothing is allocated.
+  struct serializer_buffer buffer;
+  if (object == NULL || serializer_buffer_init_fixed(&buffer, data, capacity) == 1) {
+    return 1;
+  }
+  if (vector_serialize_to_stream(object, options, &buffer) == 1) {
+    return 1;
+  }
+  // Terminate the string, the fixed buffer always keeps a spare byte.
+  data[buffer.length] = '\0';
+  if (length != NULL) {
+    *length = buffer.length;
+  }
+  return 0;
+}
+
+/**
+ * Builds the JSON tree of a Vector object.
+ *
+ * @param struct vector *object
+ *   The Vector object to serialize.
+ *
+ * @return struct json*
+ *   The JSON array, or NULL if the serialization fails.
+ */
+static struct json *vector_json_build(struct vector *object) {
   // Check if NULL vector object passed for serialization.
   if (object == NULL) {
     return NULL;
@@ -52,6 +200,19 @@ struct json *vector_serialize_to_json(struct vector *object) {
   return jobject;
 }
 
+/**
+ * {@inheritdoc}
+ */
+struct json *vector_serialize_to_json(struct vector *object) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  uint64_t tree = serializer_metrics_start();
+  struct json *jobject = vector_json_build(object);
+  serializer_metrics_stop(SERIALIZER_PHASE_TREE, tree);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_ENCODE, start, __func__);
+  return jobject;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -72,57 +233,89 @@ struct json *vector_serialize_to_json_object(const char *key, struct vector *obj
 }
 
 /**
- * {@inheritdoc}
+ * Calculates the capacity of a vector stored in a JSON array.
+ *
+ * @param struct json *jobject
+ *   The JSON array representing the vector.
+ * @param int *capacity
+ *   Pointer receiving the number of non-null values.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if the array holds no values.
  */
-struct vector *vector_unserialize_from_json_object(struct json *jobject) {
-  // Validates the input.
-  if (jobject == NULL) {
-    return NULL;
-  }
-  // Check if the data passed is a JSON array.
-  if (jobject->type != JSON_array) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Check if the JSON array is empty.
-  struct json *current = jobject->value;
-  if (current == NULL) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Calculate the capacity of the vector.
-  int capacity = 0;
-  for (struct json *iterator = current; iterator != NULL; iterator = iterator->next) {
+static int vector_json_capacity(struct json *jobject, int *capacity) {
+  uint64_t tree = serializer_metrics_start();
+  *capacity = 0;
+  for (struct json *iterator = jobject->value; iterator != NULL; iterator = iterator->next) {
     // Only count non-null values in the array.
     if (iterator->value != NULL) {
-      capacity++;
+      (*capacity)++;
     }
   }
+  serializer_metrics_stop(SERIALIZER_PHASE_TREE, tree);
   // Verify if the array contains only numeric values (no null values).
-  if (capacity == 0) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Create the vector.
-  struct vector *vector_object = vector_create(capacity);
-  if (vector_object == NULL) {
-    json_destroy(jobject);
-    return NULL;
-  }
-  // Fill the vector.
+  return *capacity == 0 ? 1 : 0;
+}
+
+/**
+ * Fills a vector with the values stored in a JSON array.
+ *
+ * @param struct json *jobject
+ *   The JSON array representing the vector.
+ * @param struct vector *vector_object
+ *   The vector to fill, its capacity must match vector_json_capacity().
+ */
+static void vector_json_fill(struct json *jobject, struct vector *vector_object) {
+  uint64_t parse = serializer_metrics_start();
   int index = 0;
-  for (struct json *iterator = current; iterator != NULL; iterator = iterator->next) {
+  for (struct json *iterator = jobject->value; iterator != NULL; iterator = iterator->next) {
     // Only count non-null values in the array.
     if (iterator->value == NULL) {
       continue;
     }
-    // Convert the number string into a long double value.
-    long double numeric_value = stold((char *)iterator->value);
+    // Convert the number string into a long double value, the fast parser
+    // defers to stold() for anything it does not recognize.
+    char *number_string = (char *)iterator->value;
+    long double numeric_value;
+    if (serializer_parse_number(number_string, strlen(number_string), &numeric_value) == 1) {
+      numeric_value = stold(number_string);
+    }
     // Add the long double value to the vector object.
     vector_setl(vector_object, index, numeric_value);
     // Increment the index.
     index++;
   }
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+}
+
+/**
+ * Creates a Vector object from a JSON array.
+ *
+ * @param struct json *jobject
+ *   The JSON array, destroyed if the conversion fails.
+ *
+ * @return struct vector*
+ *   The unserialized Vector object is returned, otherwise NULL.
+ */
+static struct vector *vector_json_read(struct json *jobject) {
+  // Validates the input.
+  if (jobject == NULL) {
+    return NULL;
+  }
+  // Check if the data passed is a non-empty JSON array.
+  int capacity = 0;
+  if (jobject->type != JSON_array || vector_json_capacity(jobject, &capacity) == 1) {
+    json_destroy(jobject);
+    return NULL;
+  }
+  // Create the vector.
+  struct vector *vector_object = serializer_vector_create(capacity);
+  if (vector_object == NULL) {
+    json_destroy(jobject);
+    return NULL;
+  }
+  // Fill the vector.
+  vector_json_fill(jobject, vector_object);
   // Return the vector object.
   return vector_object;
 }
@@ -130,28 +323,106 @@ struct vector *vector_unserialize_from_json_object(struct json *jobject) {
 /**
  * {@inheritdoc}
  */
-struct vector *vector_unserialize(char *data) {
+struct vector *vector_unserialize_from_json_object(struct json *jobject) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  struct vector *vector_object = vector_json_read(jobject);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return vector_object;
+}
+
+/**
+ * Creates a Vector object from its JSON string.
+ *
+ * @param char *data
+ *   The serialized vector string.
+ *
+ * @return struct vector*
+ *   The unserialized Vector object is returned, otherwise NULL.
+ */
+static struct vector *vector_text_read(char *data) {
   // Check if NULL JSON data passed for unserialization.
   if (data == NULL) {
     return NULL;
   }
-  // Decodes the given JSON array string.
-  struct json *jobject = json_decode(data);
-  if (jobject == NULL) {
+  // Scan the text once to infer the shape, no JSON tree is built.
+  int capacity = 0;
+  if (serializer_scan_vector_shape(data, &capacity) == 1) {
     return NULL;
   }
-  // Unserialize the JSON object.
-  struct vector *vector_object = vector_unserialize_from_json_object(jobject);
+  // Create the vector object.
+  struct vector *vector_object = serializer_vector_create(capacity);
   if (vector_object == NULL) {
-    json_destroy(jobject);
     return NULL;
   }
-  // Clean up JSON object after unserializing.
-  json_destroy(jobject);
+  // Parse the values straight into the vector storage.
+  uint64_t parse = serializer_metrics_start();
+  int status = serializer_parse_vector(data, vector_object);
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+  if (status == 1) {
+    vector_destroy(vector_object);
+    return NULL;
+  }
   // Return the vector object.
   return vector_object;
 }
 
+/**
+ * {@inheritdoc}
+ */
+struct vector *vector_unserialize(char *data) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  if (metrics && data != NULL) {
+    serializer_metrics_count(strlen(data), 0, 0);
+  }
+  struct vector *vector_object = vector_text_read(data);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return vector_object;
+}
+
+/**
+ * Parses a JSON string into the storage of an existing Vector object.
+ *
+ * @param struct vector *destination
+ *   The destination Vector object.
+ * @param const char *data
+ *   The serialized vector string.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
+ */
+static int vector_text_fill(struct vector *destination, const char *data) {
+  // Validates the input.
+  if (destination == NULL || data == NULL) {
+    return 1;
+  }
+  // Check the serialized capacity against the destination before writing anything.
+  int capacity = 0;
+  if (serializer_scan_vector_shape(data, &capacity) == 1 || capacity != destination->capacity) {
+    return 1;
+  }
+  // Parse the values straight into the destination storage.
+  uint64_t parse = serializer_metrics_start();
+  int status = serializer_parse_vector(data, destination);
+  serializer_metrics_stop(SERIALIZER_PHASE_PARSE, parse);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int vector_unserialize_into(struct vector *destination, const char *data) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  if (metrics && data != NULL) {
+    serializer_metrics_count(strlen(data), 0, 0);
+  }
+  int status = vector_text_fill(destination, data);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return status;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -166,21 +437,45 @@ struct vector *vector_get_and_unserialize_from_json_object(const char *key, stru
 }
 
 /**
- * {@inheritdoc}
+ * Fills an existing Vector object from a keyed JSON array.
+ *
+ * @param struct vector *destination
+ *   The destination Vector object.
+ * @param const char *key
+ *   The key of the JSON array.
+ * @param struct json *json_object
+ *   The JSON object holding the array.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1 if an error occurred.
  */
-int vector_set_from_json_object(struct vector *destination, const char *key, struct json *json_object) {
-  // Retrieve and unserialize the vector from the JSON object.
-  struct vector *source = vector_get_and_unserialize_from_json_object(key, json_object);
-  if (source == NULL) {
+static int vector_json_set(struct vector *destination, const char *key, struct json *json_object) {
+  // Validates the input.
+  if (destination == NULL) {
     return 1;
   }
-  // Try to copy the source vector into the destination vector.
-  if (vector_copy(source, destination) == 1) {
-    vector_destroy(source);
+  // Get the JSON array associated with the key.
+  struct json *json_array = json_get_array(json_object, key);
+  if (json_array == NULL) {
     return 1;
   }
-  // Free memory.
-  vector_destroy(source);
+  // Check the capacity before writing, then fill the destination in place.
+  int capacity = 0;
+  if (vector_json_capacity(json_array, &capacity) == 1 || capacity != destination->capacity) {
+    return 1;
+  }
+  vector_json_fill(json_array, destination);
   // Operation successfully completed.
   return 0;
 }
+
+/**
+ * {@inheritdoc}
+ */
+int vector_set_from_json_object(struct vector *destination, const char *key, struct json *json_object) {
+  int metrics = serializer_metrics_begin();
+  uint64_t start = serializer_metrics_start();
+  int status = vector_json_set(destination, key, json_object);
+  serializer_metrics_end(metrics, SERIALIZER_PHASE_DECODE, start, __func__);
+  return status;
+}
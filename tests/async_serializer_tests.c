@@ -0,0 +1,274 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+#include "async_serializer_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * State shared with the test callbacks.
+ */
+struct async_serializer_test_state {
+  // Lock guarding the fields below.
+  pthread_mutex_t lock;
+  // Signaled when the gate opens or a callback runs.
+  pthread_cond_t signal;
+  // Whether gated callbacks may return.
+  int open;
+  // The number of callbacks entered.
+  int entered;
+  // The result of the last callback, with its data and matrix.
+  struct serializer_async_result result;
+};
+
+/**
+ * Callback keeping the result of the last job.
+ *
+ * @param const struct serializer_async_result *result
+ *   The job result.
+ * @param void *context
+ *   The struct async_serializer_test_state.
+ */
+static void async_serializer_test_keep(const struct serializer_async_result *result, void *context) {
+  struct async_serializer_test_state *state = context;
+  pthread_mutex_lock(&state->lock);
+  free(state->result.data);
+  matrix_destroy(state->result.matrix);
+  state->result = *result;
+  state->entered++;
+  pthread_cond_broadcast(&state->signal);
+  pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * Callback holding its worker until the gate opens.
+ *
+ * @param const struct serializer_async_result *result
+ *   The job result.
+ * @param void *context
+ *   The struct async_serializer_test_state.
+ */
+static void async_serializer_test_gate(const struct serializer_async_result *result, void *context) {
+  struct async_serializer_test_state *state = context;
+  async_serializer_test_keep(result, context);
+  pthread_mutex_lock(&state->lock);
+  while (!state->open) {
+    pthread_cond_wait(&state->signal, &state->lock);
+  }
+  pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * Initializes the shared test state.
+ *
+ * @param struct async_serializer_test_state *state
+ *   The state.
+ */
+static void async_serializer_test_init(struct async_serializer_test_state *state) {
+  memset(state, 0, sizeof(struct async_serializer_test_state));
+  pthread_mutex_init(&state->lock, NULL);
+  pthread_cond_init(&state->signal, NULL);
+}
+
+/**
+ * Frees the shared test state.
+ *
+ * @param struct async_serializer_test_state *state
+ *   The state.
+ */
+static void async_serializer_test_release(struct async_serializer_test_state *state) {
+  free(state->result.data);
+  matrix_destroy(state->result.matrix);
+  pthread_mutex_destroy(&state->lock);
+  pthread_cond_destroy(&state->signal);
+}
+
+/**
+ * Waits until a number of callbacks have been entered.
+ *
+ * @param struct async_serializer_test_state *state
+ *   The state.
+ * @param int entered
+ *   The number of callbacks to wait for.
+ */
+static void async_serializer_test_wait_entered(struct async_serializer_test_state *state, int entered) {
+  pthread_mutex_lock(&state->lock);
+  while (state->entered < entered) {
+    pthread_cond_wait(&state->signal, &state->lock);
+  }
+  pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * Opens the gate of the gated callbacks.
+ *
+ * @param struct async_serializer_test_state *state
+ *   The state.
+ */
+static void async_serializer_test_open(struct async_serializer_test_state *state) {
+  pthread_mutex_lock(&state->lock);
+  state->open = 1;
+  pthread_cond_broadcast(&state->signal);
+  pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * Tests asynchronous round trips through JSON, binary and a pipe.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int async_serializer_round_trip_tests() {
+  printf("------------ Async Serializer Round Trip Tests. ------------\n");
+  struct serializer_pool *pool = serializer_pool_create(2, 4);
+  struct matrix *object = serializer_test_matrix(300, 40, 0);
+  char *expected = matrix_serialize(object);
+  if (pool == NULL || object == NULL || expected == NULL) {
+    serializer_pool_destroy(pool);
+    matrix_destroy(object);
+    free(expected);
+    return EXIT_FAILURE;
+  }
+  struct async_serializer_test_state state;
+  async_serializer_test_init(&state);
+  int result = EXIT_SUCCESS;
+  // The JSON encode matches the synchronous one.
+  struct serializer_job *job = matrix_serialize_async(pool, object, NULL, SERIALIZER_ASYNC_SNAPSHOT, async_serializer_test_keep, &state);
+  if (job == NULL || serializer_job_wait(job) != SERIALIZER_ASYNC_DONE || state.result.data == NULL || strcmp(state.result.data, expected) != 0) {
+    printf("Asynchronous JSON encode failed.\n");
+    result = EXIT_FAILURE;
+  }
+  serializer_job_release(job);
+  // The JSON decode gives the matrix back.
+  if (result == EXIT_SUCCESS) {
+    job = matrix_unserialize_async(pool, expected, strlen(expected), SERIALIZER_ASYNC_BORROW, async_serializer_test_keep, &state);
+    if (job == NULL || serializer_job_wait(job) != SERIALIZER_ASYNC_DONE || state.result.matrix == NULL || *matrix_getl(state.result.matrix, 299, 39) != *matrix_getl(object, 299, 39)) {
+      printf("Asynchronous JSON decode failed.\n");
+      result = EXIT_FAILURE;
+    }
+    serializer_job_release(job);
+  }
+  // A binary encode, then a binary decode of its copied bytes.
+  if (result == EXIT_SUCCESS) {
+    job = matrix_serialize_async(pool, object, NULL, SERIALIZER_ASYNC_BORROW | SERIALIZER_ASYNC_BINARY, async_serializer_test_keep, &state);
+    int status = serializer_job_wait(job);
+    serializer_job_release(job);
+    char *binary = state.result.data;
+    size_t length = state.result.length;
+    state.result.data = NULL;
+    job = status == SERIALIZER_ASYNC_DONE ? matrix_unserialize_async(pool, binary, length, SERIALIZER_ASYNC_BINARY, async_serializer_test_keep, &state) : NULL;
+    free(binary);
+    if (job == NULL || serializer_job_wait(job) != SERIALIZER_ASYNC_DONE || state.result.matrix == NULL || *matrix_getl(state.result.matrix, 17, 3) != *matrix_getl(object, 17, 3)) {
+      printf("Asynchronous binary round trip failed.\n");
+      result = EXIT_FAILURE;
+    }
+    serializer_job_release(job);
+  }
+  // A decode reading a pipe to its end.
+  int pipe_fds[2];
+  if (result == EXIT_SUCCESS && pipe(pipe_fds) == 0) {
+    const char *text = "[[\"1\",\"2\"],[\"3\",\"4.5\"]]";
+    int written = write(pipe_fds[1], text, strlen(text)) == (ssize_t)strlen(text);
+    close(pipe_fds[1]);
+    job = written ? matrix_unserialize_fd_async(pool, pipe_fds[0], 0, async_serializer_test_keep, &state) : NULL;
+    if (job == NULL || serializer_job_wait(job) != SERIALIZER_ASYNC_DONE || state.result.matrix == NULL || *matrix_getl(state.result.matrix, 1, 1) != 4.5L) {
+      printf("Asynchronous descriptor decode failed.\n");
+      result = EXIT_FAILURE;
+    }
+    serializer_job_release(job);
+    close(pipe_fds[0]);
+  }
+  // Malformed input is reported as a failure.
+  if (result == EXIT_SUCCESS) {
+    job = matrix_unserialize_async(pool, "[[\"1\",", 6, 0, async_serializer_test_keep, &state);
+    if (job == NULL || serializer_job_wait(job) != SERIALIZER_ASYNC_FAILED || state.result.matrix != NULL) {
+      printf("Malformed asynchronous decode was not reported.\n");
+      result = EXIT_FAILURE;
+    }
+    serializer_job_release(job);
+  }
+  serializer_pool_destroy(pool);
+  async_serializer_test_release(&state);
+  matrix_destroy(object);
+  free(expected);
+  return result;
+}
+
+/**
+ * Tests snapshots, the bounded queue and cancellation with a held worker.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int async_serializer_control_tests() {
+  printf("------------ Async Serializer Control Tests. ------------\n");
+  struct serializer_pool *pool = serializer_pool_create(1, 2);
+  struct matrix *object = serializer_test_matrix(20, 10, 0);
+  char *expected = matrix_serialize(object);
+  if (pool == NULL || object == NULL || expected == NULL) {
+    serializer_pool_destroy(pool);
+    matrix_destroy(object);
+    free(expected);
+    return EXIT_FAILURE;
+  }
+  struct async_serializer_test_state gate;
+  struct async_serializer_test_state state;
+  async_serializer_test_init(&gate);
+  async_serializer_test_init(&state);
+  int result = EXIT_SUCCESS;
+  // Hold the only worker inside a callback.
+  struct serializer_job *held = matrix_unserialize_async(pool, "[\"1\"]", 5, 0, async_serializer_test_gate, &gate);
+  async_serializer_test_wait_entered(&gate, 1);
+  // Two jobs fill the queue, a third one is refused.
+  struct serializer_job *snapshot = matrix_serialize_async(pool, object, NULL, SERIALIZER_ASYNC_SNAPSHOT, async_serializer_test_keep, &state);
+  struct serializer_job *cancelled = matrix_serialize_async(pool, object, NULL, SERIALIZER_ASYNC_SNAPSHOT, async_serializer_test_keep, &gate);
+  struct serializer_job *refused = matrix_serialize_async(pool, object, NULL, SERIALIZER_ASYNC_SNAPSHOT, async_serializer_test_keep, &state);
+  if (held == NULL || snapshot == NULL || cancelled == NULL || refused != NULL) {
+    printf("The bounded queue did not refuse the extra job.\n");
+    result = EXIT_FAILURE;
+  }
+  // Changing the matrix after submission does not affect the snapshot.
+  matrix_setl(object, 0, 0, 1000.0L);
+  if (result == EXIT_SUCCESS && serializer_job_cancel(cancelled) != 0) {
+    printf("The queued job could not be cancelled.\n");
+    result = EXIT_FAILURE;
+  }
+  async_serializer_test_open(&gate);
+  if (result == EXIT_SUCCESS && (serializer_job_wait(snapshot) != SERIALIZER_ASYNC_DONE || strcmp(state.result.data, expected) != 0)) {
+    printf("The snapshot did not keep the submitted values.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && (serializer_job_wait(cancelled) != SERIALIZER_ASYNC_CANCELLED || gate.result.data != NULL || gate.result.status != SERIALIZER_ASYNC_CANCELLED)) {
+    printf("The cancelled job was not reported as cancelled.\n");
+    result = EXIT_FAILURE;
+  }
+  // A finished job can no longer be cancelled.
+  if (result == EXIT_SUCCESS && serializer_job_cancel(snapshot) != 1) {
+    printf("A finished job accepted a cancellation.\n");
+    result = EXIT_FAILURE;
+  }
+  serializer_job_release(held);
+  serializer_job_release(snapshot);
+  serializer_job_release(cancelled);
+  serializer_pool_destroy(pool);
+  async_serializer_test_release(&gate);
+  async_serializer_test_release(&state);
+  matrix_destroy(object);
+  free(expected);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int async_serializer_tests() {
+  if (async_serializer_round_trip_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (async_serializer_control_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef ASYNC_SERIALIZER_TESTS_H
+#define ASYNC_SERIALIZER_TESTS_H
+
+/**
+ * Async serializer tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int async_serializer_tests();
+
+#endif
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "batch_serializer_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * The number of objects in the test batches.
+ */
+#define BATCH_TEST_COUNT 40
+
+/**
+ * Checks that a decoded vector batch matches the encoded vectors.
+ *
+ * @param struct vector_batch *batch
+ *   The decoded batch.
+ * @param const char **keys
+ *   The expected keys.
+ * @param struct vector **vectors
+ *   The expected vectors.
+ *
+ * @return int
+ *   Returns 1 if the batch matches, otherwise 0.
+ */
+static int batch_test_vectors_match(struct vector_batch *batch, const char **keys, struct vector **vectors) {
+  if (batch == NULL || batch->count != BATCH_TEST_COUNT) {
+    return 0;
+  }
+  for (int i = 0; i < BATCH_TEST_COUNT; i++) {
+    if (strcmp(batch->keys[i], keys[i]) != 0 || !serializer_test_vector_equal(vectors[i], batch->objects[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Checks that a decoded matrix batch matches the encoded matrices.
+ *
+ * @param struct matrix_batch *batch
+ *   The decoded batch.
+ * @param const char **keys
+ *   The expected keys.
+ * @param struct matrix **matrices
+ *   The expected matrices.
+ *
+ * @return int
+ *   Returns 1 if the batch matches, otherwise 0.
+ */
+static int batch_test_matrices_match(struct matrix_batch *batch, const char **keys, struct matrix **matrices) {
+  if (batch == NULL || batch->count != BATCH_TEST_COUNT) {
+    return 0;
+  }
+  for (int i = 0; i < BATCH_TEST_COUNT; i++) {
+    if (strcmp(batch->keys[i], keys[i]) != 0 || !serializer_test_matrix_equal(matrices[i], batch->objects[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Tests vector batches through the JSON object and the binary bundle.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int batch_serializer_vector_tests() {
+  printf("------------ Batch Serializer Vector Tests. ------------\n");
+  char names[BATCH_TEST_COUNT][24];
+  const char *keys[BATCH_TEST_COUNT];
+  struct vector *vectors[BATCH_TEST_COUNT] = {NULL};
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < BATCH_TEST_COUNT && result == EXIT_SUCCESS; i++) {
+    snprintf(names[i], sizeof(names[i]), "feature_%d", i);
+    keys[i] = names[i];
+    vectors[i] = vector_create(1 + i % 5);
+    if (vectors[i] == NULL) {
+      result = EXIT_FAILURE;
+      break;
+    }
+    for (int k = 0; k < vectors[i]->capacity; k++) {
+      vector_setl(vectors[i], k, i * 0.5L - k);
+    }
+  }
+  char *text = NULL;
+  struct vector_batch *batch = NULL;
+  if (result == EXIT_SUCCESS) {
+    text = vector_serialize_batch(keys, vectors, BATCH_TEST_COUNT, NULL);
+    batch = text != NULL ? vector_unserialize_batch(text) : NULL;
+  }
+  const char *prefix = "{\"feature_0\":[\"0\"],\"feature_1\":[\"0.5\",\"-0.5\"],";
+  if (result == EXIT_SUCCESS && (text == NULL || strncmp(text, prefix, strlen(prefix)) != 0)) {
+    printf("Unexpected vector batch: %.60s\n", text != NULL ? text : "(null)");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && !batch_test_vectors_match(batch, keys, vectors)) {
+    printf("Vector batch did not round trip.\n");
+    result = EXIT_FAILURE;
+  }
+  vector_batch_destroy(batch);
+  batch = NULL;
+  // The binary bundle holds the same objects.
+  size_t length = 0;
+  unsigned char *bundle = result == EXIT_SUCCESS ? vector_serialize_batch_binary(keys, vectors, BATCH_TEST_COUNT, &length) : NULL;
+  if (result == EXIT_SUCCESS) {
+    batch = vector_unserialize_batch_binary(bundle, length);
+    if (!batch_test_vectors_match(batch, keys, vectors)) {
+      printf("Vector bundle did not round trip.\n");
+      result = EXIT_FAILURE;
+    }
+  }
+  // Bundles of one kind are not read as the other.
+  if (result == EXIT_SUCCESS && matrix_unserialize_batch_binary(bundle, length) != NULL) {
+    printf("Vector bundle was read as matrices.\n");
+    result = EXIT_FAILURE;
+  }
+  free(text);
+  free(bundle);
+  vector_batch_destroy(batch);
+  for (int i = 0; i < BATCH_TEST_COUNT; i++) {
+    vector_destroy(vectors[i]);
+  }
+  return result;
+}
+
+/**
+ * Tests matrix batches through the JSON object and the binary bundle.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int batch_serializer_matrix_tests() {
+  printf("------------ Batch Serializer Matrix Tests. ------------\n");
+  char names[BATCH_TEST_COUNT][24];
+  const char *keys[BATCH_TEST_COUNT];
+  struct matrix *matrices[BATCH_TEST_COUNT] = {NULL};
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < BATCH_TEST_COUNT && result == EXIT_SUCCESS; i++) {
+    snprintf(names[i], sizeof(names[i]), "layer.%d", i);
+    keys[i] = names[i];
+    matrices[i] = serializer_test_matrix(1 + i % 3, 2 + i % 4, i);
+    if (matrices[i] == NULL) {
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+  // Sparse output is not used inside a batch.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = SERIALIZER_SPARSE_ALWAYS;
+  char *text = NULL;
+  struct matrix_batch *batch = NULL;
+  if (result == EXIT_SUCCESS) {
+    text = matrix_serialize_batch(keys, matrices, BATCH_TEST_COUNT, &options);
+    batch = text != NULL ? matrix_unserialize_batch(text) : NULL;
+  }
+  if (result == EXIT_SUCCESS && !batch_test_matrices_match(batch, keys, matrices)) {
+    printf("Matrix batch did not round trip.\n");
+    result = EXIT_FAILURE;
+  }
+  matrix_batch_destroy(batch);
+  batch = NULL;
+  size_t length = 0;
+  unsigned char *bundle = result == EXIT_SUCCESS ? matrix_serialize_batch_binary(keys, matrices, BATCH_TEST_COUNT, &length) : NULL;
+  struct serializer_bundle_header header;
+  if (result == EXIT_SUCCESS && (serializer_bundle_read_header(bundle, length, &header) == 1 || header.count != BATCH_TEST_COUNT || header.length != length)) {
+    printf("Matrix bundle header is invalid.\n");
+    result = EXIT_FAILURE;
+  }
+  // Every entry points at a standalone binary payload.
+  struct serializer_bundle_entry entry;
+  if (result == EXIT_SUCCESS && serializer_bundle_read_entry(bundle, &header, 7, &entry) == 0) {
+    struct matrix *single = matrix_unserialize_binary(bundle + entry.payload_offset, entry.payload_length);
+    if (single == NULL || strcmp((const char *)bundle + entry.key_offset, "layer.7") != 0 || single->rows != matrices[7]->rows) {
+      result = EXIT_FAILURE;
+    }
+    matrix_destroy(single);
+  }
+  if (result == EXIT_SUCCESS) {
+    batch = matrix_unserialize_batch_binary(bundle, length);
+    if (!batch_test_matrices_match(batch, keys, matrices)) {
+      printf("Matrix bundle did not round trip.\n");
+      result = EXIT_FAILURE;
+    }
+  }
+  // A damaged index or payload is rejected.
+  if (result == EXIT_SUCCESS) {
+    size_t positions[] = {SERIALIZER_BUNDLE_HEADER_SIZE + 3, length - 1};
+    for (int i = 0; i < 2; i++) {
+      bundle[positions[i]] ^= 0x01;
+      struct matrix_batch *damaged = matrix_unserialize_batch_binary(bundle, length);
+      bundle[positions[i]] ^= 0x01;
+      if (damaged != NULL) {
+        printf("Damaged matrix bundle %d was accepted.\n", i);
+        matrix_batch_destroy(damaged);
+        result = EXIT_FAILURE;
+      }
+    }
+    if (matrix_unserialize_batch_binary(bundle, length - 16) != NULL) {
+      printf("Truncated matrix bundle was accepted.\n");
+      result = EXIT_FAILURE;
+    }
+  }
+  free(text);
+  free(bundle);
+  matrix_batch_destroy(batch);
+  for (int i = 0; i < BATCH_TEST_COUNT; i++) {
+    matrix_destroy(matrices[i]);
+  }
+  return result;
+}
+
+/**
+ * Tests empty batches and malformed batch documents.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int batch_serializer_malformed_tests() {
+  printf("------------ Batch Serializer Malformed Tests. ------------\n");
+  int result = EXIT_SUCCESS;
+  // Empty batches are valid in both formats.
+  char *empty = vector_serialize_batch(NULL, NULL, 0, NULL);
+  struct vector_batch *batch = empty != NULL ? vector_unserialize_batch(empty) : NULL;
+  size_t length = 0;
+  unsigned char *bundle = matrix_serialize_batch_binary(NULL, NULL, 0, &length);
+  struct matrix_batch *matrices = bundle != NULL ? matrix_unserialize_batch_binary(bundle, length) : NULL;
+  if (empty == NULL || strcmp(empty, "{}") != 0 || batch == NULL || batch->count != 0 || matrices == NULL || matrices->count != 0) {
+    printf("Empty batches were not handled.\n");
+    result = EXIT_FAILURE;
+  }
+  free(empty);
+  free(bundle);
+  vector_batch_destroy(batch);
+  matrix_batch_destroy(matrices);
+  // Keys that would need escaping are refused.
+  struct vector *object = vector_create(2);
+  const char *quoted[] = {"a\"b"};
+  if (object == NULL || vector_serialize_batch(quoted, &object, 1, NULL) != NULL) {
+    result = EXIT_FAILURE;
+  }
+  vector_destroy(object);
+  const char *inputs[] = {
+    "",
+    "[]",
+    "{\"a\":[\"1\"],}",
+    "{\"a\":[\"1\"]",
+    "{\"a\":[]}",
+    "{\"a\" [\"1\"]}",
+    "{\"a\":[\"1\"],\"b\":[\"x\"]}",
+    "{\"a\":[\"1\"]} []",
+    "{\"a\":[[\"1\"]]}",
+  };
+  int count = sizeof(inputs) / sizeof(inputs[0]);
+  for (int i = 0; i < count && result == EXIT_SUCCESS; i++) {
+    struct vector_batch *decoded = vector_unserialize_batch(inputs[i]);
+    if (decoded != NULL) {
+      printf("Malformed vector batch %d was accepted.\n", i);
+      vector_batch_destroy(decoded);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Ragged matrices are rejected inside a batch too.
+  struct matrix_batch *ragged = matrix_unserialize_batch("{\"m\":[[\"1\",\"2\"],[\"3\"]]}");
+  if (ragged != NULL) {
+    matrix_batch_destroy(ragged);
+    result = EXIT_FAILURE;
+  }
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int batch_serializer_tests() {
+  if (batch_serializer_vector_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (batch_serializer_matrix_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (batch_serializer_malformed_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef BATCH_SERIALIZER_TESTS_H
+#define BATCH_SERIALIZER_TESTS_H
+
+/**
+ * Batch serializer tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int batch_serializer_tests();
+
+#endif
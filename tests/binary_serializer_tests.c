@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+#include "binary_serializer_tests.h"
+
+/**
+ * Tests the binary round trip of a matrix.
+ *
+ * This function serializes a matrix to the binary format, checks the output is
+ * deterministic, decodes it back and compares every element.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_binary_tests() {
+  printf("------------ Matrix Binary Tests. ------------\n");
+  // Create a matrix of 3 x 5 elements.
+  struct matrix *matrix_object = matrix_create(3, 5);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 5; k++) {
+      matrix_setl(matrix_object, j, k, (j * 5 + k - 7) / 3.0L);
+    }
+  }
+  // Serialize the matrix twice, the output must be identical.
+  size_t length = 0;
+  size_t second_length = 0;
+  unsigned char *data = matrix_serialize_binary(matrix_object, &length);
+  unsigned char *second = matrix_serialize_binary(matrix_object, &second_length);
+  int result = EXIT_SUCCESS;
+  if (data == NULL || second == NULL || length != second_length || memcmp(data, second, length) != 0
+      || length != SERIALIZER_BINARY_HEADER_SIZE + 15 * sizeof(long double)) {
+    result = EXIT_FAILURE;
+  }
+  // Decode and compare.
+  struct matrix *decoded = result == EXIT_SUCCESS ? matrix_unserialize_binary(data, length) : NULL;
+  if (decoded == NULL || decoded->rows != 3 || decoded->columns != 5) {
+    result = EXIT_FAILURE;
+  }
+  for (int j = 0; result == EXIT_SUCCESS && j < 3; j++) {
+    for (int k = 0; k < 5; k++) {
+      if (*matrix_getl(decoded, j, k) != *matrix_getl(matrix_object, j, k)) {
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  matrix_destroy(decoded);
+  // Payloads of another long double format, or of no recorded format, must
+  // be rejected; the checksum only covers the element block.
+  static const uint8_t formats[] = {
+    SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_ELEMENT_EXTENDED80, SERIALIZER_ELEMENT_BINARY128, SERIALIZER_ELEMENT_DOUBLE_DOUBLE,
+  };
+  uint8_t written = data[7];
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(formats); i++) {
+    if (formats[i] == written) {
+      continue;
+    }
+    data[7] = formats[i];
+    struct matrix *foreign = matrix_unserialize_binary(data, length);
+    if (foreign != NULL) {
+      printf("Long double format %d was read as format %d.\n", formats[i], written);
+      matrix_destroy(foreign);
+      result = EXIT_FAILURE;
+    }
+  }
+  data[7] = written;
+  // Truncated and corrupted payloads must be rejected.
+  if (result == EXIT_SUCCESS) {
+    struct matrix *truncated = matrix_unserialize_binary(data, length - 1);
+    data[SERIALIZER_BINARY_HEADER_SIZE + 3] ^= 0x40;
+    struct matrix *corrupted = matrix_unserialize_binary(data, length);
+    if (truncated != NULL || corrupted != NULL || vector_unserialize_binary(second, second_length) != NULL) {
+      matrix_destroy(truncated);
+      matrix_destroy(corrupted);
+      result = EXIT_FAILURE;
+    }
+  }
+  printf("Binary Matrix Length: %zu bytes.\n", length);
+  // Clear the used memory.
+  free(data);
+  free(second);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests the binary round trip of a vector.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int vector_binary_tests() {
+  printf("------------ Vector Binary Tests. ------------\n");
+  // Create a vector of 7 elements.
+  struct vector *vector_object = vector_create(7);
+  if (vector_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < 7; i++) {
+    vector_setl(vector_object, i, (i - 3) * 1.1L);
+  }
+  // Serialize, decode and compare.
+  size_t length = 0;
+  unsigned char *data = vector_serialize_binary(vector_object, &length);
+  struct vector *decoded = vector_unserialize_binary(data, length);
+  int result = EXIT_SUCCESS;
+  if (data == NULL || decoded == NULL || decoded->capacity != 7) {
+    result = EXIT_FAILURE;
+  }
+  for (int i = 0; result == EXIT_SUCCESS && i < 7; i++) {
+    if (*vector_getl(decoded, i) != *vector_getl(vector_object, i)) {
+      result = EXIT_FAILURE;
+    }
+  }
+  // A vector payload is not a matrix payload.
+  if (result == EXIT_SUCCESS && matrix_unserialize_binary(data, length) != NULL) {
+    result = EXIT_FAILURE;
+  }
+  printf("Binary Vector Length: %zu bytes.\n", length);
+  // Clear the used memory.
+  free(data);
+  vector_destroy(decoded);
+  vector_destroy(vector_object);
+  return result;
+}
+
+/**
+ * Tests memory-mapped matrix loading.
+ *
+ * This function writes a matrix to a temporary binary file, maps it back and
+ * compares the view against the original matrix.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_mapping_tests() {
+  printf("------------ Matrix Mapping Tests. ------------\n");
+  // Create a matrix of 4 x 3 elements.
+  struct matrix *matrix_object = matrix_create(4, 3);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 4; j++) {
+    for (int k = 0; k < 3; k++) {
+      matrix_setl(matrix_object, j, k, j * 0.25L - k * 10.0L);
+    }
+  }
+  // Write the matrix to a temporary file.
+  char path[] = "/tmp/matrixmath_serializer_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    matrix_destroy(matrix_object);
+    return EXIT_FAILURE;
+  }
+  close(fd);
+  int result = EXIT_SUCCESS;
+  struct matrix_view *view = NULL;
+  if (matrix_write_binary_file(path, matrix_object) == 1 || (view = matrix_map_file(path)) == NULL) {
+    result = EXIT_FAILURE;
+  }
+  // Compare the mapped view with the original matrix.
+  if (result == EXIT_SUCCESS && (view->rows != 4 || view->columns != 3 || matrix_view_verify(view) == 1
+      || matrix_view_getl(view, 4, 0) != NULL)) {
+    result = EXIT_FAILURE;
+  }
+  for (int j = 0; result == EXIT_SUCCESS && j < 4; j++) {
+    for (int k = 0; k < 3; k++) {
+      if (*matrix_view_getl(view, j, k) != *matrix_getl(matrix_object, j, k)) {
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  // Copy the view into a regular matrix.
+  struct matrix *copy = result == EXIT_SUCCESS ? matrix_view_to_matrix(view) : NULL;
+  if (copy == NULL || *matrix_getl(copy, 3, 2) != *matrix_getl(matrix_object, 3, 2)) {
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  matrix_destroy(copy);
+  matrix_unmap(view);
+  unlink(path);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int binary_serializer_tests() {
+  if (matrix_binary_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (vector_binary_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_mapping_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
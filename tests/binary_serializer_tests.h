@@ -0,0 +1,12 @@
+#ifndef BINARY_SERIALIZER_TESTS_H
+#define BINARY_SERIALIZER_TESTS_H
+
+/**
+ * Binary serializer tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int binary_serializer_tests();
+
+#endif
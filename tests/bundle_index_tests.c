@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/matrixmath_serializer.h"
+#include "bundle_index_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * The number of objects in the test bundles.
+ */
+#define BUNDLE_TEST_COUNT 50
+
+/**
+ * Tests lookups in an indexed matrix bundle held in memory.
+ *
+ * Keys are written in reverse order so the writer has to sort them.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int bundle_index_lookup_tests() {
+  printf("------------ Bundle Index Lookup Tests. ------------\n");
+  char names[BUNDLE_TEST_COUNT][24];
+  const char *keys[BUNDLE_TEST_COUNT];
+  struct matrix *matrices[BUNDLE_TEST_COUNT];
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < BUNDLE_TEST_COUNT; i++) {
+    snprintf(names[i], sizeof(names[i]), "layer.%d", BUNDLE_TEST_COUNT - 1 - i);
+    keys[i] = names[i];
+    matrices[i] = serializer_test_matrix(2 + i % 3, 3, i * 100.0L);
+    if (matrices[i] == NULL) {
+      result = EXIT_FAILURE;
+    }
+  }
+  size_t length = 0;
+  unsigned char *data = result == EXIT_SUCCESS ? matrix_serialize_indexed(keys, matrices, BUNDLE_TEST_COUNT, &length) : NULL;
+  struct serializer_bundle *bundle = serializer_bundle_open(data, length);
+  if (bundle == NULL || bundle->header.count != BUNDLE_TEST_COUNT) {
+    printf("Indexed bundle was not opened.\n");
+    result = EXIT_FAILURE;
+  }
+  // Every key is found, both copied and viewed in place.
+  for (int i = 0; i < BUNDLE_TEST_COUNT && result == EXIT_SUCCESS; i++) {
+    struct matrix *copy = matrix_bundle_get(bundle, keys[i]);
+    struct matrix_view view;
+    if (!serializer_test_matrix_equal(matrices[i], copy) || matrix_bundle_view(bundle, keys[i], &view) == 1
+        || view.rows != copy->rows || *matrix_view_getl(&view, 1, 2) != *matrix_getl(copy, 1, 2)) {
+      printf("Key %s was not retrieved.\n", keys[i]);
+      result = EXIT_FAILURE;
+    }
+    matrix_destroy(copy);
+  }
+  // Missing keys, including prefixes and extensions of present ones.
+  const char *missing[] = {"", "layer", "layer.", "layer.4x", "layer.50", "zzz", "a"};
+  for (size_t i = 0; i < sizeof(missing) / sizeof(missing[0]) && result == EXIT_SUCCESS; i++) {
+    struct serializer_bundle_entry entry;
+    if (serializer_bundle_find(bundle, missing[i], &entry) == 0 || matrix_bundle_get(bundle, missing[i]) != NULL) {
+      printf("Missing key \"%s\" was found.\n", missing[i]);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Vectors cannot be read from a matrix bundle.
+  if (result == EXIT_SUCCESS && vector_bundle_get(bundle, keys[0]) != NULL) {
+    printf("Matrix payload was decoded as a vector.\n");
+    result = EXIT_FAILURE;
+  }
+  // Duplicate keys cannot be indexed.
+  size_t duplicate_length = 0;
+  keys[1] = keys[0];
+  unsigned char *duplicate = matrix_serialize_indexed(keys, matrices, BUNDLE_TEST_COUNT, &duplicate_length);
+  if (result == EXIT_SUCCESS && duplicate != NULL) {
+    printf("Duplicate keys were indexed.\n");
+    result = EXIT_FAILURE;
+  }
+  free(duplicate);
+  serializer_bundle_close(bundle);
+  free(data);
+  for (int i = 0; i < BUNDLE_TEST_COUNT; i++) {
+    matrix_destroy(matrices[i]);
+  }
+  return result;
+}
+
+/**
+ * Tests an indexed vector bundle and the bundles that cannot be opened.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int bundle_index_vector_tests() {
+  printf("------------ Bundle Index Vector Tests. ------------\n");
+  const char *keys[3] = {"weights", "bias", "scale"};
+  struct vector *vectors[3] = {vector_create(4), vector_create(1), vector_create(7)};
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < 3; i++) {
+    if (vectors[i] == NULL) {
+      result = EXIT_FAILURE;
+      continue;
+    }
+    for (int k = 0; k < vectors[i]->capacity; k++) {
+      vector_setl(vectors[i], k, i - k / 8.0L);
+    }
+  }
+  size_t length = 0;
+  unsigned char *data = result == EXIT_SUCCESS ? vector_serialize_indexed(keys, vectors, 3, &length) : NULL;
+  struct serializer_bundle *bundle = serializer_bundle_open(data, length);
+  for (int i = 0; i < 3 && result == EXIT_SUCCESS; i++) {
+    struct vector *copy = vector_bundle_get(bundle, keys[i]);
+    if (copy == NULL || copy->capacity != vectors[i]->capacity || *vector_getl(copy, copy->capacity - 1) != *vector_getl(vectors[i], vectors[i]->capacity - 1)) {
+      printf("Vector %s was not retrieved.\n", keys[i]);
+      result = EXIT_FAILURE;
+    }
+    vector_destroy(copy);
+  }
+  struct matrix_view view;
+  if (result == EXIT_SUCCESS && (matrix_bundle_get(bundle, "bias") != NULL || matrix_bundle_view(bundle, "bias", &view) == 0)) {
+    printf("Vector payload was read as a matrix.\n");
+    result = EXIT_FAILURE;
+  }
+  // A damaged index fails its checksum.
+  if (result == EXIT_SUCCESS) {
+    data[SERIALIZER_BUNDLE_HEADER_SIZE + 8] ^= 1;
+    struct serializer_bundle *damaged = serializer_bundle_open(data, length);
+    data[SERIALIZER_BUNDLE_HEADER_SIZE + 8] ^= 1;
+    if (damaged != NULL) {
+      printf("Damaged index was opened.\n");
+      serializer_bundle_close(damaged);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Batch bundles keep the caller order and have no sorted index.
+  size_t batch_length = 0;
+  unsigned char *batch = vector_serialize_batch_binary(keys, vectors, 3, &batch_length);
+  struct serializer_bundle *unsorted = serializer_bundle_open(batch, batch_length);
+  if (result == EXIT_SUCCESS && (batch == NULL || unsorted != NULL)) {
+    printf("Unsorted bundle was opened.\n");
+    result = EXIT_FAILURE;
+  }
+  // Indexed bundles still decode as a whole.
+  struct vector_batch *decoded = result == EXIT_SUCCESS ? vector_unserialize_batch_binary(data, length) : NULL;
+  if (result == EXIT_SUCCESS && (decoded == NULL || decoded->count != 3 || strcmp(decoded->keys[0], "bias") != 0)) {
+    printf("Indexed bundle was not decoded as a batch.\n");
+    result = EXIT_FAILURE;
+  }
+  vector_batch_destroy(decoded);
+  serializer_bundle_close(unsorted);
+  free(batch);
+  serializer_bundle_close(bundle);
+  free(data);
+  for (int i = 0; i < 3; i++) {
+    vector_destroy(vectors[i]);
+  }
+  return result;
+}
+
+/**
+ * Tests lookups in an indexed matrix bundle mapped from a file.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int bundle_index_mapping_tests() {
+  printf("------------ Bundle Index Mapping Tests. ------------\n");
+  const char *keys[2] = {"encoder", "decoder"};
+  struct matrix *matrices[2] = {serializer_test_matrix(2, 3, 0), serializer_test_matrix(3, 3, 100.0L)};
+  if (matrices[0] == NULL || matrices[1] == NULL) {
+    matrix_destroy(matrices[0]);
+    matrix_destroy(matrices[1]);
+    return EXIT_FAILURE;
+  }
+  // Write the bundle to a temporary file.
+  char path[] = "/tmp/matrixmath_serializer_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    matrix_destroy(matrices[0]);
+    matrix_destroy(matrices[1]);
+    return EXIT_FAILURE;
+  }
+  close(fd);
+  int result = EXIT_SUCCESS;
+  struct serializer_bundle *bundle = NULL;
+  if (matrix_write_indexed_file(path, keys, matrices, 2) == 1 || (bundle = serializer_bundle_map_file(path)) == NULL) {
+    result = EXIT_FAILURE;
+  }
+  for (int i = 0; i < 2 && result == EXIT_SUCCESS; i++) {
+    struct matrix *copy = matrix_bundle_get(bundle, keys[i]);
+    struct matrix_view view;
+    if (!serializer_test_matrix_equal(matrices[i], copy) || matrix_bundle_view(bundle, keys[i], &view) == 1
+        || view.columns != 3 || *matrix_view_getl(&view, 1, 0) != *matrix_getl(matrices[i], 1, 0)) {
+      printf("Mapped key %s was not retrieved.\n", keys[i]);
+      result = EXIT_FAILURE;
+    }
+    matrix_destroy(copy);
+  }
+  // Clear the used memory.
+  serializer_bundle_close(bundle);
+  unlink(path);
+  if (result == EXIT_SUCCESS && serializer_bundle_map_file(path) != NULL) {
+    result = EXIT_FAILURE;
+  }
+  matrix_destroy(matrices[0]);
+  matrix_destroy(matrices[1]);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int bundle_index_tests() {
+  if (bundle_index_lookup_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (bundle_index_vector_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (bundle_index_mapping_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef BUNDLE_INDEX_TESTS_H
+#define BUNDLE_INDEX_TESTS_H
+
+/**
+ * Bundle index tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int bundle_index_tests();
+
+#endif
@@ -0,0 +1,270 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "element_type_tests.h"
+
+/**
+ * The element types written by the binary encoders.
+ */
+static const int element_types[] = {
+  SERIALIZER_ELEMENT_LONG_DOUBLE,
+  SERIALIZER_ELEMENT_FLOAT64,
+  SERIALIZER_ELEMENT_FLOAT32,
+  SERIALIZER_ELEMENT_FLOAT16,
+  SERIALIZER_ELEMENT_BFLOAT16,
+};
+
+/**
+ * The stored size of each of the element_types.
+ */
+static const size_t element_sizes[] = {sizeof(long double), 8, 4, 2, 2};
+
+/**
+ * Creates a matrix of pseudo-random values within the normal range of every element type.
+ *
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ *
+ * @return struct matrix*
+ *   Returns the matrix, or NULL if an error occurred.
+ */
+static struct matrix *element_type_test_matrix(int rows, int columns) {
+  struct matrix *object = matrix_create(rows, columns);
+  if (object == NULL) {
+    return NULL;
+  }
+  uint32_t state = 2024;
+  for (int j = 0; j < rows; j++) {
+    for (int k = 0; k < columns; k++) {
+      state = state * 1103515245U + 12345U;
+      long double mantissa = 1.0L + (state >> 8) / 16777216.0L;
+      state = state * 1103515245U + 12345U;
+      int exponent = (int)(state >> 16) % 25 - 12;
+      matrix_setl(object, j, k, ldexpl((state & 1) != 0 ? -mantissa : mantissa, exponent));
+    }
+  }
+  return object;
+}
+
+/**
+ * Checks that every decoded element is within the given relative error of the original.
+ *
+ * @param struct matrix *expected
+ *   The original matrix.
+ * @param struct matrix *actual
+ *   The decoded matrix.
+ * @param long double bound
+ *   The largest accepted relative error.
+ *
+ * @return int
+ *   Returns 1 if every element is within the bound, otherwise 0.
+ */
+static int element_type_test_within(struct matrix *expected, struct matrix *actual, long double bound) {
+  if (actual == NULL || expected->rows != actual->rows || expected->columns != actual->columns) {
+    return 0;
+  }
+  for (int j = 0; j < expected->rows; j++) {
+    for (int k = 0; k < expected->columns; k++) {
+      long double value = *matrix_getl(expected, j, k);
+      if (fabsl(*matrix_getl(actual, j, k) - value) > bound * fabsl(value)) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * Tests rounding to each element type on known values.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int element_type_rounding_tests() {
+  printf("------------ Element Type Rounding Tests. ------------\n");
+  struct {
+    int element_type;
+    long double value;
+    long double expected;
+  } cases[] = {
+    {SERIALIZER_ELEMENT_FLOAT64, 0.1L, 0.1},
+    {SERIALIZER_ELEMENT_FLOAT32, 0.1L, 0.1f},
+    // Largest finite binary16, the next tie rounds to infinity.
+    {SERIALIZER_ELEMENT_FLOAT16, 65504.0L, 65504.0L},
+    {SERIALIZER_ELEMENT_FLOAT16, 65519.0L, 65504.0L},
+    {SERIALIZER_ELEMENT_FLOAT16, 65520.0L, INFINITY},
+    {SERIALIZER_ELEMENT_FLOAT16, -1e9L, -INFINITY},
+    // Ties round to even, including in the subnormal range.
+    {SERIALIZER_ELEMENT_FLOAT16, 1.0L + ldexpl(1.0L, -11), 1.0L},
+    {SERIALIZER_ELEMENT_FLOAT16, 1.0L + 3 * ldexpl(1.0L, -11), 1.0L + ldexpl(1.0L, -9)},
+    {SERIALIZER_ELEMENT_FLOAT16, ldexpl(1.0L, -24), ldexpl(1.0L, -24)},
+    {SERIALIZER_ELEMENT_FLOAT16, ldexpl(1.0L, -25), 0.0L},
+    {SERIALIZER_ELEMENT_FLOAT16, ldexpl(3.0L, -25), ldexpl(1.0L, -23)},
+    {SERIALIZER_ELEMENT_BFLOAT16, 1.0L + ldexpl(1.0L, -8), 1.0L},
+    {SERIALIZER_ELEMENT_BFLOAT16, 3.0e38L, ldexpl(226.0L, 120)},
+    {SERIALIZER_ELEMENT_BFLOAT16, 3.4e38L, INFINITY},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    long double rounded = serializer_element_round(cases[i].value, cases[i].element_type);
+    if (rounded != cases[i].expected) {
+      printf("Case %zu rounded to %Lg instead of %Lg.\n", i, rounded, cases[i].expected);
+      return EXIT_FAILURE;
+    }
+  }
+  // Unknown element types are rejected.
+  if (!isnan(serializer_element_round(1.0L, 0)) || serializer_element_epsilon(0) != -1) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Tests binary round trips of every element type against the error bound.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int element_type_binary_tests() {
+  printf("------------ Element Type Binary Tests. ------------\n");
+  struct matrix *object = element_type_test_matrix(17, 23);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  struct serializer_options options;
+  serializer_options_init(&options);
+  int result = EXIT_SUCCESS;
+  for (size_t i = 0; i < sizeof(element_types) / sizeof(element_types[0]) && result == EXIT_SUCCESS; i++) {
+    options.element_type = element_types[i];
+    for (int sparse = SERIALIZER_SPARSE_NEVER; sparse <= SERIALIZER_SPARSE_ALWAYS && result == EXIT_SUCCESS; sparse++) {
+      options.sparse = sparse;
+      size_t length = 0;
+      unsigned char *data = matrix_serialize_binary_with_options(object, &options, &length);
+      struct matrix *decoded = data != NULL ? matrix_unserialize_binary(data, length) : NULL;
+      // Dense payloads shrink with the element size.
+      if (data == NULL || (sparse == SERIALIZER_SPARSE_NEVER && length != SERIALIZER_BINARY_HEADER_SIZE + 17 * 23 * element_sizes[i])) {
+        printf("Element type %d payload has the wrong size.\n", element_types[i]);
+        result = EXIT_FAILURE;
+      }
+      // Decoding widens the rounded elements back exactly.
+      for (int j = 0; j < 17 && result == EXIT_SUCCESS; j++) {
+        for (int k = 0; k < 23; k++) {
+          long double rounded = serializer_element_round(*matrix_getl(object, j, k), element_types[i]);
+          if (decoded == NULL || *matrix_getl(decoded, j, k) != rounded) {
+            printf("Element type %d was not widened back exactly.\n", element_types[i]);
+            result = EXIT_FAILURE;
+            break;
+          }
+        }
+      }
+      if (result == EXIT_SUCCESS && !element_type_test_within(object, decoded, serializer_element_epsilon(element_types[i]))) {
+        printf("Element type %d exceeds its error bound.\n", element_types[i]);
+        result = EXIT_FAILURE;
+      }
+      free(data);
+      matrix_destroy(decoded);
+    }
+  }
+  // Vectors carry the element type too, special values included.
+  struct vector *vector_object = vector_create(4);
+  long double specials[4] = {INFINITY, -0.0L, -INFINITY, NAN};
+  for (int i = 0; vector_object != NULL && i < 4; i++) {
+    vector_setl(vector_object, i, specials[i]);
+  }
+  for (size_t i = 0; i < sizeof(element_types) / sizeof(element_types[0]) && result == EXIT_SUCCESS; i++) {
+    options.element_type = element_types[i];
+    size_t length = 0;
+    unsigned char *data = vector_object != NULL ? vector_serialize_binary_with_options(vector_object, &options, &length) : NULL;
+    struct vector *decoded = data != NULL ? vector_unserialize_binary(data, length) : NULL;
+    if (decoded == NULL || length != SERIALIZER_BINARY_HEADER_SIZE + 4 * element_sizes[i] || *vector_getl(decoded, 0) != INFINITY
+        || *vector_getl(decoded, 1) != 0 || !signbit(*vector_getl(decoded, 1)) || *vector_getl(decoded, 2) != -INFINITY || !isnan(*vector_getl(decoded, 3))) {
+      printf("Element type %d lost a special value.\n", element_types[i]);
+      result = EXIT_FAILURE;
+    }
+    free(data);
+    vector_destroy(decoded);
+  }
+  vector_destroy(vector_object);
+  // Unknown element types are rejected.
+  size_t length = 0;
+  options.element_type = 9;
+  if (result == EXIT_SUCCESS && matrix_serialize_binary_with_options(object, &options, &length) != NULL) {
+    result = EXIT_FAILURE;
+  }
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * Tests text round trips of the element types supported by the text encoders.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int element_type_text_tests() {
+  printf("------------ Element Type Text Tests. ------------\n");
+  struct matrix *object = element_type_test_matrix(20, 20);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  struct serializer_options options;
+  serializer_options_init(&options);
+  int result = EXIT_SUCCESS;
+  size_t previous = 0;
+  for (size_t i = 0; i < 3 && result == EXIT_SUCCESS; i++) {
+    options.element_type = element_types[i];
+    char *text = matrix_serialize_with_options(object, &options);
+    struct matrix *decoded = text != NULL ? matrix_unserialize(text) : NULL;
+    // Narrower types need fewer digits.
+    if (text == NULL || (previous > 0 && strlen(text) >= previous)) {
+      printf("Element type %d text is missing or not shorter.\n", element_types[i]);
+      result = EXIT_FAILURE;
+    }
+    if (result == EXIT_SUCCESS && !element_type_test_within(object, decoded, 2 * serializer_element_epsilon(element_types[i]))) {
+      printf("Element type %d text exceeds its error bound.\n", element_types[i]);
+      result = EXIT_FAILURE;
+    }
+    // The bound on the text length still holds.
+    if (result == EXIT_SUCCESS && matrix_serialized_size(object, &options) < strlen(text) + 1) {
+      printf("Element type %d text exceeds its size bound.\n", element_types[i]);
+      result = EXIT_FAILURE;
+    }
+    previous = text != NULL ? strlen(text) : 0;
+    free(text);
+    matrix_destroy(decoded);
+  }
+  // The shortest float32 text of a rounded value.
+  char buffer[SERIALIZER_NUMBER_MAX_LENGTH];
+  options.element_type = SERIALIZER_ELEMENT_FLOAT32;
+  if (result == EXIT_SUCCESS && (serializer_format_number(0.1L, &options, buffer) != 3 || strcmp(buffer, "0.1") != 0)) {
+    result = EXIT_FAILURE;
+  }
+  // The 16-bit types are only written as binary.
+  options.element_type = SERIALIZER_ELEMENT_FLOAT16;
+  char *text = matrix_serialize_with_options(object, &options);
+  if (result == EXIT_SUCCESS && (text != NULL || serializer_format_number(1.0L, &options, buffer) != -1)) {
+    result = EXIT_FAILURE;
+  }
+  free(text);
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int element_type_tests() {
+  if (element_type_rounding_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (element_type_binary_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (element_type_text_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef ELEMENT_TYPE_TESTS_H
+#define ELEMENT_TYPE_TESTS_H
+
+/**
+ * Element type tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int element_type_tests();
+
+#endif
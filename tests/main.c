@@ -1,6 +1,24 @@
 #include <stdlib.h>
 #include "vector_serializer_tests.h"
 #include "matrix_serializer_tests.h"
+#include "binary_serializer_tests.h"
+#include "number_formatter_tests.h"
+#include "number_parser_tests.h"
+#include "parallel_serializer_tests.h"
+#include "matrix_stream_tests.h"
+#include "serializer_arena_tests.h"
+#include "serializer_context_tests.h"
+#include "sparse_serializer_tests.h"
+#include "matrix_delta_tests.h"
+#include "serializer_compression_tests.h"
+#include "batch_serializer_tests.h"
+#include "bundle_index_tests.h"
+#include "element_type_tests.h"
+#include "matrix_layout_tests.h"
+#include "serializer_metrics_tests.h"
+#include "async_serializer_tests.h"
+#include "strict_decoder_tests.h"
+#include "tensor_serializer_tests.h"
 
 /**
  * Main controller function.
@@ -22,6 +40,78 @@ int main(int argc, char const *argv[]) {
   if (matrix_serializer_tests() == EXIT_FAILURE) {
     return EXIT_FAILURE;
   }
+  // Run binary serializer tests and check for failure.
+  if (binary_serializer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run number formatter tests and check for failure.
+  if (number_formatter_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run number parser tests and check for failure.
+  if (number_parser_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run parallel serializer tests and check for failure.
+  if (parallel_serializer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run matrix stream tests and check for failure.
+  if (matrix_stream_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run serializer arena tests and check for failure.
+  if (serializer_arena_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run serializer context tests and check for failure.
+  if (serializer_context_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run sparse serializer tests and check for failure.
+  if (sparse_serializer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run matrix delta tests and check for failure.
+  if (matrix_delta_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run serializer compression tests and check for failure.
+  if (serializer_compression_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run batch serializer tests and check for failure.
+  if (batch_serializer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run bundle index tests and check for failure.
+  if (bundle_index_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run element type tests and check for failure.
+  if (element_type_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run matrix layout tests and check for failure.
+  if (matrix_layout_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run serializer metrics tests and check for failure.
+  if (serializer_metrics_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run async serializer tests and check for failure.
+  if (async_serializer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run strict decoder tests and check for failure.
+  if (strict_decoder_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  // Run tensor serializer tests and check for failure.
+  if (tensor_serializer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
   // Return success response.
   return EXIT_SUCCESS;
 }
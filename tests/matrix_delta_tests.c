@@ -0,0 +1,214 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "matrix_delta_tests.h"
+
+/**
+ * Creates a copy of a matrix.
+ *
+ * @param struct matrix *object
+ *   The matrix to copy.
+ *
+ * @return struct matrix*
+ *   Returns the copy, or NULL if the allocation failed.
+ */
+static struct matrix *matrix_delta_test_copy(struct matrix *object) {
+  struct matrix *copy = matrix_create(object->rows, object->columns);
+  if (copy == NULL) {
+    return NULL;
+  }
+  for (int j = 0; j < object->rows; j++) {
+    for (int k = 0; k < object->columns; k++) {
+      matrix_setl(copy, j, k, *matrix_getl(object, j, k));
+    }
+  }
+  return copy;
+}
+
+/**
+ * Checks that two matrices hold the same element bits.
+ *
+ * @param struct matrix *expected
+ *   The expected matrix.
+ * @param struct matrix *actual
+ *   The matrix to check.
+ *
+ * @return int
+ *   Returns 1 if the matrices are identical, otherwise 0.
+ */
+static int matrix_delta_test_identical(struct matrix *expected, struct matrix *actual) {
+  for (int j = 0; j < expected->rows; j++) {
+    for (int k = 0; k < expected->columns; k++) {
+      long double a = *matrix_getl(expected, j, k);
+      long double b = *matrix_getl(actual, j, k);
+      if (a != b || signbit(a) != signbit(b)) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * Tests that a delta patches the previous snapshot into the current one.
+ *
+ * This function changes scattered elements, a whole range of rows and the sign
+ * of a zero, then checks the patched copy, the version tags and that the delta
+ * is much smaller than a full encoding.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_delta_apply_tests() {
+  printf("------------ Matrix Delta Apply Tests. ------------\n");
+  struct matrix *previous = matrix_create(50, 40);
+  if (previous == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 50; j++) {
+    for (int k = 0; k < 40; k++) {
+      matrix_setl(previous, j, k, (j * 40 + k) / 7.0L);
+    }
+  }
+  struct matrix *current = matrix_delta_test_copy(previous);
+  struct matrix *replica = matrix_delta_test_copy(previous);
+  if (current == NULL || replica == NULL) {
+    matrix_destroy(previous);
+    matrix_destroy(current);
+    matrix_destroy(replica);
+    return EXIT_FAILURE;
+  }
+  matrix_setl(current, 0, 0, -1.0L);
+  matrix_setl(current, 3, 39, 2.5L);
+  matrix_setl(current, 4, 0, 3.5L);
+  matrix_setl(current, 49, 39, 1e300L);
+  for (int j = 10; j < 13; j++) {
+    for (int k = 0; k < 40; k++) {
+      matrix_setl(current, j, k, -j - k / 3.0L);
+    }
+  }
+  matrix_setl(previous, 20, 5, 0.0L);
+  matrix_setl(replica, 20, 5, 0.0L);
+  matrix_setl(current, 20, 5, -0.0L);
+  int result = EXIT_SUCCESS;
+  char *delta = matrix_serialize_delta(previous, current, NULL);
+  char *full = matrix_serialize(current);
+  uint32_t version = matrix_checksum(replica);
+  if (delta == NULL || full == NULL || strlen(delta) * 10 > strlen(full)) {
+    printf("Delta is missing or not smaller than the full matrix.\n");
+    result = EXIT_FAILURE;
+  }
+  // Runs cover the row range and join elements across row ends.
+  if (result == EXIT_SUCCESS && (strstr(delta, "[10,0,[") == NULL || strstr(delta, "[3,39,[\"2.5\",\"3.5\"]]") == NULL)) {
+    printf("Unexpected delta runs: %s\n", delta);
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && (matrix_apply_delta(replica, delta, &version) == 1 || !matrix_delta_test_identical(current, replica))) {
+    printf("Delta did not patch the replica.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && version != matrix_checksum(current)) {
+    printf("Version tag was not advanced.\n");
+    result = EXIT_FAILURE;
+  }
+  // The same delta does not apply twice.
+  if (result == EXIT_SUCCESS && matrix_apply_delta(replica, delta, &version) == 0) {
+    printf("Delta was applied to the wrong base.\n");
+    result = EXIT_FAILURE;
+  }
+  // The tag matches the checksum of the dense binary payload.
+  size_t length = 0;
+  unsigned char *binary = matrix_serialize_binary(current, &length);
+  struct serializer_binary_header header;
+  if (result == EXIT_SUCCESS && (binary == NULL || serializer_binary_read_header(binary, length, &header) == 1 || header.checksum != matrix_checksum(current))) {
+    printf("Version tag does not match the binary checksum.\n");
+    result = EXIT_FAILURE;
+  }
+  // Identical snapshots produce an empty delta.
+  char *empty = matrix_serialize_delta(current, current, NULL);
+  if (result == EXIT_SUCCESS && (empty == NULL || strstr(empty, "\"changes\":[]") == NULL || matrix_apply_delta(replica, empty, NULL) == 1)) {
+    printf("Empty delta was not handled.\n");
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  free(delta);
+  free(full);
+  free(binary);
+  free(empty);
+  matrix_destroy(previous);
+  matrix_destroy(current);
+  matrix_destroy(replica);
+  return result;
+}
+
+/**
+ * Tests that rejected deltas leave the destination untouched.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_delta_malformed_tests() {
+  printf("------------ Matrix Delta Malformed Tests. ------------\n");
+  const char *inputs[] = {
+    // Shape mismatch.
+    "{\"format\":\"delta\",\"rows\":3,\"columns\":2,\"changes\":[],\"base\":0,\"version\":0}",
+    // Run starting outside the matrix.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[2,0,[\"1\"]]],\"base\":0,\"version\":0}",
+    // Run running past the last element.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[1,1,[\"1\",\"2\"]]],\"base\":0,\"version\":0}",
+    // Overlapping runs.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\",\"2\"]],[0,1,[\"3\"]]],\"base\":0,\"version\":0}",
+    // Empty run.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[]]],\"base\":0,\"version\":0}",
+    // Bad value after a good run.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\"]],[1,0,[\"x\"]]],\"base\":0,\"version\":0}",
+    // Missing version.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\"]]],\"base\":0}",
+    // Wrong format.
+    "{\"format\":\"csr\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\"]]],\"base\":0,\"version\":0}",
+    // Tag out of range.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\"]]],\"base\":4294967296,\"version\":0}",
+    // Trailing text.
+    "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\"]]],\"base\":0,\"version\":0},",
+  };
+  struct matrix *destination = matrix_create(2, 2);
+  if (destination == NULL) {
+    return EXIT_FAILURE;
+  }
+  matrix_setl(destination, 0, 0, 5.0L);
+  int count = sizeof(inputs) / sizeof(inputs[0]);
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < count && result == EXIT_SUCCESS; i++) {
+    if (matrix_apply_delta(destination, inputs[i], NULL) == 0 || *matrix_getl(destination, 0, 0) != 5.0L) {
+      printf("Malformed delta %d was applied.\n", i);
+      result = EXIT_FAILURE;
+    }
+  }
+  // A well formed delta with a base tag the destination does not have.
+  uint32_t version = 1;
+  const char *valid = "{\"format\":\"delta\",\"rows\":2,\"columns\":2,\"changes\":[[0,0,[\"1\"]]],\"base\":7,\"version\":8}";
+  if (result == EXIT_SUCCESS && (matrix_apply_delta(destination, valid, &version) == 0 || version != 1 || *matrix_getl(destination, 0, 0) != 5.0L)) {
+    result = EXIT_FAILURE;
+  }
+  version = 7;
+  if (result == EXIT_SUCCESS && (matrix_apply_delta(destination, valid, &version) == 1 || version != 8 || *matrix_getl(destination, 0, 0) != 1.0L)) {
+    result = EXIT_FAILURE;
+  }
+  matrix_destroy(destination);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_delta_tests() {
+  if (matrix_delta_apply_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_delta_malformed_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
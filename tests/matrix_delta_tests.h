@@ -0,0 +1,12 @@
+#ifndef MATRIX_DELTA_TESTS_H
+#define MATRIX_DELTA_TESTS_H
+
+/**
+ * Matrix delta tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int matrix_delta_tests();
+
+#endif
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "matrix_layout_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * Creates a test matrix and its transpose.
+ *
+ * The shape is not a multiple of the transpose tile, so partial tiles and
+ * strips are covered.
+ *
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ * @param struct matrix **transpose
+ *   Pointer receiving the transpose.
+ *
+ * @return struct matrix*
+ *   Returns the matrix, or NULL if an error occurred.
+ */
+static struct matrix *matrix_layout_test_create(int rows, int columns, struct matrix **transpose) {
+  struct matrix *object = serializer_test_matrix(rows, columns, 0.125L);
+  *transpose = matrix_create(columns, rows);
+  if (object == NULL || *transpose == NULL) {
+    matrix_destroy(object);
+    matrix_destroy(*transpose);
+    return NULL;
+  }
+  for (int j = 0; j < rows; j++) {
+    for (int k = 0; k < columns; k++) {
+      matrix_setl(*transpose, k, j, *matrix_getl(object, j, k));
+    }
+  }
+  return object;
+}
+
+/**
+ * Tests column-major JSON text.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_layout_text_tests() {
+  printf("------------ Matrix Layout Text Tests. ------------\n");
+  struct matrix *transpose = NULL;
+  struct matrix *object = matrix_layout_test_create(37, 21, &transpose);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.layout = SERIALIZER_LAYOUT_COLUMN_MAJOR;
+  // The text is the row-major text of the transpose, CSR is never used.
+  char *columns = matrix_serialize_with_options(object, &options);
+  char *expected = matrix_serialize(transpose);
+  options.sparse = SERIALIZER_SPARSE_ALWAYS;
+  char *dense = matrix_serialize_with_options(object, &options);
+  int result = EXIT_SUCCESS;
+  if (columns == NULL || expected == NULL || dense == NULL || strcmp(columns, expected) != 0 || strcmp(dense, expected) != 0) {
+    printf("Column-major text does not match the transpose.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && matrix_serialized_size(object, &options) < strlen(columns) + 1) {
+    printf("Column-major text exceeds its size bound.\n");
+    result = EXIT_FAILURE;
+  }
+  // The decoders rebuild the original matrix, serially or not.
+  struct matrix *decoded = result == EXIT_SUCCESS ? matrix_unserialize_with_options(columns, &options) : NULL;
+  struct matrix *parallel = result == EXIT_SUCCESS ? matrix_unserialize_parallel(columns, &options, 4) : NULL;
+  if (result == EXIT_SUCCESS && (!serializer_test_matrix_equal(object, decoded) || !serializer_test_matrix_equal(object, parallel))) {
+    printf("Column-major text was not decoded.\n");
+    result = EXIT_FAILURE;
+  }
+  // Ragged or oversized columns are rejected.
+  const char *malformed[] = {
+    "[[\"1\",\"2\"],[\"3\"]]",
+    "[[\"1\",\"2\"],[\"3\",\"4\",\"5\"]]",
+    "[[\"1\",\"2\"],[\"3\",\"4\"]",
+    "[[\"1\",\"2\"],\"3\"]",
+  };
+  for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]) && result == EXIT_SUCCESS; i++) {
+    struct matrix *rejected = matrix_unserialize_with_options(malformed[i], &options);
+    if (rejected != NULL) {
+      printf("Malformed column-major text %zu was accepted.\n", i);
+      matrix_destroy(rejected);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Null elements and empty arrays are skipped like in row-major text.
+  struct matrix *small = matrix_unserialize_with_options("[[\"1\",null,\"2\"],[],[\"3\",\"4\"]]", &options);
+  if (result == EXIT_SUCCESS && (small == NULL || small->rows != 2 || small->columns != 2 || *matrix_getl(small, 0, 1) != 3 || *matrix_getl(small, 1, 0) != 2)) {
+    printf("Column-major text with nulls was not decoded.\n");
+    result = EXIT_FAILURE;
+  }
+  options.layout = 7;
+  if (result == EXIT_SUCCESS && (matrix_unserialize_with_options(columns, &options) != NULL || matrix_serialize_with_options(object, &options) != NULL)) {
+    printf("Unknown layout was accepted.\n");
+    result = EXIT_FAILURE;
+  }
+  free(columns);
+  free(expected);
+  free(dense);
+  matrix_destroy(decoded);
+  matrix_destroy(parallel);
+  matrix_destroy(small);
+  matrix_destroy(object);
+  matrix_destroy(transpose);
+  return result;
+}
+
+/**
+ * Tests column-major binary payloads.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_layout_binary_tests() {
+  printf("------------ Matrix Layout Binary Tests. ------------\n");
+  struct matrix *transpose = NULL;
+  struct matrix *object = matrix_layout_test_create(19, 40, &transpose);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.layout = SERIALIZER_LAYOUT_COLUMN_MAJOR;
+  int result = EXIT_SUCCESS;
+  int element_types[2] = {SERIALIZER_ELEMENT_LONG_DOUBLE, SERIALIZER_ELEMENT_FLOAT64};
+  for (int i = 0; i < 2 && result == EXIT_SUCCESS; i++) {
+    options.element_type = element_types[i];
+    size_t length = 0;
+    size_t transpose_length = 0;
+    unsigned char *data = matrix_serialize_binary_with_options(object, &options, &length);
+    options.layout = SERIALIZER_LAYOUT_ROW_MAJOR;
+    unsigned char *rows = matrix_serialize_binary_with_options(transpose, &options, &transpose_length);
+    options.layout = SERIALIZER_LAYOUT_COLUMN_MAJOR;
+    // The element block is the row-major block of the transpose.
+    struct serializer_binary_header header;
+    if (data == NULL || rows == NULL || length != transpose_length || serializer_binary_read_header(data, length, &header) == 1
+        || header.flags != SERIALIZER_BINARY_FLAG_COLUMN_MAJOR || header.rows != 19 || header.columns != 40
+        || memcmp(data + SERIALIZER_BINARY_HEADER_SIZE, rows + SERIALIZER_BINARY_HEADER_SIZE, length - SERIALIZER_BINARY_HEADER_SIZE) != 0) {
+      printf("Column-major payload %d does not match the transpose.\n", i);
+      result = EXIT_FAILURE;
+    }
+    struct matrix *decoded = result == EXIT_SUCCESS ? matrix_unserialize_binary(data, length) : NULL;
+    if (result == EXIT_SUCCESS && !serializer_test_matrix_equal(object, decoded)) {
+      printf("Column-major payload %d was not decoded.\n", i);
+      result = EXIT_FAILURE;
+    }
+    // The sparse form has no column-major variant.
+    if (result == EXIT_SUCCESS && i == 0) {
+      data[9] |= SERIALIZER_BINARY_FLAG_SPARSE;
+      struct matrix *rejected = matrix_unserialize_binary(data, length);
+      data[9] &= ~SERIALIZER_BINARY_FLAG_SPARSE;
+      if (rejected != NULL) {
+        printf("Sparse column-major payload was accepted.\n");
+        matrix_destroy(rejected);
+        result = EXIT_FAILURE;
+      }
+    }
+    free(data);
+    free(rows);
+    matrix_destroy(decoded);
+  }
+  // Vectors have no column-major form.
+  struct vector *vector_object = vector_create(3);
+  size_t length = 0;
+  unsigned char *data = vector_object != NULL ? vector_serialize_binary(vector_object, &length) : NULL;
+  if (data != NULL) {
+    data[9] = SERIALIZER_BINARY_FLAG_COLUMN_MAJOR;
+  }
+  struct vector *rejected = data != NULL ? vector_unserialize_binary(data, length) : NULL;
+  if (result == EXIT_SUCCESS && (data == NULL || rejected != NULL)) {
+    printf("Column-major vector payload was accepted.\n");
+    result = EXIT_FAILURE;
+  }
+  vector_destroy(rejected);
+  vector_destroy(vector_object);
+  free(data);
+  matrix_destroy(object);
+  matrix_destroy(transpose);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_layout_tests() {
+  if (matrix_layout_text_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_layout_binary_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef MATRIX_LAYOUT_TESTS_H
+#define MATRIX_LAYOUT_TESTS_H
+
+/**
+ * Matrix layout tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int matrix_layout_tests();
+
+#endif
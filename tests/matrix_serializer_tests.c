@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/matrixmath_serializer.h"
 #include "matrix_serializer_tests.h"
+#include "serializer_test_helpers.h"
 
 /**
  * Tests the serialization of a matrix.
@@ -66,6 +68,218 @@ static int matrix_unserialize_tests() {
   return EXIT_SUCCESS;
 }
 
+/**
+ * Tests the streaming matrix encoder.
+ *
+ * This function checks that, with the legacy number format, the streaming
+ * encoder, the sink encoder and the JSON tree encoder all produce
+ * byte-for-byte identical output.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_serialize_stream_tests() {
+  printf("------------ Matrix Serialize Stream Tests. ------------\n");
+  // Create a matrix of 3 x 4 elements.
+  struct matrix *matrix_object = matrix_create(3, 4);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 4; k++) {
+      matrix_setl(matrix_object, j, k, (j - 1) * 1234.5678L / (k + 3));
+    }
+  }
+  // Encode through the JSON tree.
+  struct json *jobject = matrix_serialize_to_json(matrix_object);
+  char *tree_string = json_encode(jobject);
+  json_destroy(jobject);
+  // Encode through the streaming encoder with the legacy number format.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.precision = SERIALIZER_PRECISION_LEGACY;
+  char *stream_string = matrix_serialize_with_options(matrix_object, &options);
+  // Encode through a sink.
+  struct serializer_buffer collected;
+  serializer_buffer_init(&collected, 0);
+  int status = matrix_serialize_to_sink(matrix_object, &options, serializer_test_collect, &collected);
+  char *sink_string = serializer_buffer_detach(&collected, NULL);
+  // Compare the outputs.
+  int result = EXIT_SUCCESS;
+  if (status == 1 || tree_string == NULL || stream_string == NULL || sink_string == NULL
+      || strcmp(tree_string, stream_string) != 0 || strcmp(tree_string, sink_string) != 0) {
+    printf("Stream output mismatch.\n");
+    result = EXIT_FAILURE;
+  }
+  else {
+    printf("Streamed Matrix String: %s \n", stream_string);
+  }
+  // Clear the used memory.
+  free(tree_string);
+  free(stream_string);
+  free(sink_string);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests the tree-less matrix decoder.
+ *
+ * This function checks that the scanner decodes the same values as the JSON
+ * tree decoder, accepts whitespace and bare numbers, and rejects malformed or
+ * ragged input.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_unserialize_scanner_tests() {
+  printf("------------ Matrix Un-Serialize Scanner Tests. ------------\n");
+  char *matrix_string = "[[\"1.5\",\"-2.25e3\",\"3\"],[\"0.1\",\"7\",\"-0\"]]";
+  // Decode through the JSON tree.
+  struct json *jobject = json_decode(matrix_string);
+  struct matrix *expected = matrix_unserialize_from_json_object(jobject);
+  json_destroy(jobject);
+  // Decode through the scanner.
+  struct matrix *actual = matrix_unserialize(matrix_string);
+  struct matrix *spaced = matrix_unserialize(" [ [ 1.5 , \"-2.25e3\", 3 ] ,\n [\"0.1\", 7, \"-0\"] ] ");
+  int result = EXIT_SUCCESS;
+  if (expected == NULL || actual == NULL || spaced == NULL || actual->rows != 2 || actual->columns != 3
+      || spaced->rows != 2 || spaced->columns != 3) {
+    result = EXIT_FAILURE;
+  }
+  for (int j = 0; result == EXIT_SUCCESS && j < 2; j++) {
+    for (int k = 0; k < 3; k++) {
+      if (*matrix_getl(expected, j, k) != *matrix_getl(actual, j, k) || *matrix_getl(actual, j, k) != *matrix_getl(spaced, j, k)) {
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  matrix_destroy(expected);
+  matrix_destroy(actual);
+  matrix_destroy(spaced);
+  // Malformed input must be rejected.
+  const char *invalid[] = {"", "[]", "[[]]", "[[\"1\"],[\"2\",\"3\"]]", "[[\"1\",\"x\"]]", "[[\"1\"]", "[[\"1\"]] x"};
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    struct matrix *rejected = matrix_unserialize((char *)invalid[i]);
+    if (rejected != NULL) {
+      printf("Accepted malformed input: %s\n", invalid[i]);
+      matrix_destroy(rejected);
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
+
+/**
+ * Tests decoding into an existing matrix.
+ *
+ * This function decodes a string and a JSON object into a preallocated
+ * matrix and checks that shape mismatches are rejected without writing.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_unserialize_into_tests() {
+  printf("------------ Matrix Un-Serialize Into Tests. ------------\n");
+  struct matrix *destination = matrix_create(2, 3);
+  if (destination == NULL) {
+    return EXIT_FAILURE;
+  }
+  int result = EXIT_SUCCESS;
+  // Decode a string in place.
+  if (matrix_unserialize_into(destination, "[[\"1\",\"2\",\"3\"],[\"4\",\"5\",\"6.5\"]]") == 1
+      || *matrix_getl(destination, 1, 2) != 6.5L || *matrix_getl(destination, 0, 0) != 1.0L) {
+    result = EXIT_FAILURE;
+  }
+  // A shape mismatch must be rejected before anything is written.
+  if (matrix_unserialize_into(destination, "[[\"9\",\"9\"],[\"9\",\"9\"]]") == 0 || *matrix_getl(destination, 0, 0) != 1.0L) {
+    result = EXIT_FAILURE;
+  }
+  // Decode a JSON object in place.
+  struct json *jobject = json_object("weights", json_decode("[[\"-1\",\"-2\",\"-3\"],[\"-4\",\"-5\",\"-6\"]]"));
+  if (matrix_set_from_json_object(destination, "weights", jobject) == 1 || *matrix_getl(destination, 1, 1) != -5.0L) {
+    result = EXIT_FAILURE;
+  }
+  if (matrix_set_from_json_object(destination, "missing", jobject) == 0) {
+    result = EXIT_FAILURE;
+  }
+  // Ragged rows must be rejected before anything is written, whichever row
+  // is the odd one out.
+  const char *ragged[] = {
+    "[[\"9\",\"9\"],[\"9\",\"9\",\"9\"]]",
+    "[[\"9\",\"9\",\"9\",\"9\"],[\"9\",\"9\",\"9\"]]",
+    "[[\"9\",\"9\",\"9\"],[\"9\",\"9\"],[\"9\",\"9\",\"9\"]]",
+  };
+  for (size_t i = 0; i < sizeof(ragged) / sizeof(ragged[0]); i++) {
+    struct json *jragged = json_object("weights", json_decode((char *)ragged[i]));
+    if (matrix_set_from_json_object(destination, "weights", jragged) == 0 || *matrix_getl(destination, 0, 0) != -1.0L) {
+      printf("Accepted ragged input: %s\n", ragged[i]);
+      result = EXIT_FAILURE;
+    }
+    json_destroy(jragged);
+  }
+  // Clear the used memory.
+  json_destroy(jobject);
+  matrix_destroy(destination);
+  return result;
+}
+
+/**
+ * Tests the size bound and serialization into caller memory.
+ *
+ * This function checks, for every precision mode, that the size bound covers
+ * the actual output and that writing into memory of exactly the right size
+ * works while one byte less fails.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_serialize_to_buffer_tests() {
+  printf("------------ Matrix Serialize To Buffer Tests. ------------\n");
+  struct matrix *object = matrix_create(9, 11);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 9; j++) {
+    for (int k = 0; k < 11; k++) {
+      matrix_setl(object, j, k, ((j * 11 + k) % 2 ? -1 : 1) * (j * 11 + k + 1) / 3e-30L);
+    }
+  }
+  int result = EXIT_SUCCESS;
+  struct serializer_options options;
+  const int precisions[] = {SERIALIZER_PRECISION_SHORTEST, SERIALIZER_PRECISION_DOUBLE, SERIALIZER_PRECISION_FIXED, SERIALIZER_PRECISION_LEGACY};
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(precisions) / sizeof(precisions[0]); i++) {
+    serializer_options_init(&options);
+    options.precision = precisions[i];
+    options.digits = 12;
+    char *expected = matrix_serialize_with_options(object, &options);
+    size_t bound = matrix_serialized_size(object, &options);
+    size_t length = expected != NULL ? strlen(expected) : 0;
+    char *data = malloc(bound + 1);
+    if (expected == NULL || data == NULL || bound < length) {
+      printf("Size bound %zu below the actual length %zu.\n", bound, length);
+      result = EXIT_FAILURE;
+    }
+    // The bound always suffices, and so does the exact length.
+    size_t written = 0;
+    if (result == EXIT_SUCCESS && (matrix_serialize_to_buffer(object, &options, data, bound + 1, &written) == 1 || written != length || strcmp(data, expected) != 0)) {
+      result = EXIT_FAILURE;
+    }
+    if (result == EXIT_SUCCESS && (matrix_serialize_to_buffer(object, &options, data, length + 1, &written) == 1 || strcmp(data, expected) != 0)) {
+      result = EXIT_FAILURE;
+    }
+    // One byte less, leaving no room for the terminator, must fail.
+    if (result == EXIT_SUCCESS && matrix_serialize_to_buffer(object, &options, data, length, &written) == 0) {
+      result = EXIT_FAILURE;
+    }
+    free(data);
+    free(expected);
+  }
+  // Clear the used memory.
+  matrix_destroy(object);
+  return result;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -73,8 +287,20 @@ int matrix_serializer_tests() {
   if (matrix_serialize_tests() == EXIT_FAILURE) {
     return EXIT_FAILURE;
   }
+  if (matrix_serialize_stream_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
   if (matrix_unserialize_tests() == EXIT_FAILURE) {
     return EXIT_FAILURE;
   }
+  if (matrix_unserialize_scanner_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_unserialize_into_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_serialize_to_buffer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
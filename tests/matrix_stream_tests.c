@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "matrix_stream_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * Sink that accepts a single write and fails every later one.
+ *
+ * @param const char *data
+ *   The data to write.
+ * @param size_t length
+ *   The number of bytes to write.
+ * @param void *context
+ *   Pointer to the number of writes accepted so far.
+ *
+ * @return int
+ *   Returns 0 for the first write, otherwise 1.
+ */
+static int matrix_stream_test_failing_sink(const char *data, size_t length, void *context) {
+  (void)data;
+  (void)length;
+  return (*(int *)context)++ > 0;
+}
+
+/**
+ * Rows collected by the streaming reader tests.
+ */
+struct matrix_stream_test_rows {
+  // Destination matrix, or NULL to only count the rows.
+  struct matrix *destination;
+  // Index of the next row to fill.
+  int next_row;
+};
+
+/**
+ * Row callback that copies every row into the destination matrix.
+ */
+static int matrix_stream_test_collect(const long double *row, int columns, void *context) {
+  struct matrix_stream_test_rows *rows = context;
+  struct matrix *destination = rows->destination;
+  if (destination != NULL) {
+    if (rows->next_row >= destination->rows || columns != destination->columns) {
+      return 1;
+    }
+    for (int k = 0; k < columns; k++) {
+      matrix_setl(destination, rows->next_row, k, row[k]);
+    }
+  }
+  rows->next_row++;
+  return 0;
+}
+
+/**
+ * Tests that the streaming writer matches the one-shot encoder.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_writer_tests() {
+  printf("------------ Matrix Writer Tests. ------------\n");
+  // Create a matrix of 31 x 7 elements.
+  struct matrix *matrix_object = matrix_create(31, 7);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  long double row[7];
+  struct serializer_buffer output;
+  if (serializer_buffer_init(&output, 0) == 1) {
+    matrix_destroy(matrix_object);
+    return EXIT_FAILURE;
+  }
+  // Push the rows one at a time through a small staging buffer.
+  int result = EXIT_SUCCESS;
+  struct matrix_writer *writer = matrix_writer_begin(serializer_test_collect, &output, NULL);
+  if (writer == NULL) {
+    result = EXIT_FAILURE;
+  }
+  for (int j = 0; result == EXIT_SUCCESS && j < 31; j++) {
+    for (int k = 0; k < 7; k++) {
+      row[k] = (j * 7 + k) / 3.0L - 11;
+      matrix_setl(matrix_object, j, k, row[k]);
+    }
+    if (matrix_writer_push_row(writer, row, 7) == 1) {
+      result = EXIT_FAILURE;
+    }
+  }
+  // A row of the wrong width must be rejected.
+  if (result == EXIT_SUCCESS && matrix_writer_push_row(writer, row, 6) == 0) {
+    result = EXIT_FAILURE;
+  }
+  if (writer != NULL && matrix_writer_end(writer) == 1) {
+    result = EXIT_FAILURE;
+  }
+  char *actual = serializer_buffer_detach(&output, NULL);
+  char *expected = matrix_serialize(matrix_object);
+  if (result == EXIT_SUCCESS && (actual == NULL || expected == NULL || strcmp(actual, expected) != 0)) {
+    printf("Streaming writer output mismatch.\n");
+    result = EXIT_FAILURE;
+  }
+  // Once a row fails partway through, every later push and the end must fail.
+  int writes = 0;
+  struct matrix_writer *failing = result == EXIT_SUCCESS ? matrix_writer_begin(matrix_stream_test_failing_sink, &writes, NULL) : NULL;
+  int failed = 0;
+  for (int j = 0; failing != NULL && j < 100000 && !failed; j++) {
+    failed = matrix_writer_push_row(failing, row, 7);
+  }
+  int recovered = failing == NULL || !failed || matrix_writer_push_row(failing, row, 7) == 0;
+  if (failing != NULL && matrix_writer_end(failing) == 0) {
+    recovered = 1;
+  }
+  if (result == EXIT_SUCCESS && recovered) {
+    printf("Streaming writer recovered from a failed row.\n");
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  free(actual);
+  free(expected);
+  serializer_buffer_release(&output);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests that the streaming reader accepts arbitrarily fragmented input.
+ *
+ * This function feeds a serialized matrix one byte at a time and in uneven
+ * chunks, and checks that malformed input is rejected.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_reader_tests() {
+  printf("------------ Matrix Reader Tests. ------------\n");
+  // Create and serialize a matrix of 23 x 5 elements.
+  struct matrix *matrix_object = matrix_create(23, 5);
+  struct matrix *decoded = matrix_create(23, 5);
+  if (matrix_object == NULL || decoded == NULL) {
+    matrix_destroy(matrix_object);
+    matrix_destroy(decoded);
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 23; j++) {
+    for (int k = 0; k < 5; k++) {
+      matrix_setl(matrix_object, j, k, (j - 2 * k) * 1.25e-3L);
+    }
+  }
+  char *matrix_string = matrix_serialize(matrix_object);
+  int result = matrix_string != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+  size_t length = result == EXIT_SUCCESS ? strlen(matrix_string) : 0;
+  const size_t chunk_sizes[] = {1, 3, 17, 4096};
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+    struct matrix_stream_test_rows rows = {decoded, 0};
+    struct matrix_reader *reader = matrix_reader_create(matrix_stream_test_collect, &rows);
+    if (reader == NULL) {
+      result = EXIT_FAILURE;
+      break;
+    }
+    for (size_t offset = 0; result == EXIT_SUCCESS && offset < length; offset += chunk_sizes[i]) {
+      size_t chunk = length - offset < chunk_sizes[i] ? length - offset : chunk_sizes[i];
+      if (matrix_reader_feed(reader, matrix_string + offset, chunk) == 1) {
+        result = EXIT_FAILURE;
+      }
+    }
+    if (result == EXIT_SUCCESS && (matrix_reader_finish(reader) == 1 || rows.next_row != 23 || reader->columns != 5)) {
+      result = EXIT_FAILURE;
+    }
+    matrix_reader_destroy(reader);
+    for (int j = 0; result == EXIT_SUCCESS && j < 23; j++) {
+      for (int k = 0; k < 5; k++) {
+        if (*matrix_getl(decoded, j, k) != *matrix_getl(matrix_object, j, k)) {
+          printf("Streaming reader value mismatch with chunks of %zu bytes.\n", chunk_sizes[i]);
+          result = EXIT_FAILURE;
+          break;
+        }
+      }
+    }
+  }
+  // Bare numbers, nulls and empty rows are accepted, ragged rows are not.
+  const char *inputs[] = {"[[1, 2.5e1], [], [null, -3, 4]]", "[[1,2],[3]]", "[[1,2]", "[[1,2]]x", "[[\"\"]]"};
+  const int expected[] = {0, 1, 1, 1, 1};
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    struct matrix_stream_test_rows rows = {NULL, 0};
+    struct matrix_reader *reader = matrix_reader_create(matrix_stream_test_collect, &rows);
+    int status = reader == NULL || matrix_reader_feed(reader, inputs[i], strlen(inputs[i])) == 1 || matrix_reader_finish(reader) == 1;
+    if (status != expected[i]) {
+      printf("Streaming reader misjudged input %s.\n", inputs[i]);
+      result = EXIT_FAILURE;
+    }
+    matrix_reader_destroy(reader);
+  }
+  // Tokens longer than any formatted number are read like matrix_unserialize()
+  // reads them, even when split across fragments.
+  char long_input[256];
+  char digits[81];
+  memset(digits, '1', 80);
+  digits[0] = '0';
+  digits[1] = '.';
+  digits[80] = '\0';
+  snprintf(long_input, sizeof(long_input), "[[\"%s\",%se-3]]", digits, digits);
+  struct matrix *expected_long = matrix_unserialize(long_input);
+  struct matrix *actual_long = matrix_create(1, 2);
+  struct matrix_stream_test_rows long_rows = {actual_long, 0};
+  struct matrix_reader *long_reader = actual_long != NULL ? matrix_reader_create(matrix_stream_test_collect, &long_rows) : NULL;
+  int long_status = long_reader == NULL || expected_long == NULL;
+  for (size_t offset = 0; !long_status && offset < strlen(long_input); offset += 7) {
+    size_t chunk = strlen(long_input) - offset < 7 ? strlen(long_input) - offset : 7;
+    long_status = matrix_reader_feed(long_reader, long_input + offset, chunk);
+  }
+  if (result == EXIT_SUCCESS && (long_status || matrix_reader_finish(long_reader) == 1 || long_rows.next_row != 1
+      || *matrix_getl(actual_long, 0, 0) != *matrix_getl(expected_long, 0, 0) || *matrix_getl(actual_long, 0, 1) != *matrix_getl(expected_long, 0, 1))) {
+    printf("Streaming reader misread an 80 character token.\n");
+    result = EXIT_FAILURE;
+  }
+  matrix_reader_destroy(long_reader);
+  matrix_destroy(actual_long);
+  matrix_destroy(expected_long);
+  // Clear the used memory.
+  free(matrix_string);
+  matrix_destroy(matrix_object);
+  matrix_destroy(decoded);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int matrix_stream_tests() {
+  if (matrix_writer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_reader_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
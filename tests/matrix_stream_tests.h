@@ -0,0 +1,12 @@
+#ifndef MATRIX_STREAM_TESTS_H
+#define MATRIX_STREAM_TESTS_H
+
+/**
+ * Matrix stream tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int matrix_stream_tests();
+
+#endif
@@ -0,0 +1,199 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "number_formatter_tests.h"
+
+/**
+ * Tests the shortest round-trip formatters on known values.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int number_formatter_shortest_tests() {
+  printf("------------ Number Formatter Shortest Tests. ------------\n");
+  char buffer[SERIALIZER_NUMBER_MAX_LENGTH];
+  // Known long double values.
+  const long double values[] = {0.1L, -2.5L, 1234567.0L, 1e-300L, 0.0L, -0.0L};
+  const char *expected[] = {"0.1", "-2.5", "1234567", "1e-300", "0", "-0"};
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    serializer_format_long_double(values[i], buffer);
+    if (strcmp(buffer, expected[i]) != 0) {
+      printf("Formatted %s, expected %s.\n", buffer, expected[i]);
+      return EXIT_FAILURE;
+    }
+  }
+  // Known double values, including the subnormal and normal extremes and a
+  // power of two whose narrower lower bound allows one digit less than printf.
+  const double doubles[] = {320.2519111111193, 5e-324, 1.7976931348623157e308, 2.2250738585072014e-308, 1e23, 0.3, 1.5e-5, ldexp(1.0, -1017)};
+  const char *expected_doubles[] = {"320.2519111111193", "5e-324", "1.7976931348623157e+308", "2.2250738585072014e-308", "1e+23", "0.3", "1.5e-05", "7.120236347223045e-307"};
+  for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+    serializer_format_double(doubles[i], buffer);
+    if (strcmp(buffer, expected_doubles[i]) != 0) {
+      printf("Formatted %s, expected %s.\n", buffer, expected_doubles[i]);
+      return EXIT_FAILURE;
+    }
+  }
+  // Float values go through the same digit generation.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.element_type = SERIALIZER_ELEMENT_FLOAT32;
+  const float floats[] = {0.1f, 3.4028235e38f, 1e-45f, 16777217.0f * 64};
+  const char *expected_floats[] = {"0.1", "3.4028235e+38", "1e-45", "1.0737418e+09"};
+  for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++) {
+    serializer_format_number(floats[i], &options, buffer);
+    if (strcmp(buffer, expected_floats[i]) != 0) {
+      printf("Formatted %s, expected %s.\n", buffer, expected_floats[i]);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Tests that the shortest formatters round trip bit-exactly on random values.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int number_formatter_round_trip_tests() {
+  printf("------------ Number Formatter Round Trip Tests. ------------\n");
+  char buffer[SERIALIZER_NUMBER_MAX_LENGTH];
+  srand(42);
+  for (int i = 0; i < 20000; i++) {
+    // Build values across a wide range of magnitudes.
+    long double mantissa = (long double)rand() / RAND_MAX + (long double)rand() / RAND_MAX / RAND_MAX;
+    long double value = ldexpl(mantissa, rand() % 2000 - 1000) * (i % 2 ? -1 : 1);
+    serializer_format_long_double(value, buffer);
+    if (strtold(buffer, NULL) != value) {
+      printf("Long double round trip failed for %s.\n", buffer);
+      return EXIT_FAILURE;
+    }
+    double dvalue = (double)value;
+    serializer_format_double(dvalue, buffer);
+    if (strtod(buffer, NULL) != dvalue) {
+      printf("Double round trip failed for %s.\n", buffer);
+      return EXIT_FAILURE;
+    }
+    // Random bit patterns reach the subnormals and every exponent.
+    uint64_t bits = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+    memcpy(&dvalue, &bits, sizeof(double));
+    if (isfinite(dvalue)) {
+      serializer_format_double(dvalue, buffer);
+      if (strtod(buffer, NULL) != dvalue) {
+        printf("Double round trip failed for %s.\n", buffer);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Tests the precision modes of the options-driven formatter.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int number_formatter_precision_tests() {
+  printf("------------ Number Formatter Precision Tests. ------------\n");
+  char buffer[SERIALIZER_NUMBER_MAX_LENGTH];
+  struct serializer_options options;
+  serializer_options_init(&options);
+  // Fixed number of significant digits.
+  options.precision = SERIALIZER_PRECISION_FIXED;
+  options.digits = 3;
+  serializer_format_number(3.14159L, &options, buffer);
+  if (strcmp(buffer, "3.14") != 0) {
+    return EXIT_FAILURE;
+  }
+  options.digits = 0;
+  if (serializer_format_number(3.14159L, &options, buffer) != -1) {
+    return EXIT_FAILURE;
+  }
+  // Double precision.
+  options.precision = SERIALIZER_PRECISION_DOUBLE;
+  serializer_format_number(0.1L, &options, buffer);
+  if (strcmp(buffer, "0.10000000000000001") != 0) {
+    return EXIT_FAILURE;
+  }
+  // Legacy output matches the JSON library formatter.
+  options.precision = SERIALIZER_PRECISION_LEGACY;
+  struct json *jvalue = json_number_string(83.5793259741265L);
+  serializer_format_number(83.5793259741265L, &options, buffer);
+  int result = strcmp(buffer, (const char *)jvalue->value) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  json_destroy(jvalue);
+  return result;
+}
+
+/**
+ * Tests that the encoders write the legacy text at its real length.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int number_formatter_legacy_tests() {
+  printf("------------ Number Formatter Legacy Tests. ------------\n");
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.precision = SERIALIZER_PRECISION_LEGACY;
+  // The buffer writer quotes the library text without the fixed buffer, so it
+  // starts with no room at all.
+  const long double values[] = {83.5793259741265L, -1e-300L, 123456789012345.0L};
+  struct serializer_buffer buffer;
+  if (serializer_buffer_init(&buffer, 1) == 1) {
+    return EXIT_FAILURE;
+  }
+  int result = EXIT_SUCCESS;
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(values) / sizeof(values[0]); i++) {
+    struct json *jvalue = json_number_string(values[i]);
+    serializer_buffer_clear(&buffer);
+    if (jvalue == NULL || serializer_buffer_write_number(&buffer, values[i], &options) == 1) {
+      result = EXIT_FAILURE;
+    }
+    else {
+      size_t length = strlen((const char *)jvalue->value);
+      if (buffer.length != length + 2 || buffer.data[0] != '"' || buffer.data[length + 1] != '"' || memcmp(buffer.data + 1, jvalue->value, length) != 0) {
+        result = EXIT_FAILURE;
+      }
+    }
+    json_destroy(jvalue);
+  }
+  serializer_buffer_release(&buffer);
+  // The legacy size is the exact length of the text.
+  struct vector *object = vector_create(3);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < 3; i++) {
+    vector_setl(object, i, values[i]);
+  }
+  char *data = vector_serialize_with_options(object, &options);
+  if (result == EXIT_SUCCESS && (data == NULL || vector_serialized_size(object, &options) != strlen(data))) {
+    result = EXIT_FAILURE;
+  }
+  free(data);
+  vector_destroy(object);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int number_formatter_tests() {
+  if (number_formatter_shortest_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (number_formatter_round_trip_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (number_formatter_precision_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (number_formatter_legacy_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
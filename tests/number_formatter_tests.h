@@ -0,0 +1,12 @@
+#ifndef NUMBER_FORMATTER_TESTS_H
+#define NUMBER_FORMATTER_TESTS_H
+
+/**
+ * Number formatter tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int number_formatter_tests();
+
+#endif
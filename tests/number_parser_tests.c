@@ -0,0 +1,107 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strutils.h>
+#include "../include/matrixmath_serializer.h"
+#include "number_parser_tests.h"
+
+/**
+ * Checks that the fast parser agrees with stold() on the given text.
+ *
+ * @param const char *text
+ *   The number text.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS if both parsers agree, otherwise EXIT_FAILURE.
+ */
+static int number_parser_check(const char *text) {
+  long double value = 0;
+  long double expected = stold((char *)text);
+  if (serializer_parse_number(text, strlen(text), &value) == 1) {
+    printf("Rejected valid number %s.\n", text);
+    return EXIT_FAILURE;
+  }
+  if (!(value == expected || (isnan(value) && isnan(expected))) || signbit(value) != signbit(expected)) {
+    printf("Parsed %s as %.21Lg, stold gives %.21Lg.\n", text, value, expected);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Tests the fast parser on hand-picked numbers, including the slow path forms.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int number_parser_known_tests() {
+  printf("------------ Number Parser Known Values Tests. ------------\n");
+  const char *valid[] = {
+    "0", "-0", "0.0000000000045", "320.2519111111193", "1e27", "1e-27", "1e28", "-1.5E+3",
+    "12345678901234567890123", "0.1", "9007199254740993", "1234567890123456789", "00012.50",
+    "4.4999999999999998085e-12", "inf", "-nan", "0x1p-3", "1e-5000", "1e5000"
+  };
+  for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+    if (number_parser_check(valid[i]) == EXIT_FAILURE) {
+      return EXIT_FAILURE;
+    }
+  }
+  const char *invalid[] = {"", "-", "1e", "1.5x", "--1", "."};
+  long double value;
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    if (serializer_parse_number(invalid[i], strlen(invalid[i]), &value) == 0) {
+      printf("Accepted invalid number %s.\n", invalid[i]);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Tests the fast parser against stold() on a fuzzed corpus.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int number_parser_fuzz_tests() {
+  printf("------------ Number Parser Fuzz Tests. ------------\n");
+  char text[64];
+  srand(7);
+  for (int i = 0; i < 100000; i++) {
+    // Random sign, digit count, decimal point position and exponent.
+    int length = 0;
+    if (rand() % 2) {
+      text[length++] = '-';
+    }
+    int digits = 1 + rand() % 24;
+    int point = rand() % (digits + 1);
+    for (int d = 0; d < digits; d++) {
+      if (d == point && d > 0) {
+        text[length++] = '.';
+      }
+      text[length++] = (char)('0' + rand() % 10);
+    }
+    if (rand() % 3 == 0) {
+      length += snprintf(text + length, sizeof(text) - length, "e%d", rand() % 80 - 40);
+    }
+    text[length] = '\0';
+    if (number_parser_check(text) == EXIT_FAILURE) {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int number_parser_tests() {
+  if (number_parser_known_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (number_parser_fuzz_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef NUMBER_PARSER_TESTS_H
+#define NUMBER_PARSER_TESTS_H
+
+/**
+ * Number parser tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int number_parser_tests();
+
+#endif
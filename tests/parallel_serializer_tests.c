@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "parallel_serializer_tests.h"
+
+/**
+ * Tests that the parallel encoder matches the serial encoder.
+ *
+ * This function encodes the same matrix with several thread counts and
+ * compares every output with the serial encoder output.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_serialize_parallel_tests() {
+  printf("------------ Matrix Serialize Parallel Tests. ------------\n");
+  // Create a matrix of 203 x 17 elements.
+  struct matrix *matrix_object = matrix_create(203, 17);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 203; j++) {
+    for (int k = 0; k < 17; k++) {
+      matrix_setl(matrix_object, j, k, (j * 17 + k) / 7.0L - 100);
+    }
+  }
+  // Force the parallel path even for this small matrix.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.parallel_threshold = 0;
+  char *expected = matrix_serialize_with_options(matrix_object, &options);
+  int result = expected != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+  const int thread_counts[] = {1, 2, 3, 8, 500};
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+    char *actual = matrix_serialize_parallel(matrix_object, &options, thread_counts[i]);
+    if (actual == NULL || strcmp(actual, expected) != 0) {
+      printf("Parallel output mismatch with %d threads.\n", thread_counts[i]);
+      result = EXIT_FAILURE;
+    }
+    free(actual);
+  }
+  // Clear the used memory.
+  free(expected);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests that the parallel decoder matches the serial decoder.
+ *
+ * This function decodes the same string with several thread counts, compares
+ * the results with the serial decoder and checks that invalid input fails the
+ * same way.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int matrix_unserialize_parallel_tests() {
+  printf("------------ Matrix Un-Serialize Parallel Tests. ------------\n");
+  // Create and serialize a matrix of 97 x 13 elements.
+  struct matrix *matrix_object = matrix_create(97, 13);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 97; j++) {
+    for (int k = 0; k < 13; k++) {
+      matrix_setl(matrix_object, j, k, (j - k) * 0.37L);
+    }
+  }
+  char *matrix_string = matrix_serialize(matrix_object);
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.parallel_threshold = 0;
+  int result = matrix_string != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+  const int thread_counts[] = {1, 2, 5, 200};
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+    struct matrix *decoded = matrix_unserialize_parallel(matrix_string, &options, thread_counts[i]);
+    if (decoded == NULL || decoded->rows != 97 || decoded->columns != 13) {
+      result = EXIT_FAILURE;
+    }
+    for (int j = 0; result == EXIT_SUCCESS && j < 97; j++) {
+      for (int k = 0; k < 13; k++) {
+        if (*matrix_getl(decoded, j, k) != *matrix_getl(matrix_object, j, k)) {
+          result = EXIT_FAILURE;
+        }
+      }
+    }
+    matrix_destroy(decoded);
+  }
+  // Corrupt a value near the end, both decoders must fail.
+  if (result == EXIT_SUCCESS) {
+    char *corrupted = strrchr(matrix_string, '"') - 1;
+    *corrupted = 'x';
+    struct matrix *serial = matrix_unserialize(matrix_string);
+    struct matrix *parallel = matrix_unserialize_parallel(matrix_string, &options, 4);
+    if (serial != NULL || parallel != NULL) {
+      matrix_destroy(serial);
+      matrix_destroy(parallel);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Clear the used memory.
+  free(matrix_string);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int parallel_serializer_tests() {
+  if (matrix_serialize_parallel_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (matrix_unserialize_parallel_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef PARALLEL_SERIALIZER_TESTS_H
+#define PARALLEL_SERIALIZER_TESTS_H
+
+/**
+ * Parallel serializer tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int parallel_serializer_tests();
+
+#endif
@@ -0,0 +1,157 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_arena_tests.h"
+
+/**
+ * Counts the blocks held by an arena.
+ */
+static int serializer_arena_test_blocks(const struct serializer_arena *arena) {
+  int blocks = 0;
+  for (const struct serializer_arena_block *block = arena->first; block != NULL; block = block->next) {
+    blocks++;
+  }
+  return blocks;
+}
+
+/**
+ * Tests the arena allocation, growth and reset behavior.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_arena_allocation_tests() {
+  printf("------------ Serializer Arena Allocation Tests. ------------\n");
+  struct serializer_arena *arena = serializer_arena_create(256);
+  if (arena == NULL) {
+    return EXIT_FAILURE;
+  }
+  int result = EXIT_SUCCESS;
+  // Every allocation is aligned for any type.
+  char *small = serializer_arena_alloc(arena, 3);
+  long double *aligned = serializer_arena_alloc(arena, sizeof(long double));
+  if (small == NULL || aligned == NULL || (uintptr_t)aligned % _Alignof(max_align_t) != 0) {
+    result = EXIT_FAILURE;
+  }
+  // The most recent allocation grows in place while its block has room.
+  char *grown = serializer_arena_alloc(arena, 16);
+  memcpy(grown, "arena", 6);
+  if (result == EXIT_SUCCESS && serializer_arena_realloc(arena, grown, 16, 64) != grown) {
+    result = EXIT_FAILURE;
+  }
+  // Larger requests move to a new block and keep their contents.
+  char *moved = serializer_arena_realloc(arena, grown, 64, 4096);
+  if (result == EXIT_SUCCESS && (moved == NULL || strcmp(moved, "arena") != 0 || serializer_arena_test_blocks(arena) != 2)) {
+    result = EXIT_FAILURE;
+  }
+  // A reset hands out the same memory again without new blocks.
+  serializer_arena_reset(arena);
+  if (result == EXIT_SUCCESS && (serializer_arena_alloc(arena, 3) != small || serializer_arena_alloc(arena, 4096) != moved || serializer_arena_test_blocks(arena) != 2)) {
+    result = EXIT_FAILURE;
+  }
+  serializer_arena_destroy(arena);
+  return result;
+}
+
+/**
+ * Tests serialization round trips through an arena.
+ *
+ * This function serializes and unserializes the same objects repeatedly,
+ * resetting the arena in between, and checks that the output matches the heap
+ * based functions and that the arena stops growing after the first round.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_arena_round_trip_tests() {
+  printf("------------ Serializer Arena Round Trip Tests. ------------\n");
+  struct matrix *matrix_object = matrix_create(40, 9);
+  struct vector *vector_object = vector_create(77);
+  struct serializer_arena *arena = serializer_arena_create(1024);
+  if (matrix_object == NULL || vector_object == NULL || arena == NULL) {
+    matrix_destroy(matrix_object);
+    vector_destroy(vector_object);
+    serializer_arena_destroy(arena);
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 40; j++) {
+    for (int k = 0; k < 9; k++) {
+      matrix_setl(matrix_object, j, k, (j * 9 - k) / 13.0L);
+    }
+  }
+  for (int i = 0; i < 77; i++) {
+    vector_setl(vector_object, i, i * -0.125L + 3);
+  }
+  char *expected_matrix = matrix_serialize(matrix_object);
+  char *expected_vector = vector_serialize(vector_object);
+  int result = expected_matrix != NULL && expected_vector != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+  int blocks = 0;
+  char *first_string = NULL;
+  for (int round = 0; result == EXIT_SUCCESS && round < 3; round++) {
+    serializer_arena_reset(arena);
+    size_t length = 0;
+    char *matrix_string = matrix_serialize_arena(matrix_object, NULL, arena, &length);
+    char *vector_string = vector_serialize_arena(vector_object, NULL, arena, NULL);
+    if (matrix_string == NULL || vector_string == NULL || length != strlen(expected_matrix)
+      || strcmp(matrix_string, expected_matrix) != 0 || strcmp(vector_string, expected_vector) != 0) {
+      printf("Arena output mismatch.\n");
+      result = EXIT_FAILURE;
+      break;
+    }
+    // Decode back into arena memory.
+    int capacity = 0;
+    struct matrix_view *view = matrix_unserialize_arena(matrix_string, arena);
+    long double *values = vector_unserialize_arena(vector_string, arena, &capacity);
+    if (view == NULL || view->rows != 40 || view->columns != 9 || values == NULL || capacity != 77) {
+      result = EXIT_FAILURE;
+      break;
+    }
+    for (int j = 0; j < 40; j++) {
+      for (int k = 0; k < 9; k++) {
+        if (*matrix_view_getl(view, j, k) != *matrix_getl(matrix_object, j, k)) {
+          result = EXIT_FAILURE;
+        }
+      }
+    }
+    for (int i = 0; i < 77; i++) {
+      if (values[i] != *vector_getl(vector_object, i)) {
+        result = EXIT_FAILURE;
+      }
+    }
+    // After the first round the arena reuses its memory.
+    if (round == 0) {
+      blocks = serializer_arena_test_blocks(arena);
+      first_string = matrix_string;
+    }
+    else if (serializer_arena_test_blocks(arena) != blocks || matrix_string != first_string) {
+      printf("Arena grew in steady state.\n");
+      result = EXIT_FAILURE;
+    }
+  }
+  // Malformed input fails without touching the heap.
+  if (result == EXIT_SUCCESS && (matrix_unserialize_arena("[[\"1\"],[\"2\",\"3\"]]", arena) != NULL || matrix_unserialize_arena("[[\"1\"]", arena) != NULL)) {
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  free(expected_matrix);
+  free(expected_vector);
+  matrix_destroy(matrix_object);
+  vector_destroy(vector_object);
+  serializer_arena_destroy(arena);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_arena_tests() {
+  if (serializer_arena_allocation_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (serializer_arena_round_trip_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
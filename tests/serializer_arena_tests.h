@@ -0,0 +1,12 @@
+#ifndef SERIALIZER_ARENA_TESTS_H
+#define SERIALIZER_ARENA_TESTS_H
+
+/**
+ * Serializer arena tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int serializer_arena_tests();
+
+#endif
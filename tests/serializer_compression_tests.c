@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_compression_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * Compresses and decompresses bytes, checking they come back unchanged.
+ *
+ * @param const unsigned char *input
+ *   The bytes to compress.
+ * @param size_t length
+ *   The number of bytes.
+ * @param int filter
+ *   The serializer_compression_filter values.
+ * @param size_t *compressed
+ *   Pointer receiving the frame length.
+ *
+ * @return int
+ *   Returns 1 if the round trip succeeded, otherwise 0.
+ */
+static int serializer_compression_test_round_trip(const unsigned char *input, size_t length, int filter, size_t *compressed) {
+  struct serializer_buffer frame;
+  struct serializer_buffer plain;
+  if (serializer_buffer_init(&frame, 0) == 1 || serializer_buffer_init(&plain, 0) == 1) {
+    return 0;
+  }
+  struct serializer_compressor *compressor = serializer_compressor_create(serializer_test_collect, &frame, filter, 16);
+  int ok = compressor != NULL;
+  // Feed the input in uneven pieces, blocks must not depend on them.
+  for (size_t i = 0; ok && i < length; i += 1000) {
+    size_t take = length - i < 1000 ? length - i : 1000;
+    ok = serializer_compressor_write((const char *)input + i, take, compressor) == 0;
+  }
+  if (compressor != NULL) {
+    ok = serializer_compressor_finish(compressor) == 0 && ok;
+  }
+  ok = ok && serializer_decompress((const unsigned char *)frame.data, frame.length, serializer_test_collect, &plain) == 0;
+  ok = ok && plain.length == length && memcmp(plain.data, input, length) == 0;
+  *compressed = frame.length;
+  serializer_buffer_release(&frame);
+  serializer_buffer_release(&plain);
+  return ok;
+}
+
+/**
+ * Tests byte round trips across block boundaries and through the raw path.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_compression_bytes_tests() {
+  printf("------------ Serializer Compression Bytes Tests. ------------\n");
+  size_t length = 3 * SERIALIZER_COMPRESSION_BLOCK_SIZE + 123;
+  unsigned char *input = malloc(length);
+  if (input == NULL) {
+    return EXIT_FAILURE;
+  }
+  int result = EXIT_SUCCESS;
+  size_t compressed = 0;
+  for (size_t i = 0; i < length; i++) {
+    input[i] = "[\"1.5\",\"-2.25\",\"0\"],"[i % 21];
+  }
+  // An empty frame.
+  if (!serializer_compression_test_round_trip(input, 0, SERIALIZER_FILTER_NONE, &compressed)) {
+    printf("Empty frame round trip failed.\n");
+    result = EXIT_FAILURE;
+  }
+  // Repetitive text spanning several blocks shrinks a lot.
+  if (result == EXIT_SUCCESS && (!serializer_compression_test_round_trip(input, length, SERIALIZER_FILTER_NONE, &compressed) || compressed * 10 > length)) {
+    printf("Repetitive round trip failed or did not shrink: %zu bytes.\n", compressed);
+    result = EXIT_FAILURE;
+  }
+  // Noise does not compress, blocks are stored as they are.
+  uint32_t state = 12345;
+  for (size_t i = 0; i < length; i++) {
+    state = state * 1103515245U + 12345U;
+    input[i] = (unsigned char)(state >> 24);
+  }
+  if (result == EXIT_SUCCESS && (!serializer_compression_test_round_trip(input, length, SERIALIZER_FILTER_NONE, &compressed) || compressed > length + 128)) {
+    printf("Incompressible round trip failed: %zu bytes.\n", compressed);
+    result = EXIT_FAILURE;
+  }
+  // The filters are reverted, including a trailing partial element.
+  int filters = SERIALIZER_FILTER_DELTA | SERIALIZER_FILTER_SHUFFLE;
+  if (result == EXIT_SUCCESS && !serializer_compression_test_round_trip(input, length, filters, &compressed)) {
+    printf("Filtered round trip failed.\n");
+    result = EXIT_FAILURE;
+  }
+  free(input);
+  return result;
+}
+
+/**
+ * Tests matrix round trips through compressed strings and binary payloads.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_compression_matrix_tests() {
+  printf("------------ Serializer Compression Matrix Tests. ------------\n");
+  struct matrix *object = matrix_create(120, 90);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 120; j++) {
+    for (int k = 0; k < 90; k++) {
+      matrix_setl(object, j, k, 20.0L + (j % 7) * 0.5L + k / 64.0L);
+    }
+  }
+  int result = EXIT_SUCCESS;
+  size_t text_length = 0;
+  size_t binary_length = 0;
+  size_t plain_length = 0;
+  char *plain = matrix_serialize(object);
+  unsigned char *text = matrix_serialize_compressed(object, NULL, &text_length);
+  unsigned char *binary = matrix_serialize_binary_compressed(object, &binary_length);
+  if (plain == NULL || text == NULL || binary == NULL || text_length * 4 > strlen(plain)) {
+    printf("Compressed string is missing or too large.\n");
+    result = EXIT_FAILURE;
+  }
+  free(matrix_serialize_binary(object, &plain_length));
+  if (result == EXIT_SUCCESS && binary_length * 4 > plain_length) {
+    printf("Compressed binary payload is too large: %zu of %zu bytes.\n", binary_length, plain_length);
+    result = EXIT_FAILURE;
+  }
+  struct matrix *copies[2] = {NULL, NULL};
+  if (result == EXIT_SUCCESS) {
+    copies[0] = matrix_unserialize_compressed(text, text_length);
+    copies[1] = matrix_unserialize_compressed(binary, binary_length);
+  }
+  for (int i = 0; i < 2 && result == EXIT_SUCCESS; i++) {
+    if (copies[i] == NULL || !serializer_test_matrix_equal(object, copies[i])) {
+      printf("Compressed frame %d was not decoded.\n", i);
+      result = EXIT_FAILURE;
+    }
+  }
+  // The sparse option is ignored, compressed strings are always dense.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = SERIALIZER_SPARSE_ALWAYS;
+  size_t dense_length = 0;
+  unsigned char *dense = matrix_serialize_compressed(object, &options, &dense_length);
+  if (result == EXIT_SUCCESS && (dense == NULL || dense_length != text_length || memcmp(dense, text, text_length) != 0)) {
+    printf("Sparse option changed the compressed string.\n");
+    result = EXIT_FAILURE;
+  }
+  free(plain);
+  free(text);
+  free(binary);
+  free(dense);
+  matrix_destroy(copies[0]);
+  matrix_destroy(copies[1]);
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * Tests that damaged frames are rejected.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_compression_malformed_tests() {
+  printf("------------ Serializer Compression Malformed Tests. ------------\n");
+  struct matrix *object = serializer_test_matrix(30, 30, 0);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  size_t lengths[2] = {0, 0};
+  unsigned char *frames[2] = {
+    matrix_serialize_compressed(object, NULL, &lengths[0]),
+    matrix_serialize_binary_compressed(object, &lengths[1]),
+  };
+  int result = frames[0] != NULL && frames[1] != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+  for (int i = 0; i < 2 && result == EXIT_SUCCESS; i++) {
+    unsigned char *frame = frames[i];
+    size_t length = lengths[i];
+    // Every truncation is rejected.
+    for (size_t cut = 0; cut < length && result == EXIT_SUCCESS; cut++) {
+      struct matrix *decoded = matrix_unserialize_compressed(frame, cut);
+      if (decoded != NULL) {
+        printf("Frame %d truncated to %zu bytes was accepted.\n", i, cut);
+        matrix_destroy(decoded);
+        result = EXIT_FAILURE;
+      }
+    }
+    // A flipped byte past the header never yields a different matrix. Some
+    // flips are harmless, such as a match offset moved to identical bytes.
+    for (size_t at = SERIALIZER_COMPRESSED_HEADER_SIZE; at < length && result == EXIT_SUCCESS; at++) {
+      frame[at] ^= 0x5A;
+      struct matrix *decoded = matrix_unserialize_compressed(frame, length);
+      frame[at] ^= 0x5A;
+      if (decoded != NULL && !serializer_test_matrix_equal(object, decoded)) {
+        printf("Frame %d corrupted at byte %zu was accepted.\n", i, at);
+        result = EXIT_FAILURE;
+      }
+      matrix_destroy(decoded);
+    }
+  }
+  // A frame recording a different shape than its contents.
+  if (result == EXIT_SUCCESS) {
+    frames[0][16] = 29;
+    frames[1][20] = 29;
+    for (int i = 0; i < 2; i++) {
+      struct matrix *decoded = matrix_unserialize_compressed(frames[i], lengths[i]);
+      if (decoded != NULL) {
+        printf("Frame %d with a wrong shape was accepted.\n", i);
+        matrix_destroy(decoded);
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  // A small frame claiming a shape its blocks can not expand to is rejected
+  // before the matrix is allocated.
+  for (int i = 0; i < 2 && result == EXIT_SUCCESS; i++) {
+    memcpy(frames[i] + 16, "\xff\xff\x00\x00\xff\xff\x00\x00", 8);
+    struct matrix *decoded = matrix_unserialize_compressed(frames[i], lengths[i]);
+    if (decoded != NULL) {
+      printf("Frame %d with an oversized shape was accepted.\n", i);
+      matrix_destroy(decoded);
+      result = EXIT_FAILURE;
+    }
+  }
+  free(frames[0]);
+  free(frames[1]);
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_compression_tests() {
+  if (serializer_compression_bytes_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (serializer_compression_matrix_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (serializer_compression_malformed_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
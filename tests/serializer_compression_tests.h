@@ -0,0 +1,12 @@
+#ifndef SERIALIZER_COMPRESSION_TESTS_H
+#define SERIALIZER_COMPRESSION_TESTS_H
+
+/**
+ * Serializer compression tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int serializer_compression_tests();
+
+#endif
@@ -0,0 +1,116 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_context_tests.h"
+
+/**
+ * Tests that a context reuses its output buffer across calls.
+ *
+ * This function sizes a context for a matrix of worst-case values, then
+ * serializes it repeatedly and checks that the output matches the one-shot
+ * encoder and that the retained buffer never moves or grows.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_context_serialize_tests() {
+  printf("------------ Serializer Context Serialize Tests. ------------\n");
+  // Values with the most significant digits and the longest exponents.
+  struct matrix *matrix_object = matrix_create(48, 48);
+  struct matrixmath_serializer_ctx *ctx = matrixmath_serializer_ctx_create(NULL);
+  if (matrix_object == NULL || ctx == NULL) {
+    matrix_destroy(matrix_object);
+    matrixmath_serializer_ctx_destroy(ctx);
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 48; j++) {
+    for (int k = 0; k < 48; k++) {
+      long double scale = (j + k) % 2 == 0 ? LDBL_TRUE_MIN * 3 : -LDBL_MAX / 3;
+      matrix_setl(matrix_object, j, k, scale * (1 + (j * 48 + k) / 7919.0L));
+    }
+  }
+  int result = matrixmath_serializer_ctx_reserve(ctx, 48, 48) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  char *expected = matrix_serialize(matrix_object);
+  const char *retained = ctx->buffer.data;
+  size_t capacity = ctx->buffer.capacity;
+  for (int round = 0; result == EXIT_SUCCESS && round < 3; round++) {
+    size_t length = 0;
+    const char *actual = matrix_serialize_ctx(ctx, matrix_object, &length);
+    if (actual == NULL || expected == NULL || strcmp(actual, expected) != 0 || length != strlen(expected)) {
+      printf("Context output mismatch.\n");
+      result = EXIT_FAILURE;
+    }
+    else if (actual != retained || ctx->buffer.capacity != capacity) {
+      printf("Context buffer was reallocated.\n");
+      result = EXIT_FAILURE;
+    }
+  }
+  // Clear the used memory.
+  free(expected);
+  matrix_destroy(matrix_object);
+  matrixmath_serializer_ctx_destroy(ctx);
+  return result;
+}
+
+/**
+ * Tests decoding through a context.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_context_unserialize_tests() {
+  printf("------------ Serializer Context Un-Serialize Tests. ------------\n");
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.precision = SERIALIZER_PRECISION_DOUBLE;
+  struct matrixmath_serializer_ctx *ctx = matrixmath_serializer_ctx_create(&options);
+  struct vector *vector_object = vector_create(10);
+  if (ctx == NULL || vector_object == NULL) {
+    matrixmath_serializer_ctx_destroy(ctx);
+    vector_destroy(vector_object);
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < 10; i++) {
+    vector_setl(vector_object, i, i * 0.5L);
+  }
+  int result = EXIT_SUCCESS;
+  // The vector round trips through the context buffer and scratch space.
+  int capacity = 0;
+  const char *vector_string = vector_serialize_ctx(ctx, vector_object, NULL);
+  const long double *values = vector_string != NULL ? vector_unserialize_ctx(ctx, vector_string, &capacity) : NULL;
+  if (values == NULL || capacity != 10) {
+    result = EXIT_FAILURE;
+  }
+  for (int i = 0; result == EXIT_SUCCESS && i < 10; i++) {
+    if (values[i] != *vector_getl(vector_object, i)) {
+      result = EXIT_FAILURE;
+    }
+  }
+  // Matrices decode into a view over the same scratch space.
+  const struct matrix_view *view = matrix_unserialize_ctx(ctx, "[[\"1\",\"2\",\"3\"],[\"4\",\"5\",\"6\"]]");
+  if (result == EXIT_SUCCESS && (view == NULL || view->rows != 2 || view->columns != 3 || *matrix_view_getl(view, 1, 2) != 6)) {
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && matrix_unserialize_ctx(ctx, "[[\"1\"],[]]x") != NULL) {
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  vector_destroy(vector_object);
+  matrixmath_serializer_ctx_destroy(ctx);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_context_tests() {
+  if (serializer_context_serialize_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (serializer_context_unserialize_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
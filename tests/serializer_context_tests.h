@@ -0,0 +1,12 @@
+#ifndef SERIALIZER_CONTEXT_TESTS_H
+#define SERIALIZER_CONTEXT_TESTS_H
+
+/**
+ * Serializer context tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int serializer_context_tests();
+
+#endif
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_metrics_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * Counters captured by the test callback.
+ */
+struct serializer_metrics_test_capture {
+  // The number of callback invocations.
+  int invocations;
+  // The operation of the last invocation.
+  char operation[64];
+  // The counters of the last invocation.
+  struct serializer_metrics metrics;
+};
+
+/**
+ * Callback recording the last finished call.
+ *
+ * @param const char *operation
+ *   The name of the public function.
+ * @param const struct serializer_metrics *metrics
+ *   The counters of the call.
+ * @param void *context
+ *   The struct serializer_metrics_test_capture.
+ */
+static void serializer_metrics_test_callback(const char *operation, const struct serializer_metrics *metrics, void *context) {
+  struct serializer_metrics_test_capture *capture = context;
+  capture->invocations++;
+  snprintf(capture->operation, sizeof(capture->operation), "%s", operation);
+  capture->metrics = *metrics;
+}
+
+/**
+ * Tests that nothing is recorded while the instrumentation is off.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_metrics_disabled_tests() {
+  printf("------------ Serializer Metrics Disabled Tests. ------------\n");
+  struct matrix *object = serializer_test_matrix(8, 5, 0);
+  if (object == NULL || serializer_metrics_enable(0) == 1) {
+    matrix_destroy(object);
+    return EXIT_FAILURE;
+  }
+  serializer_metrics_reset();
+  char *data = matrix_serialize(object);
+  struct matrix *copy = matrix_unserialize(data);
+  struct serializer_metrics metrics;
+  serializer_metrics_snapshot(&metrics);
+  int result = EXIT_SUCCESS;
+  if (data == NULL || copy == NULL || metrics.calls != 0 || metrics.bytes_out != 0) {
+    printf("Calls were recorded while disabled.\n");
+    result = EXIT_FAILURE;
+  }
+  free(data);
+  matrix_destroy(copy);
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * Tests the totals collected for text and binary round trips.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_metrics_totals_tests() {
+  printf("------------ Serializer Metrics Totals Tests. ------------\n");
+  // Nothing to check when the instrumentation is compiled out.
+  if (serializer_metrics_enable(1) == 1) {
+    return EXIT_SUCCESS;
+  }
+  struct matrix *object = serializer_test_matrix(8, 5, 0);
+  if (object == NULL) {
+    serializer_metrics_enable(0);
+    return EXIT_FAILURE;
+  }
+  serializer_metrics_reset();
+  int result = EXIT_SUCCESS;
+  size_t length = 0;
+  char *data = matrix_serialize(object);
+  struct matrix *copy = matrix_unserialize(data);
+  unsigned char *binary = matrix_serialize_binary(object, &length);
+  struct matrix *binary_copy = matrix_unserialize_binary(binary, length);
+  struct serializer_metrics metrics;
+  serializer_metrics_snapshot(&metrics);
+  serializer_metrics_enable(0);
+  if (data == NULL || copy == NULL || binary == NULL || binary_copy == NULL) {
+    printf("Round trips failed while recording.\n");
+    result = EXIT_FAILURE;
+  }
+  // Nested calls are folded into the outermost one.
+  if (result == EXIT_SUCCESS && (metrics.calls != 4 || metrics.phase_calls[SERIALIZER_PHASE_ENCODE] != 2 || metrics.phase_calls[SERIALIZER_PHASE_DECODE] != 2)) {
+    printf("Unexpected call counts: %llu calls.\n", (unsigned long long)metrics.calls);
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && (metrics.phase_calls[SERIALIZER_PHASE_FORMAT] != 1 || metrics.phase_calls[SERIALIZER_PHASE_PARSE] != 1 || metrics.phase_calls[SERIALIZER_PHASE_ALLOCATE] < 3)) {
+    printf("Unexpected phase counts.\n");
+    result = EXIT_FAILURE;
+  }
+  size_t text_length = data != NULL ? strlen(data) : 0;
+  if (result == EXIT_SUCCESS && (metrics.bytes_out != text_length + length || metrics.bytes_in != text_length + length)) {
+    printf("Unexpected byte counts: %llu in, %llu out.\n", (unsigned long long)metrics.bytes_in, (unsigned long long)metrics.bytes_out);
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && metrics.allocated_bytes < 2 * 40 * sizeof(long double) + length) {
+    printf("Allocations were not counted.\n");
+    result = EXIT_FAILURE;
+  }
+  // A reset clears the totals.
+  serializer_metrics_reset();
+  serializer_metrics_snapshot(&metrics);
+  if (result == EXIT_SUCCESS && metrics.calls != 0) {
+    printf("Reset did not clear the totals.\n");
+    result = EXIT_FAILURE;
+  }
+  free(data);
+  free(binary);
+  matrix_destroy(copy);
+  matrix_destroy(binary_copy);
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * Tests that the callback receives the counters of each call.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int serializer_metrics_callback_tests() {
+  printf("------------ Serializer Metrics Callback Tests. ------------\n");
+  if (serializer_metrics_enable(1) == 1) {
+    return EXIT_SUCCESS;
+  }
+  struct serializer_metrics_test_capture capture;
+  memset(&capture, 0, sizeof(capture));
+  serializer_metrics_set_callback(serializer_metrics_test_callback, &capture);
+  int result = EXIT_SUCCESS;
+  // A JSON tree decode walks the tree and parses every number.
+  struct json *jobject = json_decode("[[\"1.5\",\"2\"],[\"3\",\"-4\"]]");
+  struct matrix *object = matrix_unserialize_from_json_object(jobject);
+  if (object == NULL) {
+    // The array is destroyed by a failed decode.
+    jobject = NULL;
+  }
+  if (object == NULL || capture.invocations != 1 || strcmp(capture.operation, "matrix_unserialize_from_json_object") != 0) {
+    printf("The tree decode was not reported.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && (capture.metrics.calls != 1 || capture.metrics.phase_calls[SERIALIZER_PHASE_TREE] != 1
+      || capture.metrics.phase_calls[SERIALIZER_PHASE_PARSE] != 1 || capture.metrics.allocated_bytes != 4 * sizeof(long double))) {
+    printf("The tree decode counters are wrong.\n");
+    result = EXIT_FAILURE;
+  }
+  // A sink encode counts the bytes handed to the sink.
+  struct serializer_buffer collected;
+  if (result == EXIT_SUCCESS && serializer_buffer_init(&collected, 0) == 0) {
+    if (matrix_serialize_to_sink(object, NULL, serializer_test_collect, &collected) == 1 || capture.invocations != 2
+        || strcmp(capture.operation, "matrix_serialize_to_stream") != 0 || capture.metrics.bytes_out != collected.length) {
+      printf("The sink encode counters are wrong.\n");
+      result = EXIT_FAILURE;
+    }
+    serializer_buffer_release(&collected);
+  }
+  serializer_metrics_set_callback(NULL, NULL);
+  serializer_metrics_enable(0);
+  json_destroy(jobject);
+  matrix_destroy(object);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_metrics_tests() {
+  if (serializer_metrics_disabled_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (serializer_metrics_totals_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (serializer_metrics_callback_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef SERIALIZER_METRICS_TESTS_H
+#define SERIALIZER_METRICS_TESTS_H
+
+/**
+ * Serializer metrics tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int serializer_metrics_tests();
+
+#endif
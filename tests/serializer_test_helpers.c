@@ -0,0 +1,58 @@
+#include <stdlib.h>
+#include "../include/matrixmath_serializer.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * {@inheritdoc}
+ */
+struct matrix *serializer_test_matrix(int rows, int columns, long double offset) {
+  struct matrix *object = matrix_create(rows, columns);
+  if (object == NULL) {
+    return NULL;
+  }
+  for (int j = 0; j < rows; j++) {
+    for (int k = 0; k < columns; k++) {
+      matrix_setl(object, j, k, offset + (long double)j * columns - k * 0.25L);
+    }
+  }
+  return object;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_test_matrix_equal(struct matrix *expected, struct matrix *actual) {
+  if (actual == NULL || actual->rows != expected->rows || actual->columns != expected->columns) {
+    return 0;
+  }
+  for (int j = 0; j < expected->rows; j++) {
+    for (int k = 0; k < expected->columns; k++) {
+      if (*matrix_getl(actual, j, k) != *matrix_getl(expected, j, k)) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_test_vector_equal(struct vector *expected, struct vector *actual) {
+  if (actual == NULL || actual->capacity != expected->capacity) {
+    return 0;
+  }
+  for (int k = 0; k < expected->capacity; k++) {
+    if (*vector_getl(actual, k) != *vector_getl(expected, k)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int serializer_test_collect(const char *data, size_t length, void *context) {
+  return serializer_buffer_write((struct serializer_buffer *)context, data, length);
+}
@@ -0,0 +1,66 @@
+#ifndef SERIALIZER_TEST_HELPERS_H
+#define SERIALIZER_TEST_HELPERS_H
+
+#include <stddef.h>
+#include "../include/matrixmath_serializer.h"
+
+/**
+ * Creates a matrix with distinct values.
+ *
+ * Every element holds offset + j * columns - k / 4, so no two elements of one
+ * matrix are equal and both signs and fractions are covered.
+ *
+ * @param int rows
+ *   The number of rows.
+ * @param int columns
+ *   The number of columns.
+ * @param long double offset
+ *   The value added to every element, to tell matrices apart.
+ *
+ * @return struct matrix*
+ *   The matrix, or NULL if the allocation failed.
+ */
+struct matrix *serializer_test_matrix(int rows, int columns, long double offset);
+
+/**
+ * Checks that two matrices have the same shape and values.
+ *
+ * @param struct matrix *expected
+ *   The expected matrix.
+ * @param struct matrix *actual
+ *   The matrix to check, may be NULL.
+ *
+ * @return int
+ *   Returns 1 if the matrices are equal, otherwise 0.
+ */
+int serializer_test_matrix_equal(struct matrix *expected, struct matrix *actual);
+
+/**
+ * Checks that two vectors have the same capacity and values.
+ *
+ * @param struct vector *expected
+ *   The expected vector.
+ * @param struct vector *actual
+ *   The vector to check, may be NULL.
+ *
+ * @return int
+ *   Returns 1 if the vectors are equal, otherwise 0.
+ */
+int serializer_test_vector_equal(struct vector *expected, struct vector *actual);
+
+/**
+ * Sink appending the received bytes to a growable buffer.
+ *
+ * @param const char *data
+ *   The bytes to append.
+ * @param size_t length
+ *   The number of bytes.
+ * @param void *context
+ *   The struct serializer_buffer.
+ *
+ * @return int
+ *   Returns 0 if successful, otherwise 1.
+ */
+int serializer_test_collect(const char *data, size_t length, void *context);
+
+#endif
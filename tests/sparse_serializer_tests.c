@@ -0,0 +1,304 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "sparse_serializer_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * Tests the CSR text form.
+ *
+ * This function encodes a small matrix with an empty row, compares it with the
+ * expected CSR text and decodes it back through every text decoder.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int sparse_serializer_text_tests() {
+  printf("------------ Sparse Serializer Text Tests. ------------\n");
+  struct matrix *matrix_object = matrix_create(3, 3);
+  struct matrix *destination = matrix_create(3, 3);
+  struct serializer_arena *arena = serializer_arena_create(0);
+  if (matrix_object == NULL || destination == NULL || arena == NULL) {
+    matrix_destroy(matrix_object);
+    matrix_destroy(destination);
+    serializer_arena_destroy(arena);
+    return EXIT_FAILURE;
+  }
+  matrix_setl(matrix_object, 0, 1, 1.5L);
+  matrix_setl(matrix_object, 2, 0, -2.0L);
+  matrix_setl(matrix_object, 2, 2, 4.0L);
+  // Stale values in the destination must be overwritten with zeros.
+  matrix_setl(destination, 1, 1, 9.0L);
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = SERIALIZER_SPARSE_ALWAYS;
+  const char *expected = "{\"format\":\"csr\",\"rows\":3,\"columns\":3,\"row_offsets\":[0,1,1,3],"
+    "\"column_indices\":[1,0,2],\"values\":[\"1.5\",\"-2\",\"4\"]}";
+  char *actual = matrix_serialize_with_options(matrix_object, &options);
+  int result = EXIT_SUCCESS;
+  if (actual == NULL || strcmp(actual, expected) != 0) {
+    printf("Unexpected CSR text: %s\n", actual != NULL ? actual : "(null)");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && strlen(actual) > matrix_serialized_size(matrix_object, &options)) {
+    printf("CSR text exceeds the size bound.\n");
+    result = EXIT_FAILURE;
+  }
+  // Every text decoder accepts the CSR form.
+  struct matrix *decoded = result == EXIT_SUCCESS ? matrix_unserialize(actual) : NULL;
+  struct matrix *parallel = result == EXIT_SUCCESS ? matrix_unserialize_parallel(actual, NULL, 4) : NULL;
+  if (result == EXIT_SUCCESS && (!serializer_test_matrix_equal(matrix_object, decoded) || !serializer_test_matrix_equal(matrix_object, parallel))) {
+    printf("CSR text did not round trip.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && (matrix_unserialize_into(destination, actual) == 1 || !serializer_test_matrix_equal(matrix_object, destination))) {
+    printf("CSR text did not decode in place.\n");
+    result = EXIT_FAILURE;
+  }
+  const struct matrix_view *view = result == EXIT_SUCCESS ? matrix_unserialize_arena(actual, arena) : NULL;
+  if (result == EXIT_SUCCESS && (view == NULL || *matrix_view_getl(view, 1, 1) != 0 || *matrix_view_getl(view, 2, 2) != 4)) {
+    printf("CSR text did not decode into the arena.\n");
+    result = EXIT_FAILURE;
+  }
+  // Keys may come in any order.
+  const char *reordered = "{ \"values\" : [\"7\"], \"columns\": 2, \"column_indices\": [1], \"rows\": 1,"
+    " \"row_offsets\": [0, 1], \"format\": \"csr\" }";
+  struct matrix *shuffled = result == EXIT_SUCCESS ? matrix_unserialize((char *)reordered) : NULL;
+  if (result == EXIT_SUCCESS && (shuffled == NULL || shuffled->columns != 2 || *matrix_getl(shuffled, 0, 0) != 0 || *matrix_getl(shuffled, 0, 1) != 7)) {
+    printf("Reordered CSR text did not decode.\n");
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  free(actual);
+  matrix_destroy(decoded);
+  matrix_destroy(parallel);
+  matrix_destroy(shuffled);
+  matrix_destroy(destination);
+  matrix_destroy(matrix_object);
+  serializer_arena_destroy(arena);
+  return result;
+}
+
+/**
+ * Tests the density-based choice between the dense and CSR forms.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int sparse_serializer_auto_tests() {
+  printf("------------ Sparse Serializer Auto Tests. ------------\n");
+  struct matrix *matrix_object = matrix_create(20, 20);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = SERIALIZER_SPARSE_AUTO;
+  int result = EXIT_SUCCESS;
+  // The diagonal holds 5% nonzeros, under the default density limit.
+  for (int j = 0; j < 20; j++) {
+    matrix_setl(matrix_object, j, j, j + 1.0L);
+  }
+  char *sparse = matrix_serialize_with_options(matrix_object, &options);
+  char *dense = matrix_serialize(matrix_object);
+  if (sparse == NULL || dense == NULL || sparse[0] != '{' || dense[0] != '[' || strlen(sparse) >= strlen(dense)) {
+    printf("Auto mode did not pick the CSR form.\n");
+    result = EXIT_FAILURE;
+  }
+  struct matrix *decoded = sparse != NULL ? matrix_unserialize(sparse) : NULL;
+  if (result == EXIT_SUCCESS && !serializer_test_matrix_equal(matrix_object, decoded)) {
+    result = EXIT_FAILURE;
+  }
+  // Past the limit the dense form is kept.
+  for (int k = 0; k < 20; k++) {
+    for (int j = 0; j < 10; j++) {
+      matrix_setl(matrix_object, j, k, 1.0L);
+    }
+  }
+  char *full = matrix_serialize_with_options(matrix_object, &options);
+  if (result == EXIT_SUCCESS && (full == NULL || full[0] != '[')) {
+    printf("Auto mode did not pick the dense form.\n");
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  free(sparse);
+  free(dense);
+  free(full);
+  matrix_destroy(decoded);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests the sparse binary form.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int sparse_serializer_binary_tests() {
+  printf("------------ Sparse Serializer Binary Tests. ------------\n");
+  struct matrix *matrix_object = matrix_create(9, 31);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < 9; j += 2) {
+    matrix_setl(matrix_object, j, (j * 7) % 31, -1.0L / (j + 3));
+    matrix_setl(matrix_object, j, 30, j + 0.25L);
+  }
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = SERIALIZER_SPARSE_AUTO;
+  size_t sparse_length = 0;
+  size_t dense_length = 0;
+  unsigned char *sparse = matrix_serialize_binary_with_options(matrix_object, &options, &sparse_length);
+  unsigned char *dense = matrix_serialize_binary(matrix_object, &dense_length);
+  struct serializer_binary_header header;
+  int result = EXIT_SUCCESS;
+  if (sparse == NULL || dense == NULL || serializer_binary_read_header(sparse, sparse_length, &header) == 1
+      || header.flags != SERIALIZER_BINARY_FLAG_SPARSE || sparse_length >= dense_length) {
+    printf("Sparse binary payload is not flagged or not smaller.\n");
+    result = EXIT_FAILURE;
+  }
+  struct matrix *decoded = result == EXIT_SUCCESS ? matrix_unserialize_binary(sparse, sparse_length) : NULL;
+  if (result == EXIT_SUCCESS && !serializer_test_matrix_equal(matrix_object, decoded)) {
+    printf("Sparse binary payload did not round trip.\n");
+    result = EXIT_FAILURE;
+  }
+  // Vectors and truncated payloads are rejected.
+  if (result == EXIT_SUCCESS && (vector_unserialize_binary(sparse, sparse_length) != NULL || matrix_unserialize_binary(sparse, sparse_length - 1) != NULL)) {
+    result = EXIT_FAILURE;
+  }
+  // A column index out of order fails even with a valid checksum.
+  if (result == EXIT_SUCCESS) {
+    size_t offsets_length = (10 * sizeof(uint64_t) + sizeof(long double) - 1) / sizeof(long double) * sizeof(long double);
+    uint32_t column = 31;
+    memcpy(sparse + SERIALIZER_BINARY_HEADER_SIZE + offsets_length, &column, sizeof(uint32_t));
+    uint32_t checksum = serializer_crc32(0, sparse + SERIALIZER_BINARY_HEADER_SIZE, sparse_length - SERIALIZER_BINARY_HEADER_SIZE);
+    memcpy(sparse + 20, &checksum, sizeof(uint32_t));
+    if (matrix_unserialize_binary(sparse, sparse_length) != NULL) {
+      printf("Out of range column index was accepted.\n");
+      result = EXIT_FAILURE;
+    }
+  }
+  // Clear the used memory.
+  free(sparse);
+  free(dense);
+  matrix_destroy(decoded);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests that negative zeros survive the CSR forms.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int sparse_serializer_negative_zero_tests() {
+  printf("------------ Sparse Serializer Negative Zero Tests. ------------\n");
+  struct matrix *matrix_object = matrix_create(2, 3);
+  if (matrix_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  matrix_setl(matrix_object, 0, 2, -0.0L);
+  matrix_setl(matrix_object, 1, 0, 3.0L);
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.sparse = SERIALIZER_SPARSE_ALWAYS;
+  size_t length = 0;
+  char *text = matrix_serialize_with_options(matrix_object, &options);
+  unsigned char *data = matrix_serialize_binary_with_options(matrix_object, &options, &length);
+  struct matrix *decoded[2] = {
+    text != NULL ? matrix_unserialize(text) : NULL,
+    data != NULL ? matrix_unserialize_binary(data, length) : NULL,
+  };
+  int result = EXIT_SUCCESS;
+  for (int i = 0; i < 2; i++) {
+    if (!serializer_test_matrix_equal(matrix_object, decoded[i]) || !signbit(*matrix_getl(decoded[i], 0, 2))
+        || signbit(*matrix_getl(decoded[i], 0, 1))) {
+      printf("CSR form %d lost the sign of a zero.\n", i);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Clear the used memory.
+  matrix_destroy(decoded[0]);
+  matrix_destroy(decoded[1]);
+  free(text);
+  free(data);
+  matrix_destroy(matrix_object);
+  return result;
+}
+
+/**
+ * Tests that malformed CSR text is rejected.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int sparse_serializer_malformed_tests() {
+  printf("------------ Sparse Serializer Malformed Tests. ------------\n");
+  const char *inputs[] = {
+    // Offsets not starting at zero.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[1,1],\"column_indices\":[0],\"values\":[\"1\"]}",
+    // Decreasing offsets.
+    "{\"format\":\"csr\",\"rows\":2,\"columns\":2,\"row_offsets\":[0,1,0],\"column_indices\":[0],\"values\":[\"1\"]}",
+    // Column index out of range.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[2],\"values\":[\"1\"]}",
+    // Repeated column within a row.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,2],\"column_indices\":[1,1],\"values\":[\"1\",\"2\"]}",
+    // More values than the offsets describe.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[\"1\",\"2\"]}",
+    // Fewer row offsets than rows.
+    "{\"format\":\"csr\",\"rows\":2,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[\"1\"]}",
+    // Null value.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[null]}",
+    // Unknown format.
+    "{\"format\":\"coo\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[\"1\"]}",
+    // Duplicate key.
+    "{\"format\":\"csr\",\"rows\":1,\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[\"1\"]}",
+    // Missing key.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"values\":[\"1\"]}",
+    // Zero rows.
+    "{\"format\":\"csr\",\"rows\":0,\"columns\":2,\"row_offsets\":[0],\"column_indices\":[],\"values\":[]}",
+    // Negative shape.
+    "{\"format\":\"csr\",\"rows\":-1,\"columns\":2,\"row_offsets\":[0,0],\"column_indices\":[],\"values\":[]}",
+    // Unparseable value.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[\"x\"]}",
+    // Trailing text.
+    "{\"format\":\"csr\",\"rows\":1,\"columns\":2,\"row_offsets\":[0,1],\"column_indices\":[0],\"values\":[\"1\"]}]",
+  };
+  int count = sizeof(inputs) / sizeof(inputs[0]);
+  for (int i = 0; i < count; i++) {
+    struct matrix *matrix_object = matrix_unserialize((char *)inputs[i]);
+    if (matrix_object != NULL) {
+      printf("Malformed CSR text %d was accepted.\n", i);
+      matrix_destroy(matrix_object);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int sparse_serializer_tests() {
+  if (sparse_serializer_text_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (sparse_serializer_auto_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (sparse_serializer_binary_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (sparse_serializer_negative_zero_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (sparse_serializer_malformed_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef SPARSE_SERIALIZER_TESTS_H
+#define SPARSE_SERIALIZER_TESTS_H
+
+/**
+ * Sparse serializer tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int sparse_serializer_tests();
+
+#endif
@@ -0,0 +1,153 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "strict_decoder_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * A malformed input and the error it must report.
+ */
+struct strict_decoder_test_case {
+  // The serialized matrix.
+  const char *data;
+  // The expected error.
+  struct serializer_error error;
+};
+
+/**
+ * Tests that valid inputs decode like the lenient decoder.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int strict_decoder_valid_tests() {
+  printf("------------ Strict Decoder Valid Tests. ------------\n");
+  struct matrix *object = serializer_test_matrix(6, 4, 0);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  int result = EXIT_SUCCESS;
+  struct serializer_error error;
+  char *data = matrix_serialize(object);
+  struct matrix *decoded = matrix_unserialize_strict(data, NULL, &error);
+  if (decoded == NULL || error.code != SERIALIZER_ERROR_NONE || decoded->rows != 6 || decoded->columns != 4) {
+    printf("Strict decode of a valid matrix failed with code %d.\n", error.code);
+    result = EXIT_FAILURE;
+  }
+  for (int j = 0; j < 6 && result == EXIT_SUCCESS; j++) {
+    for (int k = 0; k < 4; k++) {
+      if (*matrix_getl(decoded, j, k) != *matrix_getl(object, j, k)) {
+        printf("Strict decode changed the value at %d, %d.\n", j, k);
+        result = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+  // Column-major text, bare numbers and whitespace.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.layout = SERIALIZER_LAYOUT_COLUMN_MAJOR;
+  struct matrix *columns = matrix_unserialize_strict(" [ [1, 2, 3] , [\"-4.5e1\", 0, 6] ] ", &options, &error);
+  if (result == EXIT_SUCCESS && (columns == NULL || columns->rows != 3 || columns->columns != 2 || *matrix_getl(columns, 0, 1) != -45.0L)) {
+    printf("Strict column-major decode failed.\n");
+    result = EXIT_FAILURE;
+  }
+  // Non-finite values are accepted when the policy allows them.
+  options.layout = SERIALIZER_LAYOUT_ROW_MAJOR;
+  options.non_finite = SERIALIZER_NON_FINITE_ALLOW;
+  struct vector *special = vector_unserialize_strict("[\"nan\",\"-inf\",\"Infinity\"]", &options, &error);
+  if (result == EXIT_SUCCESS && (special == NULL || !isnan(*vector_getl(special, 0)) || *vector_getl(special, 1) != -INFINITY || *vector_getl(special, 2) != INFINITY)) {
+    printf("Allowed non-finite values were not decoded.\n");
+    result = EXIT_FAILURE;
+  }
+  // The JSON tree decoder leaves the tree to the caller.
+  struct json *jobject = json_decode(data);
+  struct matrix *tree = matrix_unserialize_from_json_object_strict(jobject, NULL, &error);
+  if (result == EXIT_SUCCESS && (tree == NULL || *matrix_getl(tree, 5, 3) != *matrix_getl(object, 5, 3))) {
+    printf("Strict tree decode failed.\n");
+    result = EXIT_FAILURE;
+  }
+  json_destroy(jobject);
+  free(data);
+  matrix_destroy(object);
+  matrix_destroy(decoded);
+  matrix_destroy(columns);
+  matrix_destroy(tree);
+  vector_destroy(special);
+  return result;
+}
+
+/**
+ * Tests the code and location reported for malformed inputs.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int strict_decoder_error_tests() {
+  printf("------------ Strict Decoder Error Tests. ------------\n");
+  const struct strict_decoder_test_case cases[] = {
+    {"[[\"1\",\"2\"],[\"3\"]]", {SERIALIZER_ERROR_SHAPE, 1, 1, 15}},
+    {"[[\"1\",\"2\"],[\"3\",\"4\",\"5\"]]", {SERIALIZER_ERROR_SHAPE, 1, 2, 20}},
+    {"[[\"1\",null],[\"3\",\"4\"]]", {SERIALIZER_ERROR_NULL, 0, 1, 6}},
+    {"[[\"1\",\"2\"],null]", {SERIALIZER_ERROR_NULL, 1, -1, 11}},
+    {"[[\"1\",\"2\"],[\"3\",\"4x\"]]", {SERIALIZER_ERROR_NUMBER, 1, 1, 16}},
+    {"[[1,02]]", {SERIALIZER_ERROR_NUMBER, 0, 1, 4}},
+    {"[[1,\"1e99999\"]]", {SERIALIZER_ERROR_OVERFLOW, 0, 1, 4}},
+    {"[[\"nan\",1]]", {SERIALIZER_ERROR_NON_FINITE, 0, 0, 2}},
+    {"[[1,2] [3,4]]", {SERIALIZER_ERROR_SYNTAX, 1, -1, 7}},
+    {"[[1,2]]x", {SERIALIZER_ERROR_SYNTAX, -1, -1, 7}},
+    {"[[]]", {SERIALIZER_ERROR_SHAPE, 0, 0, 2}},
+    {"[]", {SERIALIZER_ERROR_SHAPE, -1, -1, 1}},
+  };
+  int result = EXIT_SUCCESS;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]) && result == EXIT_SUCCESS; i++) {
+    struct serializer_error error;
+    struct matrix *decoded = matrix_unserialize_strict(cases[i].data, NULL, &error);
+    const struct serializer_error *expected = &cases[i].error;
+    if (decoded != NULL || error.code != expected->code || error.row != expected->row || error.column != expected->column || error.offset != expected->offset) {
+      printf("Case %zu reported code %d at %d, %d, offset %zu.\n", i, error.code, error.row, error.column, error.offset);
+      matrix_destroy(decoded);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Values must fit the element type of the options.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.element_type = SERIALIZER_ELEMENT_FLOAT32;
+  struct serializer_error error;
+  struct vector *narrow = vector_unserialize_strict("[1, 1e39]", &options, &error);
+  if (result == EXIT_SUCCESS && (narrow != NULL || error.code != SERIALIZER_ERROR_OVERFLOW || error.column != 1 || error.offset != 4)) {
+    printf("Float32 overflow was not reported.\n");
+    result = EXIT_FAILURE;
+  }
+  vector_destroy(narrow);
+  // The tree decoder reports ragged rows and null values too.
+  struct json *ragged = json_decode("[[\"1\",\"2\"],[\"3\"]]");
+  struct matrix *decoded = matrix_unserialize_from_json_object_strict(ragged, NULL, &error);
+  if (result == EXIT_SUCCESS && (decoded != NULL || error.code != SERIALIZER_ERROR_SHAPE || error.row != 1 || error.column != 1)) {
+    printf("Ragged tree was not reported.\n");
+    result = EXIT_FAILURE;
+  }
+  matrix_destroy(decoded);
+  json_destroy(ragged);
+  if (result == EXIT_SUCCESS && (matrix_unserialize_strict(NULL, NULL, &error) != NULL || error.code != SERIALIZER_ERROR_ARGUMENT)) {
+    printf("NULL input was not reported.\n");
+    result = EXIT_FAILURE;
+  }
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int strict_decoder_tests() {
+  if (strict_decoder_valid_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (strict_decoder_error_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
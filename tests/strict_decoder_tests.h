@@ -0,0 +1,12 @@
+#ifndef STRICT_DECODER_TESTS_H
+#define STRICT_DECODER_TESTS_H
+
+/**
+ * Strict decoder tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int strict_decoder_tests();
+
+#endif
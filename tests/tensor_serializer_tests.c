@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/matrixmath_serializer.h"
+#include "tensor_serializer_tests.h"
+#include "serializer_test_helpers.h"
+
+/**
+ * Checks that every slice of a tensor views the matching stacked matrix.
+ *
+ * @param const struct serializer_tensor *tensor
+ *   The tensor to check.
+ * @param struct matrix **objects
+ *   The stacked matrices.
+ * @param int count
+ *   The number of matrices.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int tensor_serializer_check_slices(const struct serializer_tensor *tensor, struct matrix **objects, int count) {
+  if (tensor == NULL || tensor->rank != 3 || serializer_tensor_slice_count(tensor) != count) {
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < count; i++) {
+    struct matrix_view view;
+    if (serializer_tensor_slice(tensor, i, &view) == 1 || view.rows != objects[i]->rows || view.columns != objects[i]->columns) {
+      return EXIT_FAILURE;
+    }
+    for (int j = 0; j < view.rows; j++) {
+      for (int k = 0; k < view.columns; k++) {
+        if (view.values[j * view.columns + k] != *matrix_getl(objects[i], j, k)) {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Tests stacking matrices and the JSON round trip.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int tensor_serializer_text_tests() {
+  printf("------------ Tensor Serializer Text Tests. ------------\n");
+  struct matrix *objects[5];
+  for (int i = 0; i < 5; i++) {
+    objects[i] = serializer_test_matrix(4, 3, i * 100.0L);
+    if (objects[i] == NULL) {
+      return EXIT_FAILURE;
+    }
+  }
+  int result = EXIT_SUCCESS;
+  struct serializer_tensor *tensor = serializer_tensor_stack(objects, 5);
+  if (tensor_serializer_check_slices(tensor, objects, 5) == EXIT_FAILURE) {
+    printf("Stacked slices do not match the matrices.\n");
+    result = EXIT_FAILURE;
+  }
+  char *data = tensor_serialize(tensor, NULL);
+  if (result == EXIT_SUCCESS && (data == NULL || strncmp(data, "{\"format\":\"tensor\",\"shape\":[5,4,3],\"values\":[", 45) != 0)) {
+    printf("Unexpected tensor text: %s\n", data != NULL ? data : "(null)");
+    result = EXIT_FAILURE;
+  }
+  struct serializer_tensor *decoded = tensor_unserialize(data);
+  if (result == EXIT_SUCCESS && tensor_serializer_check_slices(decoded, objects, 5) == EXIT_FAILURE) {
+    printf("Tensor text round trip failed.\n");
+    result = EXIT_FAILURE;
+  }
+  // A slice copies into a Matrix object.
+  struct matrix_view view;
+  struct matrix *copy = serializer_tensor_slice(decoded, 3, &view) == 0 ? matrix_view_to_matrix(&view) : NULL;
+  if (result == EXIT_SUCCESS && (copy == NULL || *matrix_getl(copy, 2, 1) != *matrix_getl(objects[3], 2, 1))) {
+    printf("Slice copy failed.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && serializer_tensor_slice(decoded, 5, &view) == 0) {
+    printf("Out of range slice was accepted.\n");
+    result = EXIT_FAILURE;
+  }
+  // Matrices of another shape cannot be stacked.
+  struct matrix *other = matrix_create(3, 4);
+  struct matrix *mixed[2] = {objects[0], other};
+  struct serializer_tensor *rejected = serializer_tensor_stack(mixed, 2);
+  if (result == EXIT_SUCCESS && rejected != NULL) {
+    printf("Mixed shapes were stacked.\n");
+    result = EXIT_FAILURE;
+  }
+  serializer_tensor_destroy(rejected);
+  matrix_destroy(other);
+  matrix_destroy(copy);
+  serializer_tensor_destroy(decoded);
+  serializer_tensor_destroy(tensor);
+  free(data);
+  for (int i = 0; i < 5; i++) {
+    matrix_destroy(objects[i]);
+  }
+  return result;
+}
+
+/**
+ * Tests the binary round trip of a higher-rank tensor.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int tensor_serializer_binary_tests() {
+  printf("------------ Tensor Serializer Binary Tests. ------------\n");
+  int shape[4] = {2, 3, 2, 5};
+  struct serializer_tensor *tensor = serializer_tensor_create(4, shape);
+  if (tensor == NULL || tensor->count != 60 || serializer_tensor_slice_count(tensor) != 6) {
+    serializer_tensor_destroy(tensor);
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < tensor->count; i++) {
+    tensor->values[i] = (long double)i / 3.0L - 7.0L;
+  }
+  int result = EXIT_SUCCESS;
+  size_t length = 0;
+  unsigned char *data = tensor_serialize_binary(tensor, NULL, &length);
+  struct serializer_tensor *decoded = tensor_unserialize_binary(data, length);
+  if (decoded == NULL || decoded->rank != 4 || memcmp(decoded->shape, shape, sizeof(shape)) != 0) {
+    printf("Tensor binary round trip failed.\n");
+    result = EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < tensor->count && result == EXIT_SUCCESS; i++) {
+    if (decoded->values[i] != tensor->values[i]) {
+      printf("Tensor binary round trip changed element %zu.\n", i);
+      result = EXIT_FAILURE;
+    }
+  }
+  // Narrower element types round each element once.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.element_type = SERIALIZER_ELEMENT_FLOAT64;
+  size_t narrow_length = 0;
+  unsigned char *narrow = tensor_serialize_binary(tensor, &options, &narrow_length);
+  struct serializer_tensor *widened = tensor_unserialize_binary(narrow, narrow_length);
+  if (result == EXIT_SUCCESS && (narrow_length >= length || widened == NULL || widened->values[59] != (long double)(double)tensor->values[59])) {
+    printf("Float64 tensor round trip failed.\n");
+    result = EXIT_FAILURE;
+  }
+  // Tensor payloads are not matrices.
+  if (result == EXIT_SUCCESS && matrix_unserialize_binary(data, length) != NULL) {
+    printf("Tensor payload decoded as a matrix.\n");
+    result = EXIT_FAILURE;
+  }
+  serializer_tensor_destroy(widened);
+  serializer_tensor_destroy(decoded);
+  serializer_tensor_destroy(tensor);
+  free(narrow);
+  free(data);
+  return result;
+}
+
+/**
+ * Tests that malformed tensors are rejected.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int tensor_serializer_malformed_tests() {
+  printf("------------ Tensor Serializer Malformed Tests. ------------\n");
+  static const char *inputs[] = {
+    "{\"format\":\"tensor\",\"values\":[\"1\",\"2\"],\"shape\":[2]}",
+    "{\"format\":\"tensor\",\"shape\":[2,2],\"values\":[\"1\",\"2\",\"3\"]}",
+    "{\"format\":\"tensor\",\"shape\":[2],\"values\":[\"1\",\"2\",\"3\"]}",
+    "{\"format\":\"tensor\",\"shape\":[2],\"values\":[\"1\",null]}",
+    "{\"format\":\"tensor\",\"shape\":[0],\"values\":[]}",
+    "{\"format\":\"csr\",\"shape\":[1],\"values\":[\"1\"]}",
+    "{\"shape\":[1],\"values\":[\"1\"]}",
+    "{\"format\":\"tensor\",\"shape\":[1],\"shape\":[1],\"values\":[\"1\"]}",
+    "{\"format\":\"tensor\",\"shape\":[1,1,1,1,1,1,1,1,1],\"values\":[\"1\"]}",
+    "{\"format\":\"tensor\",\"shape\":[1],\"values\":[\"1\"]} x",
+  };
+  for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    struct serializer_tensor *tensor = tensor_unserialize(inputs[i]);
+    if (tensor != NULL) {
+      printf("Malformed tensor %zu was accepted.\n", i);
+      serializer_tensor_destroy(tensor);
+      return EXIT_FAILURE;
+    }
+  }
+  // A shape larger than the text can hold is rejected before any allocation.
+  int result = EXIT_SUCCESS;
+  if (serializer_metrics_enable(1) == 0) {
+    serializer_metrics_reset();
+    struct serializer_tensor *oversized = tensor_unserialize("{\"format\":\"tensor\",\"shape\":[4096,4096,64],\"values\":[\"1\"]}");
+    struct serializer_metrics metrics;
+    serializer_metrics_snapshot(&metrics);
+    serializer_metrics_enable(0);
+    if (oversized != NULL || metrics.allocated_bytes != 0) {
+      printf("Oversized tensor shape allocated %llu bytes.\n", (unsigned long long)metrics.allocated_bytes);
+      serializer_tensor_destroy(oversized);
+      return EXIT_FAILURE;
+    }
+  }
+  struct serializer_tensor *valid = tensor_unserialize(" { \"shape\" : [3] , \"values\" : [1, \"2\", -3e0], \"format\" : \"tensor\" } ");
+  if (valid == NULL || valid->rank != 1 || valid->values[2] != -3.0L) {
+    printf("Valid rank 1 tensor was rejected.\n");
+    result = EXIT_FAILURE;
+  }
+  // A shape that disagrees with the header is rejected even with a valid checksum.
+  size_t length = 0;
+  unsigned char *data = tensor_serialize_binary(valid, NULL, &length);
+  uint32_t extent = 4;
+  memcpy(data + SERIALIZER_BINARY_HEADER_SIZE + sizeof(uint32_t), &extent, sizeof(uint32_t));
+  uint32_t checksum = serializer_crc32(0, data + SERIALIZER_BINARY_HEADER_SIZE, length - SERIALIZER_BINARY_HEADER_SIZE);
+  memcpy(data + 20, &checksum, sizeof(uint32_t));
+  struct serializer_tensor *corrupted = tensor_unserialize_binary(data, length);
+  if (result == EXIT_SUCCESS && corrupted != NULL) {
+    printf("Corrupted tensor shape was accepted.\n");
+    result = EXIT_FAILURE;
+  }
+  if (result == EXIT_SUCCESS && tensor_unserialize_binary(data, length - 1) != NULL) {
+    printf("Truncated tensor was accepted.\n");
+    result = EXIT_FAILURE;
+  }
+  serializer_tensor_destroy(corrupted);
+  serializer_tensor_destroy(valid);
+  free(data);
+  return result;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int tensor_serializer_tests() {
+  if (tensor_serializer_text_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (tensor_serializer_binary_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (tensor_serializer_malformed_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef TENSOR_SERIALIZER_TESTS_H
+#define TENSOR_SERIALIZER_TESTS_H
+
+/**
+ * Tensor serializer tests function.
+ *
+ * @return int
+ *   The constant that represent the exit status.
+ */
+int tensor_serializer_tests();
+
+#endif
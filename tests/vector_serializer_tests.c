@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/matrixmath_serializer.h"
 #include "vector_serializer_tests.h"
+#include "serializer_test_helpers.h"
 
 /**
  * Tests the serialization of a vector.
@@ -62,6 +64,189 @@ static int vector_unserialize_tests() {
   return EXIT_SUCCESS;
 }
 
+/**
+ * Tests the streaming vector encoder.
+ *
+ * This function checks that, with the legacy number format, the streaming
+ * encoder, the sink encoder and the JSON tree encoder all produce
+ * byte-for-byte identical output.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int vector_serialize_stream_tests() {
+  printf("------------ Vector Serialize Stream Tests. ------------\n");
+  // Create a vector of 5 elements.
+  struct vector *vector_object = vector_create(5);
+  if (vector_object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < 5; i++) {
+    vector_setl(vector_object, i, (i - 2) * 1234.5678L / (i + 3));
+  }
+  // Encode through the JSON tree.
+  struct json *jobject = vector_serialize_to_json(vector_object);
+  char *tree_string = json_encode(jobject);
+  json_destroy(jobject);
+  // Encode through the streaming encoder with the legacy number format.
+  struct serializer_options options;
+  serializer_options_init(&options);
+  options.precision = SERIALIZER_PRECISION_LEGACY;
+  char *stream_string = vector_serialize_with_options(vector_object, &options);
+  // Encode through a sink.
+  struct serializer_buffer collected;
+  serializer_buffer_init(&collected, 0);
+  int status = vector_serialize_to_sink(vector_object, &options, serializer_test_collect, &collected);
+  char *sink_string = serializer_buffer_detach(&collected, NULL);
+  // Compare the outputs.
+  int result = EXIT_SUCCESS;
+  if (status == 1 || tree_string == NULL || stream_string == NULL || sink_string == NULL
+      || strcmp(tree_string, stream_string) != 0 || strcmp(tree_string, sink_string) != 0) {
+    printf("Stream output mismatch.\n");
+    result = EXIT_FAILURE;
+  }
+  else {
+    printf("Streamed Vector String: %s \n", stream_string);
+  }
+  // Clear the used memory.
+  free(tree_string);
+  free(stream_string);
+  free(sink_string);
+  vector_destroy(vector_object);
+  return result;
+}
+
+/**
+ * Tests the tree-less vector decoder.
+ *
+ * This function checks that the scanner decodes the same values as the JSON
+ * tree decoder and rejects malformed input.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int vector_unserialize_scanner_tests() {
+  printf("------------ Vector Un-Serialize Scanner Tests. ------------\n");
+  char *vector_string = "[\"1.5\",\"-2.25e3\",\"3\",\"0.1\"]";
+  // Decode through the JSON tree.
+  struct json *jobject = json_decode(vector_string);
+  struct vector *expected = vector_unserialize_from_json_object(jobject);
+  json_destroy(jobject);
+  // Decode through the scanner.
+  struct vector *actual = vector_unserialize(vector_string);
+  int result = EXIT_SUCCESS;
+  if (expected == NULL || actual == NULL || actual->capacity != 4) {
+    result = EXIT_FAILURE;
+  }
+  for (int i = 0; result == EXIT_SUCCESS && i < 4; i++) {
+    if (*vector_getl(expected, i) != *vector_getl(actual, i)) {
+      result = EXIT_FAILURE;
+    }
+  }
+  vector_destroy(expected);
+  vector_destroy(actual);
+  // Malformed input must be rejected.
+  const char *invalid[] = {"", "[]", "[\"1\",]", "[\"1\" \"2\"]", "[\"\"]", "[\"1\"] ]"};
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    struct vector *rejected = vector_unserialize((char *)invalid[i]);
+    if (rejected != NULL) {
+      printf("Accepted malformed input: %s\n", invalid[i]);
+      vector_destroy(rejected);
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
+
+/**
+ * Tests decoding into an existing vector.
+ *
+ * This function decodes a string and a JSON object into a preallocated
+ * vector and checks that capacity mismatches are rejected without writing.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int vector_unserialize_into_tests() {
+  printf("------------ Vector Un-Serialize Into Tests. ------------\n");
+  struct vector *destination = vector_create(3);
+  if (destination == NULL) {
+    return EXIT_FAILURE;
+  }
+  int result = EXIT_SUCCESS;
+  // Decode a string in place.
+  if (vector_unserialize_into(destination, "[\"1\",\"2\",\"3.25\"]") == 1 || *vector_getl(destination, 2) != 3.25L) {
+    result = EXIT_FAILURE;
+  }
+  // A capacity mismatch must be rejected before anything is written.
+  if (vector_unserialize_into(destination, "[\"9\",\"9\"]") == 0 || *vector_getl(destination, 0) != 1.0L) {
+    result = EXIT_FAILURE;
+  }
+  // Decode a JSON object in place.
+  struct json *jobject = json_object("bias", json_decode("[\"-1\",\"-2\",\"-3\"]"));
+  if (vector_set_from_json_object(destination, "bias", jobject) == 1 || *vector_getl(destination, 1) != -2.0L) {
+    result = EXIT_FAILURE;
+  }
+  // Clear the used memory.
+  json_destroy(jobject);
+  vector_destroy(destination);
+  return result;
+}
+
+/**
+ * Tests the size bound and serialization into caller memory.
+ *
+ * This function checks, for every precision mode, that the size bound covers
+ * the actual output and that writing into memory of exactly the right size
+ * works while one byte less fails.
+ *
+ * @return int
+ *   Returns EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ */
+static int vector_serialize_to_buffer_tests() {
+  printf("------------ Vector Serialize To Buffer Tests. ------------\n");
+  struct vector *object = vector_create(37);
+  if (object == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < 37; i++) {
+    vector_setl(object, i, (i % 2 ? -1 : 1) * (i + 1) / 3e-30L);
+  }
+  int result = EXIT_SUCCESS;
+  struct serializer_options options;
+  const int precisions[] = {SERIALIZER_PRECISION_SHORTEST, SERIALIZER_PRECISION_DOUBLE, SERIALIZER_PRECISION_FIXED, SERIALIZER_PRECISION_LEGACY};
+  for (size_t i = 0; result == EXIT_SUCCESS && i < sizeof(precisions) / sizeof(precisions[0]); i++) {
+    serializer_options_init(&options);
+    options.precision = precisions[i];
+    options.digits = 12;
+    char *expected = vector_serialize_with_options(object, &options);
+    size_t bound = vector_serialized_size(object, &options);
+    size_t length = expected != NULL ? strlen(expected) : 0;
+    char *data = malloc(bound + 1);
+    if (expected == NULL || data == NULL || bound < length) {
+      printf("Size bound %zu below the actual length %zu.\n", bound, length);
+      result = EXIT_FAILURE;
+    }
+    // The bound always suffices, and so does the exact length.
+    size_t written = 0;
+    if (result == EXIT_SUCCESS && (vector_serialize_to_buffer(object, &options, data, bound + 1, &written) == 1 || written != length || strcmp(data, expected) != 0)) {
+      result = EXIT_FAILURE;
+    }
+    if (result == EXIT_SUCCESS && (vector_serialize_to_buffer(object, &options, data, length + 1, &written) == 1 || strcmp(data, expected) != 0)) {
+      result = EXIT_FAILURE;
+    }
+    // One byte less, leaving no room for the terminator, must fail.
+    if (result == EXIT_SUCCESS && vector_serialize_to_buffer(object, &options, data, length, &written) == 0) {
+      result = EXIT_FAILURE;
+    }
+    free(data);
+    free(expected);
+  }
+  // Clear the used memory.
+  vector_destroy(object);
+  return result;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -69,8 +254,20 @@ int vector_serializer_tests() {
   if (vector_serialize_tests() == EXIT_FAILURE) {
     return EXIT_FAILURE;
   }
+  if (vector_serialize_stream_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
   if (vector_unserialize_tests() == EXIT_FAILURE) {
     return EXIT_FAILURE;
   }
+  if (vector_unserialize_scanner_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (vector_unserialize_into_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
+  if (vector_serialize_to_buffer_tests() == EXIT_FAILURE) {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }